@@ -35,6 +35,7 @@
 #include "lwcell/lwcell_conn.h"
 #include "lwcell/lwcell_mem.h"
 #include "lwcell/lwcell_private.h"
+#include "lwcell/lwcell_timeout.h"
 
 #if LWCELL_CFG_NETCONN || __DOXYGEN__
 
@@ -59,8 +60,17 @@ typedef struct lwcell_netconn {
     lwcell_conn_p conn;             /*!< Pointer to actual connection */
 
     lwcell_sys_mbox_t mbox_receive; /*!< Message queue for receive mbox */
+    lwcell_pbuf_p rcv_pbuf;         /*!< Partially read packet, its payload starts at first unread byte */
+    lwcell_sys_mbox_t mbox_accept;  /*!< Message queue for accepting new connections */
+    lwcell_port_t listen_port;      /*!< Local port to listen on, set with \ref lwcell_netconn_bind */
+    uint32_t last_active;           /*!< Time of last data exchange in units of milliseconds */
 
     lwcell_linbuff_t buff;          /*!< Linear buffer structure */
+    uint32_t wr_delay;              /*!< Automatic flush delay of write buffer in units of milliseconds,
+                                                `0` when buffer is only sent when full or on explicit flush */
+    size_t wr_threshold;            /*!< Number of buffered bytes sent immediately, `0` to use full buffer */
+    lwcell_timeout_handle_t wr_tmo; /*!< Pending automatic flush timeout, `0` when not running */
+    lwcellr_t wr_err;               /*!< Automatic flush error, returned by next write or flush */
 
     uint16_t conn_timeout;         /*!< Connection timeout in units of seconds when
                                                     netconn is in server (listen) mode.
@@ -70,10 +80,35 @@ typedef struct lwcell_netconn {
 #if LWCELL_CFG_NETCONN_RECEIVE_TIMEOUT || __DOXYGEN__
     uint32_t rcv_timeout; /*!< Receive timeout in unit of milliseconds */
 #endif
+#if LWCELL_CFG_NETCONN_POLL || __DOXYGEN__
+    size_t rcv_queued;    /*!< Number of data and close entries in receive mbox */
+    size_t accept_queued; /*!< Number of connections in accept mbox */
+    uint8_t closed;       /*!< Set to `1` when connection has been closed */
+#endif                    /* LWCELL_CFG_NETCONN_POLL || __DOXYGEN__ */
 } lwcell_netconn_t;
 
+#if LWCELL_CFG_NETCONN_POLL || __DOXYGEN__
+
+/**
+ * \brief           Thread waiting in \ref lwcell_netconn_poll
+ */
+typedef struct netconn_poll_waiter {
+    struct netconn_poll_waiter* next; /*!< Linked list entry */
+    lwcell_netconn_poll_t* fds;       /*!< Netconns waited for */
+    size_t fds_cnt;                   /*!< Number of entries in fds array */
+    lwcell_sys_sem_t sem;             /*!< Semaphore released when any entry becomes ready */
+    uint8_t signaled;                 /*!< Set to `1` when semaphore has been released */
+} netconn_poll_waiter_t;
+
+#endif /* LWCELL_CFG_NETCONN_POLL || __DOXYGEN__ */
+
 static uint8_t recv_closed = 0xFF;
 static lwcell_netconn_t* netconn_list; /*!< Linked list of netconn entries */
+static lwcell_netconn_t* listen_api;   /*!< Netconn in listening mode, device supports single server */
+#if LWCELL_CFG_NETCONN_POLL || __DOXYGEN__
+static netconn_poll_waiter_t* poll_waiters; /*!< Linked list of threads waiting in poll */
+static lwcell_sys_sem_t poll_sem_spare;     /*!< Semaphore kept for next poll, to avoid creating it every time */
+#endif                                      /* LWCELL_CFG_NETCONN_POLL || __DOXYGEN__ */
 
 /**
  * \brief           Flush all mboxes and clear possible used memories
@@ -95,11 +130,115 @@ flush_mboxes(lwcell_netconn_t* nc, uint8_t protect) {
         lwcell_sys_mbox_delete(&nc->mbox_receive);  /* Delete message queue */
         lwcell_sys_mbox_invalid(&nc->mbox_receive); /* Invalid handle */
     }
+    if (nc->rcv_pbuf != NULL) {
+        lwcell_pbuf_free_s(&nc->rcv_pbuf); /* Free partially read packet */
+    }
+    if (lwcell_sys_mbox_isvalid(&nc->mbox_accept)) {
+        lwcell_netconn_t* new_nc;
+
+        /* Connections not accepted by application are closed */
+        while (lwcell_sys_mbox_getnow(&nc->mbox_accept, (void**)&new_nc)) {
+            if (new_nc != NULL && (uint8_t*)new_nc != (uint8_t*)&recv_closed) {
+                if (new_nc->conn != NULL && lwcell_conn_get_arg(new_nc->conn) == new_nc) {
+                    lwcell_conn_set_arg(new_nc->conn, NULL);
+                    lwcell_conn_close(new_nc->conn, 0);
+                }
+                lwcell_netconn_delete(new_nc);
+            }
+        }
+        lwcell_sys_mbox_delete(&nc->mbox_accept);  /* Delete message queue */
+        lwcell_sys_mbox_invalid(&nc->mbox_accept); /* Invalid handle */
+    }
+#if LWCELL_CFG_NETCONN_POLL
+    nc->rcv_queued = 0;
+    nc->accept_queued = 0;
+#endif /* LWCELL_CFG_NETCONN_POLL */
     if (protect) {
         lwcell_core_unlock();
     }
 }
 
+#if LWCELL_CFG_NETCONN_POLL || __DOXYGEN__
+
+/**
+ * \brief           Get current readiness state of netconn
+ * \note            Function must be called with core locked
+ * \param[in]       nc: Netconn handle
+ * \return          Bitwise-ORed \ref LWCELL_NETCONN_POLL_READ and other flags
+ */
+static uint8_t
+netconn_poll_state(lwcell_netconn_t* nc) {
+    uint8_t st = 0;
+
+    if (nc->rcv_queued > 0 || nc->accept_queued > 0 || nc->rcv_pbuf != NULL) {
+        st |= LWCELL_NETCONN_POLL_READ;
+    }
+    if (nc == listen_api) {
+        /* Listening netconn has no connection */
+    } else if (nc->conn == NULL || nc->closed) {
+        st |= LWCELL_NETCONN_POLL_CLOSED;
+    } else if (nc->conn->status.f.active
+#if LWCELL_CFG_CONN_QSEND
+               && nc->conn->tx_unacked < LWCELL_CFG_CONN_QSEND_WINDOW
+#endif /* LWCELL_CFG_CONN_QSEND */
+    ) {
+        st |= LWCELL_NETCONN_POLL_WRITE;
+    }
+    return st;
+}
+
+/**
+ * \brief           Fill ready states of poll entries
+ * \note            Function must be called with core locked
+ * \param[in,out]   fds: Poll entries
+ * \param[in]       fds_cnt: Number of entries
+ * \return          Number of entries with at least one ready state
+ */
+static size_t
+netconn_poll_check(lwcell_netconn_poll_t* fds, size_t fds_cnt) {
+    size_t cnt = 0;
+
+    for (size_t i = 0; i < fds_cnt; ++i) {
+        fds[i].revents = 0;
+        if (fds[i].nc != NULL) {
+            fds[i].revents = netconn_poll_state(fds[i].nc) & (fds[i].events | LWCELL_NETCONN_POLL_CLOSED);
+        }
+        if (fds[i].revents) {
+            ++cnt;
+        }
+    }
+    return cnt;
+}
+
+/**
+ * \brief           Wake up threads waiting for netconn, when it became ready
+ * \note            Function must be called with core locked
+ * \param[in]       nc: Netconn with changed state
+ */
+static void
+netconn_poll_notify(lwcell_netconn_t* nc) {
+    uint8_t st;
+
+    if (poll_waiters == NULL) {
+        return;
+    }
+    st = netconn_poll_state(nc);
+    for (netconn_poll_waiter_t* w = poll_waiters; w != NULL; w = w->next) {
+        if (w->signaled) {
+            continue;
+        }
+        for (size_t i = 0; i < w->fds_cnt; ++i) {
+            if (w->fds[i].nc == nc && (st & (w->fds[i].events | LWCELL_NETCONN_POLL_CLOSED))) {
+                w->signaled = 1;
+                lwcell_sys_sem_release(&w->sem);
+                break;
+            }
+        }
+    }
+}
+
+#endif /* LWCELL_CFG_NETCONN_POLL || __DOXYGEN__ */
+
 /**
  * \brief           Callback function for every server connection
  * \param[in]       evt: Pointer to callback structure
@@ -122,13 +261,39 @@ netconn_evt(lwcell_evt_t* evt) {
                 nc = lwcell_conn_get_arg(conn); /* Argument should be already set */
                 if (nc != NULL) {
                     nc->conn = conn;           /* Save actual connection */
+#if LWCELL_CFG_NETCONN_POLL
+                    nc->closed = 0;
+                    netconn_poll_notify(nc);
+#endif                                         /* LWCELL_CFG_NETCONN_POLL */
                 } else {
                     close = 1;                 /* Close this connection, invalid netconn */
                 }
             } else {
-                LWCELL_DEBUGF(LWCELL_CFG_DBG_NETCONN | LWCELL_DBG_TYPE_TRACE | LWCELL_DBG_LVL_WARNING,
-                             "[LWCELL NETCONN] Closing connection, it is not in client mode!\r\n");
-                close = 1; /* Close the connection at this point */
+                /* Connection accepted by server, queue it for application */
+                if (listen_api != NULL && (nc = lwcell_netconn_new(LWCELL_NETCONN_TYPE_TCP)) != NULL) {
+                    nc->conn = conn;
+                    nc->conn_timeout = listen_api->conn_timeout;
+                    lwcell_conn_set_arg(conn, nc);
+                    if (!lwcell_sys_mbox_isvalid(&listen_api->mbox_accept)
+                        || !lwcell_sys_mbox_putnow(&listen_api->mbox_accept, nc)) {
+                        LWCELL_DEBUGF(LWCELL_CFG_DBG_NETCONN | LWCELL_DBG_TYPE_TRACE | LWCELL_DBG_LVL_WARNING,
+                                      "[LWCELL NETCONN] Accept queue full, closing connection\r\n");
+                        close = 1;
+                    }
+#if LWCELL_CFG_NETCONN_POLL
+                    if (!close) {
+                        ++listen_api->accept_queued;
+                        netconn_poll_notify(listen_api);
+                    }
+#endif /* LWCELL_CFG_NETCONN_POLL */
+                } else {
+                    LWCELL_DEBUGF(LWCELL_CFG_DBG_NETCONN | LWCELL_DBG_TYPE_TRACE | LWCELL_DBG_LVL_WARNING,
+                                  "[LWCELL NETCONN] Closing connection, there is no listening netconn!\r\n");
+                    close = 1; /* Close the connection at this point */
+                }
+            }
+            if (nc != NULL) {
+                nc->last_active = lwcell_sys_now();
             }
 
             /* Decide if some events want to close the connection */
@@ -153,7 +318,9 @@ netconn_evt(lwcell_evt_t* evt) {
             nc = lwcell_conn_get_arg(conn);            /* Get API from connection */
             pbuf = lwcell_evt_conn_recv_get_buff(evt); /* Get received buff */
 
+#if !LWCELL_CFG_CONN_MANUAL_RX
             lwcell_conn_recved(conn, pbuf);            /* Notify stack about received data */
+#endif                                                 /* !LWCELL_CFG_CONN_MANUAL_RX */
 
             lwcell_pbuf_ref(pbuf);                     /* Increase reference counter */
             if (nc == NULL || !lwcell_sys_mbox_isvalid(&nc->mbox_receive)
@@ -163,6 +330,11 @@ netconn_evt(lwcell_evt_t* evt) {
                 return lwcellOKIGNOREMORE; /* Return OK to free the memory and ignore further data */
             }
             ++nc->rcv_packets;            /* Increase number of received packets */
+            nc->last_active = lwcell_sys_now();
+#if LWCELL_CFG_NETCONN_POLL
+            ++nc->rcv_queued;
+            netconn_poll_notify(nc);
+#endif /* LWCELL_CFG_NETCONN_POLL */
             LWCELL_DEBUGF(LWCELL_CFG_DBG_NETCONN | LWCELL_DBG_TYPE_TRACE,
                          "[LWCELL NETCONN] Received pbuf contains %d bytes. Handle written to receive mbox\r\n",
                          (int)lwcell_pbuf_length(pbuf, 0));
@@ -178,9 +350,48 @@ netconn_evt(lwcell_evt_t* evt) {
              * simply write pointer to received variable to indicate closed state
              */
             if (nc != NULL && lwcell_sys_mbox_isvalid(&nc->mbox_receive)) {
+#if LWCELL_CFG_NETCONN_POLL
+                if (lwcell_sys_mbox_putnow(&nc->mbox_receive, (void*)&recv_closed)) {
+                    ++nc->rcv_queued;
+                }
+                nc->closed = 1;
+                netconn_poll_notify(nc);
+#else  /* LWCELL_CFG_NETCONN_POLL */
                 lwcell_sys_mbox_putnow(&nc->mbox_receive, (void*)&recv_closed);
+#endif /* !LWCELL_CFG_NETCONN_POLL */
+            }
+
+            break;
+        }
+        /* Data have been sent */
+        case LWCELL_EVT_CONN_SEND: {
+            nc = lwcell_conn_get_arg(conn);
+            if (nc != NULL) {
+                nc->last_active = lwcell_sys_now();
+#if LWCELL_CFG_NETCONN_POLL
+                netconn_poll_notify(nc); /* Sent data may open quick send window for writing */
+#endif                                   /* LWCELL_CFG_NETCONN_POLL */
+            }
+            break;
+        }
+
+        /* Periodic poll of active connection */
+        case LWCELL_EVT_CONN_POLL: {
+            nc = lwcell_conn_get_arg(conn);
+            if (nc == NULL) {
+                break;
             }
 
+            /* Close idle connection accepted by server */
+            if (nc->conn_timeout > 0 && !lwcell_conn_is_client(conn)
+                && (lwcell_sys_now() - nc->last_active) >= (uint32_t)nc->conn_timeout * 1000U) {
+                LWCELL_DEBUGF(LWCELL_CFG_DBG_NETCONN | LWCELL_DBG_TYPE_TRACE,
+                              "[LWCELL NETCONN] Closing idle server connection\r\n");
+                lwcell_conn_close(conn, 0);
+            }
+#if LWCELL_CFG_NETCONN_POLL
+            netconn_poll_notify(nc);
+#endif /* LWCELL_CFG_NETCONN_POLL */
             break;
         }
         default: return lwcellERR;
@@ -188,6 +399,22 @@ netconn_evt(lwcell_evt_t* evt) {
     return lwcellOK;
 }
 
+/**
+ * \brief           Stop server, if netconn is in listening mode
+ * \param[in]       nc: Netconn handle
+ */
+static void
+netconn_listen_stop(lwcell_netconn_t* nc) {
+    lwcell_core_lock();
+    if (listen_api != nc) {
+        lwcell_core_unlock();
+        return;
+    }
+    listen_api = NULL; /* Connections accepted from now on are closed */
+    lwcell_core_unlock();
+    lwcell_set_server(0, nc->listen_port, NULL, NULL, NULL, 1);
+}
+
 /**
  * \brief           Global event callback function
  * \param[in]       evt: Callback information and data
@@ -196,6 +423,20 @@ netconn_evt(lwcell_evt_t* evt) {
 static lwcellr_t
 lwcell_evt(lwcell_evt_t* evt) {
     switch (lwcell_evt_get_type(evt)) {
+        /* Server is not active after device reset, notify thread waiting in accept */
+        case LWCELL_EVT_RESET: {
+            if (listen_api != NULL) {
+                if (lwcell_sys_mbox_isvalid(&listen_api->mbox_accept)
+                    && lwcell_sys_mbox_putnow(&listen_api->mbox_accept, (void*)&recv_closed)) {
+#if LWCELL_CFG_NETCONN_POLL
+                    ++listen_api->accept_queued;
+                    netconn_poll_notify(listen_api);
+#endif /* LWCELL_CFG_NETCONN_POLL */
+                }
+                listen_api = NULL;
+            }
+            break;
+        }
         default: break;
     }
     return lwcellOK;
@@ -215,7 +456,8 @@ lwcell_netconn_new(lwcell_netconn_type_t type) {
     lwcell_core_lock();
     if (first) {
         first = 0;
-        lwcell_evt_register(lwcell_evt); /* Register global event function */
+        /* Only reset event is used, always called directly */
+        lwcelli_evt_register(lwcell_evt, LWCELL_EVT_MASK(LWCELL_EVT_RESET), 0);
     }
     lwcell_core_unlock();
     a = lwcell_mem_calloc(1, sizeof(*a)); /* Allocate memory for core object */
@@ -259,8 +501,16 @@ lwcellr_t
 lwcell_netconn_delete(lwcell_netconn_p nc) {
     LWCELL_ASSERT(nc != NULL);
 
+    netconn_listen_stop(nc); /* Stop listening on netconn */
+
     lwcell_core_lock();
     flush_mboxes(nc, 0); /* Clear mboxes */
+    if (nc->wr_tmo != 0) {
+        lwcell_timeout_cancel(nc->wr_tmo); /* Stop automatic flush */
+    }
+    if (nc->buff.buff != NULL) {
+        lwcell_mem_free_s((void**)&nc->buff.buff); /* Free data not sent */
+    }
 
     /* Remove netconn from linkedlist */
     if (netconn_list == nc) {
@@ -307,6 +557,213 @@ lwcell_netconn_connect(lwcell_netconn_p nc, const char* host, lwcell_port_t port
     return res;
 }
 
+/**
+ * \brief           Bind a connection to specific port, can be only used for server connections
+ * \note            Device listens on all its addresses, only port is used
+ * \param[in]       nc: Netconn handle
+ * \param[in]       port: Port used to bind a connection to
+ * \return          \ref lwcellOK on success, member of \ref lwcellr_t enumeration otherwise
+ */
+lwcellr_t
+lwcell_netconn_bind(lwcell_netconn_p nc, lwcell_port_t port) {
+    LWCELL_ASSERT(nc != NULL);
+    LWCELL_ASSERT(port > 0);
+
+    nc->listen_port = port;
+    return lwcellOK;
+}
+
+/**
+ * \brief           Set timeout value in units of seconds when connection is in listening mode
+ *                  If new connection is accepted, it will be automatically closed after `seconds` elapsed
+ *                  without any data exchange.
+ * \note            Call this function before you put connection to listen mode with \ref lwcell_netconn_listen
+ * \param[in]       nc: Netconn handle used for listen mode
+ * \param[in]       timeout: Time in units of seconds. Set to `0` to disable timeout feature
+ * \return          \ref lwcellOK on success, member of \ref lwcellr_t otherwise
+ */
+lwcellr_t
+lwcell_netconn_set_listen_conn_timeout(lwcell_netconn_p nc, uint16_t timeout) {
+    LWCELL_ASSERT(nc != NULL);
+
+    nc->conn_timeout = timeout;
+    return lwcellOK;
+}
+
+/**
+ * \brief           Listen on previously binded connection
+ *
+ * Device supports single server, only one netconn may be in listening mode at a time.
+ * Incoming connections are kept in accept queue of \ref LWCELL_CFG_NETCONN_ACCEPT_QUEUE_LEN entries,
+ * connections not fitting into the queue are closed.
+ *
+ * \param[in]       nc: Netconn handle used to listen for new connections
+ * \return          \ref lwcellOK on success, member of \ref lwcellr_t enumeration otherwise
+ */
+lwcellr_t
+lwcell_netconn_listen(lwcell_netconn_p nc) {
+    lwcellr_t res;
+
+    LWCELL_ASSERT(nc != NULL);
+    LWCELL_ASSERT(nc->type == LWCELL_NETCONN_TYPE_TCP);
+    LWCELL_ASSERT(nc->listen_port > 0);
+
+    if (!lwcell_sys_mbox_isvalid(&nc->mbox_accept)
+        && !lwcell_sys_mbox_create(&nc->mbox_accept, LWCELL_CFG_NETCONN_ACCEPT_QUEUE_LEN)) {
+        LWCELL_DEBUGF(LWCELL_CFG_DBG_NETCONN | LWCELL_DBG_TYPE_TRACE | LWCELL_DBG_LVL_DANGER,
+                      "[LWCELL NETCONN] Cannot create accept MBOX\r\n");
+        return lwcellERRMEM;
+    }
+
+    lwcell_core_lock();
+    if (listen_api != NULL) {
+        lwcell_core_unlock();
+        return lwcellERR; /* Another netconn is already listening */
+    }
+    listen_api = nc;      /* Set before server starts, to queue first connection too */
+    lwcell_core_unlock();
+
+    if ((res = lwcell_set_server(1, nc->listen_port, netconn_evt, NULL, NULL, 1)) != lwcellOK) {
+        lwcell_core_lock();
+        listen_api = NULL;
+        lwcell_core_unlock();
+    }
+    return res;
+}
+
+/**
+ * \brief           Accept a new connection
+ * \note            Receive timeout set with \ref lwcell_netconn_set_receive_timeout applies to accept too
+ * \param[in]       nc: Netconn handle used as base connection to accept new clients
+ * \param[out]      client: Pointer to netconn handle to save new connection to.
+ *                      Application must close and delete it when not used anymore
+ * \return          \ref lwcellOK on success,
+ * \return          \ref lwcellCLOSED when server was stopped by device reset,
+ * \return          \ref lwcellTIMEOUT when receive timeout occurs
+ * \return          Any other member of \ref lwcellr_t otherwise
+ */
+lwcellr_t
+lwcell_netconn_accept(lwcell_netconn_p nc, lwcell_netconn_p* client) {
+    lwcell_netconn_t* tmp = NULL;
+
+    LWCELL_ASSERT(nc != NULL);
+    LWCELL_ASSERT(client != NULL);
+    LWCELL_ASSERT(lwcell_sys_mbox_isvalid(&nc->mbox_accept));
+
+    *client = NULL;
+#if LWCELL_CFG_NETCONN_RECEIVE_TIMEOUT
+    if (nc->rcv_timeout == LWCELL_NETCONN_RECEIVE_NO_WAIT) {
+        if (!lwcell_sys_mbox_getnow(&nc->mbox_accept, (void**)&tmp)) {
+            return lwcellTIMEOUT;
+        }
+    } else if (lwcell_sys_mbox_get(&nc->mbox_accept, (void**)&tmp, nc->rcv_timeout) == LWCELL_SYS_TIMEOUT) {
+        return lwcellTIMEOUT;
+    }
+#else  /* LWCELL_CFG_NETCONN_RECEIVE_TIMEOUT */
+    lwcell_sys_mbox_get(&nc->mbox_accept, (void**)&tmp, 0);
+#endif /* !LWCELL_CFG_NETCONN_RECEIVE_TIMEOUT */
+#if LWCELL_CFG_NETCONN_POLL
+    lwcell_core_lock();
+    if (nc->accept_queued > 0) {
+        --nc->accept_queued;
+    }
+    lwcell_core_unlock();
+#endif /* LWCELL_CFG_NETCONN_POLL */
+
+    /* Server has been stopped by device reset */
+    if ((uint8_t*)tmp == (uint8_t*)&recv_closed) {
+        return lwcellCLOSED;
+    }
+    *client = tmp;
+    return lwcellOK;
+}
+
+/**
+ * \brief           Automatic flush timeout callback of write buffer
+ * \note            Function is called from processing thread with core locked
+ * \param[in]       arg: Netconn handle
+ */
+static void
+netconn_autoflush_fn(void* arg) {
+    lwcell_netconn_t* nc = arg;
+
+    nc->wr_tmo = 0;
+    if (nc->buff.buff != NULL) {
+        /* Data are copied to connection write buffer and sent in non-blocking way */
+        if (nc->buff.ptr > 0 && nc->conn != NULL && lwcell_conn_is_active(nc->conn)) {
+            lwcellr_t res = lwcell_conn_write(nc->conn, nc->buff.buff, nc->buff.ptr, 1, NULL);
+
+            if (res != lwcellOK) {
+                LWCELL_DEBUGF(LWCELL_CFG_DBG_NETCONN | LWCELL_DBG_TYPE_TRACE | LWCELL_DBG_LVL_WARNING,
+                              "[LWCELL NETCONN] Automatic flush failed: %d\r\n", (int)res);
+                nc->wr_err = res; /* Data are lost, report it to application */
+            }
+        }
+        lwcell_mem_free_s((void**)&nc->buff.buff);
+        nc->buff.ptr = 0;
+    }
+}
+
+/**
+ * \brief           Get and clear error of automatic flush
+ * \note            Function must be called with core locked
+ * \param[in]       nc: Netconn handle
+ * \return          \ref lwcellOK if there was no error since last call, member of \ref lwcellr_t enumeration otherwise
+ */
+static lwcellr_t
+netconn_write_err_take(lwcell_netconn_t* nc) {
+    lwcellr_t res = nc->wr_err;
+
+    nc->wr_err = lwcellOK;
+    return res;
+}
+
+/**
+ * \brief           Take write buffer from netconn and stop automatic flush
+ * \note            Function must be called with core locked
+ * \param[in]       nc: Netconn handle
+ * \param[out]      len: Pointer to output variable to save number of bytes in buffer
+ * \return          Buffer owned by caller from now on, `NULL` if there is no buffer
+ */
+static uint8_t*
+netconn_write_buff_take(lwcell_netconn_t* nc, size_t* len) {
+    uint8_t* buff = nc->buff.buff;
+
+    if (nc->wr_tmo != 0) {
+        lwcell_timeout_cancel(nc->wr_tmo);
+        nc->wr_tmo = 0;
+    }
+    *len = nc->buff.ptr;
+    nc->buff.buff = NULL;
+    nc->buff.ptr = 0;
+    return buff;
+}
+
+/**
+ * \brief           Send write buffer immediately when threshold is reached
+ *                  or start automatic flush timeout otherwise
+ * \note            Function must be called with core locked
+ * \param[in]       nc: Netconn handle
+ * \param[out]      len: Pointer to output variable to save number of bytes in returned buffer
+ * \return          Buffer to be sent and freed by caller, `NULL` if data stay in netconn
+ */
+static uint8_t*
+netconn_write_buff_check(lwcell_netconn_t* nc, size_t* len) {
+    if (nc->buff.buff == NULL) {
+        return NULL;
+    }
+    if (nc->buff.ptr == nc->buff.len || (nc->wr_threshold > 0 && nc->buff.ptr >= nc->wr_threshold)) {
+        return netconn_write_buff_take(nc, len);
+    }
+    if (nc->wr_delay > 0 && nc->wr_tmo == 0 && nc->buff.ptr > 0) {
+        /* Delay starts with first buffered byte and is not extended by next writes */
+        if (lwcell_timeout_add_ex(nc->wr_delay, netconn_autoflush_fn, nc, &nc->wr_tmo) != lwcellOK) {
+            return netconn_write_buff_take(nc, len); /* Data would never be flushed, send them now */
+        }
+    }
+    return NULL;
+}
+
 /**
  * \brief           Write data to connection output buffers
  * \note            This function may only be used on TCP or SSL connections
@@ -319,23 +776,34 @@ lwcellr_t
 lwcell_netconn_write(lwcell_netconn_p nc, const void* data, size_t btw) {
     size_t len, sent;
     const uint8_t* d = data;
+    uint8_t* buff;
     lwcellr_t res;
 
     LWCELL_ASSERT(nc != NULL);
-    LWCELL_ASSERT(nc->type == LWCELL_NETCONN_TYPE_TCP || nc->type == LWCELL_NETCONN_TYPE_SSL);
+    LWCELL_ASSERT(nc->type == LWCELL_NETCONN_TYPE_TCP || nc->type == LWCELL_NETCONN_TYPE_SSL
+                  || nc->type == LWCELL_NETCONN_TYPE_TCP_TRANSPARENT);
     LWCELL_ASSERT(lwcell_conn_is_active(nc->conn));
 
     /*
      * Several steps are done in write process
      *
      * 1. Check if buffer is set and check if there is something to write to it.
-     *    1. In case buffer will be full after copy, send it and free memory.
+     *    1. In case buffer will be full after copy or threshold is reached, send it and free memory.
      * 2. Check how many bytes we can write directly without need to copy
      * 3. Try to allocate a new buffer and copy remaining input data to it
      * 4. In case buffer allocation fails, send data directly (may affect on speed and effectivenes)
+     *
+     * Buffer may be flushed by timeout from processing thread,
+     * it is therefore only accessed with core locked and sent after it has been taken from netconn.
+     * Data of failed automatic flush are lost, error is returned here before new data are accepted
      */
 
     /* Step 1 */
+    lwcell_core_lock();
+    if ((res = netconn_write_err_take(nc)) != lwcellOK) {
+        lwcell_core_unlock();
+        return res;
+    }
     if (nc->buff.buff != NULL) {                           /* Is there a write buffer ready to accept more data? */
         len = LWCELL_MIN(nc->buff.len - nc->buff.ptr, btw); /* Get number of bytes we can write to buffer */
         if (len > 0) {
@@ -346,16 +814,20 @@ lwcell_netconn_write(lwcell_netconn_p nc, const void* data, size_t btw) {
         }
 
         /* Step 1.1 */
-        if (nc->buff.ptr == nc->buff.len) {
-            res = lwcell_conn_send(nc->conn, nc->buff.buff, nc->buff.len, &sent, 1);
+        if ((buff = netconn_write_buff_check(nc, &len)) != NULL) {
+            lwcell_core_unlock();
+            res = lwcell_conn_send(nc->conn, buff, len, &sent, 1);
 
-            lwcell_mem_free_s((void**)&nc->buff.buff);
+            lwcell_mem_free_s((void**)&buff);
             if (res != lwcellOK) {
                 return res;
             }
         } else {
+            lwcell_core_unlock();
             return lwcellOK; /* Buffer is not yet full yet */
         }
+    } else {
+        lwcell_core_unlock();
     }
 
     /* Step 2 */
@@ -375,17 +847,27 @@ lwcell_netconn_write(lwcell_netconn_p nc, const void* data, size_t btw) {
     }
 
     /* Step 3 */
+    lwcell_core_lock();
     if (nc->buff.buff == NULL) {                    /* Check if we should allocate a new buffer */
-        nc->buff.buff = lwcell_mem_malloc(sizeof(*nc->buff.buff) * LWCELL_CFG_CONN_MAX_DATA_LEN);
+        nc->buff.buff =
+            lwcell_mem_malloc_tag(sizeof(*nc->buff.buff) * LWCELL_CFG_CONN_MAX_DATA_LEN, LWCELL_MEM_TAG_CONN);
         nc->buff.len = LWCELL_CFG_CONN_MAX_DATA_LEN; /* Save buffer length */
         nc->buff.ptr = 0;                           /* Save buffer pointer */
     }
 
     /* Step 4 */
-    if (nc->buff.buff != NULL) {                              /* Memory available? */
-        LWCELL_MEMCPY(&nc->buff.buff[nc->buff.ptr], d, btw);   /* Copy data to buffer */
+    if (nc->buff.buff != NULL) {                            /* Memory available? */
+        LWCELL_MEMCPY(&nc->buff.buff[nc->buff.ptr], d, btw); /* Copy data to buffer */
         nc->buff.ptr += btw;
+        buff = netconn_write_buff_check(nc, &len);
+        lwcell_core_unlock();
+        if (buff != NULL) {
+            res = lwcell_conn_send(nc->conn, buff, len, NULL, 1);
+            lwcell_mem_free_s((void**)&buff);
+            return res;
+        }
     } else {                                                  /* Still no memory available? */
+        lwcell_core_unlock();
         return lwcell_conn_send(nc->conn, data, btw, NULL, 1); /* Simply send directly blocking */
     }
     return lwcellOK;
@@ -423,20 +905,58 @@ lwcell_netconn_write_ex(lwcell_netconn_p nc, const void* data, size_t btw, uint1
  */
 lwcellr_t
 lwcell_netconn_flush(lwcell_netconn_p nc) {
+    uint8_t* buff;
+    size_t len;
+    lwcellr_t res;
+
     LWCELL_ASSERT(nc != NULL);
-    LWCELL_ASSERT(nc->type == LWCELL_NETCONN_TYPE_TCP || nc->type == LWCELL_NETCONN_TYPE_SSL);
+    LWCELL_ASSERT(nc->type == LWCELL_NETCONN_TYPE_TCP || nc->type == LWCELL_NETCONN_TYPE_SSL
+                  || nc->type == LWCELL_NETCONN_TYPE_TCP_TRANSPARENT);
     LWCELL_ASSERT(lwcell_conn_is_active(nc->conn));
 
     /*
      * In case we have data in write buffer,
      * flush them out to network
      */
-    if (nc->buff.buff != NULL) {                                             /* Check remaining data */
-        if (nc->buff.ptr > 0) {                                              /* Do we have data in current buffer? */
-            lwcell_conn_send(nc->conn, nc->buff.buff, nc->buff.ptr, NULL, 1); /* Send data */
+    lwcell_core_lock();
+    res = netconn_write_err_take(nc); /* Report data lost by automatic flush */
+    buff = netconn_write_buff_take(nc, &len);
+    lwcell_core_unlock();
+    if (buff != NULL) {                                 /* Check remaining data */
+        if (len > 0) {                                  /* Do we have data in current buffer? */
+            lwcell_conn_send(nc->conn, buff, len, NULL, 1); /* Send data */
         }
-        lwcell_mem_free_s((void**)&nc->buff.buff);
+        lwcell_mem_free_s((void**)&buff);
     }
+    return res;
+}
+
+/**
+ * \brief           Set automatic flush of buffered write data
+ *
+ * Data written with \ref lwcell_netconn_write are buffered until buffer is full
+ * or until \ref lwcell_netconn_flush is called. With automatic flush enabled,
+ * partially filled buffer is sent `delay` milliseconds after first byte has been written to it,
+ * or immediately when `threshold` bytes are buffered.
+ * Use \ref LWCELL_NETCONN_FLAG_FLUSH with \ref lwcell_netconn_write_ex to send data without delay.
+ * If automatic flush fails, error is returned by next call to \ref lwcell_netconn_write or \ref lwcell_netconn_flush.
+ *
+ * \note            This function may only be used on TCP or SSL connections
+ * \param[in]       nc: Netconn handle
+ * \param[in]       delay: Maximal time data stay in write buffer in units of milliseconds.
+ *                      Set to `0` to disable automatic flush
+ * \param[in]       threshold: Number of buffered bytes to send without waiting for timeout.
+ *                      Set to `0` to only send when write buffer is full
+ * \return          \ref lwcellOK on success, member of \ref lwcellr_t otherwise
+ */
+lwcellr_t
+lwcell_netconn_set_autoflush(lwcell_netconn_p nc, uint32_t delay, size_t threshold) {
+    LWCELL_ASSERT(nc != NULL);
+
+    lwcell_core_lock();
+    nc->wr_delay = delay;
+    nc->wr_threshold = threshold;
+    lwcell_core_unlock();
     return lwcellOK;
 }
 
@@ -475,8 +995,100 @@ lwcell_netconn_sendto(lwcell_netconn_p nc, const lwcell_ip_t* ip, lwcell_port_t
     return lwcell_conn_sendto(nc->conn, ip, port, data, btw, NULL, 1);
 }
 
+/**
+ * \brief           Get next received packet from receive mbox
+ * \param[in]       nc: Netconn handle used to receive from
+ * \param[out]      pbuf: Pointer to pointer to save new receive buffer to
+ * \param[in]       timeout: Maximal time to wait in units of milliseconds.
+ *                      Use `0` to wait forever or \ref LWCELL_NETCONN_RECEIVE_NO_WAIT to not wait at all
+ * \return          \ref lwcellOK when new data ready,
+ * \return          \ref lwcellCLOSED when connection closed by remote side,
+ * \return          \ref lwcellTIMEOUT when receive timeout occurs
+ */
+static lwcellr_t
+netconn_recv_pbuf(lwcell_netconn_t* nc, lwcell_pbuf_p* pbuf, uint32_t timeout) {
+    *pbuf = NULL;
+    if (timeout == LWCELL_NETCONN_RECEIVE_NO_WAIT) {
+        if (!lwcell_sys_mbox_getnow(&nc->mbox_receive, (void**)pbuf)) {
+            return lwcellTIMEOUT;
+        }
+    } else if (lwcell_sys_mbox_get(&nc->mbox_receive, (void**)pbuf, timeout) == LWCELL_SYS_TIMEOUT) {
+        return lwcellTIMEOUT;
+    }
+
+#if LWCELL_CFG_NETCONN_POLL
+    lwcell_core_lock();
+    if (nc->rcv_queued > 0) {
+        --nc->rcv_queued;
+    }
+    lwcell_core_unlock();
+#endif /* LWCELL_CFG_NETCONN_POLL */
+
+    /* Check if connection closed */
+    if ((uint8_t*)(*pbuf) == (uint8_t*)&recv_closed) {
+        *pbuf = NULL; /* Reset pbuf */
+        return lwcellCLOSED;
+    }
+#if LWCELL_CFG_CONN_MANUAL_RX
+    if (nc->conn != NULL) {
+        lwcell_conn_recved(nc->conn, *pbuf); /* Application took the data, stack may read more */
+    }
+#endif               /* LWCELL_CFG_CONN_MANUAL_RX */
+    return lwcellOK; /* We have data available */
+}
+
+/**
+ * \brief           Make sure partially consumed packet is available for reading
+ * \param[in]       nc: Netconn handle used to receive from
+ * \param[in]       timeout: Maximal time to wait for new packet in units of milliseconds.
+ *                      Use `0` to wait forever or \ref LWCELL_NETCONN_RECEIVE_NO_WAIT to not wait at all
+ * \return          \ref lwcellOK when at least one byte is available, member of \ref lwcellr_t otherwise
+ */
+static lwcellr_t
+netconn_recv_cursor(lwcell_netconn_t* nc, uint32_t timeout) {
+    lwcellr_t res;
+
+    while (nc->rcv_pbuf == NULL) {
+        if ((res = netconn_recv_pbuf(nc, &nc->rcv_pbuf, timeout)) != lwcellOK) {
+            return res;
+        }
+        if (lwcell_pbuf_length(nc->rcv_pbuf, 1) == 0) {
+            lwcell_pbuf_free_s(&nc->rcv_pbuf); /* Nothing to read in empty packet */
+        }
+    }
+    return lwcellOK;
+}
+
+/**
+ * \brief           Consume bytes from the beginning of partially read packet
+ *
+ * Payload of first pbuf is advanced, fully read pbufs in chain are freed
+ * and entire chain is freed once its last byte has been consumed.
+ *
+ * \param[in]       nc: Netconn handle with valid partially read packet
+ * \param[in]       len: Number of bytes to consume, must not exceed total length of packet
+ */
+static void
+netconn_recv_cursor_advance(lwcell_netconn_t* nc, size_t len) {
+    lwcell_pbuf_p next;
+
+    while (nc->rcv_pbuf != NULL && len > 0) {
+        size_t l = LWCELL_MIN(len, lwcell_pbuf_length(nc->rcv_pbuf, 0));
+
+        lwcell_pbuf_advance(nc->rcv_pbuf, (int)l);
+        len -= l;
+        if (lwcell_pbuf_length(nc->rcv_pbuf, 0) == 0) {
+            next = lwcell_pbuf_unchain(nc->rcv_pbuf); /* Chain reference to next pbuf is taken over */
+            lwcell_pbuf_free_s(&nc->rcv_pbuf);
+            nc->rcv_pbuf = next;
+        }
+    }
+}
+
 /**
  * \brief           Receive data from connection
+ * \note            Rest of packet partially read with \ref lwcell_netconn_recv_into
+ *                  or \ref lwcell_netconn_recv_peek is returned first
  * \param[in]       nc: Netconn handle used to receive from
  * \param[in]       pbuf: Pointer to pointer to save new receive buffer to.
  *                     When function returns, user must check for valid pbuf value `pbuf != NULL`
@@ -490,30 +1102,121 @@ lwcell_netconn_receive(lwcell_netconn_p nc, lwcell_pbuf_p* pbuf) {
     LWCELL_ASSERT(nc != NULL);
     LWCELL_ASSERT(pbuf != NULL);
 
-    *pbuf = NULL;
+    /* Partially read packet has priority */
+    if (nc->rcv_pbuf != NULL) {
+        *pbuf = nc->rcv_pbuf;
+        nc->rcv_pbuf = NULL;
+        return lwcellOK;
+    }
 #if LWCELL_CFG_NETCONN_RECEIVE_TIMEOUT
     /*
      * Wait for new received data for up to specific timeout
      * or throw error for timeout notification
      */
-    if (nc->rcv_timeout == LWCELL_NETCONN_RECEIVE_NO_WAIT) {
-        if (!lwcell_sys_mbox_getnow(&nc->mbox_receive, (void**)pbuf)) {
-            return lwcellTIMEOUT;
-        }
-    } else if (lwcell_sys_mbox_get(&nc->mbox_receive, (void**)pbuf, nc->rcv_timeout) == LWCELL_SYS_TIMEOUT) {
-        return lwcellTIMEOUT;
-    }
+    return netconn_recv_pbuf(nc, pbuf, nc->rcv_timeout);
 #else  /* LWCELL_CFG_NETCONN_RECEIVE_TIMEOUT */
     /* Forever wait for new receive packet */
-    lwcell_sys_mbox_get(&nc->mbox_receive, (void**)pbuf, 0);
+    return netconn_recv_pbuf(nc, pbuf, 0);
 #endif /* !LWCELL_CFG_NETCONN_RECEIVE_TIMEOUT */
+}
 
-    /* Check if connection closed */
-    if ((uint8_t*)(*pbuf) == (uint8_t*)&recv_closed) {
-        *pbuf = NULL; /* Reset pbuf */
-        return lwcellCLOSED;
+/**
+ * \brief           Receive exact number of bytes from connection to linear memory
+ *
+ * Function copies data across received packets and keeps unread part of last packet in netconn
+ * for next call, pbufs are freed as soon as all their data have been copied.
+ *
+ * \param[in]       nc: Netconn handle used to receive from
+ * \param[out]      data: Memory to copy received data to
+ * \param[in]       len: Number of bytes to receive
+ * \param[out]      br: Pointer to output variable to save number of bytes copied to. Can be set to `NULL`
+ * \param[in]       timeout: Maximal time to wait for all the data in units of milliseconds.
+ *                      Use `0` to wait forever or \ref LWCELL_NETCONN_RECEIVE_NO_WAIT to copy available data only
+ * \return          \ref lwcellOK when `len` bytes have been copied,
+ * \return          \ref lwcellCLOSED when connection closed by remote side before all data were received,
+ * \return          \ref lwcellTIMEOUT when timeout occurs before all data were received
+ * \return          Any other member of \ref lwcellr_t otherwise
+ */
+lwcellr_t
+lwcell_netconn_recv_into(lwcell_netconn_p nc, void* data, size_t len, size_t* br, uint32_t timeout) {
+    lwcellr_t res = lwcellOK;
+    uint8_t* d = data;
+    uint32_t start, tmo = timeout;
+    size_t copied = 0, l;
+
+    LWCELL_ASSERT(nc != NULL);
+    LWCELL_ASSERT(data != NULL);
+
+    start = lwcell_sys_now();
+    while (copied < len) {
+        if ((res = netconn_recv_cursor(nc, tmo)) != lwcellOK) {
+            break;
+        }
+        l = lwcell_pbuf_copy(nc->rcv_pbuf, &d[copied], len - copied, 0);
+        netconn_recv_cursor_advance(nc, l);
+        copied += l;
+
+        /* Remaining time for next packet */
+        if (timeout != 0 && timeout != LWCELL_NETCONN_RECEIVE_NO_WAIT) {
+            uint32_t elapsed = lwcell_sys_now() - start;
+            tmo = elapsed < timeout ? (timeout - elapsed) : LWCELL_NETCONN_RECEIVE_NO_WAIT;
+        }
     }
-    return lwcellOK; /* We have data available */
+    if (br != NULL) {
+        *br = copied;
+    }
+    return res;
+}
+
+/**
+ * \brief           Get linear memory of received data without copying or consuming it
+ *
+ * Returned memory belongs to current packet and stays valid until data are consumed
+ * with \ref lwcell_netconn_recv_consume, read by other receive function or netconn is closed.
+ * Since packet may be chained, returned length can be lower than available data,
+ * consume it to get next segment.
+ *
+ * \param[in]       nc: Netconn handle used to receive from
+ * \param[out]      data: Pointer to output variable to save pointer to received data to
+ * \param[out]      len: Pointer to output variable to save length of linear segment to
+ * \param[in]       timeout: Maximal time to wait for data in units of milliseconds.
+ *                      Use `0` to wait forever or \ref LWCELL_NETCONN_RECEIVE_NO_WAIT to not wait at all
+ * \return          \ref lwcellOK when data are available,
+ * \return          \ref lwcellCLOSED when connection closed by remote side,
+ * \return          \ref lwcellTIMEOUT when timeout occurs
+ * \return          Any other member of \ref lwcellr_t otherwise
+ */
+lwcellr_t
+lwcell_netconn_recv_peek(lwcell_netconn_p nc, const void** data, size_t* len, uint32_t timeout) {
+    lwcellr_t res;
+
+    LWCELL_ASSERT(nc != NULL);
+    LWCELL_ASSERT(data != NULL);
+    LWCELL_ASSERT(len != NULL);
+
+    *data = NULL;
+    *len = 0;
+    if ((res = netconn_recv_cursor(nc, timeout)) == lwcellOK) {
+        *data = lwcell_pbuf_get_linear_addr(nc->rcv_pbuf, 0, len);
+    }
+    return res;
+}
+
+/**
+ * \brief           Consume data previously returned by \ref lwcell_netconn_recv_peek
+ * \param[in]       nc: Netconn handle used to receive from
+ * \param[in]       len: Number of bytes to consume. It may span over multiple linear segments of current packet
+ * \return          \ref lwcellOK on success, \ref lwcellERRPAR when less than `len` bytes are available
+ */
+lwcellr_t
+lwcell_netconn_recv_consume(lwcell_netconn_p nc, size_t len) {
+    LWCELL_ASSERT(nc != NULL);
+
+    if (len > lwcell_pbuf_length(nc->rcv_pbuf, 1)) {
+        return lwcellERRPAR;
+    }
+    netconn_recv_cursor_advance(nc, len);
+    return lwcellOK;
 }
 
 /**
@@ -526,6 +1229,13 @@ lwcell_netconn_close(lwcell_netconn_p nc) {
     lwcell_conn_p conn;
 
     LWCELL_ASSERT(nc != NULL);
+
+    /* Listening netconn has no connection, stop server instead */
+    if (nc == listen_api) {
+        netconn_listen_stop(nc);
+        flush_mboxes(nc, 1);
+        return lwcellOK;
+    }
     LWCELL_ASSERT(nc->conn != NULL);
     LWCELL_ASSERT(lwcell_conn_is_active(nc->conn));
 
@@ -584,4 +1294,108 @@ lwcell_netconn_get_receive_timeout(lwcell_netconn_p nc) {
 
 #endif /* LWCELL_CFG_NETCONN_RECEIVE_TIMEOUT || __DOXYGEN__ */
 
+#if LWCELL_CFG_NETCONN_POLL || __DOXYGEN__
+
+/**
+ * \brief           Wait until at least one of netconns becomes ready
+ *
+ * Function lets single thread serve several connections.
+ * When it returns with \ref lwcellOK, \ref lwcell_netconn_receive does not block
+ * on entries with \ref LWCELL_NETCONN_POLL_READ state set.
+ *
+ * \code{c}
+lwcell_netconn_poll_t fds[2] = {{nc1, LWCELL_NETCONN_POLL_READ}, {nc2, LWCELL_NETCONN_POLL_READ}};
+
+while (lwcell_netconn_poll(fds, LWCELL_ARRAYSIZE(fds), NULL, 1000) != lwcellERRMEM) {
+    for (size_t i = 0; i < LWCELL_ARRAYSIZE(fds); ++i) {
+        if (fds[i].revents & LWCELL_NETCONN_POLL_READ) {
+            //Receive will not block here
+        }
+    }
+}
+\endcode
+ *
+ * \param[in,out]   fds: Array of netconns with requested states.
+ *                      Ready states are written to `revents` member of every entry.
+ *                      \ref LWCELL_NETCONN_POLL_CLOSED is reported even when not requested.
+ *                      Entries with `NULL` netconn are ignored
+ * \param[in]       fds_cnt: Number of entries in `fds` array
+ * \param[out]      ready_cnt: Pointer to output variable to save number of ready entries. Set to `NULL` if not used
+ * \param[in]       timeout: Maximal time to wait in units of milliseconds.
+ *                      Set to `0` to wait until any entry is ready.
+ *                      Set to \ref LWCELL_NETCONN_RECEIVE_NO_WAIT to only check current state
+ * \return          \ref lwcellOK when at least one entry is ready,
+ * \return          \ref lwcellTIMEOUT when no entry became ready in time,
+ * \return          Any other member of \ref lwcellr_t otherwise
+ */
+lwcellr_t
+lwcell_netconn_poll(lwcell_netconn_poll_t* fds, size_t fds_cnt, size_t* ready_cnt, uint32_t timeout) {
+    netconn_poll_waiter_t w = {0};
+    uint32_t waited;
+    size_t cnt;
+
+    LWCELL_ASSERT(fds != NULL);
+    LWCELL_ASSERT(fds_cnt > 0);
+
+    lwcell_core_lock();
+    cnt = netconn_poll_check(fds, fds_cnt);
+    if (cnt == 0 && timeout != LWCELL_NETCONN_RECEIVE_NO_WAIT) {
+        /* Reuse semaphore of previous poll, if available */
+        if (lwcell_sys_sem_isvalid(&poll_sem_spare)) {
+            w.sem = poll_sem_spare;
+            lwcell_sys_sem_invalid(&poll_sem_spare);
+        } else if (!lwcell_sys_sem_create(&w.sem, 0)) {
+            lwcell_core_unlock();
+            return lwcellERRMEM;
+        }
+        w.fds = fds;
+        w.fds_cnt = fds_cnt;
+        w.next = poll_waiters;
+        poll_waiters = &w;
+
+        /* Any state change is reported with semaphore release, core lock prevents lost wake-ups */
+        while (1) {
+            lwcell_core_unlock();
+            waited = lwcell_sys_sem_wait(&w.sem, timeout);
+            lwcell_core_lock();
+            if (waited != LWCELL_SYS_TIMEOUT) {
+                w.signaled = 0; /* Token has been taken */
+            }
+            if ((cnt = netconn_poll_check(fds, fds_cnt)) > 0 || waited == LWCELL_SYS_TIMEOUT) {
+                break;
+            }
+            if (timeout > 0) {
+                if (waited >= timeout) {
+                    break;
+                }
+                timeout -= waited;
+            }
+        }
+
+        /* Remove from list and keep semaphore for next call */
+        for (netconn_poll_waiter_t** pw = &poll_waiters; *pw != NULL; pw = &(*pw)->next) {
+            if (*pw == &w) {
+                *pw = w.next;
+                break;
+            }
+        }
+        if (w.signaled) {
+            lwcell_sys_sem_wait(&w.sem, 0); /* Take token released after last wake-up, call does not block */
+        }
+        if (!lwcell_sys_sem_isvalid(&poll_sem_spare)) {
+            poll_sem_spare = w.sem;
+        } else {
+            lwcell_sys_sem_delete(&w.sem);
+        }
+    }
+    lwcell_core_unlock();
+
+    if (ready_cnt != NULL) {
+        *ready_cnt = cnt;
+    }
+    return cnt > 0 ? lwcellOK : lwcellTIMEOUT;
+}
+
+#endif /* LWCELL_CFG_NETCONN_POLL || __DOXYGEN__ */
+
 #endif /* LWCELL_CFG_NETCONN || __DOXYGEN__ */
@@ -0,0 +1,755 @@
+/**
+ * \file            lwcell.hpp
+ * \brief           C++20 coroutine and RAII wrapper
+ */
+
+/*
+ * Copyright (c) 2023 Tilen MAJERLE
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without restriction,
+ * including without limitation the rights to use, copy, modify, merge,
+ * publish, distribute, sublicense, and/or sell copies of the Software,
+ * and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE
+ * AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * This file is part of LwCELL - Lightweight cellular modem AT library.
+ *
+ * Author:          Tilen MAJERLE <tilen@majerle.eu>
+ * Version:         v0.1.1
+ */
+#ifndef LWCELL_HDR_HPP
+#define LWCELL_HDR_HPP
+
+#include <atomic>
+#include <concepts>
+#include <coroutine>
+#include <cstddef>
+#include <cstdint>
+#include <exception>
+#include <iterator>
+#include <span>
+#include <type_traits>
+#include <utility>
+#include "lwcell/apps/lwcell_mqtt_client.h"
+#include "lwcell/apps/lwcell_mqtt_client_api.h"
+#include "lwcell/lwcell.h"
+#include "lwcell/lwcell_netconn.h"
+#include "lwcell/lwcell_pbuf.h"
+
+#if !LWCELL_CFG_USE_API_FUNC_EVT
+#error "LWCELL_CFG_USE_API_FUNC_EVT must be enabled for C++ coroutine wrapper!"
+#endif /* !LWCELL_CFG_USE_API_FUNC_EVT */
+
+/**
+ * \ingroup         LWCELL
+ * \defgroup        LWCELL_CPP C++ wrapper
+ * \brief           C++20 coroutine and RAII wrapper
+ *
+ * Commands are started in non-blocking mode and `co_await` suspends calling coroutine
+ * until command callback function is called. No thread is blocked while command is in progress.
+ *
+ * \note            Coroutine is resumed from producer thread with core locked, unless
+ *                  application sets its own dispatcher with \ref lwcell::set_resume_dispatcher.
+ *                  Only non-blocking API calls are allowed in this context
+ * \{
+ */
+
+namespace lwcell {
+
+/**
+ * \brief           Command result with output value
+ * \tparam          T: Type of output value
+ */
+template <typename T>
+struct result {
+    lwcellr_t res; /*!< Command result */
+    T value;       /*!< Output value, valid only when `res == lwcellOK` */
+
+    /**
+     * \brief           Check if command finished successfully
+     * \return          `true` on success, `false` otherwise
+     */
+    explicit
+    operator bool() const noexcept {
+        return res == lwcellOK;
+    }
+};
+
+/**
+ * \brief           Function to resume coroutine with, when set by application
+ */
+using resume_dispatcher_fn = void (*)(std::coroutine_handle<> handle);
+
+namespace detail {
+
+/**
+ * \brief           Get reference to current resume dispatcher
+ * \return          Reference to dispatcher, `nullptr` to resume directly from command callback
+ */
+inline std::atomic<resume_dispatcher_fn>&
+resume_dispatcher() noexcept {
+    static std::atomic<resume_dispatcher_fn> fn{nullptr};
+    return fn;
+}
+
+/**
+ * \brief           State of single command awaited by coroutine
+ *
+ * Command callback function may be called before or after coroutine has been suspended.
+ * Whichever of both happens last resumes the coroutine.
+ */
+class cmd_op {
+  public:
+    /**
+     * \brief           Start command and suspend coroutine
+     * \param[in]       handle: Handle of awaiting coroutine
+     * \param[in]       start: Function to start command with callback function and argument
+     * \return          `true` to suspend, `false` when command already finished or could not start
+     */
+    template <typename F>
+    bool
+    suspend(std::coroutine_handle<> handle, F& start) noexcept {
+        lwcellr_t r;
+
+        handle_ = handle;
+        if ((r = start(&cmd_op::evt_fn, static_cast<void*>(this))) != lwcellOK) {
+            res_ = r; /* Callback function is not called when command did not start */
+            return false;
+        }
+        return !done_.exchange(true, std::memory_order_acq_rel);
+    }
+
+    /**
+     * \brief           Get command result
+     * \return          Result received in command callback function
+     */
+    lwcellr_t
+    res() const noexcept {
+        return res_;
+    }
+
+  private:
+    /**
+     * \brief           Command callback function
+     * \param[in]       res: Command result
+     * \param[in]       arg: Pointer to \ref cmd_op object
+     */
+    static void
+    evt_fn(lwcellr_t res, void* arg) {
+        cmd_op* op = static_cast<cmd_op*>(arg);
+
+        op->res_ = res;
+        if (op->done_.exchange(true, std::memory_order_acq_rel)) {
+            resume_dispatcher_fn fn = resume_dispatcher().load(std::memory_order_acquire);
+            if (fn != nullptr) {
+                fn(op->handle_);
+            } else {
+                op->handle_.resume();
+            }
+        }
+    }
+
+    std::coroutine_handle<> handle_; /*!< Awaiting coroutine */
+    std::atomic<bool> done_{false};  /*!< Set by first of suspend and callback */
+    lwcellr_t res_{lwcellOK};        /*!< Command result */
+};
+
+} /* namespace detail */
+
+/**
+ * \brief           Set function to resume coroutines with after command finished
+ *
+ * By default, coroutine continues in producer thread. Dispatcher can instead
+ * post handle to application event loop, where blocking API calls are allowed again.
+ *
+ * \param[in]       fn: Dispatcher function, `nullptr` to resume directly
+ */
+inline void
+set_resume_dispatcher(resume_dispatcher_fn fn) noexcept {
+    detail::resume_dispatcher().store(fn, std::memory_order_release);
+}
+
+/**
+ * \brief           Awaitable command without output value
+ * \tparam          F: Function object `lwcellr_t(lwcell_api_cmd_evt_fn, void*)` starting command
+ *                      in non-blocking mode
+ */
+template <typename F>
+class cmd_awaiter {
+  public:
+    explicit cmd_awaiter(F start) : start_(std::move(start)) {}
+
+    bool
+    await_ready() const noexcept {
+        return false;
+    }
+
+    bool
+    await_suspend(std::coroutine_handle<> handle) noexcept {
+        return op_.suspend(handle, start_);
+    }
+
+    lwcellr_t
+    await_resume() const noexcept {
+        return op_.res();
+    }
+
+  private:
+    F start_;           /*!< Function to start command */
+    detail::cmd_op op_; /*!< Command state */
+};
+
+/**
+ * \brief           Awaitable command with output value stored in coroutine frame
+ * \tparam          T: Type of output value
+ * \tparam          F: Function object `lwcellr_t(T&, lwcell_api_cmd_evt_fn, void*)` starting command
+ *                      in non-blocking mode
+ */
+template <typename T, typename F>
+class cmd_result_awaiter {
+  public:
+    explicit cmd_result_awaiter(F start) : start_(std::move(start)) {}
+
+    bool
+    await_ready() const noexcept {
+        return false;
+    }
+
+    bool
+    await_suspend(std::coroutine_handle<> handle) noexcept {
+        auto start = [this](lwcell_api_cmd_evt_fn evt_fn, void* evt_arg) { return start_(value_, evt_fn, evt_arg); };
+        return op_.suspend(handle, start);
+    }
+
+    result<T>
+    await_resume() noexcept(std::is_nothrow_move_constructible_v<T>) {
+        return result<T>{op_.res(), std::move(value_)};
+    }
+
+  private:
+    F start_;           /*!< Function to start command */
+    T value_{};         /*!< Output value, written by command */
+    detail::cmd_op op_; /*!< Command state */
+};
+
+/**
+ * \brief           Await any API function with `evt_fn`, `evt_arg` and `blocking` as last parameters
+ *
+ * \code{.cpp}
+ * lwcellr_t res = co_await lwcell::cmd(lwcell_network_attach, "internet", "", "");
+ * res = co_await lwcell::cmd(lwcell_set_server, 1, 80, server_evt_fn);
+ * \endcode
+ *
+ * Parameters are copied to awaiter and must stay valid until command finished,
+ * which is always the case for local variables of suspended coroutine.
+ *
+ * \param[in]       fn: API function
+ * \param[in]       args: Parameters before `evt_fn`
+ * \return          Awaitable object, resulting in \ref lwcellr_t
+ */
+template <typename Fn, typename... Args>
+    requires std::invocable<Fn&, Args&..., lwcell_api_cmd_evt_fn, void*, uint32_t>
+auto
+cmd(Fn fn, Args... args) {
+    auto start = [fn, args...](lwcell_api_cmd_evt_fn evt_fn, void* evt_arg) mutable -> lwcellr_t {
+        return fn(args..., evt_fn, evt_arg, 0);
+    };
+    return cmd_awaiter<decltype(start)>(std::move(start));
+}
+
+/**
+ * \brief           Await command with output value
+ *
+ * \code{.cpp}
+ * auto rssi = co_await lwcell::cmd_result<int16_t>([](int16_t& out, lwcell_api_cmd_evt_fn fn, void* arg) {
+ *     return lwcell_network_rssi(&out, fn, arg, 0);
+ * });
+ * \endcode
+ *
+ * \tparam          T: Type of output value
+ * \param[in]       start: Function object `lwcellr_t(T&, lwcell_api_cmd_evt_fn, void*)`
+ * \return          Awaitable object, resulting in \ref result
+ */
+template <typename T, typename F>
+    requires std::invocable<F&, T&, lwcell_api_cmd_evt_fn, void*>
+auto
+cmd_result(F start) {
+    return cmd_result_awaiter<T, F>(std::move(start));
+}
+
+/**
+ * \brief           Await network RSSI query
+ * \return          Awaitable object, resulting in \ref result with RSSI in units of dBm
+ */
+inline auto
+network_rssi() {
+    return cmd_result<int16_t>([](int16_t& rssi, lwcell_api_cmd_evt_fn evt_fn, void* evt_arg) {
+        return lwcell_network_rssi(&rssi, evt_fn, evt_arg, 0);
+    });
+}
+
+/**
+ * \brief           Await device reset
+ * \return          Awaitable object, resulting in \ref lwcellr_t
+ */
+inline auto
+reset() {
+    return cmd(lwcell_reset);
+}
+
+/**
+ * \brief           Fire-and-forget coroutine type
+ *
+ * Coroutine starts immediately and frees its frame when it returns.
+ */
+struct detached {
+    struct promise_type {
+        detached
+        get_return_object() noexcept {
+            return {};
+        }
+
+        std::suspend_never
+        initial_suspend() noexcept {
+            return {};
+        }
+
+        std::suspend_never
+        final_suspend() noexcept {
+            return {};
+        }
+
+        void
+        return_void() noexcept {}
+
+        void
+        unhandled_exception() noexcept {
+            std::terminate();
+        }
+    };
+};
+
+/**
+ * \brief           Range of linear memory segments of pbuf chain
+ */
+class pbuf_segments {
+  public:
+    /**
+     * \brief           Forward iterator over segments
+     */
+    class iterator {
+      public:
+        using iterator_category = std::forward_iterator_tag;
+        using value_type = std::span<const uint8_t>;
+        using difference_type = std::ptrdiff_t;
+
+        iterator() noexcept = default;
+
+        iterator(lwcell_pbuf_p pbuf, size_t offset) noexcept : pbuf_(pbuf), offset_(offset) {}
+
+        value_type
+        operator*() const noexcept {
+            size_t len = 0;
+            const void* data = lwcell_pbuf_get_linear_addr(pbuf_, offset_, &len);
+            return value_type(static_cast<const uint8_t*>(data), data != nullptr ? len : 0);
+        }
+
+        iterator&
+        operator++() noexcept {
+            size_t len = 0;
+            lwcell_pbuf_get_linear_addr(pbuf_, offset_, &len);
+            offset_ += len > 0 ? len : lwcell_pbuf_length(pbuf_, 1) - offset_;
+            return *this;
+        }
+
+        iterator
+        operator++(int) noexcept {
+            iterator tmp = *this;
+            ++*this;
+            return tmp;
+        }
+
+        bool
+        operator==(const iterator& other) const noexcept {
+            return pbuf_ == other.pbuf_ && offset_ == other.offset_;
+        }
+
+        bool
+        operator==(std::default_sentinel_t) const noexcept {
+            return offset_ >= lwcell_pbuf_length(pbuf_, 1);
+        }
+
+      private:
+        lwcell_pbuf_p pbuf_{nullptr}; /*!< Head of pbuf chain */
+        size_t offset_{0};            /*!< Offset of current segment from beginning of chain */
+    };
+
+    explicit pbuf_segments(lwcell_pbuf_p pbuf) noexcept : pbuf_(pbuf) {}
+
+    iterator
+    begin() const noexcept {
+        return iterator(pbuf_, 0);
+    }
+
+    std::default_sentinel_t
+    end() const noexcept {
+        return {};
+    }
+
+  private:
+    lwcell_pbuf_p pbuf_; /*!< Head of pbuf chain */
+};
+
+/**
+ * \brief           Owning packet buffer handle
+ */
+class pbuf {
+  public:
+    pbuf() noexcept = default;
+
+    /**
+     * \brief           Take ownership of pbuf
+     * \param[in]       p: Packet buffer, freed when object is destroyed
+     */
+    explicit pbuf(lwcell_pbuf_p p) noexcept : p_(p) {}
+
+    pbuf(pbuf&& other) noexcept : p_(std::exchange(other.p_, nullptr)) {}
+
+    pbuf&
+    operator=(pbuf&& other) noexcept {
+        if (this != &other) {
+            reset(std::exchange(other.p_, nullptr));
+        }
+        return *this;
+    }
+
+    pbuf(const pbuf&) = delete;
+    pbuf& operator=(const pbuf&) = delete;
+
+    ~pbuf() {
+        reset();
+    }
+
+    /**
+     * \brief           Free current pbuf and take ownership of new one
+     * \param[in]       p: New packet buffer or `nullptr`
+     */
+    void
+    reset(lwcell_pbuf_p p = nullptr) noexcept {
+        if (p_ != nullptr) {
+            lwcell_pbuf_free_s(&p_);
+        }
+        p_ = p;
+    }
+
+    /**
+     * \brief           Release ownership of pbuf
+     * \return          Packet buffer, application is responsible to free it
+     */
+    lwcell_pbuf_p
+    release() noexcept {
+        return std::exchange(p_, nullptr);
+    }
+
+    lwcell_pbuf_p
+    get() const noexcept {
+        return p_;
+    }
+
+    explicit
+    operator bool() const noexcept {
+        return p_ != nullptr;
+    }
+
+    /**
+     * \brief           Get total length of pbuf chain
+     * \return          Length in units of bytes
+     */
+    size_t
+    size() const noexcept {
+        return lwcell_pbuf_length(p_, 1);
+    }
+
+    /**
+     * \brief           Get linear memory segments of pbuf chain, without copying data
+     * \return          Range of `std::span<const uint8_t>` segments
+     */
+    pbuf_segments
+    segments() const noexcept {
+        return pbuf_segments(p_);
+    }
+
+  private:
+    lwcell_pbuf_p p_{nullptr}; /*!< Owned packet buffer */
+};
+
+#if LWCELL_CFG_NETCONN || __DOXYGEN__
+
+/**
+ * \brief           Owning netconn handle
+ *
+ * Connection is closed and netconn deleted when object is destroyed.
+ * Netconn API is sequential and must not be used from coroutine resumed in producer thread.
+ */
+class netconn {
+  public:
+    netconn() noexcept = default;
+
+    /**
+     * \brief           Create new netconn
+     * \param[in]       type: Netconn type
+     */
+    explicit netconn(lwcell_netconn_type_t type) noexcept : nc_(lwcell_netconn_new(type)) {}
+
+    /**
+     * \brief           Take ownership of netconn, such as one returned by accept
+     * \param[in]       nc: Netconn handle
+     */
+    explicit netconn(lwcell_netconn_p nc) noexcept : nc_(nc) {}
+
+    netconn(netconn&& other) noexcept : nc_(std::exchange(other.nc_, nullptr)) {}
+
+    netconn&
+    operator=(netconn&& other) noexcept {
+        if (this != &other) {
+            reset(std::exchange(other.nc_, nullptr));
+        }
+        return *this;
+    }
+
+    netconn(const netconn&) = delete;
+    netconn& operator=(const netconn&) = delete;
+
+    ~netconn() {
+        reset();
+    }
+
+    /**
+     * \brief           Close and delete current netconn and take ownership of new one
+     * \param[in]       nc: New netconn handle or `nullptr`
+     */
+    void
+    reset(lwcell_netconn_p nc = nullptr) noexcept {
+        if (nc_ != nullptr) {
+            if (lwcell_netconn_getconnnum(nc_) >= 0) {
+                lwcell_netconn_close(nc_); /* Fails without effect when already closed by remote side */
+            }
+            lwcell_netconn_delete(nc_);
+        }
+        nc_ = nc;
+    }
+
+    lwcell_netconn_p
+    get() const noexcept {
+        return nc_;
+    }
+
+    explicit
+    operator bool() const noexcept {
+        return nc_ != nullptr;
+    }
+
+    lwcellr_t
+    connect(const char* host, lwcell_port_t port) noexcept {
+        return lwcell_netconn_connect(nc_, host, port);
+    }
+
+    lwcellr_t
+    write(std::span<const uint8_t> data, uint16_t flags = 0) noexcept {
+        return lwcell_netconn_write_ex(nc_, data.data(), data.size(), flags);
+    }
+
+    lwcellr_t
+    flush() noexcept {
+        return lwcell_netconn_flush(nc_);
+    }
+
+    lwcellr_t
+    close() noexcept {
+        return lwcell_netconn_close(nc_);
+    }
+
+    /**
+     * \brief           Receive next packet
+     * \return          \ref result with owned pbuf
+     */
+    result<pbuf>
+    receive() noexcept {
+        lwcell_pbuf_p p = nullptr;
+        lwcellr_t res = lwcell_netconn_receive(nc_, &p);
+        return result<pbuf>{res, pbuf(p)};
+    }
+
+    /**
+     * \brief           Receive exact number of bytes
+     * \param[out]      data: Memory to fill
+     * \param[in]       timeout: Timeout in units of milliseconds, see \ref lwcell_netconn_recv_into
+     * \return          \ref result with number of bytes copied
+     */
+    result<size_t>
+    recv_into(std::span<uint8_t> data, uint32_t timeout = 0) noexcept {
+        size_t br = 0;
+        lwcellr_t res = lwcell_netconn_recv_into(nc_, data.data(), data.size(), &br, timeout);
+        return result<size_t>{res, br};
+    }
+
+    /**
+     * \brief           Accept new connection on listening netconn
+     * \return          \ref result with owned client netconn
+     */
+    result<netconn>
+    accept() noexcept {
+        lwcell_netconn_p client = nullptr;
+        lwcellr_t res = lwcell_netconn_accept(nc_, &client);
+        return result<netconn>{res, netconn(client)};
+    }
+
+  private:
+    lwcell_netconn_p nc_{nullptr}; /*!< Owned netconn */
+};
+
+#endif /* LWCELL_CFG_NETCONN || __DOXYGEN__ */
+
+/**
+ * \brief           Owning MQTT client handle
+ */
+class mqtt_client {
+  public:
+    mqtt_client() noexcept = default;
+
+    /**
+     * \brief           Create new MQTT client
+     * \param[in]       tx_buff_len: Length of raw data output buffer
+     * \param[in]       rx_buff_len: Length of raw data input buffer
+     */
+    mqtt_client(size_t tx_buff_len, size_t rx_buff_len) noexcept
+        : c_(lwcell_mqtt_client_new(tx_buff_len, rx_buff_len)) {}
+
+    mqtt_client(mqtt_client&& other) noexcept : c_(std::exchange(other.c_, nullptr)) {}
+
+    mqtt_client&
+    operator=(mqtt_client&& other) noexcept {
+        if (this != &other) {
+            reset(std::exchange(other.c_, nullptr));
+        }
+        return *this;
+    }
+
+    mqtt_client(const mqtt_client&) = delete;
+    mqtt_client& operator=(const mqtt_client&) = delete;
+
+    ~mqtt_client() {
+        reset();
+    }
+
+    /**
+     * \brief           Delete current client and take ownership of new one
+     * \note            Client must be disconnected before it is deleted
+     * \param[in]       c: New client handle or `nullptr`
+     */
+    void
+    reset(lwcell_mqtt_client_p c = nullptr) noexcept {
+        if (c_ != nullptr) {
+            lwcell_mqtt_client_delete(c_);
+        }
+        c_ = c;
+    }
+
+    lwcell_mqtt_client_p
+    get() const noexcept {
+        return c_;
+    }
+
+    explicit
+    operator bool() const noexcept {
+        return c_ != nullptr;
+    }
+
+  private:
+    lwcell_mqtt_client_p c_{nullptr}; /*!< Owned client */
+};
+
+/**
+ * \brief           Owning sequential MQTT client API handle
+ *
+ * Connection is closed and client deleted when object is destroyed.
+ */
+class mqtt_client_api {
+  public:
+    mqtt_client_api() noexcept = default;
+
+    /**
+     * \brief           Create new MQTT client API
+     * \param[in]       tx_buff_len: Length of raw data output buffer
+     * \param[in]       rx_buff_len: Length of raw data input buffer
+     */
+    mqtt_client_api(size_t tx_buff_len, size_t rx_buff_len) noexcept
+        : c_(lwcell_mqtt_client_api_new(tx_buff_len, rx_buff_len)) {}
+
+    mqtt_client_api(mqtt_client_api&& other) noexcept : c_(std::exchange(other.c_, nullptr)) {}
+
+    mqtt_client_api&
+    operator=(mqtt_client_api&& other) noexcept {
+        if (this != &other) {
+            reset(std::exchange(other.c_, nullptr));
+        }
+        return *this;
+    }
+
+    mqtt_client_api(const mqtt_client_api&) = delete;
+    mqtt_client_api& operator=(const mqtt_client_api&) = delete;
+
+    ~mqtt_client_api() {
+        reset();
+    }
+
+    /**
+     * \brief           Close and delete current client and take ownership of new one
+     * \param[in]       c: New client handle or `nullptr`
+     */
+    void
+    reset(lwcell_mqtt_client_api_p c = nullptr) noexcept {
+        if (c_ != nullptr) {
+            if (lwcell_mqtt_client_api_is_connected(c_)) {
+                lwcell_mqtt_client_api_close(c_);
+            }
+            lwcell_mqtt_client_api_delete(c_);
+        }
+        c_ = c;
+    }
+
+    lwcell_mqtt_client_api_p
+    get() const noexcept {
+        return c_;
+    }
+
+    explicit
+    operator bool() const noexcept {
+        return c_ != nullptr;
+    }
+
+  private:
+    lwcell_mqtt_client_api_p c_{nullptr}; /*!< Owned client */
+};
+
+} /* namespace lwcell */
+
+/**
+ * \}
+ */
+
+#endif /* LWCELL_HDR_HPP */
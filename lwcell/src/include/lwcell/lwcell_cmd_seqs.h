@@ -0,0 +1,196 @@
+/**
+ * \file            lwcell_cmd_seqs.h
+ * \brief           AT command sequences
+ */
+
+/*
+ * Copyright (c) 2023 Tilen MAJERLE
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without restriction,
+ * including without limitation the rights to use, copy, modify, merge,
+ * publish, distribute, sublicense, and/or sell copies of the Software,
+ * and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE
+ * AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * This file is part of LwCELL - Lightweight cellular modem AT library.
+ *
+ * Author:          Tilen MAJERLE <tilen@majerle.eu>
+ * Version:         v0.1.1
+ */
+
+/*
+ * Multi-step command sequences, executed one step after another.
+ * Sequence is selected by default command of the message.
+ * API function may start the message with any step, to skip steps not needed for its parameters,
+ * execution continues with steps after the first one matching start command.
+ *
+ * Order: Step command; Step flags
+ *
+ * Use \ref LWCELL_CMD_STEP_F_CHECK_ERROR to execute step only
+ * if previous step did not finish with error.
+ * Use \ref LWCELL_CMD_STEP_F_RETRY to repeat step when it finishes with error.
+ */
+LWCELL_CMD_SEQ_BEGIN(LWCELL_CMD_RESET)
+LWCELL_CMD_SEQ_STEP(LWCELL_CMD_RESET, 0)
+LWCELL_CMD_SEQ_STEP(LWCELL_CFG_AT_ECHO ? LWCELL_CMD_ATE1 : LWCELL_CMD_ATE0, 0)
+LWCELL_CMD_SEQ_STEP(LWCELL_CMD_CFUN_SET, 0)
+LWCELL_CMD_SEQ_STEP(LWCELL_CMD_CMEE_SET, 0)
+LWCELL_CMD_SEQ_STEP(LWCELL_CMD_CGMI_GET, 0)
+LWCELL_CMD_SEQ_STEP(LWCELL_CMD_CGMM_GET, 0)
+LWCELL_CMD_SEQ_STEP(LWCELL_CMD_CGSN_GET, 0)
+LWCELL_CMD_SEQ_STEP(LWCELL_CMD_CGMR_GET, 0)
+LWCELL_CMD_SEQ_STEP(LWCELL_CMD_CREG_SET, 0)
+LWCELL_CMD_SEQ_STEP(LWCELL_CMD_CLCC_SET, 0)
+LWCELL_CMD_SEQ_STEP(LWCELL_CMD_CPIN_GET, 0)
+LWCELL_CMD_SEQ_END(LWCELL_CMD_RESET)
+
+/* Own number may not be available just after PIN has been entered */
+LWCELL_CMD_SEQ_BEGIN(LWCELL_CMD_SIM_PROCESS_BASIC_CMDS)
+LWCELL_CMD_SEQ_STEP(LWCELL_CMD_CNUM, LWCELL_CMD_STEP_F_RETRY)
+LWCELL_CMD_SEQ_END(LWCELL_CMD_SIM_PROCESS_BASIC_CMDS)
+
+#if LWCELL_CFG_SMS
+LWCELL_CMD_SEQ_BEGIN(LWCELL_CMD_SMS_ENABLE)
+LWCELL_CMD_SEQ_STEP(LWCELL_CMD_CPMS_GET_OPT, 0)
+LWCELL_CMD_SEQ_STEP(LWCELL_CMD_CPMS_GET, LWCELL_CMD_STEP_F_CHECK_ERROR)
+LWCELL_CMD_SEQ_END(LWCELL_CMD_SMS_ENABLE)
+
+LWCELL_CMD_SEQ_BEGIN(LWCELL_CMD_CMGS)
+LWCELL_CMD_SEQ_STEP(LWCELL_CMD_CMGF, 0)
+LWCELL_CMD_SEQ_STEP(LWCELL_CMD_CMGS, LWCELL_CMD_STEP_F_CHECK_ERROR)
+LWCELL_CMD_SEQ_END(LWCELL_CMD_CMGS)
+
+LWCELL_CMD_SEQ_BEGIN(LWCELL_CMD_CMGR)
+LWCELL_CMD_SEQ_STEP(LWCELL_CMD_CPMS_GET, 0)
+LWCELL_CMD_SEQ_STEP(LWCELL_CMD_CPMS_SET, LWCELL_CMD_STEP_F_CHECK_ERROR)
+LWCELL_CMD_SEQ_STEP(LWCELL_CMD_CMGF, LWCELL_CMD_STEP_F_CHECK_ERROR)
+LWCELL_CMD_SEQ_STEP(LWCELL_CMD_CMGR, LWCELL_CMD_STEP_F_CHECK_ERROR)
+LWCELL_CMD_SEQ_END(LWCELL_CMD_CMGR)
+
+LWCELL_CMD_SEQ_BEGIN(LWCELL_CMD_CMGD)
+LWCELL_CMD_SEQ_STEP(LWCELL_CMD_CPMS_GET, 0)
+LWCELL_CMD_SEQ_STEP(LWCELL_CMD_CPMS_SET, LWCELL_CMD_STEP_F_CHECK_ERROR)
+LWCELL_CMD_SEQ_STEP(LWCELL_CMD_CMGD, LWCELL_CMD_STEP_F_CHECK_ERROR)
+LWCELL_CMD_SEQ_END(LWCELL_CMD_CMGD)
+
+LWCELL_CMD_SEQ_BEGIN(LWCELL_CMD_CMGDA)
+LWCELL_CMD_SEQ_STEP(LWCELL_CMD_CMGF, 0)
+LWCELL_CMD_SEQ_STEP(LWCELL_CMD_CMGDA, LWCELL_CMD_STEP_F_CHECK_ERROR)
+LWCELL_CMD_SEQ_END(LWCELL_CMD_CMGDA)
+
+LWCELL_CMD_SEQ_BEGIN(LWCELL_CMD_CMGL)
+LWCELL_CMD_SEQ_STEP(LWCELL_CMD_CPMS_GET, 0)
+LWCELL_CMD_SEQ_STEP(LWCELL_CMD_CPMS_SET, LWCELL_CMD_STEP_F_CHECK_ERROR)
+LWCELL_CMD_SEQ_STEP(LWCELL_CMD_CMGF, LWCELL_CMD_STEP_F_CHECK_ERROR)
+LWCELL_CMD_SEQ_STEP(LWCELL_CMD_CMGL, LWCELL_CMD_STEP_F_CHECK_ERROR)
+LWCELL_CMD_SEQ_END(LWCELL_CMD_CMGL)
+
+LWCELL_CMD_SEQ_BEGIN(LWCELL_CMD_CPMS_SET)
+LWCELL_CMD_SEQ_STEP(LWCELL_CMD_CPMS_GET, 0)
+LWCELL_CMD_SEQ_STEP(LWCELL_CMD_CPMS_SET, LWCELL_CMD_STEP_F_CHECK_ERROR)
+LWCELL_CMD_SEQ_END(LWCELL_CMD_CPMS_SET)
+#endif /* LWCELL_CFG_SMS */
+
+#if LWCELL_CFG_PHONEBOOK
+LWCELL_CMD_SEQ_BEGIN(LWCELL_CMD_CPBW_SET)
+LWCELL_CMD_SEQ_STEP(LWCELL_CMD_CPBS_GET, 0)
+LWCELL_CMD_SEQ_STEP(LWCELL_CMD_CPBS_SET, LWCELL_CMD_STEP_F_CHECK_ERROR)
+LWCELL_CMD_SEQ_STEP(LWCELL_CMD_CPBW_SET, LWCELL_CMD_STEP_F_CHECK_ERROR)
+LWCELL_CMD_SEQ_END(LWCELL_CMD_CPBW_SET)
+
+LWCELL_CMD_SEQ_BEGIN(LWCELL_CMD_CPBR)
+LWCELL_CMD_SEQ_STEP(LWCELL_CMD_CPBS_GET, 0)
+LWCELL_CMD_SEQ_STEP(LWCELL_CMD_CPBS_SET, LWCELL_CMD_STEP_F_CHECK_ERROR)
+LWCELL_CMD_SEQ_STEP(LWCELL_CMD_CPBR, LWCELL_CMD_STEP_F_CHECK_ERROR)
+LWCELL_CMD_SEQ_END(LWCELL_CMD_CPBR)
+
+LWCELL_CMD_SEQ_BEGIN(LWCELL_CMD_CPBF)
+LWCELL_CMD_SEQ_STEP(LWCELL_CMD_CPBS_GET, 0)
+LWCELL_CMD_SEQ_STEP(LWCELL_CMD_CPBS_SET, LWCELL_CMD_STEP_F_CHECK_ERROR)
+LWCELL_CMD_SEQ_STEP(LWCELL_CMD_CPBF, LWCELL_CMD_STEP_F_CHECK_ERROR)
+LWCELL_CMD_SEQ_END(LWCELL_CMD_CPBF)
+#endif /* LWCELL_CFG_PHONEBOOK */
+
+#if LWCELL_CFG_USSD
+LWCELL_CMD_SEQ_BEGIN(LWCELL_CMD_CUSD)
+LWCELL_CMD_SEQ_STEP(LWCELL_CMD_CUSD_GET, 0)
+LWCELL_CMD_SEQ_STEP(LWCELL_CMD_CUSD, LWCELL_CMD_STEP_F_CHECK_ERROR)
+LWCELL_CMD_SEQ_END(LWCELL_CMD_CUSD)
+#endif /* LWCELL_CFG_USSD */
+
+#if LWCELL_CFG_NETWORK
+LWCELL_CMD_SEQ_BEGIN(LWCELL_CMD_NETWORK_ATTACH)
+#if LWCELL_CFG_CONN
+LWCELL_CMD_SEQ_STEP(LWCELL_CMD_CIPSTATUS, 0)
+#else  /* LWCELL_CFG_CONN */
+LWCELL_CMD_SEQ_STEP(LWCELL_CMD_NETWORK_ATTACH, 0)
+#endif /* !LWCELL_CFG_CONN */
+LWCELL_CMD_SEQ_STEP(LWCELL_CMD_CGACT_SET_0, LWCELL_CMD_STEP_F_CHECK_ERROR)
+LWCELL_CMD_SEQ_STEP(LWCELL_CMD_CGACT_SET_1, 0)
+#if LWCELL_CFG_NETWORK_IGNORE_CGACT_RESULT
+LWCELL_CMD_SEQ_STEP(LWCELL_CMD_CGATT_SET_0, 0)
+#else  /* LWCELL_CFG_NETWORK_IGNORE_CGACT_RESULT */
+LWCELL_CMD_SEQ_STEP(LWCELL_CMD_CGATT_SET_0, LWCELL_CMD_STEP_F_CHECK_ERROR)
+#endif /* !LWCELL_CFG_NETWORK_IGNORE_CGACT_RESULT */
+LWCELL_CMD_SEQ_STEP(LWCELL_CMD_CGATT_SET_1, 0)
+LWCELL_CMD_SEQ_STEP(LWCELL_CMD_CIPSHUT, LWCELL_CMD_STEP_F_CHECK_ERROR)
+LWCELL_CMD_SEQ_STEP(LWCELL_CMD_CIPMUX_SET, LWCELL_CMD_STEP_F_CHECK_ERROR)
+#if LWCELL_CFG_CONN && LWCELL_CFG_CONN_QSEND
+LWCELL_CMD_SEQ_STEP(LWCELL_CMD_CIPQSEND, LWCELL_CMD_STEP_F_CHECK_ERROR)
+#endif /* LWCELL_CFG_CONN && LWCELL_CFG_CONN_QSEND */
+LWCELL_CMD_SEQ_STEP(LWCELL_CMD_CIPRXGET_SET, LWCELL_CMD_STEP_F_CHECK_ERROR)
+LWCELL_CMD_SEQ_STEP(LWCELL_CMD_CSTT_SET, LWCELL_CMD_STEP_F_CHECK_ERROR)
+LWCELL_CMD_SEQ_STEP(LWCELL_CMD_CIICR, LWCELL_CMD_STEP_F_CHECK_ERROR)
+LWCELL_CMD_SEQ_STEP(LWCELL_CMD_CIFSR, LWCELL_CMD_STEP_F_CHECK_ERROR)
+LWCELL_CMD_SEQ_STEP(LWCELL_CMD_CIPSTATUS, 0)
+LWCELL_CMD_SEQ_END(LWCELL_CMD_NETWORK_ATTACH)
+
+LWCELL_CMD_SEQ_BEGIN(LWCELL_CMD_NETWORK_DETACH)
+LWCELL_CMD_SEQ_STEP(LWCELL_CMD_NETWORK_DETACH, 0)
+LWCELL_CMD_SEQ_STEP(LWCELL_CMD_CGATT_SET_0, 0)
+LWCELL_CMD_SEQ_STEP(LWCELL_CMD_CGACT_SET_0, 0)
+#if LWCELL_CFG_CONN
+LWCELL_CMD_SEQ_STEP(LWCELL_CMD_CIPSTATUS, 0)
+#endif /* LWCELL_CFG_CONN */
+LWCELL_CMD_SEQ_END(LWCELL_CMD_NETWORK_DETACH)
+#endif /* LWCELL_CFG_NETWORK */
+
+#if LWCELL_CFG_CONN && LWCELL_CFG_CONN_TRANSPARENT
+/* Return to multi-connection mode after transparent connection was closed by remote side */
+LWCELL_CMD_SEQ_BEGIN(LWCELL_CMD_CIPMODE_SET_0)
+LWCELL_CMD_SEQ_STEP(LWCELL_CMD_CIPMODE_SET_0, 0)
+LWCELL_CMD_SEQ_STEP(LWCELL_CMD_CIPMUX, 0)
+LWCELL_CMD_SEQ_END(LWCELL_CMD_CIPMODE_SET_0)
+#endif /* LWCELL_CFG_CONN && LWCELL_CFG_CONN_TRANSPARENT */
+
+#if LWCELL_CFG_CMUX
+LWCELL_CMD_SEQ_BEGIN(LWCELL_CMD_CMUX)
+LWCELL_CMD_SEQ_STEP(LWCELL_CMD_CMUX, 0)
+LWCELL_CMD_SEQ_STEP(LWCELL_CMD_CMUX_AT, LWCELL_CMD_STEP_F_CHECK_ERROR)
+LWCELL_CMD_SEQ_END(LWCELL_CMD_CMUX)
+#endif /* LWCELL_CFG_CMUX */
+
+#if LWCELL_CFG_PPP
+LWCELL_CMD_SEQ_BEGIN(LWCELL_CMD_PPP_START)
+LWCELL_CMD_SEQ_STEP(LWCELL_CMD_PPP_START, 0)
+LWCELL_CMD_SEQ_STEP(LWCELL_CMD_ATD_PPP, LWCELL_CMD_STEP_F_CHECK_ERROR)
+LWCELL_CMD_SEQ_END(LWCELL_CMD_PPP_START)
+#endif /* LWCELL_CFG_PPP */
+
+#undef LWCELL_CMD_SEQ_BEGIN
+#undef LWCELL_CMD_SEQ_STEP
+#undef LWCELL_CMD_SEQ_END
\ No newline at end of file
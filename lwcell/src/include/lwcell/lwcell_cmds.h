@@ -0,0 +1,167 @@
+/**
+ * \file            lwcell_cmds.h
+ * \brief           AT command descriptors
+ */
+
+/*
+ * Copyright (c) 2023 Tilen MAJERLE
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without restriction,
+ * including without limitation the rights to use, copy, modify, merge,
+ * publish, distribute, sublicense, and/or sell copies of the Software,
+ * and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE
+ * AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * This file is part of LwCELL - Lightweight cellular modem AT library.
+ *
+ * Author:          Tilen MAJERLE <tilen@majerle.eu>
+ * Version:         v0.1.1
+ */
+
+/*
+ * Order: Command; AT string sent after "AT" prefix; Final response; Timeout; Prepare function; Arguments function
+ *
+ * Final response is `LWCELL_CMD_FINAL_OK` for commands finished by `OK` or `ERROR`,
+ * or `LWCELL_CMD_FINAL_DATA` when `OK` is followed by command specific response, which finishes the command.
+ * Timeout is maximal time to wait for final response in units of milliseconds,
+ * or `0` to only use blocking time of API call. Command finishes with error when it expires.
+ * Prepare function is called before anything is sent to the device
+ * and may abort the command by returning error.
+ * Arguments function is called after AT string has been sent,
+ * to write command parameters to the device.
+ * Use `NULL` where function is not needed.
+ */
+LWCELL_CMD_ENTRY(LWCELL_CMD_RESET, "+CFUN=1,1", LWCELL_CMD_FINAL_OK, 0, lwcelli_cmd_prep_reset, NULL)
+LWCELL_CMD_ENTRY(LWCELL_CMD_RESET_DEVICE_FIRST_CMD, "", LWCELL_CMD_FINAL_OK, 0, NULL, NULL)
+LWCELL_CMD_ENTRY(LWCELL_CMD_ATE0, "E0", LWCELL_CMD_FINAL_OK, 0, NULL, NULL)
+LWCELL_CMD_ENTRY(LWCELL_CMD_ATE1, "E1", LWCELL_CMD_FINAL_OK, 0, NULL, NULL)
+LWCELL_CMD_ENTRY(LWCELL_CMD_CMEE_SET, "+CMEE=1", LWCELL_CMD_FINAL_OK, 0, NULL, NULL)
+LWCELL_CMD_ENTRY(LWCELL_CMD_CLCC_SET, "+CLCC=1", LWCELL_CMD_FINAL_OK, 0, NULL, NULL)
+LWCELL_CMD_ENTRY(LWCELL_CMD_CGMI_GET, "+CGMI", LWCELL_CMD_FINAL_OK, 0, NULL, NULL)
+LWCELL_CMD_ENTRY(LWCELL_CMD_CGMM_GET, "+CGMM", LWCELL_CMD_FINAL_OK, 0, NULL, NULL)
+LWCELL_CMD_ENTRY(LWCELL_CMD_CGSN_GET, "+CGSN", LWCELL_CMD_FINAL_OK, 0, NULL, NULL)
+LWCELL_CMD_ENTRY(LWCELL_CMD_CGMR_GET, "+CGMR", LWCELL_CMD_FINAL_OK, 0, NULL, NULL)
+LWCELL_CMD_ENTRY(LWCELL_CMD_CREG_SET, "+CREG=1", LWCELL_CMD_FINAL_OK, 0, NULL, NULL)
+LWCELL_CMD_ENTRY(LWCELL_CMD_CREG_GET, "+CREG?", LWCELL_CMD_FINAL_OK, 0, NULL, NULL)
+LWCELL_CMD_ENTRY(LWCELL_CMD_CFUN_SET, "+CFUN=", LWCELL_CMD_FINAL_OK, 10000, NULL, lwcelli_cmd_args_cfun_set)
+LWCELL_CMD_ENTRY(LWCELL_CMD_CPIN_GET, "+CPIN?", LWCELL_CMD_FINAL_OK, 0, NULL, NULL)
+LWCELL_CMD_ENTRY(LWCELL_CMD_CPIN_SET, "+CPIN=", LWCELL_CMD_FINAL_OK, 0, NULL, lwcelli_cmd_args_cpin_set)
+LWCELL_CMD_ENTRY(LWCELL_CMD_CPIN_ADD, "+CLCK=\"SC\",1,", LWCELL_CMD_FINAL_OK, 0, NULL, lwcelli_cmd_args_cpin_add)
+LWCELL_CMD_ENTRY(LWCELL_CMD_CPIN_CHANGE, "+CPWD=\"SC\"", LWCELL_CMD_FINAL_OK, 0, NULL, lwcelli_cmd_args_cpin_change)
+LWCELL_CMD_ENTRY(LWCELL_CMD_CPIN_REMOVE, "+CLCK=\"SC\",0,", LWCELL_CMD_FINAL_OK, 0, NULL, lwcelli_cmd_args_cpin_remove)
+LWCELL_CMD_ENTRY(LWCELL_CMD_CPUK_SET, "+CPIN=", LWCELL_CMD_FINAL_OK, 0, NULL, lwcelli_cmd_args_cpuk_set)
+LWCELL_CMD_ENTRY(LWCELL_CMD_COPS_SET, "+COPS=", LWCELL_CMD_FINAL_OK, 0, NULL, lwcelli_cmd_args_cops_set)
+LWCELL_CMD_ENTRY(LWCELL_CMD_COPS_GET, "+COPS?", LWCELL_CMD_FINAL_OK, 0, NULL, NULL)
+LWCELL_CMD_ENTRY(LWCELL_CMD_COPS_GET_OPT, "+COPS=?", LWCELL_CMD_FINAL_OK, 0, NULL, NULL)
+LWCELL_CMD_ENTRY(LWCELL_CMD_CSQ_GET, "+CSQ", LWCELL_CMD_FINAL_OK, 0, NULL, NULL)
+LWCELL_CMD_ENTRY(LWCELL_CMD_CNUM, "+CNUM", LWCELL_CMD_FINAL_OK, 5000, NULL, NULL)
+LWCELL_CMD_ENTRY(LWCELL_CMD_CIPSHUT, "+CIPSHUT", LWCELL_CMD_FINAL_OK, 65000, NULL, NULL)
+
+#if LWCELL_CFG_CONN
+LWCELL_CMD_ENTRY(LWCELL_CMD_CIPMUX, "+CIPMUX=1", LWCELL_CMD_FINAL_OK, 0, NULL, NULL)
+LWCELL_CMD_ENTRY(LWCELL_CMD_CIPHEAD, "+CIPHEAD=1", LWCELL_CMD_FINAL_OK, 0, NULL, NULL)
+LWCELL_CMD_ENTRY(LWCELL_CMD_CIPSRIP, "+CIPSRIP=1", LWCELL_CMD_FINAL_OK, 0, NULL, NULL)
+LWCELL_CMD_ENTRY(LWCELL_CMD_CIPSSL, "+CIPSSL=", LWCELL_CMD_FINAL_OK, 0, NULL, lwcelli_cmd_args_cipssl)
+LWCELL_CMD_ENTRY(LWCELL_CMD_CIPSTART, "+CIPSTART=", LWCELL_CMD_FINAL_DATA, 0, lwcelli_cmd_prep_cipstart,
+                 lwcelli_cmd_args_cipstart)
+LWCELL_CMD_ENTRY(LWCELL_CMD_CIPCLOSE, "+CIPCLOSE=", LWCELL_CMD_FINAL_OK, 0, lwcelli_cmd_prep_cipclose,
+                 lwcelli_cmd_args_cipclose)
+LWCELL_CMD_ENTRY(LWCELL_CMD_CIPSEND, "+CIPSEND=", LWCELL_CMD_FINAL_DATA, 0, lwcelli_cmd_prep_cipsend,
+                 lwcelli_cmd_args_cipsend)
+LWCELL_CMD_ENTRY(LWCELL_CMD_CIPSTATUS, "+CIPSTATUS", LWCELL_CMD_FINAL_DATA, 0, NULL, NULL)
+LWCELL_CMD_ENTRY(LWCELL_CMD_CIPSERVER, "+CIPSERVER=", LWCELL_CMD_FINAL_DATA, 0, NULL, lwcelli_cmd_args_cipserver)
+#if LWCELL_CFG_CONN_QSEND
+LWCELL_CMD_ENTRY(LWCELL_CMD_CIPQSEND, "+CIPQSEND=1", LWCELL_CMD_FINAL_OK, 0, NULL, NULL)
+LWCELL_CMD_ENTRY(LWCELL_CMD_CIPACK, "+CIPACK=", LWCELL_CMD_FINAL_OK, 0, NULL, lwcelli_cmd_args_cipack)
+#endif /* LWCELL_CFG_CONN_QSEND */
+#if LWCELL_CFG_CONN_MANUAL_RX
+LWCELL_CMD_ENTRY(LWCELL_CMD_CIPRXGET, "+CIPRXGET=2,", LWCELL_CMD_FINAL_OK, 0, lwcelli_cmd_prep_ciprxget,
+                 lwcelli_cmd_args_ciprxget)
+LWCELL_CMD_ENTRY(LWCELL_CMD_CIPRXGET_LEN, "+CIPRXGET=4,", LWCELL_CMD_FINAL_OK, 0, NULL, lwcelli_cmd_args_ciprxget_len)
+#endif /* LWCELL_CFG_CONN_MANUAL_RX */
+#if LWCELL_CFG_CONN_TRANSPARENT
+LWCELL_CMD_ENTRY(LWCELL_CMD_CIPMUX_SET_0, "+CIPMUX=0", LWCELL_CMD_FINAL_OK, 0, lwcelli_cmd_prep_cipmux_set_0, NULL)
+LWCELL_CMD_ENTRY(LWCELL_CMD_CIPMODE_SET_0, "+CIPMODE=0", LWCELL_CMD_FINAL_OK, 0, NULL, NULL)
+LWCELL_CMD_ENTRY(LWCELL_CMD_CIPMODE_SET_1, "+CIPMODE=1", LWCELL_CMD_FINAL_OK, 0, NULL, NULL)
+LWCELL_CMD_ENTRY(LWCELL_CMD_PPP, "+++", LWCELL_CMD_FINAL_OK, 0, lwcelli_cmd_prep_ppp, NULL)
+#endif /* LWCELL_CFG_CONN_TRANSPARENT */
+#endif /* LWCELL_CFG_CONN */
+
+#if LWCELL_CFG_SMS
+LWCELL_CMD_ENTRY(LWCELL_CMD_CMGF, "+CMGF=", LWCELL_CMD_FINAL_OK, 0, NULL, lwcelli_cmd_args_cmgf)
+LWCELL_CMD_ENTRY(LWCELL_CMD_CMGS, "+CMGS=", LWCELL_CMD_FINAL_OK, 0, NULL, lwcelli_cmd_args_cmgs)
+LWCELL_CMD_ENTRY(LWCELL_CMD_CMGR, "+CMGR=", LWCELL_CMD_FINAL_OK, 5000, NULL, lwcelli_cmd_args_cmgr)
+LWCELL_CMD_ENTRY(LWCELL_CMD_CMGD, "+CMGD=", LWCELL_CMD_FINAL_OK, 5000, NULL, lwcelli_cmd_args_cmgd)
+LWCELL_CMD_ENTRY(LWCELL_CMD_CMGDA, "+CMGDA=", LWCELL_CMD_FINAL_OK, 25000, NULL, lwcelli_cmd_args_cmgda)
+LWCELL_CMD_ENTRY(LWCELL_CMD_CMGL, "+CMGL=", LWCELL_CMD_FINAL_OK, 20000, NULL, lwcelli_cmd_args_cmgl)
+LWCELL_CMD_ENTRY(LWCELL_CMD_CPMS_GET_OPT, "+CPMS=?", LWCELL_CMD_FINAL_OK, 5000, NULL, NULL)
+LWCELL_CMD_ENTRY(LWCELL_CMD_CPMS_GET, "+CPMS?", LWCELL_CMD_FINAL_OK, 5000, NULL, NULL)
+LWCELL_CMD_ENTRY(LWCELL_CMD_CPMS_SET, "+CPMS=", LWCELL_CMD_FINAL_OK, 5000, NULL, lwcelli_cmd_args_cpms_set)
+#endif /* LWCELL_CFG_SMS */
+
+#if LWCELL_CFG_CALL
+LWCELL_CMD_ENTRY(LWCELL_CMD_ATD, "D", LWCELL_CMD_FINAL_OK, 0, NULL, lwcelli_cmd_args_atd)
+LWCELL_CMD_ENTRY(LWCELL_CMD_ATA, "A", LWCELL_CMD_FINAL_OK, 0, NULL, NULL)
+LWCELL_CMD_ENTRY(LWCELL_CMD_ATH, "H", LWCELL_CMD_FINAL_OK, 0, NULL, NULL)
+#endif /* LWCELL_CFG_CALL */
+
+#if LWCELL_CFG_PHONEBOOK
+LWCELL_CMD_ENTRY(LWCELL_CMD_CPBS_GET_OPT, "+CPBS=?", LWCELL_CMD_FINAL_OK, 5000, NULL, NULL)
+LWCELL_CMD_ENTRY(LWCELL_CMD_CPBS_GET, "+CPBS?", LWCELL_CMD_FINAL_OK, 5000, NULL, NULL)
+LWCELL_CMD_ENTRY(LWCELL_CMD_CPBS_SET, "+CPBS=", LWCELL_CMD_FINAL_OK, 5000, NULL, lwcelli_cmd_args_cpbs_set)
+LWCELL_CMD_ENTRY(LWCELL_CMD_CPBW_SET, "+CPBW=", LWCELL_CMD_FINAL_OK, 5000, NULL, lwcelli_cmd_args_cpbw_set)
+LWCELL_CMD_ENTRY(LWCELL_CMD_CPBR, "+CPBR=", LWCELL_CMD_FINAL_OK, 0, NULL, lwcelli_cmd_args_cpbr)
+LWCELL_CMD_ENTRY(LWCELL_CMD_CPBF, "+CPBF=", LWCELL_CMD_FINAL_OK, 0, NULL, lwcelli_cmd_args_cpbf)
+#endif /* LWCELL_CFG_PHONEBOOK */
+
+#if LWCELL_CFG_NETWORK
+LWCELL_CMD_ENTRY(LWCELL_CMD_NETWORK_ATTACH, "+CGACT=0", LWCELL_CMD_FINAL_OK, 0, NULL, NULL)
+LWCELL_CMD_ENTRY(LWCELL_CMD_CGACT_SET_0, "+CGACT=0", LWCELL_CMD_FINAL_OK, 0, NULL, NULL)
+LWCELL_CMD_ENTRY(LWCELL_CMD_CGACT_SET_1, "+CGACT=1", LWCELL_CMD_FINAL_OK, 0, NULL, NULL)
+LWCELL_CMD_ENTRY(LWCELL_CMD_NETWORK_DETACH, "+CGATT=0", LWCELL_CMD_FINAL_OK, 75000, NULL, NULL)
+LWCELL_CMD_ENTRY(LWCELL_CMD_CGATT_SET_0, "+CGATT=0", LWCELL_CMD_FINAL_OK, 75000, NULL, NULL)
+LWCELL_CMD_ENTRY(LWCELL_CMD_CGATT_SET_1, "+CGATT=1", LWCELL_CMD_FINAL_OK, 75000, NULL, NULL)
+LWCELL_CMD_ENTRY(LWCELL_CMD_CIPMUX_SET, "+CIPMUX=1", LWCELL_CMD_FINAL_OK, 0, NULL, NULL)
+#if LWCELL_CFG_CONN && LWCELL_CFG_CONN_MANUAL_RX
+LWCELL_CMD_ENTRY(LWCELL_CMD_CIPRXGET_SET, "+CIPRXGET=1", LWCELL_CMD_FINAL_OK, 0, NULL, NULL)
+#else  /* LWCELL_CFG_CONN && LWCELL_CFG_CONN_MANUAL_RX */
+LWCELL_CMD_ENTRY(LWCELL_CMD_CIPRXGET_SET, "+CIPRXGET=0", LWCELL_CMD_FINAL_OK, 0, NULL, NULL)
+#endif /* !(LWCELL_CFG_CONN && LWCELL_CFG_CONN_MANUAL_RX) */
+LWCELL_CMD_ENTRY(LWCELL_CMD_CSTT_SET, "+CSTT=", LWCELL_CMD_FINAL_OK, 0, NULL, lwcelli_cmd_args_cstt_set)
+LWCELL_CMD_ENTRY(LWCELL_CMD_CIICR, "+CIICR", LWCELL_CMD_FINAL_OK, 85000, NULL, NULL)
+LWCELL_CMD_ENTRY(LWCELL_CMD_CIFSR, "+CIFSR", LWCELL_CMD_FINAL_OK, 0, NULL, NULL)
+#endif /* LWCELL_CFG_NETWORK */
+
+#if LWCELL_CFG_PPP
+LWCELL_CMD_ENTRY(LWCELL_CMD_PPP_START, "+CGDCONT=1,\"IP\",", LWCELL_CMD_FINAL_OK, 0, lwcelli_cmd_prep_ppp_start,
+                 lwcelli_cmd_args_ppp_start)
+LWCELL_CMD_ENTRY(LWCELL_CMD_ATD_PPP, "D*99#", LWCELL_CMD_FINAL_OK, 0, NULL, NULL)
+LWCELL_CMD_ENTRY(LWCELL_CMD_PPP_STOP, "", LWCELL_CMD_FINAL_OK, 0, lwcelli_cmd_prep_ppp_stop, NULL)
+#endif /* LWCELL_CFG_PPP */
+
+#if LWCELL_CFG_USSD
+LWCELL_CMD_ENTRY(LWCELL_CMD_CUSD_GET, "+CUSD?", LWCELL_CMD_FINAL_OK, 0, NULL, NULL)
+LWCELL_CMD_ENTRY(LWCELL_CMD_CUSD, "+CUSD=1,", LWCELL_CMD_FINAL_DATA, 0, NULL, lwcelli_cmd_args_cusd)
+#endif /* LWCELL_CFG_USSD */
+
+#if LWCELL_CFG_CMUX
+LWCELL_CMD_ENTRY(LWCELL_CMD_CMUX, "+CMUX=0,0,", LWCELL_CMD_FINAL_OK, 0, lwcelli_cmd_prep_cmux, lwcelli_cmd_args_cmux)
+LWCELL_CMD_ENTRY(LWCELL_CMD_CMUX_AT, "", LWCELL_CMD_FINAL_OK, 0, lwcelli_cmd_prep_cmux_at, NULL)
+LWCELL_CMD_ENTRY(LWCELL_CMD_CMUX_CLD, "", LWCELL_CMD_FINAL_OK, 0, lwcelli_cmd_prep_cmux_cld, NULL)
+#endif /* LWCELL_CFG_CMUX */
+
+#undef LWCELL_CMD_ENTRY
\ No newline at end of file
@@ -0,0 +1,71 @@
+/**
+ * \file            lwcell_cmux.h
+ * \brief           GSM 07.10 multiplexer
+ */
+
+/*
+ * Copyright (c) 2023 Tilen MAJERLE
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without restriction,
+ * including without limitation the rights to use, copy, modify, merge,
+ * publish, distribute, sublicense, and/or sell copies of the Software,
+ * and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE
+ * AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * This file is part of LwCELL - Lightweight cellular modem AT library.
+ *
+ * Author:          Tilen MAJERLE <tilen@majerle.eu>
+ * Version:         v0.1.1
+ */
+#ifndef LWCELL_CMUX_HDR_H
+#define LWCELL_CMUX_HDR_H
+
+#include "lwcell/lwcell_types.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif /* __cplusplus */
+
+/**
+ * \ingroup         LWCELL
+ * \defgroup        LWCELL_CMUX GSM 07.10 multiplexer
+ * \brief           Multiplexer in basic mode with virtual channels over single serial port
+ * \{
+ *
+ * Once started, AT commands run over DLCI `1` and channels `2` to \ref LWCELL_CFG_CMUX_CHANNELS
+ * are opened for application. Data received on application channels are kept in per-channel buffer
+ * and reported with \ref LWCELL_EVT_CMUX_RECV event, use \ref lwcell_cmux_read to get them.
+ */
+
+#define LWCELL_CMUX_DLCI_AT 1 /*!< Channel used for AT commands */
+
+lwcellr_t lwcell_cmux_start(const lwcell_api_cmd_evt_fn evt_fn, void* const evt_arg, const uint32_t blocking);
+lwcellr_t lwcell_cmux_stop(const lwcell_api_cmd_evt_fn evt_fn, void* const evt_arg, const uint32_t blocking);
+uint8_t lwcell_cmux_is_active(void);
+size_t lwcell_cmux_write(uint8_t dlci, const void* data, size_t len);
+size_t lwcell_cmux_read(uint8_t dlci, void* data, size_t len);
+size_t lwcell_cmux_get_full(uint8_t dlci);
+
+/**
+ * \}
+ */
+
+#ifdef __cplusplus
+}
+#endif /* __cplusplus */
+
+#endif /* LWCELL_CMUX_HDR_H */
@@ -53,6 +53,9 @@ lwcellr_t lwcell_conn_close(lwcell_conn_p conn, const uint32_t blocking);
 lwcellr_t lwcell_conn_send(lwcell_conn_p conn, const void* data, size_t btw, size_t* const bw, const uint32_t blocking);
 lwcellr_t lwcell_conn_sendto(lwcell_conn_p conn, const lwcell_ip_t* const ip, lwcell_port_t port, const void* data,
                            size_t btw, size_t* bw, const uint32_t blocking);
+lwcellr_t lwcell_conn_sendv(lwcell_conn_p conn, const lwcell_iovec_t* iov, size_t iov_cnt, size_t* const bw,
+                            const uint32_t blocking);
+lwcellr_t lwcell_conn_send_pbuf(lwcell_conn_p conn, lwcell_pbuf_p pbuf, size_t* const bw, const uint32_t blocking);
 lwcellr_t lwcell_conn_set_arg(lwcell_conn_p conn, void* const arg);
 void* lwcell_conn_get_arg(lwcell_conn_p conn);
 uint8_t lwcell_conn_is_client(lwcell_conn_p conn);
@@ -60,10 +63,13 @@ uint8_t lwcell_conn_is_active(lwcell_conn_p conn);
 uint8_t lwcell_conn_is_closed(lwcell_conn_p conn);
 int8_t lwcell_conn_getnum(lwcell_conn_p conn);
 lwcellr_t lwcell_get_conns_status(const uint32_t blocking);
+lwcellr_t lwcell_set_server(uint8_t en, lwcell_port_t port, lwcell_evt_fn server_evt_fn,
+                            const lwcell_api_cmd_evt_fn evt_fn, void* const evt_arg, const uint32_t blocking);
 lwcell_conn_p lwcell_conn_get_from_evt(lwcell_evt_t* evt);
 lwcellr_t lwcell_conn_write(lwcell_conn_p conn, const void* data, size_t btw, uint8_t flush, size_t* const mem_available);
 lwcellr_t lwcell_conn_recved(lwcell_conn_p conn, lwcell_pbuf_p pbuf);
 size_t lwcell_conn_get_total_recved_count(lwcell_conn_p conn);
+size_t lwcell_conn_get_unacked_count(lwcell_conn_p conn);
 
 uint8_t lwcell_conn_get_remote_ip(lwcell_conn_p conn, lwcell_ip_t* ip);
 lwcell_port_t lwcell_conn_get_remote_port(lwcell_conn_p conn);
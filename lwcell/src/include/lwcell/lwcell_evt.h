@@ -48,9 +48,22 @@ extern "C" {
  */
 
 lwcellr_t lwcell_evt_register(lwcell_evt_fn fn);
+lwcellr_t lwcell_evt_register_ex(lwcell_evt_fn fn, lwcell_evt_mask_t mask);
 lwcellr_t lwcell_evt_unregister(lwcell_evt_fn fn);
 lwcell_evt_type_t lwcell_evt_get_type(lwcell_evt_t* cc);
 
+#if LWCELL_CFG_EVT_DEFER || __DOXYGEN__
+
+/**
+ * \brief           Timeout value for \ref lwcell_evt_dispatch to return immediately when queue is empty
+ */
+#define LWCELL_EVT_DISPATCH_NO_WAIT 0xFFFFFFFF
+
+size_t lwcell_evt_dispatch(uint32_t timeout);
+lwcellr_t lwcell_evt_get_defer_stat(lwcell_evt_defer_stat_t* stat);
+
+#endif /* LWCELL_CFG_EVT_DEFER || __DOXYGEN__ */
+
 /**
  * \anchor          LWCELL_EVT_RESET
  * \name            Reset event
@@ -257,6 +270,19 @@ lwcellr_t lwcell_evt_operator_scan_get_result(lwcell_evt_t* cc);
 lwcell_operator_t* lwcell_evt_operator_scan_get_entries(lwcell_evt_t* cc);
 size_t lwcell_evt_operator_scan_get_length(lwcell_evt_t* cc);
 
+/**
+ * \}
+ */
+
+/**
+ * \anchor          LWCELL_EVT_CMUX_RECV
+ * \name            Multiplexer data received
+ * \brief           Event helper functions for \ref LWCELL_EVT_CMUX_RECV event
+ */
+
+uint8_t lwcell_evt_cmux_recv_get_dlci(lwcell_evt_t* cc);
+size_t lwcell_evt_cmux_recv_get_length(lwcell_evt_t* cc);
+
 /**
  * \}
  */
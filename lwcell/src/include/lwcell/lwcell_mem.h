@@ -47,6 +47,26 @@ extern "C" {
  * \{
  */
 
+/**
+ * \brief           Subsystem tag of allocation, used for per-subsystem statistics
+ * \sa              LWCELL_CFG_MEM_TAGS
+ */
+typedef enum {
+    LWCELL_MEM_TAG_OTHER = 0x00, /*!< Allocation without specific subsystem */
+    LWCELL_MEM_TAG_PBUF,         /*!< Packet buffers */
+    LWCELL_MEM_TAG_MSG,          /*!< API command messages */
+    LWCELL_MEM_TAG_CONN,         /*!< Connection and netconn write buffers */
+    LWCELL_MEM_TAG_MQTT,         /*!< MQTT client objects and buffers */
+    LWCELL_MEM_TAG_END,          /*!< Last entry, used for array size */
+} lwcell_mem_tag_t;
+
+/**
+ * \brief           Number of entries in allocation size histogram
+ *
+ * Entry `i` counts allocations up to `16 << i` bytes, last entry counts all bigger allocations
+ */
+#define LWCELL_MEM_SIZE_HIST_LEN 8
+
 #if !LWCELL_CFG_MEM_CUSTOM || __DOXYGEN__
 
 /**
@@ -57,10 +77,67 @@ typedef struct {
     size_t size;      /*!< Size in units of bytes of region */
 } lwcell_mem_region_t;
 
+/**
+ * \brief           Memory manager statistics
+ * \note            Sizes include block metadata
+ */
+typedef struct {
+    size_t mem_size_bytes;          /*!< Total size of all assigned regions */
+    size_t mem_available_bytes;     /*!< Number of bytes currently available for allocations */
+    size_t largest_free_block;      /*!< Size of largest free block */
+    size_t free_blocks;             /*!< Number of free blocks */
+    uint8_t fragmentation;          /*!< Percentage of free memory outside largest free block */
+    size_t mem_available_bytes_min; /*!< Minimal number of available bytes since regions were assigned */
+    size_t alloc_count;             /*!< Number of successful allocations */
+    size_t alloc_failed_count;      /*!< Number of failed allocations */
+    size_t free_count;              /*!< Number of freed allocations */
+} lwcell_mem_stats_t;
+
+/**
+ * \brief           Allocation statistics of single subsystem
+ * \note            Sizes are requested sizes, without block metadata
+ */
+typedef struct {
+    size_t alloc_count;                         /*!< Number of successful allocations */
+    size_t free_count;                          /*!< Number of freed allocations */
+    size_t bytes_used;                          /*!< Number of bytes currently allocated */
+    size_t bytes_used_max;                      /*!< Maximal number of bytes allocated at the same time */
+    size_t size_hist[LWCELL_MEM_SIZE_HIST_LEN]; /*!< Allocation size histogram */
+} lwcell_mem_tag_stats_t;
+
+/**
+ * \brief           Callback function for live allocation, reported by \ref lwcell_mem_leak_check
+ * \param[in]       ptr: Allocated memory
+ * \param[in]       size: Requested size in units of bytes
+ * \param[in]       tag: Subsystem tag of allocation
+ * \param[in]       seq: Allocation sequence number
+ * \param[in]       arg: User argument
+ */
+typedef void (*lwcell_mem_leak_fn)(const void* ptr, size_t size, lwcell_mem_tag_t tag, uint32_t seq, void* arg);
+
 uint8_t lwcell_mem_assignmemory(const lwcell_mem_region_t* regions, size_t size);
+lwcellr_t lwcell_mem_get_stats(lwcell_mem_stats_t* stats);
 
 #endif /* !LWCELL_CFG_MEM_CUSTOM || __DOXYGEN__ */
 
+#if (!LWCELL_CFG_MEM_CUSTOM && LWCELL_CFG_MEM_TAGS) || __DOXYGEN__
+
+void* lwcell_mem_malloc_tag(size_t size, lwcell_mem_tag_t tag);
+void* lwcell_mem_calloc_tag(size_t num, size_t size, lwcell_mem_tag_t tag);
+lwcellr_t lwcell_mem_get_tag_stats(lwcell_mem_tag_t tag, lwcell_mem_tag_stats_t* stats);
+
+#if LWCELL_CFG_MEM_LEAK_TRACK || __DOXYGEN__
+uint32_t lwcell_mem_leak_mark(void);
+size_t lwcell_mem_leak_check(uint32_t mark, lwcell_mem_leak_fn fn, void* arg);
+#endif /* LWCELL_CFG_MEM_LEAK_TRACK || __DOXYGEN__ */
+
+#else /* (!LWCELL_CFG_MEM_CUSTOM && LWCELL_CFG_MEM_TAGS) || __DOXYGEN__ */
+
+#define lwcell_mem_malloc_tag(size, tag)      lwcell_mem_malloc(size)
+#define lwcell_mem_calloc_tag(num, size, tag) lwcell_mem_calloc((num), (size))
+
+#endif /* !((!LWCELL_CFG_MEM_CUSTOM && LWCELL_CFG_MEM_TAGS) || __DOXYGEN__) */
+
 void* lwcell_mem_malloc(size_t size);
 void* lwcell_mem_realloc(void* ptr, size_t size);
 void* lwcell_mem_calloc(size_t num, size_t size);
@@ -63,28 +63,52 @@ typedef struct lwcell_netconn* lwcell_netconn_p;
 /* Immediate flush for TCP write. Used with \ref lwcell_netconn_write_ex*/
 #define LWCELL_NETCONN_FLAG_FLUSH      ((uint16_t)0x0001) /*!< Immediate flush after netconn write */
 
+/* Readiness flags. Used with \ref lwcell_netconn_poll */
+#define LWCELL_NETCONN_POLL_READ   ((uint8_t)0x01) /*!< Data or close notification waiting, receive will not block */
+#define LWCELL_NETCONN_POLL_WRITE  ((uint8_t)0x02) /*!< Connection is active and accepts more data */
+#define LWCELL_NETCONN_POLL_CLOSED ((uint8_t)0x04) /*!< Connection closed or not connected, reported always */
+
 /**
  * \brief           Netconn connection type
  */
 typedef enum {
-    LWCELL_NETCONN_TYPE_TCP = LWCELL_CONN_TYPE_TCP, /*!< TCP connection */
-    LWCELL_NETCONN_TYPE_UDP = LWCELL_CONN_TYPE_UDP, /*!< UDP connection */
-    LWCELL_NETCONN_TYPE_SSL = LWCELL_CONN_TYPE_SSL, /*!< TCP connection over SSL */
+    LWCELL_NETCONN_TYPE_TCP = LWCELL_CONN_TYPE_TCP,                         /*!< TCP connection */
+    LWCELL_NETCONN_TYPE_UDP = LWCELL_CONN_TYPE_UDP,                         /*!< UDP connection */
+    LWCELL_NETCONN_TYPE_SSL = LWCELL_CONN_TYPE_SSL,                         /*!< TCP connection over SSL */
+    LWCELL_NETCONN_TYPE_TCP_TRANSPARENT = LWCELL_CONN_TYPE_TCP_TRANSPARENT, /*!< TCP connection in transparent mode */
 } lwcell_netconn_type_t;
 
+/**
+ * \brief           Netconn entry to wait for with \ref lwcell_netconn_poll
+ */
+typedef struct {
+    lwcell_netconn_p nc; /*!< Netconn handle */
+    uint8_t events;      /*!< Requested states, bitwise-ORed \ref LWCELL_NETCONN_POLL_READ and others */
+    uint8_t revents;     /*!< Ready states, set by \ref lwcell_netconn_poll */
+} lwcell_netconn_poll_t;
+
 lwcell_netconn_p lwcell_netconn_new(lwcell_netconn_type_t type);
 lwcellr_t lwcell_netconn_delete(lwcell_netconn_p nc);
 lwcellr_t lwcell_netconn_connect(lwcell_netconn_p nc, const char* host, lwcell_port_t port);
+lwcellr_t lwcell_netconn_bind(lwcell_netconn_p nc, lwcell_port_t port);
+lwcellr_t lwcell_netconn_listen(lwcell_netconn_p nc);
+lwcellr_t lwcell_netconn_set_listen_conn_timeout(lwcell_netconn_p nc, uint16_t timeout);
+lwcellr_t lwcell_netconn_accept(lwcell_netconn_p nc, lwcell_netconn_p* client);
 lwcellr_t lwcell_netconn_receive(lwcell_netconn_p nc, lwcell_pbuf_p* pbuf);
+lwcellr_t lwcell_netconn_recv_into(lwcell_netconn_p nc, void* data, size_t len, size_t* br, uint32_t timeout);
+lwcellr_t lwcell_netconn_recv_peek(lwcell_netconn_p nc, const void** data, size_t* len, uint32_t timeout);
+lwcellr_t lwcell_netconn_recv_consume(lwcell_netconn_p nc, size_t len);
 lwcellr_t lwcell_netconn_close(lwcell_netconn_p nc);
 int8_t lwcell_netconn_getconnnum(lwcell_netconn_p nc);
 void lwcell_netconn_set_receive_timeout(lwcell_netconn_p nc, uint32_t timeout);
 uint32_t lwcell_netconn_get_receive_timeout(lwcell_netconn_p nc);
+lwcellr_t lwcell_netconn_poll(lwcell_netconn_poll_t* fds, size_t fds_cnt, size_t* ready_cnt, uint32_t timeout);
 
 /* TCP only */
 lwcellr_t lwcell_netconn_write(lwcell_netconn_p nc, const void* data, size_t btw);
 lwcellr_t lwcell_netconn_write_ex(lwcell_netconn_p nc, const void* data, size_t btw, uint16_t flags);
 lwcellr_t lwcell_netconn_flush(lwcell_netconn_p nc);
+lwcellr_t lwcell_netconn_set_autoflush(lwcell_netconn_p nc, uint32_t delay, size_t threshold);
 
 /* UDP only */
 lwcellr_t lwcell_netconn_send(lwcell_netconn_p nc, const void* data, size_t btw);
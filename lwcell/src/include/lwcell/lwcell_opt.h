@@ -96,6 +96,54 @@
 #define LWCELL_CFG_MEM_ALIGNMENT 4
 #endif
 
+/**
+ * \brief           Enables `1` or disables `0` two-level segregated fit (TLSF) allocator
+ *
+ * When enabled, \ref LWCELL_MEM uses segregated free lists with bitmap lookup instead of single first-fit list.
+ * Allocation and free take bounded time, regardless of number of free blocks and heap fragmentation.
+ *
+ * \note            Used only when \ref LWCELL_CFG_MEM_CUSTOM is disabled
+ * \note            \ref LWCELL_CFG_MEM_ALIGNMENT must not exceed `16` bytes
+ */
+#ifndef LWCELL_CFG_MEM_TLSF
+#define LWCELL_CFG_MEM_TLSF 0
+#endif
+
+/**
+ * \brief           Size of largest TLSF block in units of power of `2`
+ *
+ * Memory regions bigger than `2^LWCELL_CFG_MEM_TLSF_FL_MAX` bytes are truncated.
+ * Larger value increases number of free list heads, kept in static memory.
+ *
+ * \note            Value must be between `7` and `31`
+ */
+#ifndef LWCELL_CFG_MEM_TLSF_FL_MAX
+#define LWCELL_CFG_MEM_TLSF_FL_MAX 20
+#endif
+
+/**
+ * \brief           Enables `1` or disables `0` per-subsystem allocation statistics
+ *
+ * Every allocation gets small header with requested size and subsystem tag,
+ * used to track memory usage and size histogram for each \ref lwcell_mem_tag_t
+ *
+ * \note            Used only when \ref LWCELL_CFG_MEM_CUSTOM is disabled
+ * \sa              lwcell_mem_get_tag_stats
+ */
+#ifndef LWCELL_CFG_MEM_TAGS
+#define LWCELL_CFG_MEM_TAGS 0
+#endif
+
+/**
+ * \brief           Enables `1` or disables `0` tracking of all live allocations for leak detection
+ *
+ * \note            Requires \ref LWCELL_CFG_MEM_TAGS to be enabled
+ * \sa              lwcell_mem_leak_mark, lwcell_mem_leak_check
+ */
+#ifndef LWCELL_CFG_MEM_LEAK_TRACK
+#define LWCELL_CFG_MEM_LEAK_TRACK 0
+#endif
+
 /**
  * \brief           Enables `1` or disables `0` callback function and custom parameter for API functions
  *
@@ -106,6 +154,30 @@
 #define LWCELL_CFG_USE_API_FUNC_EVT 1
 #endif
 
+/**
+ * \brief           Number of preallocated command messages
+ *
+ * API functions take messages from static pool instead of allocating them from heap.
+ * Semaphore of pool message is created only once and reused for next blocking calls.
+ * When pool is empty, message is allocated from heap.
+ *
+ * Set to `0` to always allocate messages from heap
+ */
+#ifndef LWCELL_CFG_MSG_POOL_SIZE
+#define LWCELL_CFG_MSG_POOL_SIZE 0
+#endif
+
+/**
+ * \brief           Enables `1` or disables `0` placing command message on caller stack for blocking API calls
+ *
+ * Blocking call waits for command to finish, therefore message can live on its stack.
+ *
+ * \note            When enabled, every API function requires additional stack of `sizeof(lwcell_msg_t)`
+ */
+#ifndef LWCELL_CFG_MSG_STACK_BLOCKING
+#define LWCELL_CFG_MSG_STACK_BLOCKING 0
+#endif
+
 /**
  * \defgroup        LWCELL_OPT_CONN Connection settings
  * \brief           Connection settings
@@ -142,6 +214,33 @@
 #define LWCELL_CFG_CONN_MIN_DATA_LEN 16
 #endif
 
+/**
+ * \brief           Enables `1` or disables `0` static packet buffer pool
+ *
+ * Packet buffers are taken from the smallest size class with enough space in constant time.
+ * When class is empty, next larger class is used and heap is used as last fallback.
+ *
+ * \sa              LWCELL_CFG_PBUF_POOL_CLASSES
+ */
+#ifndef LWCELL_CFG_PBUF_POOL
+#define LWCELL_CFG_PBUF_POOL 0
+#endif
+
+/**
+ * \brief           List of packet buffer pool size classes
+ *
+ * Every class is defined with `LWCELL_PBUF_POOL_CLASS(size, count)`,
+ * where `size` is maximal payload length and `count` is number of buffers in the class.
+ *
+ * \note            Classes must be sorted by ascending `size`
+ */
+#ifndef LWCELL_CFG_PBUF_POOL_CLASSES
+#define LWCELL_CFG_PBUF_POOL_CLASSES                                                                                   \
+    LWCELL_PBUF_POOL_CLASS(64, 8)                                                                                      \
+    LWCELL_PBUF_POOL_CLASS(256, 8)                                                                                     \
+    LWCELL_PBUF_POOL_CLASS(1460, 4)
+#endif
+
 /**
  * \brief           Set number of retries for send data command.
  *
@@ -152,6 +251,123 @@
 #define LWCELL_CFG_MAX_SEND_RETRIES 3
 #endif
 
+/**
+ * \brief           Enables `1` or disables `0` quick send mode for connections
+ *
+ * In quick send mode (`AT+CIPQSEND=1`), device replies with `DATA ACCEPT`
+ * as soon as data are copied to its internal buffer, instead of `SEND OK`
+ * after remote side acknowledged them. Next chunk is sent without waiting for network round trip.
+ *
+ * Bytes accepted by device but not yet acknowledged by remote side are tracked per TCP connection
+ * and limited to \ref LWCELL_CFG_CONN_QSEND_WINDOW bytes.
+ *
+ * \note            Mode is configured during network attach and requires \ref LWCELL_CFG_NETWORK
+ */
+#ifndef LWCELL_CFG_CONN_QSEND
+#define LWCELL_CFG_CONN_QSEND 0
+#endif
+
+/**
+ * \brief           Maximal number of unacknowledged bytes on single TCP connection in quick send mode
+ *
+ * When next chunk does not fit into the window, `AT+CIPACK` is polled
+ * every \ref LWCELL_CFG_CONN_QSEND_POLL_INTERVAL milliseconds until remote side acknowledges enough data
+ */
+#ifndef LWCELL_CFG_CONN_QSEND_WINDOW
+#define LWCELL_CFG_CONN_QSEND_WINDOW (4 * LWCELL_CFG_CONN_MAX_DATA_LEN)
+#endif
+
+/**
+ * \brief           Interval in units of milliseconds between `AT+CIPACK` queries when quick send window is full
+ */
+#ifndef LWCELL_CFG_CONN_QSEND_POLL_INTERVAL
+#define LWCELL_CFG_CONN_QSEND_POLL_INTERVAL 50
+#endif
+
+/**
+ * \brief           Enables `1` or disables `0` manual receive mode for connections
+ *
+ * In manual receive mode (`AT+CIPRXGET=1`), device keeps received data in its internal buffer
+ * and only notifies stack about new data. Stack reads data with `AT+CIPRXGET=2` when:
+ *
+ *  - Packet buffer can be allocated for the data, read length is adjusted to available memory
+ *  - Application confirmed previously received data with \ref lwcell_conn_recved,
+ *      see \ref LWCELL_CFG_CONN_MANUAL_RX_WINDOW and \ref LWCELL_CFG_CONN_MANUAL_RX_MAX_PBUFS
+ *
+ * Data are therefore kept in device instead of being dropped when stack or application cannot accept them.
+ *
+ * \note            Application using connection API directly must call \ref lwcell_conn_recved
+ *                  for every received packet buffer, otherwise reading stops once window is full
+ */
+#ifndef LWCELL_CFG_CONN_MANUAL_RX
+#define LWCELL_CFG_CONN_MANUAL_RX 0
+#endif
+
+/**
+ * \brief           Maximal number of received bytes sent to application,
+ *                  but not yet confirmed with \ref lwcell_conn_recved, per connection
+ */
+#ifndef LWCELL_CFG_CONN_MANUAL_RX_WINDOW
+#define LWCELL_CFG_CONN_MANUAL_RX_WINDOW (4 * LWCELL_CFG_CONN_MAX_DATA_LEN)
+#endif
+
+/**
+ * \brief           Maximal number of received packet buffers sent to application,
+ *                  but not yet confirmed with \ref lwcell_conn_recved, per connection
+ *
+ * Default value leaves one entry in netconn receive queue for connection closed notification
+ */
+#ifndef LWCELL_CFG_CONN_MANUAL_RX_MAX_PBUFS
+#define LWCELL_CFG_CONN_MANUAL_RX_MAX_PBUFS (LWCELL_CFG_NETCONN_RECEIVE_QUEUE_LEN - 1)
+#endif
+
+/**
+ * \brief           Time in units of milliseconds to retry reading data in manual receive mode,
+ *                  when there was not enough memory for packet buffer or command message
+ */
+#ifndef LWCELL_CFG_CONN_MANUAL_RX_RETRY_INTERVAL
+#define LWCELL_CFG_CONN_MANUAL_RX_RETRY_INTERVAL 100
+#endif
+
+/**
+ * \brief           Enables `1` or disables `0` transparent data mode connections
+ *
+ * Connection of type \ref LWCELL_CONN_TYPE_TCP_TRANSPARENT switches device
+ * to single connection transparent mode (`AT+CIPMUX=0` and `AT+CIPMODE=1`).
+ * Data are then streamed between AT port and connection directly,
+ * without `AT+CIPSEND` handshake and without parsing of received data.
+ * Send requests still go through producer queue, hence `blocking` parameter applies
+ * and \ref LWCELL_EVT_CONN_SEND is reported from stack thread as for other connections.
+ *
+ * Device returns to command mode with `+++` escape sequence when connection is closed.
+ *
+ * \note            Transparent connection can only be started when no other connection is active.
+ *                  While it is active, other AT commands are rejected with \ref lwcellERR
+ */
+#ifndef LWCELL_CFG_CONN_TRANSPARENT
+#define LWCELL_CFG_CONN_TRANSPARENT 0
+#endif
+
+/**
+ * \brief           Guard time in units of milliseconds without any data before and after `+++` escape sequence
+ *
+ * Value must not be lower than guard time configured in device
+ */
+#ifndef LWCELL_CFG_CONN_TRANSPARENT_GUARD_TIME
+#define LWCELL_CFG_CONN_TRANSPARENT_GUARD_TIME 1000
+#endif
+
+/**
+ * \brief           Idle time in units of milliseconds after possible status marker in data mode
+ *
+ * Received bytes that may start `CLOSED` status marker are held back from connection.
+ * Marker is accepted only when line stays idle for this time after it,
+ * otherwise held back bytes are delivered to connection as regular data
+ */
+#ifndef LWCELL_CFG_CONN_TRANSPARENT_MARKER_TIME
+#define LWCELL_CFG_CONN_TRANSPARENT_MARKER_TIME 20
+#endif
+
 /**
  * \}
  */
@@ -231,6 +447,50 @@
 #define LWCELL_CFG_KEEP_ALIVE_TIMEOUT 1000
 #endif
 
+/**
+ * \brief           Number of preallocated timeout entries
+ *
+ * Default value is calculated from enabled features, each reserving entries it may use at the same time:
+ *
+ *  - Connection poll timer and netconn write autoflush for every connection
+ *  - Read retry for every connection in manual receive mode
+ *  - Timeout of active command, acknowledged bytes poll in quick send mode,
+ *      status marker in transparent mode, PPP restart timer and keep-alive event
+ *  - \ref LWCELL_CFG_TIMEOUT_POOL_USER entries for application timeouts
+ *
+ * \ref lwcell_timeout_add returns \ref lwcellERRMEM when all entries are in use
+ */
+#ifndef LWCELL_CFG_TIMEOUT_POOL_SIZE
+#define LWCELL_CFG_TIMEOUT_POOL_SIZE                                                                                   \
+    (LWCELL_CFG_MAX_CONNS * (1 + LWCELL_CFG_NETCONN + LWCELL_CFG_CONN_MANUAL_RX) + 1 + LWCELL_CFG_CONN_QSEND           \
+     + LWCELL_CFG_CONN_TRANSPARENT + LWCELL_CFG_PPP + LWCELL_CFG_KEEP_ALIVE + LWCELL_CFG_TIMEOUT_POOL_USER)
+#endif
+
+/**
+ * \brief           Number of timeout entries reserved for application in \ref LWCELL_CFG_TIMEOUT_POOL_SIZE
+ */
+#ifndef LWCELL_CFG_TIMEOUT_POOL_USER
+#define LWCELL_CFG_TIMEOUT_POOL_USER 4
+#endif
+
+/**
+ * \brief           Number of slots in timeout timing wheel
+ *
+ * \note            Value must be power of `2`
+ */
+#ifndef LWCELL_CFG_TIMEOUT_WHEEL_SIZE
+#define LWCELL_CFG_TIMEOUT_WHEEL_SIZE 64
+#endif
+
+/**
+ * \brief           Time resolution of timing wheel slot in units of milliseconds
+ *
+ * Timeouts are rounded up to multiple of this value
+ */
+#ifndef LWCELL_CFG_TIMEOUT_TICK
+#define LWCELL_CFG_TIMEOUT_TICK 10
+#endif
+
 /**
  * \defgroup        LWCELL_OPT_DBG Debugging
  * \brief           Debugging configurations
@@ -382,6 +642,28 @@
 #define LWCELL_CFG_AT_ECHO 0
 #endif
 
+/**
+ * \brief           Enables `1` or disables `0` per-command latency statistics
+ *
+ * For every command type, time waiting in producer queue, execution time,
+ * timeouts and errors are recorded to histograms, available with \ref lwcell_stats_get
+ *
+ * \note            Statistics need `(6 + 2 * LWCELL_CFG_STATS_HIST_LEN) * 4` bytes of RAM per command type
+ */
+#ifndef LWCELL_CFG_STATS
+#define LWCELL_CFG_STATS 0
+#endif
+
+/**
+ * \brief           Number of buckets in each latency histogram
+ *
+ * Bucket `0` counts durations below `1` ms, bucket `i` durations from `2^(i-1)` to `2^i - 1` ms.
+ * Last bucket counts all longer durations too
+ */
+#ifndef LWCELL_CFG_STATS_HIST_LEN
+#define LWCELL_CFG_STATS_HIST_LEN 16
+#endif
+
 /**
  * \}
  */
@@ -445,6 +727,58 @@
 #define LWCELL_THREAD_PROCESS_HOOK()
 #endif
 
+/**
+ * \brief           Enables `1` or disables `0` deferred dispatch of global events
+ *
+ * When enabled, global events are copied to a queue and functions registered by application,
+ * with \ref lwcell_init, \ref lwcell_evt_register or \ref lwcell_evt_register_ex,
+ * are called after core lock has been released.
+ * Slow application callback does not delay processing of received data anymore.
+ *
+ * Events pointing to memory valid only during the call (operator scan, SMS read and list,
+ * phonebook list and search) are always dispatched directly from processing thread.
+ *
+ * \note            This mode can only be used when \ref LWCELL_CFG_OS is enabled
+ * \sa              LWCELL_CFG_EVT_DEFER_THREAD
+ */
+#ifndef LWCELL_CFG_EVT_DEFER
+#define LWCELL_CFG_EVT_DEFER 0
+#endif
+
+/**
+ * \brief           Number of events deferred dispatch queue can hold
+ *
+ * \note            Every entry holds copy of \ref lwcell_evt_t structure and call or operator information
+ */
+#ifndef LWCELL_CFG_EVT_DEFER_LEN
+#define LWCELL_CFG_EVT_DEFER_LEN 16
+#endif
+
+/**
+ * \brief           Enables `1` or disables `0` dedicated thread for deferred event dispatch
+ *
+ * When disabled, application must periodically call \ref lwcell_evt_dispatch from single thread
+ */
+#ifndef LWCELL_CFG_EVT_DEFER_THREAD
+#define LWCELL_CFG_EVT_DEFER_THREAD 1
+#endif
+
+#define LWCELL_EVT_DEFER_OVERFLOW_DROP   0 /*!< Event not fitting to deferred queue is dropped */
+#define LWCELL_EVT_DEFER_OVERFLOW_DIRECT 1 /*!< Event not fitting to deferred queue is dispatched directly */
+
+/**
+ * \brief           Action when deferred dispatch queue is full
+ *
+ * Possible values are \ref LWCELL_EVT_DEFER_OVERFLOW_DROP or \ref LWCELL_EVT_DEFER_OVERFLOW_DIRECT.
+ *
+ * \note            Directly dispatched events are called from processing thread with core lock held,
+ *                  like when feature is disabled. Deferred functions must not block when
+ *                  \ref LWCELL_EVT_DEFER_OVERFLOW_DIRECT is used
+ */
+#ifndef LWCELL_CFG_EVT_DEFER_OVERFLOW
+#define LWCELL_CFG_EVT_DEFER_OVERFLOW LWCELL_EVT_DEFER_OVERFLOW_DROP
+#endif
+
 /**
  * \brief           Enables `1` or disables `0` custom memory byte pool extension for ThreadX port
  *
@@ -528,6 +862,16 @@
 #define LWCELL_CFG_NETCONN_RECEIVE_QUEUE_LEN 8
 #endif
 
+/**
+ * \brief           Enables `1` or disables `0` waiting on multiple netconns with \ref lwcell_netconn_poll
+ *
+ * Single thread can serve several connections, instead of blocking
+ * in \ref lwcell_netconn_receive on every connection in its own thread
+ */
+#ifndef LWCELL_CFG_NETCONN_POLL
+#define LWCELL_CFG_NETCONN_POLL 0
+#endif
+
 /**
  * \}
  */
@@ -665,6 +1009,73 @@
 #define LWCELL_CFG_USSD 0
 #endif
 
+/**
+ * \brief           Enables `1` or disables `0` GSM 07.10 / 3GPP 27.010 multiplexer in basic mode.
+ *
+ * When multiplexer is started with \ref lwcell_cmux_start, all AT traffic runs over DLCI `1`
+ * and additional virtual channels can be used with \ref lwcell_cmux_write and \ref lwcell_cmux_read
+ */
+#ifndef LWCELL_CFG_CMUX
+#define LWCELL_CFG_CMUX 0
+#endif
+
+/**
+ * \brief           Number of multiplexer channels opened on start, including AT channel
+ *
+ * DLCI `1` is always used for AT commands, DLCIs `2` to this value are available to application
+ *
+ * \note            Used only when \ref LWCELL_CFG_CMUX is enabled
+ */
+#ifndef LWCELL_CFG_CMUX_CHANNELS
+#define LWCELL_CFG_CMUX_CHANNELS 2
+#endif
+
+/**
+ * \brief           Maximum information field length of multiplexer frame in units of bytes
+ *
+ * Value is sent to device as `N1` parameter of `AT+CMUX` command.
+ * Two static buffers of this size are used, one for transmit and one for receive.
+ *
+ * \note            Used only when \ref LWCELL_CFG_CMUX is enabled
+ */
+#ifndef LWCELL_CFG_CMUX_N1
+#define LWCELL_CFG_CMUX_N1 127
+#endif
+
+/**
+ * \brief           Size of receive buffer of each multiplexer channel in units of bytes
+ *
+ * Buffers are allocated when multiplexer is started and freed when it is stopped
+ *
+ * \note            Used only when \ref LWCELL_CFG_CMUX is enabled
+ */
+#ifndef LWCELL_CFG_CMUX_CH_BUFF_SIZE
+#define LWCELL_CFG_CMUX_CH_BUFF_SIZE 1024
+#endif
+
+/**
+ * \brief           Enables `1` or disables `0` PPP data mode for IP stack on host side
+ *
+ * Device is dialled with `ATD*99#` and link is negotiated with LCP, optional PAP and IPCP.
+ * IP packets are exchanged with application as packet buffers, bypassing internal TCP/IP stack of the device
+ *
+ * \note            \ref LWCELL_CFG_NETWORK must be enabled to use PPP
+ */
+#ifndef LWCELL_CFG_PPP
+#define LWCELL_CFG_PPP 0
+#endif
+
+/**
+ * \brief           Maximum receive unit of PPP link in units of bytes
+ *
+ * Size of single static receive frame buffer and value requested from peer during LCP negotiation
+ *
+ * \note            Used only when \ref LWCELL_CFG_PPP is enabled
+ */
+#ifndef LWCELL_CFG_PPP_MRU
+#define LWCELL_CFG_PPP_MRU 1500
+#endif
+
 /**
  * \}
  */
@@ -742,8 +1153,32 @@ void *  my_memset(void* dst, int b, size_t len);
 #if LWCELL_CFG_INPUT_USE_PROCESS
 #error "LWCELL_CFG_INPUT_USE_PROCESS may only be enabled when OS is used!"
 #endif /* LWCELL_CFG_INPUT_USE_PROCESS */
+#if LWCELL_CFG_EVT_DEFER
+#error "LWCELL_CFG_EVT_DEFER may only be enabled when OS is used!"
+#endif /* LWCELL_CFG_EVT_DEFER */
 #endif /* !LWCELL_CFG_OS */
 
+#if LWCELL_CFG_CMUX
+#if LWCELL_CFG_CMUX_CHANNELS < 1 || LWCELL_CFG_CMUX_CHANNELS > 63
+#error "LWCELL_CFG_CMUX_CHANNELS must be between 1 and 63!"
+#endif /* LWCELL_CFG_CMUX_CHANNELS < 1 || LWCELL_CFG_CMUX_CHANNELS > 63 */
+#if LWCELL_CFG_CMUX_N1 < 1 || LWCELL_CFG_CMUX_N1 > 32767
+#error "LWCELL_CFG_CMUX_N1 must be between 1 and 32767!"
+#endif /* LWCELL_CFG_CMUX_N1 < 1 || LWCELL_CFG_CMUX_N1 > 32767 */
+#endif /* LWCELL_CFG_CMUX */
+
+#if LWCELL_CFG_STATS && (LWCELL_CFG_STATS_HIST_LEN < 2 || LWCELL_CFG_STATS_HIST_LEN > 33)
+#error "LWCELL_CFG_STATS_HIST_LEN must be between 2 and 33!"
+#endif /* LWCELL_CFG_STATS && (LWCELL_CFG_STATS_HIST_LEN < 2 || LWCELL_CFG_STATS_HIST_LEN > 33) */
+
+#if LWCELL_CFG_EVT_DEFER && LWCELL_CFG_EVT_DEFER_LEN < 1
+#error "LWCELL_CFG_EVT_DEFER_LEN must be at least 1!"
+#endif /* LWCELL_CFG_EVT_DEFER && LWCELL_CFG_EVT_DEFER_LEN < 1 */
+
+#if LWCELL_CFG_PPP && !LWCELL_CFG_NETWORK
+#error "LWCELL_CFG_NETWORK must be enabled when LWCELL_CFG_PPP is used!"
+#endif /* LWCELL_CFG_PPP && !LWCELL_CFG_NETWORK */
+
 #endif /* !__DOXYGEN__ */
 
 #include "lwcell/lwcell_debug.h"
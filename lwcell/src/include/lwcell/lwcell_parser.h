@@ -68,6 +68,8 @@ uint8_t lwcelli_parse_cpbf(const char* str);
 uint8_t lwcelli_parse_cipstatus_conn(const char* str, uint8_t is_conn_line, uint8_t* continueScan);
 
 uint8_t lwcelli_parse_ipd(const char* str);
+uint8_t lwcelli_parse_cipack(const char* str, lwcell_conn_p conn);
+uint8_t lwcelli_parse_ciprxget(const char* str);
 
 #if defined(__cplusplus)
 }
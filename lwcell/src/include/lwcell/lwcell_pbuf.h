@@ -58,6 +58,7 @@ size_t lwcell_pbuf_copy(lwcell_pbuf_p pbuf, void* data, size_t len, size_t offse
 lwcellr_t lwcell_pbuf_cat(lwcell_pbuf_p head, const lwcell_pbuf_p tail);
 lwcellr_t lwcell_pbuf_cat_s(lwcell_pbuf_p head, lwcell_pbuf_p* tail);
 lwcellr_t lwcell_pbuf_chain(lwcell_pbuf_p head, lwcell_pbuf_p tail);
+lwcell_pbuf_p lwcell_pbuf_unchain(lwcell_pbuf_p head);
 lwcellr_t lwcell_pbuf_ref(lwcell_pbuf_p pbuf);
 
 uint8_t lwcell_pbuf_get_at(const lwcell_pbuf_p pbuf, size_t pos, uint8_t* el);
@@ -73,6 +74,8 @@ void* lwcell_pbuf_get_linear_addr(const lwcell_pbuf_p pbuf, size_t offset, size_
 
 void lwcell_pbuf_set_ip(lwcell_pbuf_p pbuf, const lwcell_ip_t* ip, lwcell_port_t port);
 
+size_t lwcell_pbuf_pool_get_stats(lwcell_pbuf_pool_stat_t* stats, size_t btr);
+
 /**
  * \}
  */
@@ -0,0 +1,75 @@
+/**
+ * \file            lwcell_ppp.h
+ * \brief           PPP link with HDLC-like framing
+ */
+
+/*
+ * Copyright (c) 2023 Tilen MAJERLE
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without restriction,
+ * including without limitation the rights to use, copy, modify, merge,
+ * publish, distribute, sublicense, and/or sell copies of the Software,
+ * and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE
+ * AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * This file is part of LwCELL - Lightweight cellular modem AT library.
+ *
+ * Author:          Tilen MAJERLE <tilen@majerle.eu>
+ * Version:         v0.1.1
+ */
+#ifndef LWCELL_PPP_HDR_H
+#define LWCELL_PPP_HDR_H
+
+#include "lwcell/lwcell_types.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif /* __cplusplus */
+
+/**
+ * \ingroup         LWCELL
+ * \defgroup        LWCELL_PPP PPP data mode
+ * \brief           Point-to-point protocol link for IP stack running on host
+ * \{
+ *
+ * Device is dialled with `ATD*99#` and, once it replies with `CONNECT`,
+ * link is negotiated with LCP, optional PAP authentication and IPCP.
+ * \ref LWCELL_EVT_PPP_UP is sent when IP packets may be exchanged,
+ * \ref LWCELL_EVT_PPP_DOWN when link is terminated or negotiation fails.
+ *
+ * Received IP packets are passed to \ref lwcell_ppp_input_fn as packet buffers,
+ * packets from IP stack are sent with \ref lwcell_ppp_output.
+ * AT commands are rejected while device is in PPP data mode.
+ */
+
+lwcellr_t lwcell_ppp_start(const char* apn, const char* user, const char* pass, lwcell_ppp_input_fn input_fn,
+                           void* input_arg, const lwcell_api_cmd_evt_fn evt_fn, void* const evt_arg,
+                           const uint32_t blocking);
+lwcellr_t lwcell_ppp_stop(const lwcell_api_cmd_evt_fn evt_fn, void* const evt_arg, const uint32_t blocking);
+lwcellr_t lwcell_ppp_output(const lwcell_pbuf_p pbuf);
+uint8_t lwcell_ppp_is_up(void);
+lwcellr_t lwcell_ppp_get_ip(lwcell_ip_t* ip, lwcell_ip_t* dns1, lwcell_ip_t* dns2);
+
+/**
+ * \}
+ */
+
+#ifdef __cplusplus
+}
+#endif /* __cplusplus */
+
+#endif /* LWCELL_PPP_HDR_H */
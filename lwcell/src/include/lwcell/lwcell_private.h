@@ -44,6 +44,9 @@
 #include "lwcell/lwcell_timeout.h"
 #include "lwcell/lwcell_types.h"
 #include "lwcell/lwcell_unicode.h"
+#if LWCELL_CFG_EVT_DEFER
+#include <stdatomic.h>
+#endif /* LWCELL_CFG_EVT_DEFER */
 
 #ifdef __cplusplus
 extern "C" {
@@ -75,8 +78,14 @@ typedef enum {
     LWCELL_CMD_CGATT_SET_1,
     LWCELL_CMD_NETWORK_ATTACH, /*!< Attach to a network */
     LWCELL_CMD_NETWORK_DETACH, /*!< Detach from network */
+    LWCELL_CMD_PPP_START,      /*!< Define PDP context for packet data call */
+    LWCELL_CMD_ATD_PPP,        /*!< Dial packet data service and enter PPP data mode */
+    LWCELL_CMD_PPP_STOP,       /*!< Terminate PPP link and wait for device to return to command mode */
 
     LWCELL_CMD_CIPMUX_SET,
+    LWCELL_CMD_CIPMUX_SET_0,
+    LWCELL_CMD_CIPMODE_SET_0,
+    LWCELL_CMD_CIPMODE_SET_1,
     LWCELL_CMD_CIPRXGET_SET,
     LWCELL_CMD_CSTT_SET,
 
@@ -187,6 +196,8 @@ typedef enum {
     LWCELL_CMD_VTD,      /*!< Tone Duration */
     LWCELL_CMD_VTS,      /*!< DTMF and Tone Generation */
     LWCELL_CMD_CMUX,     /*!< Multiplexer Control */
+    LWCELL_CMD_CMUX_AT,  /*!< Check AT channel after multiplexer has been started */
+    LWCELL_CMD_CMUX_CLD, /*!< Close down multiplexer and check AT port in normal mode */
     LWCELL_CMD_CPOL,     /*!< Preferred Operator List */
     LWCELL_CMD_COPN,     /*!< Read Operator Names */
     LWCELL_CMD_CCLK,     /*!< Clock */
@@ -203,37 +214,38 @@ typedef enum {
     LWCELL_CMD_CUSD,     /*!< Unstructured Supplementary Service Data, Execute command */
     LWCELL_CMD_CSSN,     /*!< Supplementary Services Notification */
 
-    LWCELL_CMD_CIPMUX,     /*!< Start Up Multi-IP Connection */
-    LWCELL_CMD_CIPSTART,   /*!< Start Up TCP or UDP Connection */
-    LWCELL_CMD_CIPSEND,    /*!< Send Data Through TCP or UDP Connection */
-    LWCELL_CMD_CIPQSEND,   /*!< Select Data Transmitting Mode */
-    LWCELL_CMD_CIPACK,     /*!< Query Previous Connection Data Transmitting State */
-    LWCELL_CMD_CIPCLOSE,   /*!< Close TCP or UDP Connection */
-    LWCELL_CMD_CIPSHUT,    /*!< Deactivate GPRS PDP Context */
-    LWCELL_CMD_CLPORT,     /*!< Set Local Port */
-    LWCELL_CMD_CSTT,       /*!< Start Task and Set APN, username, password */
-    LWCELL_CMD_CIICR,      /*!< Bring Up Wireless Connection with GPRS or CSD */
-    LWCELL_CMD_CIFSR,      /*!< Get Local IP Address */
-    LWCELL_CMD_CIPSTATUS,  /*!< Query Current Connection Status */
-    LWCELL_CMD_CDNSCFG,    /*!< Configure Domain Name Server */
-    LWCELL_CMD_CDNSGIP,    /*!< Query the IP Address of Given Domain Name */
-    LWCELL_CMD_CIPHEAD,    /*!< Add an IP Head at the Beginning of a Package Received */
-    LWCELL_CMD_CIPATS,     /*!< Set Auto Sending Timer */
-    LWCELL_CMD_CIPSPRT,    /*!< Set Prompt of greater than sign When Module Sends Data */
-    LWCELL_CMD_CIPSERVER,  /*!< Configure Module as Server */
-    LWCELL_CMD_CIPCSGP,    /*!< Set CSD or GPRS for Connection Mode */
-    LWCELL_CMD_CIPSRIP,    /*!< Show Remote IP Address and Port When Received Data */
-    LWCELL_CMD_CIPDPDP,    /*!< Set Whether to Check State of GPRS Network Timing */
-    LWCELL_CMD_CIPMODE,    /*!< Select TCPIP Application Mode */
-    LWCELL_CMD_CIPCCFG,    /*!< Configure Transparent Transfer Mode */
-    LWCELL_CMD_CIPSHOWTP,  /*!< Display Transfer Protocol in IP Head When Received Data */
-    LWCELL_CMD_CIPUDPMODE, /*!< UDP Extended Mode */
-    LWCELL_CMD_CIPRXGET,   /*!< Get Data from Network Manually */
-    LWCELL_CMD_CIPSCONT,   /*!< Save TCPIP Application Context */
-    LWCELL_CMD_CIPRDTIMER, /*!< Set Remote Delay Timer */
-    LWCELL_CMD_CIPSGTXT,   /*!< Select GPRS PDP context */
-    LWCELL_CMD_CIPTKA,     /*!< Set TCP Keepalive Parameters */
-    LWCELL_CMD_CIPSSL,     /*!< Connection SSL function */
+    LWCELL_CMD_CIPMUX,       /*!< Start Up Multi-IP Connection */
+    LWCELL_CMD_CIPSTART,     /*!< Start Up TCP or UDP Connection */
+    LWCELL_CMD_CIPSEND,      /*!< Send Data Through TCP or UDP Connection */
+    LWCELL_CMD_CIPQSEND,     /*!< Select Data Transmitting Mode */
+    LWCELL_CMD_CIPACK,       /*!< Query Previous Connection Data Transmitting State */
+    LWCELL_CMD_CIPCLOSE,     /*!< Close TCP or UDP Connection */
+    LWCELL_CMD_CIPSHUT,      /*!< Deactivate GPRS PDP Context */
+    LWCELL_CMD_CLPORT,       /*!< Set Local Port */
+    LWCELL_CMD_CSTT,         /*!< Start Task and Set APN, username, password */
+    LWCELL_CMD_CIICR,        /*!< Bring Up Wireless Connection with GPRS or CSD */
+    LWCELL_CMD_CIFSR,        /*!< Get Local IP Address */
+    LWCELL_CMD_CIPSTATUS,    /*!< Query Current Connection Status */
+    LWCELL_CMD_CDNSCFG,      /*!< Configure Domain Name Server */
+    LWCELL_CMD_CDNSGIP,      /*!< Query the IP Address of Given Domain Name */
+    LWCELL_CMD_CIPHEAD,      /*!< Add an IP Head at the Beginning of a Package Received */
+    LWCELL_CMD_CIPATS,       /*!< Set Auto Sending Timer */
+    LWCELL_CMD_CIPSPRT,      /*!< Set Prompt of greater than sign When Module Sends Data */
+    LWCELL_CMD_CIPSERVER,    /*!< Configure Module as Server */
+    LWCELL_CMD_CIPCSGP,      /*!< Set CSD or GPRS for Connection Mode */
+    LWCELL_CMD_CIPSRIP,      /*!< Show Remote IP Address and Port When Received Data */
+    LWCELL_CMD_CIPDPDP,      /*!< Set Whether to Check State of GPRS Network Timing */
+    LWCELL_CMD_CIPMODE,      /*!< Select TCPIP Application Mode */
+    LWCELL_CMD_CIPCCFG,      /*!< Configure Transparent Transfer Mode */
+    LWCELL_CMD_CIPSHOWTP,    /*!< Display Transfer Protocol in IP Head When Received Data */
+    LWCELL_CMD_CIPUDPMODE,   /*!< UDP Extended Mode */
+    LWCELL_CMD_CIPRXGET,     /*!< Get Data from Network Manually */
+    LWCELL_CMD_CIPRXGET_LEN, /*!< Query number of received bytes waiting to be read manually */
+    LWCELL_CMD_CIPSCONT,     /*!< Save TCPIP Application Context */
+    LWCELL_CMD_CIPRDTIMER,   /*!< Set Remote Delay Timer */
+    LWCELL_CMD_CIPSGTXT,     /*!< Select GPRS PDP context */
+    LWCELL_CMD_CIPTKA,       /*!< Set TCP Keepalive Parameters */
+    LWCELL_CMD_CIPSSL,       /*!< Connection SSL function */
 
     LWCELL_CMD_SMS_ENABLE,
     LWCELL_CMD_CMGD,         /*!< Delete SMS Message */
@@ -277,18 +289,26 @@ typedef struct lwcell_conn {
 
     lwcell_linbuff_t buff; /*!< Linear buffer structure */
 
-    size_t total_recved; /*!< Total number of bytes received */
+    size_t total_recved;   /*!< Total number of bytes received */
+    size_t tx_unacked;     /*!< Number of bytes accepted by device but not yet acknowledged by remote side.
+                                                     Used in quick send mode only */
+    size_t rx_avail;       /*!< Number of bytes waiting in device to be read in manual receive mode */
+    size_t rx_unconfirmed; /*!< Number of bytes sent to application but not yet confirmed */
+    size_t rx_pbufs;       /*!< Number of packet buffers sent to application but not yet confirmed */
 
     union {
         struct {
-            uint8_t active        : 1; /*!< Status whether connection is active */
-            uint8_t client        : 1; /*!< Status whether connection is in client mode */
-            uint8_t data_received : 1; /*!< Status whether first data were received on connection */
-            uint8_t in_closing    : 1; /*!< Status if connection is in closing mode.
+            uint8_t active           : 1; /*!< Status whether connection is active */
+            uint8_t client           : 1; /*!< Status whether connection is in client mode */
+            uint8_t data_received    : 1; /*!< Status whether first data were received on connection */
+            uint8_t in_closing       : 1; /*!< Status if connection is in closing mode.
                                                     When in closing mode, ignore any possible received data from function */
-            uint8_t bearer        : 1; /*!< Bearer used. Can be `1` or `0` */
-        } f;                           /*!< Connection flags */
-    } status;                          /*!< Connection status union with flag bits */
+            uint8_t bearer           : 1; /*!< Bearer used. Can be `1` or `0` */
+            uint8_t rx_avail_unknown : 1; /*!< Device reported new data in manual receive mode, length is unknown */
+            uint8_t rx_queued        : 1; /*!< Command to read data in manual receive mode is in message queue */
+            uint8_t rx_retry         : 1; /*!< Timeout to retry reading data in manual receive mode is active */
+        } f;                              /*!< Connection flags */
+    } status;                             /*!< Connection status union with flag bits */
 } lwcell_conn_t;
 
 /**
@@ -319,6 +339,18 @@ typedef struct {
     lwcell_pbuf_p buff; /*!< Pointer to data buffer used for receiving data */
 } lwcell_ipd_t;
 
+/**
+ * \brief           Transparent data mode state
+ */
+typedef struct {
+    lwcell_conn_p conn;          /*!< Connection in transparent mode, `NULL` when not used */
+    uint8_t data_mode;           /*!< Set to `1` when device is in data mode and all input is connection data */
+    uint8_t escaping;            /*!< Set to `1` when escape sequence is in progress and data may not be sent */
+    const char* match;           /*!< Status marker currently being matched in received data */
+    uint8_t match_len;           /*!< Number of received bytes matching `match`, held back from connection */
+    lwcell_timeout_handle_t tmr; /*!< Timeout resolving held back bytes when line stays idle */
+} lwcell_transp_t;
+
 /**
  * \brief           Connection result on connect command
  */
@@ -329,6 +361,15 @@ typedef enum {
     LWCELL_CONN_CONNECT_ALREADY, /*!< Already connected */
 } lwcell_conn_connect_res_t;
 
+/**
+ * \brief           Memory type of command message
+ */
+typedef enum {
+    LWCELL_MSG_MEM_HEAP = 0x00, /*!< Message allocated from heap */
+    LWCELL_MSG_MEM_POOL,        /*!< Message taken from static message pool */
+    LWCELL_MSG_MEM_STACK,       /*!< Message placed on caller stack */
+} lwcell_msg_mem_t;
+
 /**
  * \brief           Message queue structure to share between threads
  */
@@ -336,11 +377,17 @@ typedef struct lwcell_msg {
     lwcell_cmd_t cmd_def; /*!< Default message type received from queue */
     lwcell_cmd_t cmd;     /*!< Since some commands can have different subcommands, sub command is used here */
     uint8_t i;           /*!< Variable to indicate order number of subcommands */
+    uint8_t seq_step;    /*!< Index of current step in command sequence */
+    uint8_t seq_tries;   /*!< Number of repetitions of current sequence step */
     lwcell_sys_sem_t sem; /*!< Semaphore for the message */
     uint8_t is_blocking; /*!< Status if command is blocking */
+    uint8_t mem_type;    /*!< Memory type of message, member of \ref lwcell_msg_mem_t enumeration */
     uint32_t block_time; /*!< Maximal blocking time in units of milliseconds. Use 0 to for non-blocking call */
     lwcellr_t res;        /*!< Result of message operation */
     lwcellr_t (*fn)(struct lwcell_msg*); /*!< Processing callback function to process packet */
+#if LWCELL_CFG_STATS || __DOXYGEN__
+    uint32_t stats_time; /*!< Time when message was put to producer queue */
+#endif                   /* LWCELL_CFG_STATS || __DOXYGEN__ */
 
 #if LWCELL_CFG_USE_API_FUNC_EVT
     lwcell_api_cmd_evt_fn evt_fn; /*!< Command callback API function */
@@ -382,10 +429,6 @@ typedef struct lwcell_msg {
             const char* pin; /*!< New PIN code */
         } cpuk_enter;        /*!< Enter PUK and new PIN */
 
-        struct {
-            size_t cnum_tries; /*!< Number of tries */
-        } sim_info;            /*!< Get information for SIM card */
-
         struct {
             char* str;  /*!< Pointer to output string array */
             size_t len; /*!< Length of output string array including trailing zero memory */
@@ -432,21 +475,37 @@ typedef struct lwcell_msg {
             uint8_t val_id;     /*!< Connection current validation ID when command was sent to queue */
         } conn_close;           /*!< Close connection */
 
+        struct {
+            uint8_t en;             /*!< Set to `1` to enable server, `0` to disable it */
+            lwcell_port_t port;     /*!< Local port to listen on */
+            lwcell_evt_fn evt_func; /*!< Callback function for every incoming connection */
+        } tcpip_server;             /*!< Server configuration */
+
         struct {
             lwcell_conn_t* conn;          /*!< Pointer to connection to send data */
             size_t btw;                  /*!< Number of remaining bytes to write */
             size_t ptr;                  /*!< Current write pointer for data */
             const uint8_t* data;         /*!< Data to send */
+            const lwcell_iovec_t* iov;   /*!< Data segments to send, used when `data` is `NULL` */
+            size_t iov_cnt;              /*!< Number of entries in `iov` array */
+            lwcell_pbuf_p pbuf;          /*!< Packet buffer chain to send, used when `data` and `iov` are `NULL` */
             size_t sent;                 /*!< Number of bytes sent in last packet */
             size_t sent_all;             /*!< Number of bytes sent all together */
             uint8_t tries;               /*!< Number of tries used for last packet */
             uint8_t wait_send_ok_err;    /*!< Set to 1 when we wait for SEND OK or SEND ERROR */
+            lwcell_timeout_handle_t ack_tmr; /*!< Timeout to query acknowledged bytes again in quick send mode */
             const lwcell_ip_t* remote_ip; /*!< Remote IP address for UDP connection */
             lwcell_port_t remote_port;    /*!< Remote port address for UDP connection */
             uint8_t fau;                 /*!< Free after use flag to free memory after data are sent (or not) */
             size_t* bw;                  /*!< Number of bytes written so far */
             uint8_t val_id;              /*!< Connection current validation ID when command was sent to queue */
         } conn_send;                     /*!< Structure to send data on connection */
+
+        struct {
+            lwcell_conn_t* conn; /*!< Pointer to connection to read data from */
+            uint8_t val_id;      /*!< Connection current validation ID when command was sent to queue */
+            lwcell_pbuf_p pbuf;  /*!< Packet buffer for data, allocated before read command is sent */
+        } conn_recv;             /*!< Read received data in manual receive mode */
 #endif                                   /* LWCELL_CFG_CONN || __DOXYGEN__ */
 #if LWCELL_CFG_SMS || __DOXYGEN__
         struct {
@@ -538,6 +597,15 @@ typedef struct lwcell_msg {
             const char* pass; /*!< APN password */
         } network_attach;     /*!< Settings for network attach */
 #endif                        /* LWCELL_CFG_NETWORK || __DOXYGEN__ */
+#if LWCELL_CFG_PPP || __DOXYGEN__
+        struct {
+            const char* apn;             /*!< APN address */
+            const char* user;            /*!< PAP username */
+            const char* pass;            /*!< PAP password */
+            lwcell_ppp_input_fn input_fn; /*!< Function receiving IP packets */
+            void* input_arg;             /*!< Custom argument for input function */
+        } ppp_start;                     /*!< Settings for PPP link start */
+#endif                                   /* LWCELL_CFG_PPP || __DOXYGEN__ */
     } msg;                    /*!< Group of different possible message contents */
 } lwcell_msg_t;
 
@@ -570,8 +638,61 @@ typedef struct {
 typedef struct lwcell_evt_func {
     struct lwcell_evt_func* next; /*!< Next function in the list */
     lwcell_evt_fn fn;             /*!< Function pointer itself */
+    lwcell_evt_mask_t mask;       /*!< Bitmask of event types function receives */
+    uint8_t defer;                /*!< Set to `1` if function is called from deferred dispatch */
 } lwcell_evt_func_t;
 
+/**
+ * \brief           Registered callback functions grouped by event type
+ *
+ * Functions for event type `t` are stored in `fns[first[t]]` up to `fns[first[t + 1] - 1]`,
+ * in the same order as they were registered.
+ * With \ref LWCELL_CFG_EVT_DEFER, functions called from deferred dispatch
+ * start at `fns[defer[t]]`, after functions called directly
+ */
+typedef struct {
+    uint16_t first[LWCELL_EVT_END + 1]; /*!< Index of first function of each event type in `fns` array */
+#if LWCELL_CFG_EVT_DEFER || __DOXYGEN__
+    uint16_t defer[LWCELL_EVT_END]; /*!< Index of first deferred function of each event type in `fns` array */
+    atomic_uint ref;                /*!< Number of references, one for current table and one per queued event */
+#endif                              /* LWCELL_CFG_EVT_DEFER || __DOXYGEN__ */
+    lwcell_evt_fn* fns;             /*!< Functions of all event types, allocated together with structure */
+} lwcell_evt_tbl_t;
+
+#if LWCELL_CFG_EVT_DEFER || __DOXYGEN__
+
+/**
+ * \brief           Single entry of deferred event queue
+ */
+typedef struct {
+    lwcell_evt_t evt;      /*!< Copy of event structure */
+    uint32_t time;         /*!< Time when event was generated, in units of milliseconds */
+    lwcell_evt_tbl_t* tbl; /*!< Referenced table with functions to call, or `NULL` to check linked list */
+
+    union {
+        lwcell_operator_curr_t operator_current; /*!< Copy of current operator */
+#if LWCELL_CFG_CALL || __DOXYGEN__
+        lwcell_call_t call; /*!< Copy of call information */
+#endif                      /* LWCELL_CFG_CALL || __DOXYGEN__ */
+    } data;                 /*!< Copy of data event points to, as original may change before dispatch */
+} lwcell_evt_defer_entry_t;
+
+/**
+ * \brief           Deferred dispatch statistics, modified only by dispatching thread
+ *
+ * Fields are atomic as they are read by \ref lwcell_evt_get_defer_stat from any thread,
+ * without synchronization with dispatching thread
+ */
+typedef struct {
+    atomic_uint dispatched;                   /*!< Number of events taken from queue and dispatched */
+    atomic_uint lat_last;                     /*!< Latency of last dispatched event */
+    atomic_uint lat_max;                      /*!< Maximal latency of all dispatched events */
+    atomic_uint lat_total;                    /*!< Sum of latencies of all dispatched events */
+    atomic_uint lat_max_type[LWCELL_EVT_END]; /*!< Maximal latency per event type */
+} lwcell_evt_defer_disp_stat_t;
+
+#endif /* LWCELL_CFG_EVT_DEFER || __DOXYGEN__ */
+
 /**
  * \ingroup         LWCELL_SMS
  * \brief           SMS memory information
@@ -634,6 +755,65 @@ typedef struct {
     lwcell_ip_t ip_addr;  /*!< Device IP address when network PDP context is enabled */
 } lwcell_network_t;
 
+#if LWCELL_CFG_PPP || __DOXYGEN__
+
+/**
+ * \ingroup         LWCELL_PPP
+ * \brief           PPP link phase, as defined in RFC 1661
+ */
+typedef enum {
+    LWCELL_PPP_PHASE_DEAD = 0x00, /*!< Link is down, device is in command mode */
+    LWCELL_PPP_PHASE_ESTABLISH,   /*!< LCP negotiation in progress */
+    LWCELL_PPP_PHASE_AUTHENTICATE, /*!< PAP authentication in progress */
+    LWCELL_PPP_PHASE_NETWORK,     /*!< IPCP negotiation in progress */
+    LWCELL_PPP_PHASE_RUNNING,     /*!< IP packets may be exchanged */
+    LWCELL_PPP_PHASE_TERMINATE,   /*!< Link termination in progress */
+} lwcell_ppp_phase_t;
+
+/**
+ * \ingroup         LWCELL_PPP
+ * \brief           Control protocol negotiation state, used for LCP and IPCP
+ */
+typedef struct {
+    uint8_t id;        /*!< Identifier of last configure request sent */
+    uint8_t req_acked; /*!< Set to `1` when peer acknowledged our configure request */
+    uint8_t ack_sent;  /*!< Set to `1` when we acknowledged configure request of peer */
+    uint8_t rejected;  /*!< Bit mask of our options rejected by peer */
+} lwcell_ppp_cp_t;
+
+/**
+ * \ingroup         LWCELL_PPP
+ * \brief           PPP link state
+ */
+typedef struct {
+    uint8_t data_mode;            /*!< Set to `1` when device is in PPP data mode */
+    lwcell_ppp_phase_t phase;     /*!< Current link phase */
+    lwcell_ppp_input_fn input_fn; /*!< Function receiving IP packets */
+    void* input_arg;              /*!< Custom argument for input function */
+    char user[32];                /*!< PAP username */
+    char pass[32];                /*!< PAP password */
+    uint8_t auth;                 /*!< Set to `1` when peer requires PAP authentication */
+    uint8_t retries;              /*!< Number of requests sent in current phase without reply */
+    uint8_t id;                   /*!< Identifier for PAP and terminate requests */
+    uint32_t magic;               /*!< Our LCP magic number */
+    uint32_t tx_accm;             /*!< Asynchronous control character map of peer */
+    uint16_t peer_mru;            /*!< Maximum receive unit of peer */
+
+    lwcell_ppp_cp_t lcp;          /*!< LCP negotiation state */
+    lwcell_ppp_cp_t ipcp;         /*!< IPCP negotiation state */
+    lwcell_ip_t ip;               /*!< Local IP address assigned by peer */
+    lwcell_ip_t dns[2];           /*!< Primary and secondary DNS server */
+
+    uint8_t rx_esc;                       /*!< Set to `1` when previous byte was control escape */
+    uint8_t rx_drop;                      /*!< Set to `1` when current frame is discarded */
+    uint8_t rx_nc;                        /*!< Number of `NO CARRIER` bytes matched at the end of previous data */
+    uint16_t rx_fcs;                      /*!< Running frame check sequence of received frame */
+    size_t rx_len;                        /*!< Number of bytes in receive buffer */
+    uint8_t rx[LWCELL_CFG_PPP_MRU + 8];   /*!< Received frame, including header and frame check sequence */
+} lwcell_ppp_t;
+
+#endif /* LWCELL_CFG_PPP || __DOXYGEN__ */
+
 /**
  * \brief           GSM modules structure
  */
@@ -657,6 +837,11 @@ typedef struct {
     lwcell_conn_t conns[LWCELL_CFG_MAX_CONNS]; /*!< Array of all connection structures */
     lwcell_ipd_t ipd;                         /*!< Connection incoming data structure */
     uint8_t conn_val_id;                     /*!< Validation ID increased each time device connects to network */
+    lwcell_port_t server_port;               /*!< Local port of active server, `0` when server is disabled */
+    lwcell_evt_fn server_evt_func;           /*!< Callback function for every incoming server connection */
+#if LWCELL_CFG_CONN_TRANSPARENT || __DOXYGEN__
+    lwcell_transp_t transp; /*!< Transparent data mode state */
+#endif                      /* LWCELL_CFG_CONN_TRANSPARENT || __DOXYGEN__ */
 #endif                                       /* LWCELL_CFG_CONNS || __DOXYGEN__ */
 #if LWCELL_CFG_SMS || __DOXYGEN__
     lwcell_sms_t sms; /*!< SMS information */
@@ -667,8 +852,61 @@ typedef struct {
 #if LWCELL_CFG_CALL || __DOXYGEN__
     lwcell_call_t call; /*!< Call information */
 #endif                 /* LWCELL_CFG_CALL || __DOXYGEN__ */
+#if LWCELL_CFG_PPP || __DOXYGEN__
+    lwcell_ppp_t ppp; /*!< PPP link state */
+#endif                /* LWCELL_CFG_PPP || __DOXYGEN__ */
 } lwcell_modules_t;
 
+#if LWCELL_CFG_CMUX || __DOXYGEN__
+
+/**
+ * \ingroup         LWCELL_CMUX
+ * \brief           Multiplexer frame decoder state
+ */
+typedef enum {
+    LWCELL_CMUX_RX_FLAG = 0x00, /*!< Waiting for opening flag */
+    LWCELL_CMUX_RX_ADDR,        /*!< Waiting for address field */
+    LWCELL_CMUX_RX_CTRL,        /*!< Waiting for control field */
+    LWCELL_CMUX_RX_LEN1,        /*!< Waiting for first length octet */
+    LWCELL_CMUX_RX_LEN2,        /*!< Waiting for second length octet */
+    LWCELL_CMUX_RX_INFO,        /*!< Receiving information field */
+    LWCELL_CMUX_RX_FCS,         /*!< Waiting for frame check sequence */
+    LWCELL_CMUX_RX_CLOSE,       /*!< Waiting for closing flag */
+} lwcell_cmux_rx_state_t;
+
+/**
+ * \ingroup         LWCELL_CMUX
+ * \brief           Multiplexer virtual channel
+ */
+typedef struct {
+    lwcell_buff_t buff; /*!< Receive buffer of application channel, AT channel goes directly to parser */
+    uint8_t open;       /*!< Set to `1` when device confirmed channel with `UA` frame */
+} lwcell_cmux_ch_t;
+
+/**
+ * \ingroup         LWCELL_CMUX
+ * \brief           Multiplexer state
+ */
+typedef struct {
+    uint8_t active;               /*!< Set to `1` when all traffic to device is multiplexed */
+    lwcell_ll_send_fn ll_send_fn; /*!< Low-level send function, replaced by framing function while active */
+
+    lwcell_cmux_rx_state_t state;     /*!< Frame decoder state */
+    uint8_t addr;                     /*!< Address field of frame being received */
+    uint8_t ctrl;                     /*!< Control field of frame being received */
+    uint8_t fcs;                      /*!< Running frame check sequence of header */
+    size_t len;                       /*!< Information field length of frame being received */
+    size_t ptr;                       /*!< Number of information bytes received so far */
+    uint8_t info[LWCELL_CFG_CMUX_N1]; /*!< Information field of frame being received */
+
+    uint8_t tx[LWCELL_CFG_CMUX_N1]; /*!< AT channel data waiting to be framed */
+    size_t tx_len;                  /*!< Number of bytes in AT channel transmit buffer */
+
+    lwcell_cmux_ch_t ch[LWCELL_CFG_CMUX_CHANNELS + 1]; /*!< Channels, indexed by DLCI. DLCI `0` is control channel */
+} lwcell_cmux_t;
+
+#endif /* LWCELL_CFG_CMUX || __DOXYGEN__ */
+
 /**
  * \brief           GSM global structure
  */
@@ -684,11 +922,30 @@ typedef struct {
     lwcell_buff_t buff; /*!< Input processing buffer */
 #endif                 /* !LWCELL_CFG_INPUT_USE_PROCESS || __DOXYGEN__ */
     lwcell_ll_t ll;     /*!< Low level functions */
+#if LWCELL_CFG_CMUX || __DOXYGEN__
+    lwcell_cmux_t cmux; /*!< Multiplexer state, lays between low-level and AT parser */
+#endif                  /* LWCELL_CFG_CMUX || __DOXYGEN__ */
 
-    lwcell_msg_t* msg; /*!< Pointer to current user message being executed */
+    lwcell_msg_t* msg;               /*!< Pointer to current user message being executed */
+    lwcell_timeout_handle_t cmd_tmr; /*!< Timeout of current command, set from command descriptor */
 
     lwcell_evt_t evt;            /*!< Callback processing structure */
     lwcell_evt_func_t* evt_func; /*!< Callback function linked list */
+    lwcell_evt_tbl_t* evt_tbl;   /*!< Callback functions per event type, built from linked list */
+    uint8_t evt_tbl_dirty;       /*!< Set to `1` when linked list changed and table has to be rebuilt */
+    uint8_t evt_cb_depth;        /*!< Number of nested calls of event dispatcher */
+#if LWCELL_CFG_EVT_DEFER || __DOXYGEN__
+    lwcell_evt_defer_entry_t evt_defer[LWCELL_CFG_EVT_DEFER_LEN]; /*!< Deferred event queue */
+    atomic_size_t evt_defer_w;          /*!< Queue write index, only modified by thread generating events */
+    atomic_size_t evt_defer_r;          /*!< Queue read index, only modified by thread dispatching events */
+    lwcell_sys_sem_t evt_defer_sem;     /*!< Semaphore released on every new event in queue */
+    lwcell_evt_defer_stat_t evt_defer_stat; /*!< Deferred queue statistics, modified with core lock held.
+                                                    Dispatch fields are kept in `evt_defer_disp_stat` */
+    lwcell_evt_defer_disp_stat_t evt_defer_disp_stat; /*!< Deferred dispatch statistics */
+#if LWCELL_CFG_EVT_DEFER_THREAD || __DOXYGEN__
+    lwcell_sys_thread_t thread_evt; /*!< Deferred event dispatch thread handle */
+#endif                              /* LWCELL_CFG_EVT_DEFER_THREAD || __DOXYGEN__ */
+#endif                              /* LWCELL_CFG_EVT_DEFER || __DOXYGEN__ */
 
     lwcell_modules_t m; /*!< All modules. When resetting, reset structure */
 
@@ -747,29 +1004,28 @@ extern const size_t lwcell_dev_model_map_size;
 #define CRLF                       "\r\n"
 #define CRLF_LEN                   2
 
-#define LWCELL_MSG_VAR_DEFINE(name) lwcell_msg_t* name
-#define LWCELL_MSG_VAR_ALLOC(name, blocking)                                                                            \
+#if LWCELL_CFG_MSG_STACK_BLOCKING
+#define LWCELL_MSG_VAR_DEFINE(name)                                                                                    \
+    lwcell_msg_t name##_stack;                                                                                         \
+    lwcell_msg_t* name
+#define LWCELL_MSG_VAR_STACK(name, blocking) ((blocking) > 0 ? &name##_stack : NULL)
+#else /* LWCELL_CFG_MSG_STACK_BLOCKING */
+#define LWCELL_MSG_VAR_DEFINE(name)          lwcell_msg_t* name
+#define LWCELL_MSG_VAR_STACK(name, blocking) NULL
+#endif /* !LWCELL_CFG_MSG_STACK_BLOCKING */
+#define LWCELL_MSG_VAR_ALLOC(name, blocking)                                                                           \
     do {                                                                                                               \
-        (name) = lwcell_mem_malloc(sizeof(*(name)));                                                                    \
-        LWCELL_DEBUGW(LWCELL_CFG_DBG_VAR | LWCELL_DBG_TYPE_TRACE, (name) != NULL,                                         \
-                     "[MSG VAR] Allocated %d bytes at %p\r\n", (int)sizeof(*(name)), (void*)(name));                   \
-        LWCELL_DEBUGW(LWCELL_CFG_DBG_VAR | LWCELL_DBG_TYPE_TRACE, (name) == NULL,                                         \
-                     "[MSG VAR] Error allocating %d bytes\r\n", (int)sizeof(*(name)));                                 \
+        (name) = lwcelli_msg_alloc(LWCELL_MSG_VAR_STACK(name, blocking));                                              \
         if ((name) == NULL) {                                                                                          \
-            return lwcellERRMEM;                                                                                        \
+            return lwcellERRMEM;                                                                                       \
         }                                                                                                              \
-        LWCELL_MEMSET((name), 0x00, sizeof(*(name)));                                                                   \
-        (name)->is_blocking = LWCELL_U8((blocking) > 0);                                                                \
+        (name)->is_blocking = LWCELL_U8((blocking) > 0);                                                               \
     } while (0)
 #define LWCELL_MSG_VAR_REF(name) (*(name))
-#define LWCELL_MSG_VAR_FREE(name)                                                                                       \
+#define LWCELL_MSG_VAR_FREE(name)                                                                                      \
     do {                                                                                                               \
-        LWCELL_DEBUGF(LWCELL_CFG_DBG_VAR | LWCELL_DBG_TYPE_TRACE, "[MSG VAR] Free memory: %p\r\n", (void*)(name));        \
-        if (lwcell_sys_sem_isvalid(&((name)->sem))) {                                                                   \
-            lwcell_sys_sem_delete(&((name)->sem));                                                                      \
-            lwcell_sys_sem_invalid(&((name)->sem));                                                                     \
-        }                                                                                                              \
-        lwcell_mem_free_s((void**)&(name));                                                                             \
+        lwcelli_msg_free(name);                                                                                        \
+        (name) = NULL;                                                                                                 \
     } while (0)
 #if LWCELL_CFG_USE_API_FUNC_EVT
 #define LWCELL_MSG_VAR_SET_EVT(name, e_fn, e_arg)                                                                       \
@@ -798,23 +1054,52 @@ extern const size_t lwcell_dev_model_map_size;
 
 const char* lwcelli_dbg_msg_to_string(lwcell_cmd_t cmd);
 lwcellr_t lwcelli_process(const void* data, size_t len);
+lwcellr_t lwcelli_process_at(const void* data, size_t len);
 lwcellr_t lwcelli_process_buffer(void);
 lwcellr_t lwcelli_initiate_cmd(lwcell_msg_t* msg);
+lwcell_msg_t* lwcelli_msg_alloc(lwcell_msg_t* stack_msg);
+void lwcelli_msg_free(lwcell_msg_t* msg);
 uint8_t lwcelli_is_valid_conn_ptr(lwcell_conn_p conn);
 lwcellr_t lwcelli_send_cb(lwcell_evt_type_t type);
+lwcellr_t lwcelli_evt_register(lwcell_evt_fn fn, lwcell_evt_mask_t mask, uint8_t defer);
+#if LWCELL_CFG_EVT_DEFER
+void lwcelli_evt_defer_call(lwcell_evt_defer_entry_t* entry);
+#endif /* LWCELL_CFG_EVT_DEFER */
 lwcellr_t lwcelli_send_conn_cb(lwcell_conn_t* conn, lwcell_evt_fn cb);
 void lwcelli_conn_init(void);
 lwcellr_t lwcelli_send_msg_to_producer_mbox(lwcell_msg_t* msg, lwcellr_t (*process_fn)(lwcell_msg_t*),
                                           uint32_t max_block_time);
 uint32_t lwcelli_get_from_mbox_with_timeout_checks(lwcell_sys_mbox_t* b, void** m, uint32_t timeout);
 uint8_t lwcelli_conn_closed_process(uint8_t conn_num, uint8_t forced);
-void lwcelli_conn_start_timeout(lwcell_conn_p conn);
+lwcellr_t lwcelli_conn_start_timeout(lwcell_conn_p conn);
+lwcellr_t lwcelli_conn_manual_rx_read(lwcell_conn_p conn);
+void lwcelli_conn_manual_rx_done(lwcell_msg_t* msg, lwcellr_t res);
 
 lwcellr_t lwcelli_get_sim_info(const uint32_t blocking);
 
 void lwcelli_reset_everything(uint8_t forced);
 void lwcelli_process_events_for_timeout_or_error(lwcell_msg_t* msg, lwcellr_t err);
 
+#if LWCELL_CFG_STATS
+#define LWCELL_STATS_NO_EXEC 0xFFFFFFFF /*!< Execution time value of command that did not start */
+void lwcelli_stats_cmd(lwcell_cmd_t cmd, lwcellr_t res, uint32_t queue, uint32_t exec, uint32_t cb);
+#endif /* LWCELL_CFG_STATS */
+
+#if LWCELL_CFG_CMUX
+size_t lwcelli_cmux_process(const void* data, size_t len);
+lwcellr_t lwcelli_cmux_prepare(void);
+void lwcelli_cmux_activate(void);
+void lwcelli_cmux_close(uint8_t forced);
+#endif /* LWCELL_CFG_CMUX */
+
+#if LWCELL_CFG_PPP
+size_t lwcelli_ppp_process(const uint8_t* data, size_t len);
+lwcellr_t lwcelli_ppp_prepare(const lwcell_msg_t* msg);
+void lwcelli_ppp_connected(void);
+lwcellr_t lwcelli_ppp_terminate(void);
+void lwcelli_ppp_reset(void);
+#endif /* LWCELL_CFG_PPP */
+
 /**
  * \}
  */
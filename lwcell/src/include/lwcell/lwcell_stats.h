@@ -0,0 +1,91 @@
+/**
+ * \file            lwcell_stats.h
+ * \brief           Command latency statistics
+ */
+
+/*
+ * Copyright (c) 2023 Tilen MAJERLE
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without restriction,
+ * including without limitation the rights to use, copy, modify, merge,
+ * publish, distribute, sublicense, and/or sell copies of the Software,
+ * and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE
+ * AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * This file is part of LwCELL - Lightweight cellular modem AT library.
+ *
+ * Author:          Tilen MAJERLE <tilen@majerle.eu>
+ * Version:         v0.1.1
+ */
+#ifndef LWCELL_STATS_HDR_H
+#define LWCELL_STATS_HDR_H
+
+#include "lwcell/lwcell_types.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif /* __cplusplus */
+
+/**
+ * \ingroup         LWCELL
+ * \defgroup        LWCELL_STATS Command statistics
+ * \brief           Per-command latency histograms and queueing metrics
+ * \{
+ *
+ * Statistics are recorded for every command type, identified by its number as printed in debug output.
+ * Queue time is measured from the moment API function puts command to producer queue
+ * until producer thread takes it, execution time from start of the command
+ * until processing thread reports it finished or timeout expires.
+ *
+ * Long queue time points to commands waiting behind other long commands,
+ * long execution time to slow device, long callback time to slow application callback functions.
+ */
+
+#if LWCELL_CFG_STATS || __DOXYGEN__
+
+/**
+ * \brief           Statistics of single command type
+ * \note            All durations are in units of milliseconds
+ */
+typedef struct {
+    uint32_t count;                                 /*!< Number of processed commands */
+    uint32_t timeouts;                              /*!< Number of commands not finished within maximal time */
+    uint32_t errors;                                /*!< Number of commands finished with error other than timeout,
+                                                         including commands that could not be started */
+    uint32_t queue_max;                             /*!< Maximal time spent in producer queue */
+    uint32_t exec_max;                              /*!< Maximal execution time */
+    uint32_t cb_max;                                /*!< Maximal duration of command callback function */
+    uint32_t queue_hist[LWCELL_CFG_STATS_HIST_LEN]; /*!< Histogram of time spent in producer queue */
+    uint32_t exec_hist[LWCELL_CFG_STATS_HIST_LEN];  /*!< Histogram of execution time.
+                                                         Commands rejected before start are not counted */
+} lwcell_stats_cmd_t;
+
+size_t lwcell_stats_get(lwcell_stats_cmd_t* stats, size_t btr);
+size_t lwcell_stats_get_cmd_count(void);
+void lwcell_stats_reset(void);
+
+#endif /* LWCELL_CFG_STATS || __DOXYGEN__ */
+
+/**
+ * \}
+ */
+
+#ifdef __cplusplus
+}
+#endif /* __cplusplus */
+
+#endif /* LWCELL_STATS_HDR_H */
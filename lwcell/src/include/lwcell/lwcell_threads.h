@@ -42,6 +42,9 @@ extern "C" {
 
 void lwcell_thread_produce(void* const arg);
 void lwcell_thread_process(void* const arg);
+#if LWCELL_CFG_EVT_DEFER && LWCELL_CFG_EVT_DEFER_THREAD
+void lwcell_thread_evt(void* const arg);
+#endif /* LWCELL_CFG_EVT_DEFER && LWCELL_CFG_EVT_DEFER_THREAD */
 
 #ifdef __cplusplus
 }
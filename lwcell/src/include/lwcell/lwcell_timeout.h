@@ -48,6 +48,8 @@ extern "C" {
  */
 
 lwcellr_t lwcell_timeout_add(uint32_t time, lwcell_timeout_fn fn, void* arg);
+lwcellr_t lwcell_timeout_add_ex(uint32_t time, lwcell_timeout_fn fn, void* arg, lwcell_timeout_handle_t* handle);
+lwcellr_t lwcell_timeout_cancel(lwcell_timeout_handle_t handle);
 lwcellr_t lwcell_timeout_remove(lwcell_timeout_fn fn);
 
 /**
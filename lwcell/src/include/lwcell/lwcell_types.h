@@ -139,9 +139,11 @@ typedef struct {
  * \brief           List of possible connection types
  */
 typedef enum {
-    LWCELL_CONN_TYPE_TCP, /*!< Connection type is TCP */
-    LWCELL_CONN_TYPE_UDP, /*!< Connection type is UDP */
-    LWCELL_CONN_TYPE_SSL, /*!< Connection type is TCP over SSL */
+    LWCELL_CONN_TYPE_TCP,             /*!< Connection type is TCP */
+    LWCELL_CONN_TYPE_UDP,             /*!< Connection type is UDP */
+    LWCELL_CONN_TYPE_SSL,             /*!< Connection type is TCP over SSL */
+    LWCELL_CONN_TYPE_TCP_TRANSPARENT, /*!< Connection type is TCP in transparent data mode.
+                                            Requires \ref LWCELL_CFG_CONN_TRANSPARENT */
 } lwcell_conn_type_t;
 
 /**
@@ -344,12 +346,34 @@ struct lwcell_pbuf;
  */
 typedef struct lwcell_conn* lwcell_conn_p;
 
+/**
+ * \ingroup         LWCELL_CONN
+ * \brief           Single data segment for scatter-gather send
+ * \sa              lwcell_conn_sendv
+ */
+typedef struct {
+    const void* data; /*!< Pointer to segment data */
+    size_t len;       /*!< Length of segment in units of bytes */
+} lwcell_iovec_t;
+
 /**
  * \ingroup         LWCELL_PBUF
  * \brief           Pointer to \ref lwcell_pbuf_t structure
  */
 typedef struct lwcell_pbuf* lwcell_pbuf_p;
 
+/**
+ * \ingroup         LWCELL_PBUF
+ * \brief           Statistics of single packet buffer pool size class
+ */
+typedef struct {
+    size_t size;     /*!< Maximal payload length of buffer in class */
+    size_t count;    /*!< Number of buffers in class */
+    size_t used;     /*!< Number of buffers currently in use */
+    size_t used_max; /*!< Maximal number of buffers used at the same time */
+    size_t empty;    /*!< Number of times class was empty and allocation moved to larger class or heap */
+} lwcell_pbuf_pool_stat_t;
+
 /**
  * \ingroup         LWCELL_EVT
  * \brief           Event function prototype
@@ -423,8 +447,60 @@ typedef enum lwcell_cb_type_t {
     LWCELL_EVT_PB_LIST,         /*!< Phonebook list event */
     LWCELL_EVT_PB_SEARCH,       /*!< Phonebook search event */
 #endif                         /* LWCELL_CFG_PHONEBOOK || __DOXYGEN__ */
+
+#if LWCELL_CFG_CMUX || __DOXYGEN__
+    LWCELL_EVT_CMUX_RECV, /*!< Data received on multiplexer virtual channel */
+#endif                    /* LWCELL_CFG_CMUX || __DOXYGEN__ */
+
+#if LWCELL_CFG_PPP || __DOXYGEN__
+    LWCELL_EVT_PPP_UP,   /*!< PPP link negotiated, IP packets may be exchanged */
+    LWCELL_EVT_PPP_DOWN, /*!< PPP link terminated, device is in command mode */
+#endif                   /* LWCELL_CFG_PPP || __DOXYGEN__ */
+
+    LWCELL_EVT_END, /*!< Last entry, used for array size */
 } lwcell_evt_type_t;
 
+/**
+ * \ingroup         LWCELL_EVT
+ * \brief           Bitmask of event types, used with \ref lwcell_evt_register_ex
+ */
+typedef uint64_t lwcell_evt_mask_t;
+
+/**
+ * \ingroup         LWCELL_EVT
+ * \brief           Get mask bit of single event type
+ * \param[in]       type: Event type, member of \ref lwcell_evt_type_t enumeration
+ */
+#define LWCELL_EVT_MASK(type) ((lwcell_evt_mask_t)1 << (type))
+
+/**
+ * \ingroup         LWCELL_EVT
+ * \brief           Mask of all event types
+ */
+#define LWCELL_EVT_MASK_ALL   (~(lwcell_evt_mask_t)0)
+
+#if LWCELL_CFG_EVT_DEFER || __DOXYGEN__
+
+/**
+ * \ingroup         LWCELL_EVT
+ * \brief           Statistics of deferred event dispatch
+ * \note            Latency is time between event generation and start of its dispatch, in units of milliseconds
+ * \sa              lwcell_evt_get_defer_stat
+ */
+typedef struct {
+    uint32_t queued;                       /*!< Number of events put to queue */
+    uint32_t dispatched;                   /*!< Number of events taken from queue and dispatched */
+    uint32_t overflow;                     /*!< Number of events not fitting to queue,
+                                                handled as per \ref LWCELL_CFG_EVT_DEFER_OVERFLOW */
+    uint32_t used_max;                     /*!< Maximal number of events waiting in queue at the same time */
+    uint32_t lat_last;                     /*!< Latency of last dispatched event */
+    uint32_t lat_max;                      /*!< Maximal latency of all dispatched events */
+    uint32_t lat_total;                    /*!< Sum of latencies of all dispatched events */
+    uint32_t lat_max_type[LWCELL_EVT_END]; /*!< Maximal latency per event type */
+} lwcell_evt_defer_stat_t;
+
+#endif /* LWCELL_CFG_EVT_DEFER || __DOXYGEN__ */
+
 /**
  * \ingroup         LWCELL_EVT
  * \brief           Global callback structure to pass as parameter to callback function
@@ -553,6 +629,12 @@ typedef struct lwcell_evt {
             lwcellr_t res;              /*!< Operation success */
         } pb_search;                   /*!< Phonebok search list. Use with \ref LWCELL_EVT_PB_SEARCH event */
 #endif                                 /* LWCELL_CFG_PHONEBOOK || __DOXYGEN__ */
+#if LWCELL_CFG_CMUX || __DOXYGEN__
+        struct {
+            uint8_t dlci; /*!< Channel number with new data */
+            size_t len;   /*!< Number of bytes written to channel buffer */
+        } cmux_recv;      /*!< Multiplexer data received. Use with \ref LWCELL_EVT_CMUX_RECV event */
+#endif                    /* LWCELL_CFG_CMUX || __DOXYGEN__ */
     } evt;                             /*!< Callback event union */
 } lwcell_evt_t;
 
@@ -605,12 +687,21 @@ typedef void (*lwcell_timeout_fn)(void* arg);
  * \brief           Timeout structure
  */
 typedef struct lwcell_timeout {
-    struct lwcell_timeout* next; /*!< Pointer to next timeout entry */
-    uint32_t time;              /*!< Time difference from previous entry */
-    void* arg;                  /*!< Argument to pass to callback function */
+    struct lwcell_timeout* next; /*!< Pointer to next timeout entry in wheel slot or free list */
+    struct lwcell_timeout* prev; /*!< Pointer to previous timeout entry in wheel slot */
+    uint32_t expire;             /*!< Absolute wheel tick when timeout expires */
+    void* arg;                   /*!< Argument to pass to callback function */
     lwcell_timeout_fn fn;        /*!< Callback function for timeout */
+    uint16_t gen;                /*!< Generation counter, increased on every release to invalidate handles */
 } lwcell_timeout_t;
 
+/**
+ * \ingroup         LWCELL_TIMEOUT
+ * \brief           Timeout handle, used to cancel timeout.
+ *                  Value `0` is never a valid handle
+ */
+typedef uint32_t lwcell_timeout_handle_t;
+
 /**
  * \ingroup         LWCELL_BUFF
  * \brief           Buffer structure
@@ -644,6 +735,18 @@ typedef struct {
  */
 typedef void (*lwcell_api_cmd_evt_fn)(lwcellr_t res, void* arg);
 
+/**
+ * \ingroup         LWCELL_PPP
+ * \brief           Function declaration for IP packet received on PPP link
+ *
+ * Function is called from processing thread with core locked,
+ * application becomes owner of packet buffer and must free it with \ref lwcell_pbuf_free
+ *
+ * \param[in]       pbuf: Packet buffer with single IP packet
+ * \param[in]       arg: Custom user argument
+ */
+typedef void (*lwcell_ppp_input_fn)(lwcell_pbuf_p pbuf, void* arg);
+
 /**
  * \ingroup         LWCELL_UNICODE
  * \brief           Unicode support structure
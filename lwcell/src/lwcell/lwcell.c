@@ -65,11 +65,17 @@ prv_def_callback(lwcell_evt_t* evt) {
  */
 static void
 prv_keep_alive_timeout_fn(void* arg) {
+    /*
+     * Start new timeout before events are dispatched,
+     * entry of this timeout has just been released and cannot be taken by callbacks
+     */
+    if (lwcell_timeout_add(LWCELL_CFG_KEEP_ALIVE_TIMEOUT, prv_keep_alive_timeout_fn, arg) != lwcellOK) {
+        LWCELL_DEBUGF(LWCELL_CFG_DBG_INIT | LWCELL_DBG_LVL_SEVERE | LWCELL_DBG_TYPE_TRACE,
+                      "[LWCELL CORE] Cannot restart keep-alive timeout!\r\n");
+    }
+
     /* Dispatch keep-alive events */
     lwcelli_send_cb(LWCELL_EVT_KEEP_ALIVE);
-
-    /* Start new timeout */
-    lwcell_timeout_add(LWCELL_CFG_KEEP_ALIVE_TIMEOUT, prv_keep_alive_timeout_fn, arg);
 }
 
 #endif /* LWCELL_CFG_KEEP_ALIVE */
@@ -93,7 +99,10 @@ lwcell_init(lwcell_evt_fn evt_func, const uint32_t blocking) {
     lwcell.status.f.initialized = 0; /* Clear possible init flag */
 
     def_evt_link.fn = evt_func != NULL ? evt_func : prv_def_callback;
+    def_evt_link.mask = LWCELL_EVT_MASK_ALL;
+    def_evt_link.defer = 1;
     lwcell.evt_func = &def_evt_link; /* Set callback function */
+    lwcell.evt_tbl_dirty = 1;        /* Build dispatch table on first event */
 
     if (!lwcell_sys_init()) { /* Init low-level system */
         goto cleanup;
@@ -117,6 +126,14 @@ lwcell_init(lwcell_evt_fn evt_func, const uint32_t blocking) {
         goto cleanup;
     }
 
+#if LWCELL_CFG_EVT_DEFER
+    if (!lwcell_sys_sem_create(&lwcell.evt_defer_sem, 0)) {
+        LWCELL_DEBUGF(LWCELL_CFG_DBG_INIT | LWCELL_DBG_LVL_SEVERE | LWCELL_DBG_TYPE_TRACE,
+                     "[LWCELL CORE] Cannot allocate deferred event semaphore!\r\n");
+        goto cleanup;
+    }
+#endif /* LWCELL_CFG_EVT_DEFER */
+
     /* Create threads */
     lwcell_sys_sem_wait(&lwcell.sem_sync, 0);
     if (!lwcell_sys_thread_create(&lwcell.thread_produce, "lwcell_produce", lwcell_thread_produce, &lwcell.sem_sync,
@@ -136,6 +153,18 @@ lwcell_init(lwcell_evt_fn evt_func, const uint32_t blocking) {
         goto cleanup;
     }
     lwcell_sys_sem_wait(&lwcell.sem_sync, 0); /* Wait semaphore, should be unlocked in produce thread */
+#if LWCELL_CFG_EVT_DEFER && LWCELL_CFG_EVT_DEFER_THREAD
+    if (!lwcell_sys_thread_create(&lwcell.thread_evt, "lwcell_evt", lwcell_thread_evt, &lwcell.sem_sync,
+                                 LWCELL_SYS_THREAD_SS, LWCELL_SYS_THREAD_PRIO)) {
+        LWCELL_DEBUGF(LWCELL_CFG_DBG_INIT | LWCELL_DBG_LVL_SEVERE | LWCELL_DBG_TYPE_TRACE,
+                     "[LWCELL CORE] Cannot create event dispatch thread!\r\n");
+        lwcell_sys_thread_terminate(&lwcell.thread_produce); /* Delete produce thread */
+        lwcell_sys_thread_terminate(&lwcell.thread_process); /* Delete process thread */
+        lwcell_sys_sem_release(&lwcell.sem_sync);            /* Release semaphore and return */
+        goto cleanup;
+    }
+    lwcell_sys_sem_wait(&lwcell.sem_sync, 0); /* Wait semaphore, should be unlocked in event thread */
+#endif                                       /* LWCELL_CFG_EVT_DEFER && LWCELL_CFG_EVT_DEFER_THREAD */
     lwcell_sys_sem_release(&lwcell.sem_sync); /* Release semaphore manually */
 
     lwcell_core_lock();
@@ -153,7 +182,11 @@ lwcell_init(lwcell_evt_fn evt_func, const uint32_t blocking) {
 
 #if LWCELL_CFG_KEEP_ALIVE
     /* Register keep-alive events */
-    lwcell_timeout_add(LWCELL_CFG_KEEP_ALIVE_TIMEOUT, prv_keep_alive_timeout_fn, NULL);
+    if (lwcell_timeout_add(LWCELL_CFG_KEEP_ALIVE_TIMEOUT, prv_keep_alive_timeout_fn, NULL) != lwcellOK) {
+        LWCELL_DEBUGF(LWCELL_CFG_DBG_INIT | LWCELL_DBG_LVL_SEVERE | LWCELL_DBG_TYPE_TRACE,
+                      "[LWCELL CORE] Cannot start keep-alive timeout!\r\n");
+        res = lwcellERRMEM;
+    }
 #endif /* LWCELL_CFG_KEEP_ALIVE */
 
     /*
@@ -161,7 +194,7 @@ lwcell_init(lwcell_evt_fn evt_func, const uint32_t blocking) {
      * AT commands to prepare basic setup for device
      */
 #if LWCELL_CFG_RESET_ON_INIT
-    if (lwcell.status.f.dev_present) {
+    if (res == lwcellOK && lwcell.status.f.dev_present) {
         lwcell_core_unlock();
         res = lwcell_reset_with_delay(LWCELL_CFG_RESET_DELAY_DEFAULT, NULL, NULL,
                                      blocking); /* Send reset sequence with delay */
@@ -187,6 +220,12 @@ cleanup:
         lwcell_sys_sem_delete(&lwcell.sem_sync);
         lwcell_sys_sem_invalid(&lwcell.sem_sync);
     }
+#if LWCELL_CFG_EVT_DEFER
+    if (lwcell_sys_sem_isvalid(&lwcell.evt_defer_sem)) {
+        lwcell_sys_sem_delete(&lwcell.evt_defer_sem);
+        lwcell_sys_sem_invalid(&lwcell.evt_defer_sem);
+    }
+#endif /* LWCELL_CFG_EVT_DEFER */
     return lwcellERRMEM;
 }
 
@@ -326,6 +365,9 @@ lwcell_device_set_present(uint8_t present, const lwcell_api_cmd_evt_fn evt_fn, v
 
         if (!lwcell.status.f.dev_present) {
             /* Manually reset stack to default device state */
+#if LWCELL_CFG_CMUX
+            lwcelli_cmux_close(1);
+#endif /* LWCELL_CFG_CMUX */
             lwcelli_reset_everything(1);
         } else {
 #if LWCELL_CFG_RESET_ON_DEVICE_PRESENT
@@ -0,0 +1,573 @@
+/**
+ * \file            lwcell_cmux.c
+ * \brief           GSM 07.10 multiplexer
+ */
+
+/*
+ * Copyright (c) 2023 Tilen MAJERLE
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without restriction,
+ * including without limitation the rights to use, copy, modify, merge,
+ * publish, distribute, sublicense, and/or sell copies of the Software,
+ * and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE
+ * AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * This file is part of LwCELL - Lightweight cellular modem AT library.
+ *
+ * Author:          Tilen MAJERLE <tilen@majerle.eu>
+ * Version:         v0.1.1
+ */
+#include "lwcell/lwcell_cmux.h"
+#include "lwcell/lwcell_private.h"
+
+#if LWCELL_CFG_CMUX || __DOXYGEN__
+
+#define CMUX_FLAG     0xF9 /*!< Frame opening and closing flag */
+#define CMUX_EA       0x01 /*!< Extension bit, set in last octet of field */
+#define CMUX_CR       0x02 /*!< Command/response bit */
+#define CMUX_PF       0x10 /*!< Poll/final bit of control field */
+#define CMUX_FCS_GOOD 0xCF /*!< Frame check sequence result of valid frame */
+
+/* Frame types, control field without poll/final bit */
+#define CMUX_SABM 0x2F /*!< Set asynchronous balanced mode, opens channel */
+#define CMUX_UA   0x63 /*!< Unnumbered acknowledgement */
+#define CMUX_DM   0x0F /*!< Disconnected mode */
+#define CMUX_DISC 0x43 /*!< Disconnect, closes channel */
+#define CMUX_UIH  0xEF /*!< Unnumbered information with header check only */
+#define CMUX_UI   0x03 /*!< Unnumbered information */
+
+/* Control channel message types, without command/response bit */
+#define CMUX_MSG_PSC   0x41 /*!< Power saving control */
+#define CMUX_MSG_CLD   0xC1 /*!< Multiplexer close down */
+#define CMUX_MSG_TEST  0x21 /*!< Test command */
+#define CMUX_MSG_FCON  0xA1 /*!< Flow control on */
+#define CMUX_MSG_FCOFF 0x61 /*!< Flow control off */
+#define CMUX_MSG_MSC   0xE1 /*!< Modem status command */
+#define CMUX_MSG_NSC   0x11 /*!< Non supported command response */
+
+/* Modem status signals, sent for every opened channel */
+#define CMUX_MSC_SIGNALS 0x8D /*!< Ready to communicate, ready to receive and data valid */
+
+#define CMUX_ADDR(dlci, cr) LWCELL_U8(((dlci) << 2) | ((cr) ? CMUX_CR : 0) | CMUX_EA)
+
+/**
+ * \brief           Reversed CRC-8 table with polynomial `x^8 + x^2 + x + 1`, as defined in 3GPP 27.010
+ */
+static const uint8_t cmux_fcs_table[256] = {
+    0x00, 0x91, 0xE3, 0x72, 0x07, 0x96, 0xE4, 0x75, 0x0E, 0x9F, 0xED, 0x7C, 0x09, 0x98, 0xEA, 0x7B, 0x1C, 0x8D, 0xFF,
+    0x6E, 0x1B, 0x8A, 0xF8, 0x69, 0x12, 0x83, 0xF1, 0x60, 0x15, 0x84, 0xF6, 0x67, 0x38, 0xA9, 0xDB, 0x4A, 0x3F, 0xAE,
+    0xDC, 0x4D, 0x36, 0xA7, 0xD5, 0x44, 0x31, 0xA0, 0xD2, 0x43, 0x24, 0xB5, 0xC7, 0x56, 0x23, 0xB2, 0xC0, 0x51, 0x2A,
+    0xBB, 0xC9, 0x58, 0x2D, 0xBC, 0xCE, 0x5F, 0x70, 0xE1, 0x93, 0x02, 0x77, 0xE6, 0x94, 0x05, 0x7E, 0xEF, 0x9D, 0x0C,
+    0x79, 0xE8, 0x9A, 0x0B, 0x6C, 0xFD, 0x8F, 0x1E, 0x6B, 0xFA, 0x88, 0x19, 0x62, 0xF3, 0x81, 0x10, 0x65, 0xF4, 0x86,
+    0x17, 0x48, 0xD9, 0xAB, 0x3A, 0x4F, 0xDE, 0xAC, 0x3D, 0x46, 0xD7, 0xA5, 0x34, 0x41, 0xD0, 0xA2, 0x33, 0x54, 0xC5,
+    0xB7, 0x26, 0x53, 0xC2, 0xB0, 0x21, 0x5A, 0xCB, 0xB9, 0x28, 0x5D, 0xCC, 0xBE, 0x2F, 0xE0, 0x71, 0x03, 0x92, 0xE7,
+    0x76, 0x04, 0x95, 0xEE, 0x7F, 0x0D, 0x9C, 0xE9, 0x78, 0x0A, 0x9B, 0xFC, 0x6D, 0x1F, 0x8E, 0xFB, 0x6A, 0x18, 0x89,
+    0xF2, 0x63, 0x11, 0x80, 0xF5, 0x64, 0x16, 0x87, 0xD8, 0x49, 0x3B, 0xAA, 0xDF, 0x4E, 0x3C, 0xAD, 0xD6, 0x47, 0x35,
+    0xA4, 0xD1, 0x40, 0x32, 0xA3, 0xC4, 0x55, 0x27, 0xB6, 0xC3, 0x52, 0x20, 0xB1, 0xCA, 0x5B, 0x29, 0xB8, 0xCD, 0x5C,
+    0x2E, 0xBF, 0x90, 0x01, 0x73, 0xE2, 0x97, 0x06, 0x74, 0xE5, 0x9E, 0x0F, 0x7D, 0xEC, 0x99, 0x08, 0x7A, 0xEB, 0x8C,
+    0x1D, 0x6F, 0xFE, 0x8B, 0x1A, 0x68, 0xF9, 0x82, 0x13, 0x61, 0xF0, 0x85, 0x14, 0x66, 0xF7, 0xA8, 0x39, 0x4B, 0xDA,
+    0xAF, 0x3E, 0x4C, 0xDD, 0xA6, 0x37, 0x45, 0xD4, 0xA1, 0x30, 0x42, 0xD3, 0xB4, 0x25, 0x57, 0xC6, 0xB3, 0x22, 0x50,
+    0xC1, 0xBA, 0x2B, 0x59, 0xC8, 0xBD, 0x2C, 0x5E, 0xCF,
+};
+
+/**
+ * \brief           Update frame check sequence with new data
+ * \param[in]       fcs: Current frame check sequence, `0xFF` at start of frame
+ * \param[in]       data: Data to add
+ * \param[in]       len: Length of data in units of bytes
+ * \return          Updated frame check sequence
+ */
+static uint8_t
+cmux_fcs_update(uint8_t fcs, const uint8_t* data, size_t len) {
+    while (len-- > 0) {
+        fcs = cmux_fcs_table[fcs ^ *data++];
+    }
+    return fcs;
+}
+
+/**
+ * \brief           Send single frame directly to low-level
+ * \param[in]       addr: Address field, use \ref CMUX_ADDR to build it
+ * \param[in]       ctrl: Control field
+ * \param[in]       data: Information field. Set to `NULL` when not used
+ * \param[in]       len: Length of information field, may not exceed \ref LWCELL_CFG_CMUX_N1
+ */
+static void
+cmux_send_frame(uint8_t addr, uint8_t ctrl, const void* data, size_t len) {
+    uint8_t hdr[5], trl[2], hdr_len = 0;
+
+    hdr[hdr_len++] = CMUX_FLAG;
+    hdr[hdr_len++] = addr;
+    hdr[hdr_len++] = ctrl;
+    if (len < 0x80) {
+        hdr[hdr_len++] = LWCELL_U8((len << 1) | CMUX_EA);
+    } else {
+        hdr[hdr_len++] = LWCELL_U8(len << 1);
+        hdr[hdr_len++] = LWCELL_U8(len >> 7);
+    }
+
+    /* Information field is covered by checksum only for non-UIH frames */
+    trl[0] = cmux_fcs_update(0xFF, &hdr[1], hdr_len - 1);
+    if ((ctrl & ~CMUX_PF) != CMUX_UIH && len > 0) {
+        trl[0] = cmux_fcs_update(trl[0], data, len);
+    }
+    trl[0] = LWCELL_U8(0xFF - trl[0]);
+    trl[1] = CMUX_FLAG;
+
+    lwcell.cmux.ll_send_fn(hdr, hdr_len);
+    if (len > 0) {
+        lwcell.cmux.ll_send_fn(data, len);
+    }
+    lwcell.cmux.ll_send_fn(trl, sizeof(trl));
+    lwcell.cmux.ll_send_fn(NULL, 0);
+}
+
+/**
+ * \brief           Send message on control channel
+ * \param[in]       type: Message type, including command/response bit
+ * \param[in]       value: Message value
+ * \param[in]       len: Length of value, may not exceed `127` bytes
+ */
+static void
+cmux_send_ctrl_msg(uint8_t type, const void* value, size_t len) {
+    uint8_t msg[2 + 127];
+
+    len = LWCELL_MIN(len, sizeof(msg) - 2);
+    msg[0] = type;
+    msg[1] = LWCELL_U8((len << 1) | CMUX_EA);
+    if (len > 0) {
+        LWCELL_MEMCPY(&msg[2], value, len);
+    }
+    cmux_send_frame(CMUX_ADDR(0, 1), CMUX_UIH, msg, len + 2);
+}
+
+/**
+ * \brief           Low-level send function used for AT channel while multiplexer is active
+ *
+ * Data are collected and sent as single frame on flush request or when information field is full
+ *
+ * \param[in]       data: Data to send. Set to `NULL` to flush data
+ * \param[in]       len: Length of data in units of bytes
+ * \return          Number of bytes accepted
+ */
+static size_t
+cmux_at_send(const void* data, size_t len) {
+    const uint8_t* d = data;
+    size_t sent = 0;
+
+    if (d == NULL || len == 0) {
+        if (lwcell.cmux.tx_len > 0) {
+            cmux_send_frame(CMUX_ADDR(LWCELL_CMUX_DLCI_AT, 1), CMUX_UIH, lwcell.cmux.tx, lwcell.cmux.tx_len);
+            lwcell.cmux.tx_len = 0;
+        }
+        return 0;
+    }
+    while (sent < len) {
+        size_t copy = LWCELL_MIN(len - sent, sizeof(lwcell.cmux.tx) - lwcell.cmux.tx_len);
+
+        LWCELL_MEMCPY(&lwcell.cmux.tx[lwcell.cmux.tx_len], &d[sent], copy);
+        lwcell.cmux.tx_len += copy;
+        sent += copy;
+        if (lwcell.cmux.tx_len == sizeof(lwcell.cmux.tx)) {
+            cmux_at_send(NULL, 0);
+        }
+    }
+    return sent;
+}
+
+/**
+ * \brief           Process message received on control channel
+ */
+static void
+cmux_ctrl_process(void) {
+    uint8_t type;
+
+    if (lwcell.cmux.len < 2 || !(lwcell.cmux.info[0] & CMUX_CR)) {
+        return; /* Responses to our commands need no action */
+    }
+    type = LWCELL_U8(lwcell.cmux.info[0] & ~CMUX_CR);
+    switch (type) {
+        case CMUX_MSG_CLD: {
+            /* Device closes multiplexer, confirm and continue in normal AT mode */
+            cmux_send_ctrl_msg(CMUX_MSG_CLD, NULL, 0);
+            lwcelli_cmux_close(1);
+            break;
+        }
+        case CMUX_MSG_PSC:
+        case CMUX_MSG_TEST:
+        case CMUX_MSG_FCON:
+        case CMUX_MSG_FCOFF:
+        case CMUX_MSG_MSC: {
+            /* Confirm with the same value */
+            cmux_send_ctrl_msg(type, &lwcell.cmux.info[2], lwcell.cmux.len - 2);
+            break;
+        }
+        default: {
+            cmux_send_ctrl_msg(CMUX_MSG_NSC, &lwcell.cmux.info[0], 1);
+            break;
+        }
+    }
+}
+
+/**
+ * \brief           Process valid frame from device
+ */
+static void
+cmux_frame_process(void) {
+    uint8_t dlci = LWCELL_U8(lwcell.cmux.addr >> 2);
+    lwcell_cmux_ch_t* ch;
+
+    if (dlci > LWCELL_CFG_CMUX_CHANNELS) {
+        return;
+    }
+    ch = &lwcell.cmux.ch[dlci];
+    switch (lwcell.cmux.ctrl & ~CMUX_PF) {
+        case CMUX_UA: {
+            if (!ch->open && dlci > 0) {
+                uint8_t msc[] = {CMUX_ADDR(dlci, 1), CMUX_MSC_SIGNALS};
+
+                /* Channel is open, report our status to let device send data */
+                cmux_send_ctrl_msg(CMUX_MSG_MSC | CMUX_CR, msc, sizeof(msc));
+            }
+            ch->open = 1;
+            break;
+        }
+        case CMUX_DISC: {
+            cmux_send_frame(CMUX_ADDR(dlci, 0), CMUX_UA | CMUX_PF, NULL, 0);
+            ch->open = 0;
+            break;
+        }
+        case CMUX_DM: {
+            ch->open = 0;
+            break;
+        }
+        case CMUX_UI:
+        case CMUX_UIH: {
+            if (dlci == 0) {
+                cmux_ctrl_process();
+            } else if (dlci == LWCELL_CMUX_DLCI_AT) {
+                lwcelli_process_at(lwcell.cmux.info, lwcell.cmux.len);
+            } else if (lwcell.cmux.len > 0) {
+                size_t len = lwcell_buff_write(&ch->buff, lwcell.cmux.info, lwcell.cmux.len);
+
+                if (len > 0) {
+                    lwcell.evt.evt.cmux_recv.dlci = dlci;
+                    lwcell.evt.evt.cmux_recv.len = len;
+                    lwcelli_send_cb(LWCELL_EVT_CMUX_RECV);
+                }
+            }
+            break;
+        }
+        default: break;
+    }
+}
+
+/**
+ * \brief           Set decoder to next state after length field has been received
+ */
+static void
+cmux_rx_len_done(void) {
+    lwcell.cmux.ptr = 0;
+    if (lwcell.cmux.len > sizeof(lwcell.cmux.info)) {
+        lwcell.cmux.state = LWCELL_CMUX_RX_FLAG; /* Frame too long, wait for next one */
+    } else if (lwcell.cmux.len > 0) {
+        lwcell.cmux.state = LWCELL_CMUX_RX_INFO;
+    } else {
+        lwcell.cmux.state = LWCELL_CMUX_RX_FCS;
+    }
+}
+
+/**
+ * \brief           Decode multiplexer frames received from device
+ * \note            Decoding stops when multiplexer is closed in the middle of input data
+ * \param[in]       data: Received data
+ * \param[in]       len: Length of data in units of bytes
+ * \return          Number of bytes processed as multiplexer frames
+ */
+size_t
+lwcelli_cmux_process(const void* data, size_t len) {
+    const uint8_t* d = data;
+    size_t i = 0;
+
+    while (i < len && lwcell.cmux.active) {
+        uint8_t b = d[i++];
+
+        switch (lwcell.cmux.state) {
+            case LWCELL_CMUX_RX_FLAG: {
+                if (b == CMUX_FLAG) {
+                    lwcell.cmux.state = LWCELL_CMUX_RX_ADDR;
+                }
+                break;
+            }
+            case LWCELL_CMUX_RX_ADDR: {
+                if (b == CMUX_FLAG) {
+                    break; /* Repeated flag between frames */
+                } else if (!(b & CMUX_EA)) {
+                    lwcell.cmux.state = LWCELL_CMUX_RX_FLAG; /* Only single octet address is used in basic mode */
+                    break;
+                }
+                lwcell.cmux.addr = b;
+                lwcell.cmux.fcs = cmux_fcs_table[0xFF ^ b];
+                lwcell.cmux.state = LWCELL_CMUX_RX_CTRL;
+                break;
+            }
+            case LWCELL_CMUX_RX_CTRL: {
+                lwcell.cmux.ctrl = b;
+                lwcell.cmux.fcs = cmux_fcs_table[lwcell.cmux.fcs ^ b];
+                lwcell.cmux.state = LWCELL_CMUX_RX_LEN1;
+                break;
+            }
+            case LWCELL_CMUX_RX_LEN1: {
+                lwcell.cmux.fcs = cmux_fcs_table[lwcell.cmux.fcs ^ b];
+                lwcell.cmux.len = b >> 1;
+                if (b & CMUX_EA) {
+                    cmux_rx_len_done();
+                } else {
+                    lwcell.cmux.state = LWCELL_CMUX_RX_LEN2;
+                }
+                break;
+            }
+            case LWCELL_CMUX_RX_LEN2: {
+                lwcell.cmux.fcs = cmux_fcs_table[lwcell.cmux.fcs ^ b];
+                lwcell.cmux.len |= (size_t)b << 7;
+                cmux_rx_len_done();
+                break;
+            }
+            case LWCELL_CMUX_RX_INFO: {
+                /* Copy as much as available at once */
+                size_t copy = LWCELL_MIN(lwcell.cmux.len - lwcell.cmux.ptr, len - i + 1);
+
+                LWCELL_MEMCPY(&lwcell.cmux.info[lwcell.cmux.ptr], &d[i - 1], copy);
+                lwcell.cmux.ptr += copy;
+                i += copy - 1;
+                if (lwcell.cmux.ptr == lwcell.cmux.len) {
+                    lwcell.cmux.state = LWCELL_CMUX_RX_FCS;
+                }
+                break;
+            }
+            case LWCELL_CMUX_RX_FCS: {
+                if ((lwcell.cmux.ctrl & ~CMUX_PF) != CMUX_UIH) {
+                    lwcell.cmux.fcs = cmux_fcs_update(lwcell.cmux.fcs, lwcell.cmux.info, lwcell.cmux.len);
+                }
+                if (cmux_fcs_table[lwcell.cmux.fcs ^ b] == CMUX_FCS_GOOD) {
+                    lwcell.cmux.state = LWCELL_CMUX_RX_CLOSE;
+                } else {
+                    lwcell.cmux.state = LWCELL_CMUX_RX_FLAG;
+                }
+                break;
+            }
+            case LWCELL_CMUX_RX_CLOSE: {
+                if (b == CMUX_FLAG) {
+                    lwcell.cmux.state = LWCELL_CMUX_RX_ADDR; /* Closing flag may open next frame */
+                    cmux_frame_process();
+                } else {
+                    lwcell.cmux.state = LWCELL_CMUX_RX_FLAG;
+                }
+                break;
+            }
+            default: break;
+        }
+    }
+    return i;
+}
+
+/**
+ * \brief           Allocate receive buffers of application channels before multiplexer is started
+ * \return          \ref lwcellOK on success, member of \ref lwcellr_t enumeration otherwise
+ */
+lwcellr_t
+lwcelli_cmux_prepare(void) {
+    if (lwcell.cmux.active) {
+        return lwcellERR;
+    }
+    for (size_t i = LWCELL_CMUX_DLCI_AT + 1; i < LWCELL_ARRAYSIZE(lwcell.cmux.ch); ++i) {
+        if (!lwcell_buff_init(&lwcell.cmux.ch[i].buff, LWCELL_CFG_CMUX_CH_BUFF_SIZE)) {
+            lwcelli_cmux_close(1);
+            return lwcellERRMEM;
+        }
+    }
+    return lwcellOK;
+}
+
+/**
+ * \brief           Switch to multiplexed communication after device accepted `AT+CMUX` command
+ *
+ * Low-level send function is replaced to put AT commands into frames on \ref LWCELL_CMUX_DLCI_AT
+ * and all the channels are opened
+ */
+void
+lwcelli_cmux_activate(void) {
+    if (lwcell.cmux.active) {
+        return;
+    }
+    lwcell.cmux.ll_send_fn = lwcell.ll.send_fn;
+    lwcell.ll.send_fn = cmux_at_send;
+    lwcell.cmux.state = LWCELL_CMUX_RX_FLAG;
+    lwcell.cmux.tx_len = 0;
+    lwcell.cmux.active = 1;
+
+    for (size_t i = 0; i < LWCELL_ARRAYSIZE(lwcell.cmux.ch); ++i) {
+        lwcell.cmux.ch[i].open = 0;
+        cmux_send_frame(CMUX_ADDR(i, 1), CMUX_SABM | CMUX_PF, NULL, 0);
+    }
+}
+
+/**
+ * \brief           Stop multiplexer and free channel buffers
+ * \note            Safe to call when multiplexer is not active
+ * \param[in]       forced: Set to `1` when device already left multiplexer mode,
+ *                      such as after reset, and close down message should not be sent
+ */
+void
+lwcelli_cmux_close(uint8_t forced) {
+    if (lwcell.cmux.active) {
+        if (!forced) {
+            cmux_at_send(NULL, 0);
+            cmux_send_ctrl_msg(CMUX_MSG_CLD | CMUX_CR, NULL, 0);
+        }
+        lwcell.ll.send_fn = lwcell.cmux.ll_send_fn;
+        lwcell.cmux.active = 0;
+    }
+    for (size_t i = 0; i < LWCELL_ARRAYSIZE(lwcell.cmux.ch); ++i) {
+        lwcell_buff_free(&lwcell.cmux.ch[i].buff);
+        lwcell.cmux.ch[i].open = 0;
+    }
+}
+
+/**
+ * \brief           Start multiplexer and open all the channels
+ *
+ * After successful start, AT commands run over \ref LWCELL_CMUX_DLCI_AT
+ * and other channels are available with \ref lwcell_cmux_write and \ref lwcell_cmux_read
+ *
+ * \param[in]       evt_fn: Callback function called when command has finished. Set to `NULL` when not used
+ * \param[in]       evt_arg: Custom argument for event callback function
+ * \param[in]       blocking: Status whether command should be blocking or not
+ * \return          \ref lwcellOK on success, member of \ref lwcellr_t enumeration otherwise
+ */
+lwcellr_t
+lwcell_cmux_start(const lwcell_api_cmd_evt_fn evt_fn, void* const evt_arg, const uint32_t blocking) {
+    LWCELL_MSG_VAR_DEFINE(msg);
+
+    LWCELL_MSG_VAR_ALLOC(msg, blocking);
+    LWCELL_MSG_VAR_SET_EVT(msg, evt_fn, evt_arg);
+    LWCELL_MSG_VAR_REF(msg).cmd_def = LWCELL_CMD_CMUX;
+    LWCELL_MSG_VAR_REF(msg).cmd = LWCELL_CMD_CMUX;
+
+    return lwcelli_send_msg_to_producer_mbox(&LWCELL_MSG_VAR_REF(msg), lwcelli_initiate_cmd, 10000);
+}
+
+/**
+ * \brief           Close down multiplexer and return to normal AT command mode
+ * \param[in]       evt_fn: Callback function called when command has finished. Set to `NULL` when not used
+ * \param[in]       evt_arg: Custom argument for event callback function
+ * \param[in]       blocking: Status whether command should be blocking or not
+ * \return          \ref lwcellOK on success, member of \ref lwcellr_t enumeration otherwise
+ */
+lwcellr_t
+lwcell_cmux_stop(const lwcell_api_cmd_evt_fn evt_fn, void* const evt_arg, const uint32_t blocking) {
+    LWCELL_MSG_VAR_DEFINE(msg);
+
+    LWCELL_MSG_VAR_ALLOC(msg, blocking);
+    LWCELL_MSG_VAR_SET_EVT(msg, evt_fn, evt_arg);
+    LWCELL_MSG_VAR_REF(msg).cmd_def = LWCELL_CMD_CMUX_CLD;
+    LWCELL_MSG_VAR_REF(msg).cmd = LWCELL_CMD_CMUX_CLD;
+
+    return lwcelli_send_msg_to_producer_mbox(&LWCELL_MSG_VAR_REF(msg), lwcelli_initiate_cmd, 10000);
+}
+
+/**
+ * \brief           Check if multiplexer is active
+ * \return          `1` if active, `0` otherwise
+ */
+uint8_t
+lwcell_cmux_is_active(void) {
+    uint8_t res;
+
+    lwcell_core_lock();
+    res = lwcell.cmux.active;
+    lwcell_core_unlock();
+    return res;
+}
+
+/**
+ * \brief           Write data to application channel
+ * \param[in]       dlci: Channel number, from `2` to \ref LWCELL_CFG_CMUX_CHANNELS
+ * \param[in]       data: Data to write
+ * \param[in]       len: Length of data in units of bytes
+ * \return          Number of bytes sent, `0` if channel is not open
+ */
+size_t
+lwcell_cmux_write(uint8_t dlci, const void* data, size_t len) {
+    const uint8_t* d = data;
+    size_t sent = 0;
+
+    if (dlci <= LWCELL_CMUX_DLCI_AT || dlci > LWCELL_CFG_CMUX_CHANNELS || d == NULL) {
+        return 0;
+    }
+    lwcell_core_lock();
+    if (lwcell.cmux.active && lwcell.cmux.ch[dlci].open) {
+        while (sent < len) {
+            size_t chunk = LWCELL_MIN(len - sent, (size_t)LWCELL_CFG_CMUX_N1);
+
+            cmux_send_frame(CMUX_ADDR(dlci, 1), CMUX_UIH, &d[sent], chunk);
+            sent += chunk;
+        }
+    }
+    lwcell_core_unlock();
+    return sent;
+}
+
+/**
+ * \brief           Read received data from application channel
+ * \param[in]       dlci: Channel number, from `2` to \ref LWCELL_CFG_CMUX_CHANNELS
+ * \param[out]      data: Memory to copy data to
+ * \param[in]       len: Size of memory in units of bytes
+ * \return          Number of bytes copied to `data`
+ */
+size_t
+lwcell_cmux_read(uint8_t dlci, void* data, size_t len) {
+    size_t res = 0;
+
+    if (dlci <= LWCELL_CMUX_DLCI_AT || dlci > LWCELL_CFG_CMUX_CHANNELS || data == NULL) {
+        return 0;
+    }
+    lwcell_core_lock();
+    res = lwcell_buff_read(&lwcell.cmux.ch[dlci].buff, data, len);
+    lwcell_core_unlock();
+    return res;
+}
+
+/**
+ * \brief           Get number of received bytes waiting in application channel
+ * \param[in]       dlci: Channel number, from `2` to \ref LWCELL_CFG_CMUX_CHANNELS
+ * \return          Number of bytes ready to read
+ */
+size_t
+lwcell_cmux_get_full(uint8_t dlci) {
+    size_t res = 0;
+
+    if (dlci <= LWCELL_CMUX_DLCI_AT || dlci > LWCELL_CFG_CMUX_CHANNELS) {
+        return 0;
+    }
+    lwcell_core_lock();
+    res = lwcell_buff_get_full(&lwcell.cmux.ch[dlci].buff);
+    lwcell_core_unlock();
+    return res;
+}
+
+#endif /* LWCELL_CFG_CMUX || __DOXYGEN__ */
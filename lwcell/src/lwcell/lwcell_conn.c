@@ -61,25 +61,163 @@ static void
 conn_timeout_cb(void* arg) {
     lwcell_conn_p conn = arg;                   /* Argument is actual connection */
 
-    if (conn->status.f.active) {                /* Handle only active connections */
+    if (conn->status.f.active) { /* Handle only active connections */
+        /*
+         * Schedule new timeout before callback,
+         * entry of this timeout has just been released and cannot be taken by callback
+         */
+        lwcelli_conn_start_timeout(conn);
+
         lwcell.evt.type = LWCELL_EVT_CONN_POLL; /* Poll connection event */
         lwcell.evt.evt.conn_poll.conn = conn;   /* Set connection pointer */
         lwcelli_send_conn_cb(conn, NULL);       /* Send connection callback */
-
-        lwcelli_conn_start_timeout(conn);       /* Schedule new timeout */
         LWCELL_DEBUGF(LWCELL_CFG_DBG_CONN | LWCELL_DBG_TYPE_TRACE, "[LWCELL CONN] Poll event: %p\r\n", (void*)conn);
     }
 }
 
 /**
  * \brief           Start timeout function for connection
+ *
+ * Connection cannot be polled without timeout, it is closed when timeout cannot be started
+ *
  * \param[in]       conn: Connection handle as user argument
+ * \return          \ref lwcellOK on success, member of \ref lwcellr_t enumeration otherwise
  */
-void
+lwcellr_t
 lwcelli_conn_start_timeout(lwcell_conn_p conn) {
-    lwcell_timeout_add(LWCELL_CFG_CONN_POLL_INTERVAL, conn_timeout_cb, conn); /* Add connection timeout */
+    lwcellr_t res;
+
+    if ((res = lwcell_timeout_add(LWCELL_CFG_CONN_POLL_INTERVAL, conn_timeout_cb, conn)) != lwcellOK) {
+        LWCELL_DEBUGF(LWCELL_CFG_DBG_CONN | LWCELL_DBG_TYPE_TRACE | LWCELL_DBG_LVL_WARNING,
+                      "[LWCELL CONN] Cannot start poll timeout, closing connection: %p\r\n", (void*)conn);
+        lwcell_conn_close(conn, 0);
+    }
+    return res;
+}
+
+#if LWCELL_CFG_CONN_MANUAL_RX || __DOXYGEN__
+
+/**
+ * \brief           Timeout callback to retry reading data in manual receive mode
+ * \param[in]       arg: Connection handle
+ */
+static void
+conn_manual_rx_retry_cb(void* arg) {
+    lwcell_conn_p conn = arg;
+
+    conn->status.f.rx_retry = 0;
+    lwcelli_conn_manual_rx_read(conn);
+}
+
+/**
+ * \brief           Schedule retry of reading data in manual receive mode
+ *
+ * When retry cannot be scheduled, reading continues on next \ref lwcell_conn_recved
+ * or when device reports new data
+ *
+ * \param[in]       conn: Connection handle
+ * \return          \ref lwcellOK on success, member of \ref lwcellr_t enumeration otherwise
+ */
+static lwcellr_t
+conn_manual_rx_retry(lwcell_conn_p conn) {
+    lwcellr_t res = lwcellOK;
+
+    if (!conn->status.f.rx_retry) {
+        if ((res = lwcell_timeout_add(LWCELL_CFG_CONN_MANUAL_RX_RETRY_INTERVAL, conn_manual_rx_retry_cb, conn))
+            == lwcellOK) {
+            conn->status.f.rx_retry = 1;
+        } else {
+            LWCELL_DEBUGF(LWCELL_CFG_DBG_CONN | LWCELL_DBG_TYPE_TRACE | LWCELL_DBG_LVL_WARNING,
+                          "[LWCELL CONN] Cannot schedule read retry: %p\r\n", (void*)conn);
+        }
+    }
+    return res;
+}
+
+/**
+ * \brief           Queue read command in manual receive mode
+ * \param[in]       conn: Connection handle
+ * \return          \ref lwcellOK on success, member of \ref lwcellr_t enumeration otherwise
+ */
+static lwcellr_t
+conn_manual_rx_queue(lwcell_conn_p conn) {
+    LWCELL_MSG_VAR_DEFINE(msg);
+
+    LWCELL_MSG_VAR_ALLOC(msg, 0);
+    LWCELL_MSG_VAR_REF(msg).cmd_def = LWCELL_CMD_CIPRXGET;
+    if (conn->status.f.rx_avail_unknown) {
+        LWCELL_MSG_VAR_REF(msg).cmd = LWCELL_CMD_CIPRXGET_LEN; /* Query length first */
+    }
+    LWCELL_MSG_VAR_REF(msg).msg.conn_recv.conn = conn;
+    LWCELL_MSG_VAR_REF(msg).msg.conn_recv.val_id = conn->val_id;
+
+    return lwcelli_send_msg_to_producer_mbox(&LWCELL_MSG_VAR_REF(msg), lwcelli_initiate_cmd, 10000);
 }
 
+/**
+ * \brief           Start reading data waiting in device in manual receive mode
+ *
+ * Read command is queued only when device has data for connection,
+ * no other read command is in queue and application confirmed enough of previously received data
+ *
+ * \note            Core lock must be active when calling this function
+ * \param[in]       conn: Connection handle
+ * \return          \ref lwcellOK on success or if there is nothing to read yet,
+ *                      member of \ref lwcellr_t enumeration otherwise
+ */
+lwcellr_t
+lwcelli_conn_manual_rx_read(lwcell_conn_p conn) {
+    lwcellr_t res;
+
+    if (!conn->status.f.active || conn->status.f.rx_queued
+        || (conn->rx_avail == 0 && !conn->status.f.rx_avail_unknown)) {
+        return lwcellOK;
+    }
+
+    /* Wait for application to process data received so far */
+    if (conn->rx_unconfirmed >= LWCELL_CFG_CONN_MANUAL_RX_WINDOW
+        || conn->rx_pbufs >= LWCELL_CFG_CONN_MANUAL_RX_MAX_PBUFS) {
+        return lwcellOK;
+    }
+
+    conn->status.f.rx_queued = 1;
+    if ((res = conn_manual_rx_queue(conn)) != lwcellOK) {
+        conn->status.f.rx_queued = 0;
+        conn_manual_rx_retry(conn);
+    }
+    return res;
+}
+
+/**
+ * \brief           Finish read command in manual receive mode and continue reading if more data are available
+ * \note            Core lock must be active when calling this function
+ * \param[in]       msg: Read command message
+ * \param[in]       res: Command result. \ref lwcellINPROG when there was nothing to read
+ */
+void
+lwcelli_conn_manual_rx_done(lwcell_msg_t* msg, lwcellr_t res) {
+    lwcell_conn_p conn = msg->msg.conn_recv.conn;
+
+    if (msg->msg.conn_recv.pbuf != NULL) { /* Buffer was not used for data */
+        lwcell_pbuf_free_s(&msg->msg.conn_recv.pbuf);
+    }
+    if (msg->msg.conn_recv.val_id != conn->val_id) { /* Connection was closed in the meantime */
+        return;
+    }
+    conn->status.f.rx_queued = 0;
+    if (res == lwcellOK || res == lwcellINPROG) {
+        lwcelli_conn_manual_rx_read(conn); /* Continue if there is more to read */
+    } else {
+        /* Query available length again after memory or device error */
+        if (res != lwcellERRMEM) {
+            conn->status.f.rx_avail_unknown = 1;
+        }
+        conn_manual_rx_retry(conn);
+    }
+}
+
+#endif /* LWCELL_CFG_CONN_MANUAL_RX || __DOXYGEN__ */
+
 /**
  * \brief           Get connection validation ID
  * \param[in]       conn: Connection handle
@@ -95,6 +233,131 @@ lwcelli_conn_get_val_id(lwcell_conn_p conn) {
     return val_id;
 }
 
+#if LWCELL_CFG_CONN_TRANSPARENT || __DOXYGEN__
+
+/**
+ * \brief           Write data directly to device in transparent data mode
+ *
+ * Function is called from producer thread, as for any other command,
+ * hence \ref LWCELL_EVT_CONN_SEND is reported from stack thread and `blocking` parameter is respected.
+ * Data are written in blocks of up to \ref LWCELL_CFG_CONN_MAX_DATA_LEN bytes.
+ * Core is unlocked between blocks to let received data through.
+ *
+ * \param[in]       msg: Send data message with `data`, `iov` or `pbuf` set
+ * \return          \ref lwcellOK as there is nothing to wait for, send result is saved to message
+ */
+static lwcellr_t
+conn_send_transparent(lwcell_msg_t* msg) {
+    lwcell_conn_p conn = msg->msg.conn_send.conn;
+    lwcell_iovec_t data_iov = {.data = msg->msg.conn_send.data, .len = msg->msg.conn_send.btw};
+    const lwcell_iovec_t* iov = msg->msg.conn_send.iov;
+    size_t iov_cnt = msg->msg.conn_send.iov_cnt;
+    lwcell_pbuf_p pbuf = msg->msg.conn_send.pbuf;
+    lwcellr_t res = lwcellOK;
+    size_t sent = 0;
+
+    if (msg->msg.conn_send.data != NULL) {
+        iov = &data_iov;
+        iov_cnt = 1;
+    }
+
+    lwcell_core_unlock(); /* Producer thread calls with core locked */
+    for (size_t i = 0; res == lwcellOK && (iov != NULL ? i < iov_cnt : pbuf != NULL); ++i) {
+        const uint8_t* d;
+        size_t len;
+
+        if (iov != NULL) {
+            d = iov[i].data;
+            len = iov[i].len;
+        } else {
+            d = pbuf->payload;
+            len = pbuf->len;
+            pbuf = pbuf->next;
+        }
+        while (len > 0) {
+            size_t l = LWCELL_MIN(len, LWCELL_CFG_CONN_MAX_DATA_LEN);
+
+            lwcell_core_lock();
+            if (conn != lwcell.m.transp.conn || msg->msg.conn_send.val_id != conn->val_id || !lwcell.m.transp.data_mode
+                || lwcell.m.transp.escaping) {
+                res = lwcellCLOSED;
+            } else {
+                lwcell.ll.send_fn(d, l);
+                lwcell.ll.send_fn(NULL, 0); /* Flush data */
+            }
+            lwcell_core_unlock();
+            if (res != lwcellOK) {
+                break;
+            }
+            d += l;
+            len -= l;
+            sent += l;
+        }
+    }
+    lwcell_core_lock();
+
+    msg->msg.conn_send.sent_all = sent;
+    if (msg->msg.conn_send.bw != NULL) {
+        *msg->msg.conn_send.bw = sent;
+    }
+    if (msg->msg.conn_send.fau) { /* Data were written directly, success or not */
+        msg->msg.conn_send.fau = 0;
+        LWCELL_DEBUGF(LWCELL_CFG_DBG_CONN | LWCELL_DBG_TYPE_TRACE, "[LWCELL CONN] Free write buffer fau: %p\r\n",
+                      (void*)msg->msg.conn_send.data);
+        lwcell_mem_free_s((void**)&msg->msg.conn_send.data);
+    }
+    lwcell.evt.type = LWCELL_EVT_CONN_SEND;
+    lwcell.evt.evt.conn_data_send.res = res;
+    lwcell.evt.evt.conn_data_send.conn = conn;
+    lwcell.evt.evt.conn_data_send.sent = sent;
+    lwcelli_send_conn_cb(conn, NULL);
+
+    msg->res = res;
+    lwcell_sys_sem_release(&lwcell.sem_sync); /* Command is finished, producer must not wait for process thread */
+    return lwcellOK;
+}
+
+#endif /* LWCELL_CFG_CONN_TRANSPARENT || __DOXYGEN__ */
+
+/**
+ * \brief           Put send data message to producer queue
+ * \param[in]       conn: Pointer to connection to send data
+ * \param[in]       ip: Remote IP address for UDP connection
+ * \param[in]       port: Remote port connection
+ * \param[in]       data: Pointer to data to send
+ * \param[in]       btw: Number of bytes to send
+ * \param[out]      bw: Pointer to output variable to save number of sent data when successfully sent
+ * \param[in]       fau: "Free After Use" flag. Set to `1` if stack should free the memory after data sent
+ * \param[in]       blocking: Status whether command should be blocking or not
+ * \return          \ref lwcellOK on success, member of \ref lwcellr_t enumeration otherwise
+ */
+static lwcellr_t
+conn_send_msg(lwcell_conn_p conn, const lwcell_ip_t* const ip, lwcell_port_t port, const void* data, size_t btw,
+              size_t* const bw, uint8_t fau, const uint32_t blocking) {
+    LWCELL_MSG_VAR_DEFINE(msg);
+
+    CONN_CHECK_CLOSED_IN_CLOSING(conn); /* Check if we can continue */
+
+    LWCELL_MSG_VAR_ALLOC(msg, blocking);
+    LWCELL_MSG_VAR_REF(msg).cmd_def = LWCELL_CMD_CIPSEND;
+
+    LWCELL_MSG_VAR_REF(msg).msg.conn_send.conn = conn;
+    LWCELL_MSG_VAR_REF(msg).msg.conn_send.data = data;
+    LWCELL_MSG_VAR_REF(msg).msg.conn_send.btw = btw;
+    LWCELL_MSG_VAR_REF(msg).msg.conn_send.bw = bw;
+    LWCELL_MSG_VAR_REF(msg).msg.conn_send.remote_ip = ip;
+    LWCELL_MSG_VAR_REF(msg).msg.conn_send.remote_port = port;
+    LWCELL_MSG_VAR_REF(msg).msg.conn_send.fau = fau;
+    LWCELL_MSG_VAR_REF(msg).msg.conn_send.val_id = lwcelli_conn_get_val_id(conn);
+
+#if LWCELL_CFG_CONN_TRANSPARENT
+    if (conn->type == LWCELL_CONN_TYPE_TCP_TRANSPARENT) {
+        return lwcelli_send_msg_to_producer_mbox(&LWCELL_MSG_VAR_REF(msg), conn_send_transparent, 60000);
+    }
+#endif /* LWCELL_CFG_CONN_TRANSPARENT */
+    return lwcelli_send_msg_to_producer_mbox(&LWCELL_MSG_VAR_REF(msg), lwcelli_initiate_cmd, 60000);
+}
+
 /**
  * \brief           Send data on already active connection of type UDP to specific remote IP and port
  * \note            In case IP and port values are not set, it will behave as normal send function (suitable for TCP too)
@@ -104,18 +367,58 @@ lwcelli_conn_get_val_id(lwcell_conn_p conn) {
  * \param[in]       data: Pointer to data to send
  * \param[in]       btw: Number of bytes to send
  * \param[out]      bw: Pointer to output variable to save number of sent data when successfully sent
- * \param[in]       fau: "Free After Use" flag. Set to `1` if stack should free the memory after data sent
+ * \param[in]       fau: "Free After Use" flag. Set to `1` if stack should free the memory after data sent.
+ *                      Memory is freed on every path, also when function fails.
+ *                      Only allowed in non-blocking mode
  * \param[in]       blocking: Status whether command should be blocking or not
  * \return          \ref lwcellOK on success, member of \ref lwcellr_t enumeration otherwise
  */
 static lwcellr_t
 conn_send(lwcell_conn_p conn, const lwcell_ip_t* const ip, lwcell_port_t port, const void* data, size_t btw,
           size_t* const bw, uint8_t fau, const uint32_t blocking) {
-    LWCELL_MSG_VAR_DEFINE(msg);
+    lwcellr_t res;
 
     LWCELL_ASSERT(conn != NULL);
     LWCELL_ASSERT(data != NULL);
     LWCELL_ASSERT(btw > 0);
+    LWCELL_ASSERT(!fau || !blocking);
+
+    if (bw != NULL) {
+        *bw = 0;
+    }
+
+    /* Once message is in the queue, processing thread frees the memory */
+    if ((res = conn_send_msg(conn, ip, port, data, btw, bw, fau, blocking)) != lwcellOK && fau) {
+        LWCELL_DEBUGF(LWCELL_CFG_DBG_CONN | LWCELL_DBG_TYPE_TRACE, "[LWCELL CONN] Free write buffer: %p\r\n", data);
+        lwcell_mem_free_s((void**)&data);
+    }
+    return res;
+}
+
+/**
+ * \brief           Send data segments on already active connection without copying them
+ * \param[in]       conn: Pointer to connection to send data
+ * \param[in]       iov: Array of data segments. Set to `NULL` when sending packet buffer chain
+ * \param[in]       iov_cnt: Number of entries in `iov` array
+ * \param[in]       pbuf: Packet buffer chain. Used only when `iov` is `NULL`
+ * \param[out]      bw: Pointer to output variable to save number of sent data when successfully sent
+ * \param[in]       blocking: Status whether command should be blocking or not
+ * \return          \ref lwcellOK on success, member of \ref lwcellr_t enumeration otherwise
+ */
+static lwcellr_t
+conn_send_segs(lwcell_conn_p conn, const lwcell_iovec_t* iov, size_t iov_cnt, lwcell_pbuf_p pbuf, size_t* const bw,
+               const uint32_t blocking) {
+    LWCELL_MSG_VAR_DEFINE(msg);
+    size_t btw = 0;
+
+    if (iov != NULL) {
+        for (size_t i = 0; i < iov_cnt; ++i) {
+            btw += iov[i].len;
+        }
+    } else if (pbuf != NULL) {
+        btw = pbuf->tot_len;
+    }
+    LWCELL_ASSERT(btw > 0);
 
     if (bw != NULL) {
         *bw = 0;
@@ -127,14 +430,18 @@ conn_send(lwcell_conn_p conn, const lwcell_ip_t* const ip, lwcell_port_t port, c
     LWCELL_MSG_VAR_REF(msg).cmd_def = LWCELL_CMD_CIPSEND;
 
     LWCELL_MSG_VAR_REF(msg).msg.conn_send.conn = conn;
-    LWCELL_MSG_VAR_REF(msg).msg.conn_send.data = data;
+    LWCELL_MSG_VAR_REF(msg).msg.conn_send.iov = iov;
+    LWCELL_MSG_VAR_REF(msg).msg.conn_send.iov_cnt = iov_cnt;
+    LWCELL_MSG_VAR_REF(msg).msg.conn_send.pbuf = pbuf;
     LWCELL_MSG_VAR_REF(msg).msg.conn_send.btw = btw;
     LWCELL_MSG_VAR_REF(msg).msg.conn_send.bw = bw;
-    LWCELL_MSG_VAR_REF(msg).msg.conn_send.remote_ip = ip;
-    LWCELL_MSG_VAR_REF(msg).msg.conn_send.remote_port = port;
-    LWCELL_MSG_VAR_REF(msg).msg.conn_send.fau = fau;
     LWCELL_MSG_VAR_REF(msg).msg.conn_send.val_id = lwcelli_conn_get_val_id(conn);
 
+#if LWCELL_CFG_CONN_TRANSPARENT
+    if (conn->type == LWCELL_CONN_TYPE_TCP_TRANSPARENT) {
+        return lwcelli_send_msg_to_producer_mbox(&LWCELL_MSG_VAR_REF(msg), conn_send_transparent, 60000);
+    }
+#endif /* LWCELL_CFG_CONN_TRANSPARENT */
     return lwcelli_send_msg_to_producer_mbox(&LWCELL_MSG_VAR_REF(msg), lwcelli_initiate_cmd, 60000);
 }
 
@@ -155,12 +462,10 @@ flush_buff(lwcell_conn_p conn) {
         if (conn->buff.ptr > 0) { /* Anything to send at the moment? */
             res = conn_send(conn, NULL, 0, conn->buff.buff, conn->buff.ptr, NULL, 1, 0);
         } else {
-            res = lwcellERR;
-        }
-        if (res != lwcellOK) {
             LWCELL_DEBUGF(LWCELL_CFG_DBG_CONN | LWCELL_DBG_TYPE_TRACE, "[LWCELL CONN] Free write buffer: %p\r\n",
                           (void*)conn->buff.buff);
             lwcell_mem_free_s((void**)&conn->buff.buff);
+            res = lwcellERR;
         }
         conn->buff.buff = NULL;
     }
@@ -193,10 +498,20 @@ lwcell_conn_start(lwcell_conn_p* conn, lwcell_conn_type_t type, const char* cons
     LWCELL_ASSERT(host != NULL);
     LWCELL_ASSERT(port > 0);
     LWCELL_ASSERT(conn_evt_fn != NULL);
+#if !LWCELL_CFG_CONN_TRANSPARENT
+    if (type == LWCELL_CONN_TYPE_TCP_TRANSPARENT) {
+        return lwcellERRPAR;
+    }
+#endif /* !LWCELL_CFG_CONN_TRANSPARENT */
 
     LWCELL_MSG_VAR_ALLOC(msg, blocking);
     LWCELL_MSG_VAR_REF(msg).cmd_def = LWCELL_CMD_CIPSTART;
     LWCELL_MSG_VAR_REF(msg).cmd = LWCELL_CMD_CIPSTATUS;
+#if LWCELL_CFG_CONN_TRANSPARENT
+    if (type == LWCELL_CONN_TYPE_TCP_TRANSPARENT) {
+        LWCELL_MSG_VAR_REF(msg).cmd = LWCELL_CMD_CIPMUX_SET_0; /* Switch to single connection mode first */
+    }
+#endif /* LWCELL_CFG_CONN_TRANSPARENT */
     LWCELL_MSG_VAR_REF(msg).msg.conn_start.num = LWCELL_CFG_MAX_CONNS; /* Set maximal value as invalid number */
     LWCELL_MSG_VAR_REF(msg).msg.conn_start.conn = conn;
     LWCELL_MSG_VAR_REF(msg).msg.conn_start.type = type;
@@ -217,6 +532,7 @@ lwcell_conn_start(lwcell_conn_p* conn, lwcell_conn_type_t type, const char* cons
 lwcellr_t
 lwcell_conn_close(lwcell_conn_p conn, const uint32_t blocking) {
     lwcellr_t res = lwcellOK;
+    uint32_t max_block_time = 1000;
     LWCELL_MSG_VAR_DEFINE(msg);
 
     LWCELL_ASSERT(conn != NULL);
@@ -228,9 +544,16 @@ lwcell_conn_close(lwcell_conn_p conn, const uint32_t blocking) {
     LWCELL_MSG_VAR_REF(msg).cmd_def = LWCELL_CMD_CIPCLOSE;
     LWCELL_MSG_VAR_REF(msg).msg.conn_close.conn = conn;
     LWCELL_MSG_VAR_REF(msg).msg.conn_close.val_id = lwcelli_conn_get_val_id(conn);
+#if LWCELL_CFG_CONN_TRANSPARENT
+    if (conn->type == LWCELL_CONN_TYPE_TCP_TRANSPARENT) {
+        /* Escape from data mode first, device waits for guard time before and after the sequence */
+        LWCELL_MSG_VAR_REF(msg).cmd = LWCELL_CMD_PPP;
+        max_block_time = 2 * LWCELL_CFG_CONN_TRANSPARENT_GUARD_TIME + 5000;
+    }
+#endif /* LWCELL_CFG_CONN_TRANSPARENT */
 
     flush_buff(conn);                   /* First flush buffer */
-    res = lwcelli_send_msg_to_producer_mbox(&LWCELL_MSG_VAR_REF(msg), lwcelli_initiate_cmd, 1000);
+    res = lwcelli_send_msg_to_producer_mbox(&LWCELL_MSG_VAR_REF(msg), lwcelli_initiate_cmd, max_block_time);
     if (res == lwcellOK && !blocking) { /* Function succedded in non-blocking mode */
         lwcell_core_lock();
         LWCELL_DEBUGF(LWCELL_CFG_DBG_CONN | LWCELL_DBG_TYPE_TRACE,
@@ -300,15 +623,60 @@ lwcell_conn_send(lwcell_conn_p conn, const void* data, size_t btw, size_t* const
     return res;
 }
 
+/**
+ * \brief           Send multiple data segments as one stream on already active connection
+ *
+ * Segments are written to AT port one after another, without copying them to intermediate buffer.
+ * Segment boundaries do not need to match AT command packet boundaries.
+ *
+ * \note            In non-blocking mode, `iov` array and all segment data must stay valid
+ *                  until \ref LWCELL_EVT_CONN_SEND event is received
+ * \param[in]       conn: Connection handle to send data
+ * \param[in]       iov: Array of data segments
+ * \param[in]       iov_cnt: Number of entries in `iov` array
+ * \param[out]      bw: Pointer to output variable to save number of sent data when successfully sent
+ * \param[in]       blocking: Status whether command should be blocking or not
+ * \return          \ref lwcellOK on success, member of \ref lwcellr_t enumeration otherwise
+ */
+lwcellr_t
+lwcell_conn_sendv(lwcell_conn_p conn, const lwcell_iovec_t* iov, size_t iov_cnt, size_t* const bw,
+                  const uint32_t blocking) {
+    LWCELL_ASSERT(conn != NULL);
+    LWCELL_ASSERT(iov != NULL);
+    LWCELL_ASSERT(iov_cnt > 0);
+
+    flush_buff(conn); /* Flush currently written memory if exists */
+    return conn_send_segs(conn, iov, iov_cnt, NULL, bw, blocking);
+}
+
+/**
+ * \brief           Send packet buffer chain on already active connection without copying it
+ * \note            In non-blocking mode, packet buffer must not be freed or modified
+ *                  until \ref LWCELL_EVT_CONN_SEND event is received
+ * \param[in]       conn: Connection handle to send data
+ * \param[in]       pbuf: Packet buffer chain to send, all buffers in chain are sent
+ * \param[out]      bw: Pointer to output variable to save number of sent data when successfully sent
+ * \param[in]       blocking: Status whether command should be blocking or not
+ * \return          \ref lwcellOK on success, member of \ref lwcellr_t enumeration otherwise
+ */
+lwcellr_t
+lwcell_conn_send_pbuf(lwcell_conn_p conn, lwcell_pbuf_p pbuf, size_t* const bw, const uint32_t blocking) {
+    LWCELL_ASSERT(conn != NULL);
+    LWCELL_ASSERT(pbuf != NULL);
+
+    flush_buff(conn); /* Flush currently written memory if exists */
+    return conn_send_segs(conn, NULL, 0, pbuf, bw, blocking);
+}
+
 /**
  * \brief           Notify connection about received data which means connection is ready to accept more data
  *
  * Once data reception is confirmed, stack will try to send more data to user.
  *
- * \note            Since this feature is not supported yet by AT commands, function is only prototype
- *                  and should be used in connection callback when data are received
- *
- * \note            Function is not thread safe and may only be called from connection event function
+ * \note            In manual receive mode (\ref LWCELL_CFG_CONN_MANUAL_RX), function must be called
+ *                  for every received packet buffer, once application processed it.
+ *                  It may be called from connection event function or later from any thread.
+ *                  In other modes, function has no effect
  *
  * \param[in]       conn: Connection handle
  * \param[in]       pbuf: Packet buffer received on connection
@@ -316,8 +684,24 @@ lwcell_conn_send(lwcell_conn_p conn, const void* data, size_t btw, size_t* const
  */
 lwcellr_t
 lwcell_conn_recved(lwcell_conn_p conn, lwcell_pbuf_p pbuf) {
+#if LWCELL_CFG_CONN_MANUAL_RX
+    size_t len;
+
+    LWCELL_ASSERT(conn != NULL);
+    LWCELL_ASSERT(pbuf != NULL);
+
+    len = lwcell_pbuf_length(pbuf, 1);
+    lwcell_core_lock();
+    conn->rx_unconfirmed -= LWCELL_MIN(conn->rx_unconfirmed, len);
+    if (conn->rx_pbufs > 0) {
+        --conn->rx_pbufs;
+    }
+    lwcelli_conn_manual_rx_read(conn); /* Window may be open again */
+    lwcell_core_unlock();
+#else  /* LWCELL_CFG_CONN_MANUAL_RX */
     LWCELL_UNUSED(conn);
     LWCELL_UNUSED(pbuf);
+#endif /* !LWCELL_CFG_CONN_MANUAL_RX */
     return lwcellOK;
 }
 
@@ -366,6 +750,41 @@ lwcell_get_conns_status(const uint32_t blocking) {
     return lwcelli_send_msg_to_producer_mbox(&LWCELL_MSG_VAR_REF(msg), lwcelli_initiate_cmd, 1000);
 }
 
+/**
+ * \brief           Enable or disable server mode to accept incoming TCP connections
+ *
+ * Every incoming connection is reported with \ref LWCELL_EVT_CONN_ACTIVE event
+ * to `server_evt_fn` callback, with \ref lwcell_conn_is_client returning `0`.
+ * Further events of the connection are sent to the same callback.
+ *
+ * \note            Device reports incoming connections only in multi-connection mode
+ * \param[in]       en: Set to `1` to enable server, `0` to disable it.
+ *                      Already accepted connections stay active when server is disabled
+ * \param[in]       port: Local port to listen on. Not used when disabling server
+ * \param[in]       server_evt_fn: Callback function for every incoming connection
+ * \param[in]       evt_fn: Callback function called when command has finished. Set to `NULL` when not used
+ * \param[in]       evt_arg: Custom argument for event callback function
+ * \param[in]       blocking: Status whether command should be blocking or not
+ * \return          \ref lwcellOK on success, member of \ref lwcellr_t enumeration otherwise
+ */
+lwcellr_t
+lwcell_set_server(uint8_t en, lwcell_port_t port, lwcell_evt_fn server_evt_fn, const lwcell_api_cmd_evt_fn evt_fn,
+                  void* const evt_arg, const uint32_t blocking) {
+    LWCELL_MSG_VAR_DEFINE(msg);
+
+    LWCELL_ASSERT(!en || port > 0);
+    LWCELL_ASSERT(!en || server_evt_fn != NULL);
+
+    LWCELL_MSG_VAR_ALLOC(msg, blocking);
+    LWCELL_MSG_VAR_SET_EVT(msg, evt_fn, evt_arg);
+    LWCELL_MSG_VAR_REF(msg).cmd_def = LWCELL_CMD_CIPSERVER;
+    LWCELL_MSG_VAR_REF(msg).msg.tcpip_server.en = en;
+    LWCELL_MSG_VAR_REF(msg).msg.tcpip_server.port = port;
+    LWCELL_MSG_VAR_REF(msg).msg.tcpip_server.evt_func = server_evt_fn;
+
+    return lwcelli_send_msg_to_producer_mbox(&LWCELL_MSG_VAR_REF(msg), lwcelli_initiate_cmd, 10000);
+}
+
 /**
  * \brief           Check if connection type is client
  * \param[in]       conn: Pointer to connection to check for status
@@ -461,6 +880,7 @@ lwcell_conn_get_from_evt(lwcell_evt_t* evt) {
  */
 lwcellr_t
 lwcell_conn_write(lwcell_conn_p conn, const void* data, size_t btw, uint8_t flush, size_t* const mem_available) {
+    lwcellr_t res = lwcellOK;
     size_t len;
     const uint8_t* d = data;
 
@@ -490,26 +910,22 @@ lwcell_conn_write(lwcell_conn_p conn, const void* data, size_t btw, uint8_t flus
 
         /* Step 1.1 */
         if (conn->buff.ptr == conn->buff.len || flush) {
-            /* Try to send to processing queue in non-blocking way */
-            if (conn_send(conn, NULL, 0, conn->buff.buff, conn->buff.ptr, NULL, 1, 0) != lwcellOK) {
-                LWCELL_DEBUGF(LWCELL_CFG_DBG_CONN | LWCELL_DBG_TYPE_TRACE, "[LWCELL CONN] Free write buffer: %p\r\n",
-                              conn->buff.buff);
-                lwcell_mem_free_s((void**)&conn->buff.buff);
-            }
+            /* Try to send to processing queue in non-blocking way, memory is freed in any case */
+            res = conn_send(conn, NULL, 0, conn->buff.buff, conn->buff.ptr, NULL, 1, 0);
             conn->buff.buff = NULL;
+            if (res != lwcellOK) {
+                return res;
+            }
         }
     }
 
     /* Step 2 */
     while (btw >= LWCELL_CFG_CONN_MAX_DATA_LEN) {
         uint8_t* buff;
-        buff = lwcell_mem_malloc(sizeof(*buff) * LWCELL_CFG_CONN_MAX_DATA_LEN);
+        buff = lwcell_mem_malloc_tag(sizeof(*buff) * LWCELL_CFG_CONN_MAX_DATA_LEN, LWCELL_MEM_TAG_CONN);
         if (buff != NULL) {
             LWCELL_MEMCPY(buff, d, LWCELL_CFG_CONN_MAX_DATA_LEN); /* Copy data to buffer */
             if (conn_send(conn, NULL, 0, buff, LWCELL_CFG_CONN_MAX_DATA_LEN, NULL, 1, 0) != lwcellOK) {
-                LWCELL_DEBUGF(LWCELL_CFG_DBG_CONN | LWCELL_DBG_TYPE_TRACE, "[LWCELL CONN] Free write buffer: %p\r\n",
-                              (void*)buff);
-                lwcell_mem_free_s((void**)&buff);
                 return lwcellERRMEM;
             }
         } else {
@@ -522,7 +938,8 @@ lwcell_conn_write(lwcell_conn_p conn, const void* data, size_t btw, uint8_t flus
 
     /* Step 3 */
     if (conn->buff.buff == NULL) {
-        conn->buff.buff = lwcell_mem_malloc(sizeof(*conn->buff.buff) * LWCELL_CFG_CONN_MAX_DATA_LEN);
+        conn->buff.buff =
+            lwcell_mem_malloc_tag(sizeof(*conn->buff.buff) * LWCELL_CFG_CONN_MAX_DATA_LEN, LWCELL_MEM_TAG_CONN);
         conn->buff.len = LWCELL_CFG_CONN_MAX_DATA_LEN;
         conn->buff.ptr = 0;
 
@@ -542,7 +959,11 @@ lwcell_conn_write(lwcell_conn_p conn, const void* data, size_t btw, uint8_t flus
 
     /* Step 4 */
     if (flush && conn->buff.buff != NULL) {
-        flush_buff(conn);
+        if (conn->buff.ptr > 0) {
+            res = flush_buff(conn);
+        } else {
+            flush_buff(conn); /* Nothing to send, only release buffer */
+        }
     }
 
     /* Calculate number of available memory after write operation */
@@ -553,7 +974,7 @@ lwcell_conn_write(lwcell_conn_p conn, const void* data, size_t btw, uint8_t flus
             *mem_available = 0;
         }
     }
-    return lwcellOK;
+    return res;
 }
 
 /**
@@ -574,6 +995,26 @@ lwcell_conn_get_total_recved_count(lwcell_conn_p conn) {
     return tot;
 }
 
+/**
+ * \brief           Get number of bytes sent on connection but not yet acknowledged by remote side
+ * \note            Value is updated in quick send mode only and is always `0` otherwise
+ * \param[in]       conn: Connection handle
+ * \return          Count of unacknowledged bytes on connection
+ * \sa              LWCELL_CFG_CONN_QSEND
+ */
+size_t
+lwcell_conn_get_unacked_count(lwcell_conn_p conn) {
+    size_t tot;
+
+    LWCELL_ASSERT(conn != NULL);
+
+    lwcell_core_lock();
+    tot = conn->tx_unacked; /* Get in-flight bytes */
+    lwcell_core_unlock();
+
+    return tot;
+}
+
 /**
  * \brief           Get connection remote IP address
  * \param[in]       conn: Connection handle
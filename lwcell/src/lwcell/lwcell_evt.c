@@ -34,13 +34,50 @@
 #include "lwcell/lwcell_evt.h"
 #include "lwcell/lwcell_private.h"
 
+/* Every event type must have its bit in event mask */
+typedef char lwcell_evt_mask_size_check_t[LWCELL_EVT_END <= 8 * sizeof(lwcell_evt_mask_t) ? 1 : -1];
+
 /**
  * \brief           Register callback function for global (non-connection based) events
  * \param[in]       fn: Callback function to call on specific event
  * \return          \ref lwcellOK on success, member of \ref lwcellr_t enumeration otherwise
+ * \sa              lwcell_evt_register_ex
  */
 lwcellr_t
 lwcell_evt_register(lwcell_evt_fn fn) {
+    return lwcell_evt_register_ex(fn, LWCELL_EVT_MASK_ALL);
+}
+
+/**
+ * \brief           Register callback function for selected global events only
+ *
+ * Function is only called for event types set in `mask`,
+ * which avoids calls for frequent events application is not interested in.
+ *
+ * \code{.c}
+ * lwcell_evt_register_ex(my_evt_fn, LWCELL_EVT_MASK(LWCELL_EVT_RESET) | LWCELL_EVT_MASK(LWCELL_EVT_SIM_STATE_CHANGED));
+ * \endcode
+ *
+ * \param[in]       fn: Callback function to call on specific event
+ * \param[in]       mask: Bitwise-ORed \ref LWCELL_EVT_MASK values of event types, or \ref LWCELL_EVT_MASK_ALL
+ * \return          \ref lwcellOK on success, member of \ref lwcellr_t enumeration otherwise
+ */
+lwcellr_t
+lwcell_evt_register_ex(lwcell_evt_fn fn, lwcell_evt_mask_t mask) {
+    return lwcelli_evt_register(fn, mask, 1);
+}
+
+/**
+ * \brief           Register callback function for global events
+ * \note            Used by internal modules, which must run with core lock held
+ * \param[in]       fn: Callback function to call on specific event
+ * \param[in]       mask: Bitwise-ORed \ref LWCELL_EVT_MASK values of event types, or \ref LWCELL_EVT_MASK_ALL
+ * \param[in]       defer: Set to `1` to call function from deferred dispatch when \ref LWCELL_CFG_EVT_DEFER is enabled,
+ *                      or `0` to always call it directly from processing thread
+ * \return          \ref lwcellOK on success, member of \ref lwcellr_t enumeration otherwise
+ */
+lwcellr_t
+lwcelli_evt_register(lwcell_evt_fn fn, lwcell_evt_mask_t mask, uint8_t defer) {
     lwcellr_t res = lwcellOK;
     lwcell_evt_func_t *func, *new_func;
 
@@ -61,9 +98,12 @@ lwcell_evt_register(lwcell_evt_fn fn) {
         if (new_func != NULL) {
             LWCELL_MEMSET(new_func, 0x00, sizeof(*new_func));
             new_func->fn = fn; /* Set function pointer */
+            new_func->mask = mask;
+            new_func->defer = defer;
             for (func = lwcell.evt_func; func != NULL && func->next != NULL; func = func->next) {}
             if (func != NULL) {
-                func->next = new_func; /* Set new function as next */
+                func->next = new_func;    /* Set new function as next */
+                lwcell.evt_tbl_dirty = 1; /* Rebuild dispatch table */
                 res = lwcellOK;
             } else {
                 lwcell_mem_free_s((void**)&new_func);
@@ -80,6 +120,8 @@ lwcell_evt_register(lwcell_evt_fn fn) {
 /**
  * \brief           Unregister callback function for global (non-connection based) events
  * \note            Function must be first registered using \ref lwcell_evt_register
+ * \note            With \ref LWCELL_CFG_EVT_DEFER, function may still be called from deferred dispatch
+ *                  for events queued before this call, even after this function returns
  * \param[in]       fn: Callback function to remove from event list
  * \return          \ref lwcellOK on success, member of \ref lwcellr_t enumeration otherwise
  */
@@ -93,6 +135,7 @@ lwcell_evt_unregister(lwcell_evt_fn fn) {
         if (func->fn == fn) {
             prev->next = func->next;
             lwcell_mem_free_s((void**)&func);
+            lwcell.evt_tbl_dirty = 1; /* Rebuild dispatch table */
             break;
         }
     }
@@ -100,6 +143,75 @@ lwcell_evt_unregister(lwcell_evt_fn fn) {
     return lwcellOK;
 }
 
+#if LWCELL_CFG_EVT_DEFER || __DOXYGEN__
+
+/**
+ * \brief           Dispatch events waiting in deferred queue
+ *
+ * Functions are called from thread calling this function, without core lock held,
+ * hence they may take long time and may call blocking API functions.
+ * This does not apply to events dispatched directly on queue overflow,
+ * when \ref LWCELL_CFG_EVT_DEFER_OVERFLOW is set to \ref LWCELL_EVT_DEFER_OVERFLOW_DIRECT.
+ *
+ * \note            Function is called by stack when \ref LWCELL_CFG_EVT_DEFER_THREAD is enabled.
+ *                  Otherwise application must call it, always from the same thread
+ *                  and never from event callback function
+ * \param[in]       timeout: Maximal time to wait for first event in units of milliseconds.
+ *                      Set to `0` to wait forever or \ref LWCELL_EVT_DISPATCH_NO_WAIT to return immediately
+ * \return          Number of dispatched events
+ */
+size_t
+lwcell_evt_dispatch(uint32_t timeout) {
+    size_t r, cnt = 0;
+
+    while (1) {
+        r = atomic_load_explicit(&lwcell.evt_defer_r, memory_order_relaxed);
+        if (r == atomic_load_explicit(&lwcell.evt_defer_w, memory_order_acquire)) {
+            if (cnt > 0 || timeout == LWCELL_EVT_DISPATCH_NO_WAIT
+                || lwcell_sys_sem_wait(&lwcell.evt_defer_sem, timeout) == LWCELL_SYS_TIMEOUT) {
+                break;
+            }
+            continue;
+        }
+        lwcelli_evt_defer_call(&lwcell.evt_defer[r % LWCELL_CFG_EVT_DEFER_LEN]);
+
+        /* Entry may be reused only after functions returned */
+        atomic_store_explicit(&lwcell.evt_defer_r, r + 1, memory_order_release);
+        ++cnt;
+    }
+    return cnt;
+}
+
+/**
+ * \brief           Get deferred event dispatch statistics
+ * \note            Dispatch fields are read while events may be dispatched,
+ *                  hence they are not necessarily consistent with each other
+ * \param[out]      stat: Pointer to output structure to fill
+ * \return          \ref lwcellOK on success, member of \ref lwcellr_t enumeration otherwise
+ */
+lwcellr_t
+lwcell_evt_get_defer_stat(lwcell_evt_defer_stat_t* stat) {
+    lwcell_evt_defer_disp_stat_t* disp = &lwcell.evt_defer_disp_stat;
+
+    LWCELL_ASSERT(stat != NULL);
+
+    lwcell_core_lock();
+    LWCELL_MEMCPY(stat, &lwcell.evt_defer_stat, sizeof(*stat));
+    lwcell_core_unlock();
+
+    /* Dispatch fields are modified by dispatching thread without core lock */
+    stat->dispatched = atomic_load_explicit(&disp->dispatched, memory_order_relaxed);
+    stat->lat_last = atomic_load_explicit(&disp->lat_last, memory_order_relaxed);
+    stat->lat_max = atomic_load_explicit(&disp->lat_max, memory_order_relaxed);
+    stat->lat_total = atomic_load_explicit(&disp->lat_total, memory_order_relaxed);
+    for (size_t i = 0; i < LWCELL_ARRAYSIZE(stat->lat_max_type); ++i) {
+        stat->lat_max_type[i] = atomic_load_explicit(&disp->lat_max_type[i], memory_order_relaxed);
+    }
+    return lwcellOK;
+}
+
+#endif /* LWCELL_CFG_EVT_DEFER || __DOXYGEN__ */
+
 /**
  * \brief           Get event type
  * \param[in]       cc: Event handle
@@ -458,8 +570,31 @@ lwcell_evt_sms_delete_get_mem(lwcell_evt_t* cc) {
  */
 const lwcell_call_t*
 lwcell_evt_call_changed_get_call(lwcell_evt_t* cc) {
-    LWCELL_UNUSED(cc);
-    return lwcell.evt.evt.call_changed.call;
+    return cc->evt.call_changed.call;
 }
 
 #endif /* LWCELL_CFG_CALL || __DOXYGEN__ */
+
+#if LWCELL_CFG_CMUX || __DOXYGEN__
+
+/**
+ * \brief           Get multiplexer channel with new data
+ * \param[in]       cc: Event handle
+ * \return          Channel DLCI
+ */
+uint8_t
+lwcell_evt_cmux_recv_get_dlci(lwcell_evt_t* cc) {
+    return cc->evt.cmux_recv.dlci;
+}
+
+/**
+ * \brief           Get number of bytes written to channel buffer
+ * \param[in]       cc: Event handle
+ * \return          Length of received data in units of bytes
+ */
+size_t
+lwcell_evt_cmux_recv_get_length(lwcell_evt_t* cc) {
+    return cc->evt.cmux_recv.len;
+}
+
+#endif /* LWCELL_CFG_CMUX || __DOXYGEN__ */
@@ -52,6 +52,46 @@ typedef struct {
     uint16_t is_error; /*!< Set to `1` if error is set from the command processing */
 } lwcell_status_flags_t;
 
+/**
+ * \brief           AT command descriptor
+ */
+typedef struct {
+    const char* str;                        /*!< AT command string, sent after `AT` prefix */
+    uint8_t str_len;                        /*!< Length of AT command string */
+    uint8_t final;                          /*!< Expected final response, \ref LWCELL_CMD_FINAL_OK or
+                                                \ref LWCELL_CMD_FINAL_DATA */
+    uint32_t timeout;                       /*!< Maximal time to wait for final response in units of milliseconds.
+                                                Set to `0` to only use blocking time of API call */
+    lwcellr_t (*prep_fn)(lwcell_msg_t* msg); /*!< Optional prepare function, called before command is sent */
+    void (*args_fn)(lwcell_msg_t* msg);     /*!< Optional function to send command arguments */
+} lwcell_cmd_desc_t;
+
+/**
+ * \brief           Single step of multi-step command sequence
+ */
+typedef struct {
+    lwcell_cmd_t cmd; /*!< Command to execute */
+    uint8_t flags;    /*!< Step flags, \ref LWCELL_CMD_STEP_F_CHECK_ERROR or \ref LWCELL_CMD_STEP_F_RETRY */
+} lwcell_cmd_step_t;
+
+/**
+ * \brief           Multi-step command sequence for default command
+ */
+typedef struct {
+    lwcell_cmd_t cmd_def;           /*!< Default command of the message */
+    const lwcell_cmd_step_t* steps; /*!< Array of steps, first step is start command */
+    size_t steps_len;               /*!< Number of steps */
+} lwcell_cmd_seq_t;
+
+#define LWCELL_CMD_STEP_F_CHECK_ERROR 0x01 /*!< Execute step only if previous step did not return error */
+#define LWCELL_CMD_STEP_F_RETRY       0x02 /*!< Repeat step when it returns error */
+
+#define LWCELL_CMD_STEP_RETRY_MAX   5    /*!< Maximal number of repetitions of step with \ref LWCELL_CMD_STEP_F_RETRY */
+#define LWCELL_CMD_STEP_RETRY_DELAY 1000 /*!< Delay before step is repeated in units of milliseconds */
+
+#define LWCELL_CMD_FINAL_OK   0 /*!< Command finishes with `OK` or `ERROR` */
+#define LWCELL_CMD_FINAL_DATA 1 /*!< `OK` is followed by command specific response, which finishes command */
+
 /* Receive character macros */
 #define RECV_ADD(ch)                                                                                                   \
     do {                                                                                                               \
@@ -118,6 +158,11 @@ typedef struct {
 
 static lwcell_recv_t recv_buff;
 static lwcellr_t lwcelli_process_sub_cmd(lwcell_msg_t* msg, lwcell_status_flags_t* stat);
+static void lwcelli_process_cmd_finished(lwcell_status_flags_t* stat);
+static uint8_t lwcelli_cmd_get_final(lwcell_cmd_t cmd);
+#if LWCELL_CFG_CONN && LWCELL_CFG_CONN_MANUAL_RX
+static lwcellr_t lwcelli_conn_manual_rx_alloc(lwcell_msg_t* msg);
+#endif /* LWCELL_CFG_CONN && LWCELL_CFG_CONN_MANUAL_RX */
 
 /**
  * \brief           Memory mapping
@@ -161,6 +206,22 @@ const size_t lwcell_dev_model_map_size = LWCELL_ARRAYSIZE(lwcell_dev_model_map);
         }                                                                                                              \
     } while (0)
 
+#if LWCELL_CFG_CONN_QSEND
+/**
+ * \brief           Cancel pending query of acknowledged bytes
+ * \param[in]       m: Send data message
+ */
+#define CONN_SEND_ACK_POLL_STOP(m)                                                                                     \
+    do {                                                                                                               \
+        if ((m)->msg.conn_send.ack_tmr != 0) {                                                                         \
+            lwcell_timeout_cancel((m)->msg.conn_send.ack_tmr);                                                         \
+            (m)->msg.conn_send.ack_tmr = 0;                                                                            \
+        }                                                                                                              \
+    } while (0)
+#else /* LWCELL_CFG_CONN_QSEND */
+#define CONN_SEND_ACK_POLL_STOP(m)
+#endif /* !LWCELL_CFG_CONN_QSEND */
+
 /**
  * \brief           Send connection callback for "data send"
  * \param[in]       m: Command message
@@ -168,6 +229,7 @@ const size_t lwcell_dev_model_map_size = LWCELL_ARRAYSIZE(lwcell_dev_model_map);
  */
 #define CONN_SEND_DATA_SEND_EVT(m, err)                                                                                \
     do {                                                                                                               \
+        CONN_SEND_ACK_POLL_STOP(m);                                                                                    \
         CONN_SEND_DATA_FREE(m);                                                                                        \
         lwcell.evt.type = LWCELL_EVT_CONN_SEND;                                                                        \
         lwcell.evt.evt.conn_data_send.res = err;                                                                       \
@@ -491,6 +553,11 @@ lwcelli_reset_everything(uint8_t forced) {
     }
 #endif /* LWCELL_CFG_NETWORK */
 
+#if LWCELL_CFG_PPP
+    /* Device is in command mode after reset */
+    lwcelli_ppp_reset();
+#endif /* LWCELL_CFG_PPP */
+
     /* Invalid GSM modules */
     LWCELL_MEMSET(&lwcell.m, 0x00, sizeof(lwcell.m));
 
@@ -499,19 +566,267 @@ lwcelli_reset_everything(uint8_t forced) {
     lwcell.m.model = LWCELL_DEVICE_MODEL_UNKNOWN;
 }
 
+/**
+ * \brief           Check if function is called from deferred dispatch for event type
+ * \param[in]       link: Registered function
+ * \param[in]       type: Event type
+ * \return          `1` if function is called from deferred dispatch, `0` if directly
+ */
+static uint8_t
+evt_is_deferred(const lwcell_evt_func_t* link, lwcell_evt_type_t type) {
+#if LWCELL_CFG_EVT_DEFER
+    if (!link->defer) {
+        return 0;
+    }
+
+    /* Events pointing to memory valid only during the call */
+    switch (type) {
+        case LWCELL_EVT_OPERATOR_SCAN:
+#if LWCELL_CFG_CONN
+        case LWCELL_EVT_CONN_RECV:
+        case LWCELL_EVT_CONN_SEND:
+        case LWCELL_EVT_CONN_ACTIVE:
+        case LWCELL_EVT_CONN_ERROR:
+        case LWCELL_EVT_CONN_CLOSE:
+        case LWCELL_EVT_CONN_POLL:
+#endif /* LWCELL_CFG_CONN */
+#if LWCELL_CFG_SMS
+        case LWCELL_EVT_SMS_READ:
+        case LWCELL_EVT_SMS_LIST:
+#endif /* LWCELL_CFG_SMS */
+#if LWCELL_CFG_PHONEBOOK
+        case LWCELL_EVT_PB_LIST:
+        case LWCELL_EVT_PB_SEARCH:
+#endif /* LWCELL_CFG_PHONEBOOK */
+            return 0;
+        default: return 1;
+    }
+#else  /* LWCELL_CFG_EVT_DEFER */
+    LWCELL_UNUSED(link);
+    LWCELL_UNUSED(type);
+    return 0;
+#endif /* !LWCELL_CFG_EVT_DEFER */
+}
+
+/**
+ * \brief           Build table of registered callback functions per event type
+ * \note            When memory cannot be allocated, table stays marked for rebuild
+ *                  and events are dispatched by checking every registered function
+ */
+static void
+evt_tbl_build(void) {
+    lwcell_evt_tbl_t* tbl;
+    size_t cnt = 0, i = 0;
+
+    for (lwcell_evt_func_t* link = lwcell.evt_func; link != NULL; link = link->next) {
+        for (size_t t = 0; t < LWCELL_EVT_END; ++t) {
+            if (link->mask & LWCELL_EVT_MASK(t)) {
+                ++cnt;
+            }
+        }
+    }
+    tbl = lwcell_mem_malloc(sizeof(*tbl) + cnt * sizeof(*tbl->fns));
+    if (tbl != NULL) {
+        tbl->fns = (lwcell_evt_fn*)(void*)&tbl[1];
+        for (size_t t = 0; t < LWCELL_EVT_END; ++t) {
+            tbl->first[t] = (uint16_t)i;
+            for (lwcell_evt_func_t* link = lwcell.evt_func; link != NULL; link = link->next) {
+                if ((link->mask & LWCELL_EVT_MASK(t)) && !evt_is_deferred(link, (lwcell_evt_type_t)t)) {
+                    tbl->fns[i++] = link->fn;
+                }
+            }
+#if LWCELL_CFG_EVT_DEFER
+            tbl->defer[t] = (uint16_t)i;
+            for (lwcell_evt_func_t* link = lwcell.evt_func; link != NULL; link = link->next) {
+                if ((link->mask & LWCELL_EVT_MASK(t)) && evt_is_deferred(link, (lwcell_evt_type_t)t)) {
+                    tbl->fns[i++] = link->fn;
+                }
+            }
+#endif /* LWCELL_CFG_EVT_DEFER */
+        }
+        tbl->first[LWCELL_EVT_END] = (uint16_t)i;
+#if LWCELL_CFG_EVT_DEFER
+        atomic_init(&tbl->ref, 1);
+#endif /* LWCELL_CFG_EVT_DEFER */
+        lwcell.evt_tbl_dirty = 0;
+    }
+#if LWCELL_CFG_EVT_DEFER
+    /* Table still referenced by queued events is freed after their dispatch */
+    if (lwcell.evt_tbl != NULL && atomic_fetch_sub_explicit(&lwcell.evt_tbl->ref, 1, memory_order_acq_rel) != 1) {
+        lwcell.evt_tbl = NULL;
+    }
+#endif /* LWCELL_CFG_EVT_DEFER */
+    if (lwcell.evt_tbl != NULL) {
+        lwcell_mem_free_s((void**)&lwcell.evt_tbl);
+    }
+    lwcell.evt_tbl = tbl;
+}
+
+#if LWCELL_CFG_EVT_DEFER || __DOXYGEN__
+
+/**
+ * \brief           Copy current event to deferred queue
+ * \return          `1` on success, `0` if queue is full
+ */
+static uint8_t
+evt_defer_put(void) {
+    lwcell_evt_defer_entry_t* entry;
+    size_t w, used;
+
+    w = atomic_load_explicit(&lwcell.evt_defer_w, memory_order_relaxed);
+    used = w - atomic_load_explicit(&lwcell.evt_defer_r, memory_order_acquire);
+    if (used >= LWCELL_CFG_EVT_DEFER_LEN) {
+        ++lwcell.evt_defer_stat.overflow;
+        return 0;
+    }
+
+    entry = &lwcell.evt_defer[w % LWCELL_CFG_EVT_DEFER_LEN];
+    LWCELL_MEMCPY(&entry->evt, &lwcell.evt, sizeof(entry->evt));
+    entry->time = lwcell_sys_now();
+
+    /* Keep table alive until event is dispatched, even if functions are registered in the meantime */
+    entry->tbl = NULL;
+    if (lwcell.evt_tbl != NULL && !lwcell.evt_tbl_dirty) {
+        entry->tbl = lwcell.evt_tbl;
+        atomic_fetch_add_explicit(&entry->tbl->ref, 1, memory_order_relaxed);
+    }
+
+    /* Point to copy, original is modified by next response */
+    if (entry->evt.type == LWCELL_EVT_NETWORK_OPERATOR_CURRENT
+        && entry->evt.evt.operator_current.operator_current != NULL) {
+        LWCELL_MEMCPY(&entry->data.operator_current, entry->evt.evt.operator_current.operator_current,
+                      sizeof(entry->data.operator_current));
+        entry->evt.evt.operator_current.operator_current = &entry->data.operator_current;
+#if LWCELL_CFG_CALL
+    } else if (entry->evt.type == LWCELL_EVT_CALL_CHANGED && entry->evt.evt.call_changed.call != NULL) {
+        LWCELL_MEMCPY(&entry->data.call, entry->evt.evt.call_changed.call, sizeof(entry->data.call));
+        entry->evt.evt.call_changed.call = &entry->data.call;
+#endif /* LWCELL_CFG_CALL */
+    }
+    atomic_store_explicit(&lwcell.evt_defer_w, w + 1, memory_order_release);
+
+    ++lwcell.evt_defer_stat.queued;
+    if (used + 1 > lwcell.evt_defer_stat.used_max) {
+        lwcell.evt_defer_stat.used_max = (uint32_t)(used + 1);
+    }
+    lwcell_sys_sem_release(&lwcell.evt_defer_sem); /* Wakeup dispatcher */
+    return 1;
+}
+
+/**
+ * \brief           Call deferred functions for event taken from queue
+ *
+ * Functions are called without core lock held,
+ * from table referenced when event was put to queue
+ *
+ * \param[in]       entry: Queue entry with event to dispatch
+ */
+void
+lwcelli_evt_defer_call(lwcell_evt_defer_entry_t* entry) {
+    lwcell_evt_defer_disp_stat_t* stat = &lwcell.evt_defer_disp_stat;
+    lwcell_evt_type_t type = entry->evt.type;
+    lwcell_evt_tbl_t* tbl = entry->tbl;
+    uint32_t lat;
+
+    /* Only this thread modifies dispatch statistics, atomics protect concurrent readers */
+    lat = lwcell_sys_now() - entry->time;
+    atomic_fetch_add_explicit(&stat->dispatched, 1, memory_order_relaxed);
+    atomic_store_explicit(&stat->lat_last, lat, memory_order_relaxed);
+    atomic_fetch_add_explicit(&stat->lat_total, lat, memory_order_relaxed);
+    if (lat > atomic_load_explicit(&stat->lat_max, memory_order_relaxed)) {
+        atomic_store_explicit(&stat->lat_max, lat, memory_order_relaxed);
+    }
+    if (lat > atomic_load_explicit(&stat->lat_max_type[type], memory_order_relaxed)) {
+        atomic_store_explicit(&stat->lat_max_type[type], lat, memory_order_relaxed);
+    }
+
+    if (tbl != NULL) {
+        for (size_t i = tbl->defer[type]; i < tbl->first[type + 1]; ++i) {
+            tbl->fns[i](&entry->evt);
+        }
+        if (atomic_fetch_sub_explicit(&tbl->ref, 1, memory_order_acq_rel) == 1) {
+            lwcell_mem_free(tbl); /* Table has been replaced in the meantime */
+        }
+    } else {
+        /* Table was not available, call functions from linked list with core lock held */
+        lwcell_core_lock();
+        for (lwcell_evt_func_t* link = lwcell.evt_func; link != NULL; link = link->next) {
+            if ((link->mask & LWCELL_EVT_MASK(type)) && evt_is_deferred(link, type)) {
+                link->fn(&entry->evt);
+            }
+        }
+        lwcell_core_unlock();
+    }
+}
+
+#endif /* LWCELL_CFG_EVT_DEFER || __DOXYGEN__ */
+
 /**
  * \brief           Process callback function to user with specific type
+ *
+ * With \ref LWCELL_CFG_EVT_DEFER, functions registered by application
+ * are called later from deferred dispatch, after event is copied to queue
+ *
  * \param[in]       type: Callback event type
  * \return          Member of \ref lwcellr_t enumeration
  */
 lwcellr_t
 lwcelli_send_cb(lwcell_evt_type_t type) {
+    uint8_t defer = 0;
+
     lwcell.evt.type = type; /* Set callback type to process */
 
-    /* Call callback function for all registered functions */
-    for (lwcell_evt_func_t* link = lwcell.evt_func; link != NULL; link = link->next) {
-        link->fn(&lwcell.evt);
+    /*
+     * Table is only rebuilt when no other event is being dispatched,
+     * as callback function may register new function while table is in use
+     */
+    if (lwcell.evt_tbl_dirty && lwcell.evt_cb_depth == 0) {
+        evt_tbl_build();
+    }
+
+    ++lwcell.evt_cb_depth;
+    if (lwcell.evt_tbl != NULL && !lwcell.evt_tbl_dirty && (size_t)type < LWCELL_EVT_END) {
+        size_t end = lwcell.evt_tbl->first[type + 1];
+
+#if LWCELL_CFG_EVT_DEFER
+        if (lwcell.evt_tbl->defer[type] < end) {
+            end = lwcell.evt_tbl->defer[type];
+            defer = 1;
+        }
+#endif /* LWCELL_CFG_EVT_DEFER */
+
+        /* Call only functions subscribed to event type */
+        for (size_t i = lwcell.evt_tbl->first[type]; i < end; ++i) {
+            lwcell.evt_tbl->fns[i](&lwcell.evt);
+        }
+    } else {
+        /* Table not available or outdated, check every registered function */
+        for (lwcell_evt_func_t* link = lwcell.evt_func; link != NULL; link = link->next) {
+            if (link->mask & LWCELL_EVT_MASK(type)) {
+                if (evt_is_deferred(link, type)) {
+                    defer = 1;
+                } else {
+                    link->fn(&lwcell.evt);
+                }
+            }
+        }
+    }
+
+#if LWCELL_CFG_EVT_DEFER
+    if (defer && !evt_defer_put()) {
+#if LWCELL_CFG_EVT_DEFER_OVERFLOW == LWCELL_EVT_DEFER_OVERFLOW_DIRECT
+        /* Queue is full, call deferred functions directly */
+        for (lwcell_evt_func_t* link = lwcell.evt_func; link != NULL; link = link->next) {
+            if ((link->mask & LWCELL_EVT_MASK(type)) && evt_is_deferred(link, type)) {
+                link->fn(&lwcell.evt);
+            }
+        }
+#endif /* LWCELL_CFG_EVT_DEFER_OVERFLOW == LWCELL_EVT_DEFER_OVERFLOW_DIRECT */
     }
+#else  /* LWCELL_CFG_EVT_DEFER */
+    LWCELL_UNUSED(defer);
+#endif /* !LWCELL_CFG_EVT_DEFER */
+    --lwcell.evt_cb_depth;
     return lwcellOK;
 }
 
@@ -556,35 +871,45 @@ lwcelli_send_conn_cb(lwcell_conn_t* conn, lwcell_evt_fn evt) {
 }
 
 /**
- * \brief           Process and send data from device buffer
- * \return          Member of \ref lwcellr_t enumeration
+ * \brief           Write current data chunk of send command to AT port
+ *
+ * Chunk starts at `ptr` offset of all data and is `sent` bytes long.
+ * Segmented data are written piece by piece, directly from user memory
+ *
+ * \param[in]       msg: Send data message
  */
-static lwcellr_t
-lwcelli_tcpip_process_send_data(void) {
-    lwcell_conn_t* c = lwcell.msg->msg.conn_send.conn;
-    if (!lwcell_conn_is_active(c) ||                  /* Is the connection already closed? */
-        lwcell.msg->msg.conn_send.val_id != c->val_id /* Did validation ID change after we set parameter? */
-    ) {
-        /* Send event to user about failed send event */
-        CONN_SEND_DATA_SEND_EVT(lwcell.msg, lwcellCLOSED);
-        return lwcellERR;
-    }
-    lwcell.msg->msg.conn_send.sent = LWCELL_MIN(lwcell.msg->msg.conn_send.btw, LWCELL_CFG_CONN_MAX_DATA_LEN);
-
-    AT_PORT_SEND_BEGIN_AT();
-    AT_PORT_SEND_CONST_STR("+CIPSEND=");
-    lwcelli_send_number(LWCELL_U32(c->num), 0, 0);                         /* Send connection number */
-    lwcelli_send_number(LWCELL_U32(lwcell.msg->msg.conn_send.sent), 0, 1); /* Send length number */
-
-    /* On UDP connections, IP address and port may be selected */
-    if (c->type == LWCELL_CONN_TYPE_UDP) {
-        if (lwcell.msg->msg.conn_send.remote_ip != NULL && lwcell.msg->msg.conn_send.remote_port) {
-            lwcelli_send_ip_mac(lwcell.msg->msg.conn_send.remote_ip, 1, 1, 1); /* Send IP address including quotes */
-            lwcelli_send_port(lwcell.msg->msg.conn_send.remote_port, 0, 1);    /* Send length number */
+static void
+lwcelli_tcpip_send_chunk(lwcell_msg_t* msg) {
+    size_t off = msg->msg.conn_send.ptr, rem = msg->msg.conn_send.sent, len;
+
+    if (msg->msg.conn_send.data != NULL) {
+        AT_PORT_SEND(&msg->msg.conn_send.data[off], rem);
+    } else if (msg->msg.conn_send.iov != NULL) {
+        const lwcell_iovec_t* iov = msg->msg.conn_send.iov;
+
+        for (size_t i = 0; i < msg->msg.conn_send.iov_cnt && rem > 0; ++i) {
+            if (off >= iov[i].len) { /* Skip segments sent in previous chunks */
+                off -= iov[i].len;
+                continue;
+            }
+            len = LWCELL_MIN(iov[i].len - off, rem);
+            AT_PORT_SEND((const uint8_t*)iov[i].data + off, len);
+            rem -= len;
+            off = 0;
+        }
+    } else {
+        for (lwcell_pbuf_p p = msg->msg.conn_send.pbuf; p != NULL && rem > 0; p = p->next) {
+            if (off >= p->len) { /* Skip buffers sent in previous chunks */
+                off -= p->len;
+                continue;
+            }
+            len = LWCELL_MIN(p->len - off, rem);
+            AT_PORT_SEND(&p->payload[off], len);
+            rem -= len;
+            off = 0;
         }
     }
-    AT_PORT_SEND_END_AT();
-    return lwcellOK;
+    AT_PORT_SEND_FLUSH();
 }
 
 /**
@@ -611,7 +936,7 @@ lwcelli_tcpip_process_data_sent(uint8_t sent) {
         }
     }
     if (lwcell.msg->msg.conn_send.btw > 0) {                 /* Do we still have data to send? */
-        if (lwcelli_tcpip_process_send_data() != lwcellOK) { /* Check if we can continue */
+        if (lwcelli_initiate_cmd(lwcell.msg) != lwcellOK) { /* Check if we can continue */
             return 1;                                        /* Finish at this point */
         }
         return 0;                                            /* We still have data to send */
@@ -644,6 +969,20 @@ lwcelli_process_cipsend_response(lwcell_recv_t* rcv, lwcell_status_flags_t* stat
                 }
             }
             LWCELL_UNUSED(num);
+#if LWCELL_CFG_CONN_QSEND
+        } else if (!strncmp(rcv->data, "DATA ACCEPT:", 12)) {
+            lwcell_conn_p conn = lwcell.msg->msg.conn_send.conn;
+
+            /* Data are in device buffer, remote side acknowledges them later */
+            lwcell.msg->msg.conn_send.wait_send_ok_err = 0;
+            if (conn->type == LWCELL_CONN_TYPE_TCP) {
+                conn->tx_unacked += lwcell.msg->msg.conn_send.sent;
+            }
+            stat->is_ok = lwcelli_tcpip_process_data_sent(1);
+            if (stat->is_ok && conn->status.f.active) {
+                CONN_SEND_DATA_SEND_EVT(lwcell.msg, lwcellOK);
+            }
+#endif /* LWCELL_CFG_CONN_QSEND */
         }
         /* Check for an error or if connection closed in the meantime */
     } else if (stat->is_error) {
@@ -651,6 +990,63 @@ lwcelli_process_cipsend_response(lwcell_recv_t* rcv, lwcell_status_flags_t* stat
     }
 }
 
+#if LWCELL_CFG_CONN_QSEND || __DOXYGEN__
+
+/**
+ * \brief           Timeout callback to query acknowledged bytes again
+ * \param[in]       arg: Send data message, waiting for window to open
+ */
+static void
+lwcelli_tcpip_ack_poll_fn(void* arg) {
+    lwcell_msg_t* msg = arg;
+
+    /* Timeout is cancelled when command finishes, message is still valid here */
+    msg->msg.conn_send.ack_tmr = 0;
+    if (lwcell.msg != msg || !CMD_IS_CUR(LWCELL_CMD_CIPACK)) {
+        return;
+    }
+    if (lwcelli_initiate_cmd(msg) != lwcellOK) {
+        CONN_SEND_DATA_SEND_EVT(msg, lwcellERR);
+        msg->res = lwcellERR;
+        lwcell_sys_sem_release(&lwcell.sem_sync);
+    }
+}
+
+/**
+ * \brief           Process CIPACK response in quick send mode
+ *
+ * Sending continues when next chunk fits into in-flight window,
+ * otherwise acknowledged bytes are queried again after \ref LWCELL_CFG_CONN_QSEND_POLL_INTERVAL
+ *
+ * \param[in]       rcv: Received data
+ * \param[in,out]   stat: Status flags
+ */
+static void
+lwcelli_process_cipack_response(lwcell_recv_t* rcv, lwcell_status_flags_t* stat) {
+    lwcell_msg_t* msg = lwcell.msg;
+    lwcell_conn_p conn = msg->msg.conn_send.conn;
+
+    if (stat->is_ok) {
+        stat->is_ok = 0; /* Send command is not finished yet */
+        if ((conn->tx_unacked + LWCELL_MIN(msg->msg.conn_send.btw, LWCELL_CFG_CONN_MAX_DATA_LEN))
+            <= LWCELL_CFG_CONN_QSEND_WINDOW) {
+            msg->cmd = LWCELL_CMD_CIPSEND;
+            stat->is_error = lwcelli_initiate_cmd(msg) != lwcellOK;
+        } else {
+            if (lwcell_timeout_add_ex(LWCELL_CFG_CONN_QSEND_POLL_INTERVAL, lwcelli_tcpip_ack_poll_fn, msg,
+                                      &msg->msg.conn_send.ack_tmr)
+                != lwcellOK) {
+                stat->is_error = lwcelli_initiate_cmd(msg) != lwcellOK; /* Query again immediately */
+            }
+        }
+    } else if (stat->is_error) {
+        CONN_SEND_DATA_SEND_EVT(msg, lwcellERR);
+    }
+    LWCELL_UNUSED(rcv);
+}
+
+#endif /* LWCELL_CFG_CONN_QSEND || __DOXYGEN__ */
+
 /**
  * \brief           Send error event to application layer
  * \param[in]       msg: Message from user with connection start
@@ -686,6 +1082,60 @@ lwcelli_is_valid_conn_ptr(lwcell_conn_p conn) {
     return 0;
 }
 
+/**
+ * \brief           Reset connection structure and set it active after successful connection start
+ * \param[in]       num: Connection number
+ * \param[in]       client: Set to `1` for connection started by stack, `0` for incoming server connection
+ * \param[in]       evt_func: Connection callback function
+ * \param[in]       arg: Connection custom argument
+ * \return          Connection handle
+ */
+static lwcell_conn_t*
+lwcelli_conn_activate(uint8_t num, uint8_t client, lwcell_evt_fn evt_func, void* arg) {
+    lwcell_conn_t* conn = &lwcell.m.conns[num]; /* Get connection handle */
+    uint8_t id = conn->val_id;
+
+    LWCELL_MEMSET(conn, 0x00, sizeof(*conn)); /* Reset connection parameters */
+    conn->num = num;
+    conn->status.f.active = 1;
+    conn->val_id = ++id; /* Set new validation ID */
+
+    /* Set connection parameters */
+    conn->status.f.client = client;
+    conn->evt_func = evt_func;
+    conn->arg = arg;
+    return conn;
+}
+
+/**
+ * \brief           Process incoming connection accepted by server
+ * \param[in]       num: Connection number
+ * \param[in]       str: Remote IP address string
+ */
+static void
+lwcelli_conn_server_accepted(uint8_t num, const char* str) {
+    lwcell_conn_t* conn;
+
+    if (num >= LWCELL_CFG_MAX_CONNS) {
+        return;
+    }
+
+    /* Connection without server callback is closed when event is sent */
+    conn = lwcelli_conn_activate(num, 0, lwcell.m.server_evt_func, NULL);
+    conn->type = LWCELL_CONN_TYPE_TCP;
+    conn->local_port = lwcell.m.server_port;
+    lwcelli_parse_ip(&str, &conn->remote_ip);
+
+    lwcell.evt.type = LWCELL_EVT_CONN_ACTIVE;
+    lwcell.evt.evt.conn_active_close.client = 0;
+    lwcell.evt.evt.conn_active_close.conn = conn;
+    lwcell.evt.evt.conn_active_close.forced = 0;
+    lwcelli_send_conn_cb(conn, NULL);
+    if (conn->status.f.active) {
+        lwcelli_conn_start_timeout(conn);
+    }
+}
+
 /**
  * \brief           Connection close event detected, process with callback to user
  * \param[in]       conn_num: Connection number
@@ -697,6 +1147,14 @@ lwcelli_conn_closed_process(uint8_t conn_num, uint8_t forced) {
     lwcell_conn_t* conn = &lwcell.m.conns[conn_num];
 
     conn->status.f.active = 0;
+#if LWCELL_CFG_CONN_TRANSPARENT
+    if (lwcell.m.transp.conn == conn) { /* Device is in command mode again */
+        if (lwcell.m.transp.tmr != 0) {
+            lwcell_timeout_cancel(lwcell.m.transp.tmr);
+        }
+        LWCELL_MEMSET(&lwcell.m.transp, 0x00, sizeof(lwcell.m.transp));
+    }
+#endif /* LWCELL_CFG_CONN_TRANSPARENT */
 
     /* Check if write buffer is set */
     if (conn->buff.buff != NULL) {
@@ -719,116 +1177,328 @@ lwcelli_conn_closed_process(uint8_t conn_num, uint8_t forced) {
 #endif /* LWCELL_CFG_CONN || __DOXYGEN__ */
 
 /**
- * \brief           Process received string from GSM
+ * \brief           URC and response handler for lines starting with `+` sign
  * \param[in]       rcv: Pointer to \ref lwcell_recv_t structure with input string
+ * \param[in,out]   stat: Processing status flags of current line
  */
+typedef void (*lwcell_urc_fn)(lwcell_recv_t* rcv, lwcell_status_flags_t* stat);
+
+/**
+ * \brief           Entry of `+` prefix dispatch table
+ */
+typedef struct {
+    const char* prefix; /*!< Prefix name without leading `+` sign, up to first delimiter */
+    uint8_t len;        /*!< Length of prefix in units of characters */
+    lwcell_urc_fn fn;   /*!< Handler function */
+} lwcell_urc_t;
+
+/* Delimiter that terminates prefix name in received string */
+#define URC_IS_DELIM(ch)            ((ch) == ':' || (ch) == ',' || (ch) == ' ' || (ch) == '\r' || (ch) == '\n')
+
 static void
-lwcelli_parse_received(lwcell_recv_t* rcv) {
-    lwcell_status_flags_t stat = {0};
+urc_cme(lwcell_recv_t* rcv, lwcell_status_flags_t* stat) {
+    LWCELL_UNUSED(rcv);
+    stat->is_error = 1; /* +CME and +CMS coded errors */
+}
 
-    /* Try to remove non-parsable strings */
-    if (rcv->len == 2 && rcv->data[0] == '\r' && rcv->data[1] == '\n') {
-        return;
-    }
+static void
+urc_csq(lwcell_recv_t* rcv, lwcell_status_flags_t* stat) {
+    LWCELL_UNUSED(stat);
+    lwcelli_parse_csq(rcv->data); /* Parse +CSQ response */
+}
 
-    /* Check OK response */
-    stat.is_ok = rcv->len == (2 + CRLF_LEN) && !strcmp(rcv->data, "OK" CRLF); /* Check if received string is OK */
-    if (!stat.is_ok) {                                                        /* Check for SHUT OK string */
-        stat.is_ok = rcv->len == (7 + CRLF_LEN) && !strcmp(rcv->data, "SEND OK" CRLF);
-    }
-
-    /* Check error response */
-    if (!stat.is_ok) {                                                        /* If still not ok, check if error? */
-        stat.is_error =
-            rcv->data[0] == '+' && !strncmp(rcv->data, "+CME ERROR", 10);     /* First check +CME coded errors */
-        if (!stat.is_error) {                                                 /* Check basic error aswell */
-            stat.is_error =
-                rcv->data[0] == '+' && !strncmp(rcv->data, "+CMS ERROR", 10); /* First check +CME coded errors */
-            if (!stat.is_error) {
-                stat.is_error = !strcmp(rcv->data, "ERROR" CRLF) || !strcmp(rcv->data, "FAIL" CRLF);
-            }
-        }
+static void
+urc_creg(lwcell_recv_t* rcv, lwcell_status_flags_t* stat) {
+    LWCELL_UNUSED(stat);
+    lwcelli_parse_creg(rcv->data, LWCELL_U8(CMD_IS_CUR(LWCELL_CMD_CREG_GET))); /* Parse +CREG response */
+}
+
+static void
+urc_cpin(lwcell_recv_t* rcv, lwcell_status_flags_t* stat) {
+    LWCELL_UNUSED(stat);
+    lwcelli_parse_cpin(rcv->data, 1 /* !CMD_IS_DEF(LWCELL_CMD_CPIN_SET) */); /* Parse +CPIN response */
+}
+
+static void
+urc_cops(lwcell_recv_t* rcv, lwcell_status_flags_t* stat) {
+    LWCELL_UNUSED(stat);
+    if (CMD_IS_CUR(LWCELL_CMD_COPS_GET)) {
+        lwcelli_parse_cops(rcv->data); /* Parse current +COPS */
     }
+}
 
-    /* Scan received strings which start with '+' */
-    if (rcv->data[0] == '+') {
-        if (!strncmp(rcv->data, "+CSQ", 4)) {
-            lwcelli_parse_csq(rcv->data); /* Parse +CSQ response */
 #if LWCELL_CFG_NETWORK
-        } else if (!strncmp(rcv->data, "+PDP: DEACT", 11)) {
-            /* PDP has been deactivated */
-            lwcell_network_check_status(NULL, NULL, 0); /* Update status */
-#endif                                                  /* LWCELL_CFG_NETWORK */
+static void
+urc_pdp(lwcell_recv_t* rcv, lwcell_status_flags_t* stat) {
+    LWCELL_UNUSED(stat);
+    if (!strncmp(rcv->data, "+PDP: DEACT", 11)) {
+        /* PDP has been deactivated */
+        lwcell_network_check_status(NULL, NULL, 0); /* Update status */
+    }
+}
+#endif /* LWCELL_CFG_NETWORK */
+
 #if LWCELL_CFG_CONN
-        } else if (!strncmp(rcv->data, "+RECEIVE", 8)) {
-            lwcelli_parse_ipd(rcv->data);                                              /* Parse IPD */
-#endif                                                                                 /* LWCELL_CFG_CONN */
-        } else if (!strncmp(rcv->data, "+CREG", 5)) {                                  /* Check for +CREG indication */
-            lwcelli_parse_creg(rcv->data, LWCELL_U8(CMD_IS_CUR(LWCELL_CMD_CREG_GET))); /* Parse +CREG response */
-        } else if (!strncmp(rcv->data, "+CPIN", 5)) { /* Check for +CPIN indication for SIM */
-            lwcelli_parse_cpin(rcv->data, 1 /* !CMD_IS_DEF(LWCELL_CMD_CPIN_SET) */); /* Parse +CPIN response */
-        } else if (CMD_IS_CUR(LWCELL_CMD_COPS_GET) && !strncmp(rcv->data, "+COPS", 5)) {
-            lwcelli_parse_cops(rcv->data);                                           /* Parse current +COPS */
+static void
+urc_receive(lwcell_recv_t* rcv, lwcell_status_flags_t* stat) {
+    LWCELL_UNUSED(stat);
+    lwcelli_parse_ipd(rcv->data); /* Parse IPD */
+}
+
+#if LWCELL_CFG_CONN_QSEND
+static void
+urc_cipack(lwcell_recv_t* rcv, lwcell_status_flags_t* stat) {
+    LWCELL_UNUSED(stat);
+    if (CMD_IS_CUR(LWCELL_CMD_CIPACK)) {
+        lwcelli_parse_cipack(rcv->data, lwcell.msg->msg.conn_send.conn); /* Parse +CIPACK response */
+    }
+}
+#endif /* LWCELL_CFG_CONN_QSEND */
+
+#if LWCELL_CFG_CONN_MANUAL_RX
+static void
+urc_ciprxget(lwcell_recv_t* rcv, lwcell_status_flags_t* stat) {
+    LWCELL_UNUSED(stat);
+    lwcelli_parse_ciprxget(rcv->data); /* Parse data notification or read response */
+}
+#endif /* LWCELL_CFG_CONN_MANUAL_RX */
+#endif /* LWCELL_CFG_CONN */
+
 #if LWCELL_CFG_SMS
-        } else if (CMD_IS_CUR(LWCELL_CMD_CMGS) && !strncmp(rcv->data, "+CMGS", 5)) {
-            lwcelli_parse_cmgs(rcv->data, &lwcell.msg->msg.sms_send.pos); /* Parse +CMGS response */
-        } else if (CMD_IS_CUR(LWCELL_CMD_CMGR) && !strncmp(rcv->data, "+CMGR", 5)) {
-            if (lwcelli_parse_cmgr(rcv->data)) {                          /* Parse +CMGR response */
-                lwcell.msg->msg.sms_read.read = 2;                        /* Set read flag and process the data */
-            } else {
-                lwcell.msg->msg.sms_read.read = 1;                        /* Read but ignore data */
-            }
-        } else if (CMD_IS_CUR(LWCELL_CMD_CMGL) && !strncmp(rcv->data, "+CMGL", 5)) {
-            if (lwcelli_parse_cmgl(rcv->data)) {   /* Parse +CMGL response */
-                lwcell.msg->msg.sms_list.read = 2; /* Set read flag and process the data */
-            } else {
-                lwcell.msg->msg.sms_list.read = 1; /* Read but ignore data */
-            }
-        } else if (!strncmp(rcv->data, "+CMTI", 5)) {
-            lwcelli_parse_cmti(rcv->data, 1); /* Parse +CMTI response with received SMS */
-        } else if (CMD_IS_CUR(LWCELL_CMD_CPMS_GET_OPT) && !strncmp(rcv->data, "+CPMS", 5)) {
-            lwcelli_parse_cpms(rcv->data, 0); /* Parse +CPMS with SMS memories info */
-        } else if (CMD_IS_CUR(LWCELL_CMD_CPMS_GET) && !strncmp(rcv->data, "+CPMS", 5)) {
-            lwcelli_parse_cpms(rcv->data, 1); /* Parse +CPMS with SMS memories info */
-        } else if (CMD_IS_CUR(LWCELL_CMD_CPMS_SET) && !strncmp(rcv->data, "+CPMS", 5)) {
-            lwcelli_parse_cpms(rcv->data, 2); /* Parse +CPMS with SMS memories info */
-#endif                                        /* LWCELL_CFG_SMS */
-#if LWCELL_CFG_CALL
-        } else if (!strncmp(rcv->data, "+CLCC", 5)) {
-            lwcelli_parse_clcc(rcv->data, 1); /* Parse +CLCC response with call info change */
-#endif                                        /* LWCELL_CFG_CALL */
-#if LWCELL_CFG_PHONEBOOK
-        } else if (CMD_IS_CUR(LWCELL_CMD_CPBS_GET_OPT) && !strncmp(rcv->data, "+CPBS", 5)) {
-            lwcelli_parse_cpbs(rcv->data, 0); /* Parse +CPBS response */
-        } else if (CMD_IS_CUR(LWCELL_CMD_CPBS_GET) && !strncmp(rcv->data, "+CPBS", 5)) {
-            lwcelli_parse_cpbs(rcv->data, 1); /* Parse +CPBS response */
-        } else if (CMD_IS_CUR(LWCELL_CMD_CPBS_SET) && !strncmp(rcv->data, "+CPBS", 5)) {
-            lwcelli_parse_cpbs(rcv->data, 2); /* Parse +CPBS response */
-        } else if (CMD_IS_CUR(LWCELL_CMD_CPBR) && !strncmp(rcv->data, "+CPBR", 5)) {
-            lwcelli_parse_cpbr(rcv->data);    /* Parse +CPBR statement */
-        } else if (CMD_IS_CUR(LWCELL_CMD_CPBF) && !strncmp(rcv->data, "+CPBF", 5)) {
-            lwcelli_parse_cpbf(rcv->data);    /* Parse +CPBR statement */
-#endif                                        /* LWCELL_CFG_PHONEBOOK */
+static void
+urc_cmgs(lwcell_recv_t* rcv, lwcell_status_flags_t* stat) {
+    LWCELL_UNUSED(stat);
+    if (CMD_IS_CUR(LWCELL_CMD_CMGS)) {
+        lwcelli_parse_cmgs(rcv->data, &lwcell.msg->msg.sms_send.pos); /* Parse +CMGS response */
+    }
+}
+
+static void
+urc_cmgr(lwcell_recv_t* rcv, lwcell_status_flags_t* stat) {
+    LWCELL_UNUSED(stat);
+    if (CMD_IS_CUR(LWCELL_CMD_CMGR)) {
+        if (lwcelli_parse_cmgr(rcv->data)) {   /* Parse +CMGR response */
+            lwcell.msg->msg.sms_read.read = 2; /* Set read flag and process the data */
+        } else {
+            lwcell.msg->msg.sms_read.read = 1; /* Read but ignore data */
         }
+    }
+}
 
-        /* Messages not starting with '+' sign */
-    } else {
-        if (rcv->data[0] == 'S' && !strncmp(rcv->data, "SHUT OK" CRLF, 7 + CRLF_LEN)) {
-            stat.is_ok = 1;
-#if LWCELL_CFG_CONN
-        } else if (LWCELL_CHARISNUM(rcv->data[0]) && rcv->data[1] == ',' && rcv->data[2] == ' '
-                   && (!strncmp(&rcv->data[3], "CLOSE OK" CRLF, 8 + CRLF_LEN)
-                       || !strncmp(&rcv->data[3], "CLOSED" CRLF, 6 + CRLF_LEN))) {
-            uint8_t forced = 0, num;
+static void
+urc_cmgl(lwcell_recv_t* rcv, lwcell_status_flags_t* stat) {
+    LWCELL_UNUSED(stat);
+    if (CMD_IS_CUR(LWCELL_CMD_CMGL)) {
+        if (lwcelli_parse_cmgl(rcv->data)) {   /* Parse +CMGL response */
+            lwcell.msg->msg.sms_list.read = 2; /* Set read flag and process the data */
+        } else {
+            lwcell.msg->msg.sms_list.read = 1; /* Read but ignore data */
+        }
+    }
+}
 
-            num = LWCELL_CHARTONUM(rcv->data[0]); /* Get connection number */
-            if (CMD_IS_CUR(LWCELL_CMD_CIPCLOSE) && lwcell.msg->msg.conn_close.conn->num == num) {
-                forced = 1;
-                stat.is_ok = 1; /* If forced and connection is closed, command is OK */
-            }
+static void
+urc_cmti(lwcell_recv_t* rcv, lwcell_status_flags_t* stat) {
+    LWCELL_UNUSED(stat);
+    lwcelli_parse_cmti(rcv->data, 1); /* Parse +CMTI response with received SMS */
+}
 
-            /* Manually stop send command? */
-            if (CMD_IS_CUR(LWCELL_CMD_CIPSEND) && lwcell.msg->msg.conn_send.conn->num == num) {
+static void
+urc_cpms(lwcell_recv_t* rcv, lwcell_status_flags_t* stat) {
+    LWCELL_UNUSED(stat);
+    if (CMD_IS_CUR(LWCELL_CMD_CPMS_GET_OPT)) {
+        lwcelli_parse_cpms(rcv->data, 0); /* Parse +CPMS with SMS memories info */
+    } else if (CMD_IS_CUR(LWCELL_CMD_CPMS_GET)) {
+        lwcelli_parse_cpms(rcv->data, 1);
+    } else if (CMD_IS_CUR(LWCELL_CMD_CPMS_SET)) {
+        lwcelli_parse_cpms(rcv->data, 2);
+    }
+}
+#endif /* LWCELL_CFG_SMS */
+
+#if LWCELL_CFG_CALL
+static void
+urc_clcc(lwcell_recv_t* rcv, lwcell_status_flags_t* stat) {
+    LWCELL_UNUSED(stat);
+    lwcelli_parse_clcc(rcv->data, 1); /* Parse +CLCC response with call info change */
+}
+#endif /* LWCELL_CFG_CALL */
+
+#if LWCELL_CFG_PHONEBOOK
+static void
+urc_cpbs(lwcell_recv_t* rcv, lwcell_status_flags_t* stat) {
+    LWCELL_UNUSED(stat);
+    if (CMD_IS_CUR(LWCELL_CMD_CPBS_GET_OPT)) {
+        lwcelli_parse_cpbs(rcv->data, 0); /* Parse +CPBS response */
+    } else if (CMD_IS_CUR(LWCELL_CMD_CPBS_GET)) {
+        lwcelli_parse_cpbs(rcv->data, 1);
+    } else if (CMD_IS_CUR(LWCELL_CMD_CPBS_SET)) {
+        lwcelli_parse_cpbs(rcv->data, 2);
+    }
+}
+
+static void
+urc_cpbr(lwcell_recv_t* rcv, lwcell_status_flags_t* stat) {
+    LWCELL_UNUSED(stat);
+    if (CMD_IS_CUR(LWCELL_CMD_CPBR)) {
+        lwcelli_parse_cpbr(rcv->data); /* Parse +CPBR statement */
+    }
+}
+
+static void
+urc_cpbf(lwcell_recv_t* rcv, lwcell_status_flags_t* stat) {
+    LWCELL_UNUSED(stat);
+    if (CMD_IS_CUR(LWCELL_CMD_CPBF)) {
+        lwcelli_parse_cpbf(rcv->data); /* Parse +CPBF statement */
+    }
+}
+#endif /* LWCELL_CFG_PHONEBOOK */
+
+#define URC_ENTRY(name, fn)         {name, sizeof(name) - 1, fn}
+
+/**
+ * \brief           Dispatch table for received lines starting with `+` sign
+ * \note            Entries must be kept sorted by prefix in ascending (`memcmp`) order,
+ *                  as lookup is done with binary search.
+ *                  Only handlers of enabled features are compiled in.
+ */
+static const lwcell_urc_t urc_table[] = {
+#if LWCELL_CFG_CONN && LWCELL_CFG_CONN_QSEND
+    URC_ENTRY("CIPACK", urc_cipack),
+#endif /* LWCELL_CFG_CONN && LWCELL_CFG_CONN_QSEND */
+#if LWCELL_CFG_CONN && LWCELL_CFG_CONN_MANUAL_RX
+    URC_ENTRY("CIPRXGET", urc_ciprxget),
+#endif /* LWCELL_CFG_CONN && LWCELL_CFG_CONN_MANUAL_RX */
+#if LWCELL_CFG_CALL
+    URC_ENTRY("CLCC", urc_clcc),
+#endif /* LWCELL_CFG_CALL */
+    URC_ENTRY("CME", urc_cme),
+#if LWCELL_CFG_SMS
+    URC_ENTRY("CMGL", urc_cmgl),
+    URC_ENTRY("CMGR", urc_cmgr),
+    URC_ENTRY("CMGS", urc_cmgs),
+#endif /* LWCELL_CFG_SMS */
+    URC_ENTRY("CMS", urc_cme),
+#if LWCELL_CFG_SMS
+    URC_ENTRY("CMTI", urc_cmti),
+#endif /* LWCELL_CFG_SMS */
+    URC_ENTRY("COPS", urc_cops),
+#if LWCELL_CFG_PHONEBOOK
+    URC_ENTRY("CPBF", urc_cpbf),
+    URC_ENTRY("CPBR", urc_cpbr),
+    URC_ENTRY("CPBS", urc_cpbs),
+#endif /* LWCELL_CFG_PHONEBOOK */
+    URC_ENTRY("CPIN", urc_cpin),
+#if LWCELL_CFG_SMS
+    URC_ENTRY("CPMS", urc_cpms),
+#endif /* LWCELL_CFG_SMS */
+    URC_ENTRY("CREG", urc_creg),
+    URC_ENTRY("CSQ", urc_csq),
+#if LWCELL_CFG_NETWORK
+    URC_ENTRY("PDP", urc_pdp),
+#endif /* LWCELL_CFG_NETWORK */
+#if LWCELL_CFG_CONN
+    URC_ENTRY("RECEIVE", urc_receive),
+#endif /* LWCELL_CFG_CONN */
+};
+
+/**
+ * \brief           Find handler for received line starting with `+` sign
+ * \param[in]       rcv: Pointer to \ref lwcell_recv_t structure with input string
+ * \return          Pointer to table entry on success, `NULL` otherwise
+ */
+static const lwcell_urc_t*
+lwcelli_urc_find(const lwcell_recv_t* rcv) {
+    const char* name = &rcv->data[1];
+    size_t len, lo, hi, mid;
+    int res;
+
+    /* Get prefix name, terminated by delimiter */
+    for (len = 0; (len + 1) < rcv->len && !URC_IS_DELIM(name[len]); ++len) {}
+
+    /* Binary search through sorted table */
+    lo = 0;
+    hi = LWCELL_ARRAYSIZE(urc_table);
+    while (lo < hi) {
+        mid = (lo + hi) / 2;
+        res = memcmp(name, urc_table[mid].prefix, LWCELL_MIN(len, urc_table[mid].len));
+        if (res == 0) {
+            res = (int)len - (int)urc_table[mid].len;
+        }
+        if (res == 0) {
+            return &urc_table[mid];
+        } else if (res < 0) {
+            hi = mid;
+        } else {
+            lo = mid + 1;
+        }
+    }
+    return NULL;
+}
+
+/**
+ * \brief           Process received string from GSM
+ * \param[in]       rcv: Pointer to \ref lwcell_recv_t structure with input string
+ */
+static void
+lwcelli_parse_received(lwcell_recv_t* rcv) {
+    lwcell_status_flags_t stat = {0};
+
+    /* Try to remove non-parsable strings */
+    if (rcv->len == 2 && rcv->data[0] == '\r' && rcv->data[1] == '\n') {
+        return;
+    }
+
+    /* Check OK response */
+    if (rcv->data[0] != '+') {
+        stat.is_ok = rcv->len == (2 + CRLF_LEN) && !strcmp(rcv->data, "OK" CRLF); /* Check if received string is OK */
+        if (!stat.is_ok) { /* Check for SEND OK string */
+            stat.is_ok = rcv->len == (7 + CRLF_LEN) && !strcmp(rcv->data, "SEND OK" CRLF);
+        }
+        if (!stat.is_ok) { /* Check basic error aswell */
+            stat.is_error = !strcmp(rcv->data, "ERROR" CRLF) || !strcmp(rcv->data, "FAIL" CRLF);
+        }
+    }
+
+    /* Scan received strings which start with '+' */
+    if (rcv->data[0] == '+') {
+        const lwcell_urc_t* urc;
+
+        if ((urc = lwcelli_urc_find(rcv)) != NULL) {
+            urc->fn(rcv, &stat);
+        }
+
+        /* Messages not starting with '+' sign */
+    } else {
+        if (rcv->data[0] == 'S' && !strncmp(rcv->data, "SHUT OK" CRLF, 7 + CRLF_LEN)) {
+            stat.is_ok = 1;
+#if LWCELL_CFG_CONN
+#if LWCELL_CFG_CONN_TRANSPARENT
+        } else if (lwcell.m.transp.conn != NULL
+                   && (!strncmp(rcv->data, "CLOSE OK" CRLF, 8 + CRLF_LEN)
+                       || !strncmp(rcv->data, "CLOSED" CRLF, 6 + CRLF_LEN))) {
+            /* Single connection mode reports close without connection number */
+            uint8_t forced = CMD_IS_CUR(LWCELL_CMD_CIPCLOSE);
+
+            if (forced) {
+                stat.is_ok = 1;
+            }
+            lwcelli_conn_closed_process(lwcell.m.transp.conn->num, forced);
+#endif /* LWCELL_CFG_CONN_TRANSPARENT */
+        } else if (LWCELL_CHARISNUM(rcv->data[0]) && rcv->data[1] == ',' && rcv->data[2] == ' '
+                   && (!strncmp(&rcv->data[3], "CLOSE OK" CRLF, 8 + CRLF_LEN)
+                       || !strncmp(&rcv->data[3], "CLOSED" CRLF, 6 + CRLF_LEN))) {
+            uint8_t forced = 0, num;
+
+            num = LWCELL_CHARTONUM(rcv->data[0]); /* Get connection number */
+            if (CMD_IS_CUR(LWCELL_CMD_CIPCLOSE) && lwcell.msg->msg.conn_close.conn->num == num) {
+                forced = 1;
+                stat.is_ok = 1; /* If forced and connection is closed, command is OK */
+            }
+
+            /* Manually stop send command? */
+            if ((CMD_IS_CUR(LWCELL_CMD_CIPSEND) || CMD_IS_CUR(LWCELL_CMD_CIPACK))
+                && lwcell.msg->msg.conn_send.conn->num == num) {
                 /*
                  * If active command is CIPSEND and CLOSED event received,
                  * manually set error and process usual "ERROR" event on senddata
@@ -837,6 +1507,12 @@ lwcelli_parse_received(lwcell_recv_t* rcv) {
                 lwcelli_process_cipsend_response(rcv, &stat);
             }
             lwcelli_conn_closed_process(num, forced); /* Connection closed, process */
+        } else if (LWCELL_CHARISNUM(rcv->data[0]) && rcv->data[1] == ',' && rcv->data[2] == ' '
+                   && !strncmp(&rcv->data[3], "REMOTE IP: ", 11)) {
+            lwcelli_conn_server_accepted(LWCELL_CHARTONUM(rcv->data[0]), &rcv->data[14]);
+        } else if (!CMD_IS_CUR(LWCELL_CMD_CIPSERVER) && !strncmp(rcv->data, "SERVER CLOSE" CRLF, 12 + CRLF_LEN)) {
+            lwcell.m.server_port = 0; /* Server closed by device */
+            lwcell.m.server_evt_func = NULL;
 #endif                                                /* LWCELL_CFG_CONN */
 #if LWCELL_CFG_CALL
         } else if (rcv->data[0] == 'C' && !strncmp(rcv->data, "Call Ready" CRLF, 10 + CRLF_LEN)) {
@@ -907,6 +1583,11 @@ lwcelli_parse_received(lwcell_recv_t* rcv) {
 
     /* Check general responses for active commands */
     if (lwcell.msg != NULL) {
+        /* OK is returned before important data, command is not finished yet */
+        if (stat.is_ok && lwcelli_cmd_get_final(CMD_GET_CUR()) == LWCELL_CMD_FINAL_DATA) {
+            stat.is_ok = 0;
+        }
+
         if (CMD_IS_CUR(LWCELL_CMD_CPIN_GET)) {
             /*
              * CME ERROR 10 indicates no SIM pin inserted.
@@ -922,12 +1603,23 @@ lwcelli_parse_received(lwcell_recv_t* rcv) {
         } else if (CMD_IS_CUR(LWCELL_CMD_CMGS) && stat.is_ok) {
             /* At this point we have to wait for "> " to send data */
 #endif /* LWCELL_CFG_SMS */
+#if LWCELL_CFG_PPP
+        } else if (CMD_IS_CUR(LWCELL_CMD_ATD_PPP)) {
+            /* Dial command finishes with CONNECT, optionally followed by port speed */
+            if (!strncmp(rcv->data, "CONNECT", 7)) {
+                lwcelli_ppp_connected();
+                stat.is_ok = 1;
+            } else if (!strncmp(rcv->data, "NO CARRIER" CRLF, 10 + CRLF_LEN)) {
+                stat.is_error = 1;
+            }
+        } else if (CMD_IS_CUR(LWCELL_CMD_PPP_STOP)) {
+            /* Device reports end of data mode once link is terminated */
+            if (!strncmp(rcv->data, "NO CARRIER" CRLF, 10 + CRLF_LEN)) {
+                stat.is_ok = 1;
+            }
+#endif /* LWCELL_CFG_PPP */
 #if LWCELL_CFG_CONN
         } else if (CMD_IS_CUR(LWCELL_CMD_CIPSTATUS)) {
-            /* For CIPSTATUS, OK is returned before important data */
-            if (stat.is_ok) {
-                stat.is_ok = 0;
-            }
             /* Check if connection data received */
             if (rcv->len > 3) {
                 uint8_t continueScan = 0, processed = 0;
@@ -949,29 +1641,38 @@ lwcelli_parse_received(lwcell_recv_t* rcv) {
                 }
             }
         } else if (CMD_IS_CUR(LWCELL_CMD_CIPSTART)) {
-            /* For CIPSTART, OK is returned before important data */
-            if (stat.is_ok) {
-                stat.is_ok = 0;
-            }
-
             /* Wait here for CONNECT status before we cancel connection */
-            if (LWCELL_CHARISNUM(rcv->data[0]) && rcv->data[1] == ',' && rcv->data[2] == ' ') {
+            if (0) {
+#if LWCELL_CFG_CONN_TRANSPARENT
+            } else if (lwcell.msg->msg.conn_start.type == LWCELL_CONN_TYPE_TCP_TRANSPARENT) {
+                /* Single connection mode reports status without connection number */
+                if (!strncmp(rcv->data, "CONNECT" CRLF, 7 + CRLF_LEN)) {
+                    lwcell_conn_t* conn =
+                        lwcelli_conn_activate(lwcell.msg->msg.conn_start.num, 1, lwcell.msg->msg.conn_start.evt_func,
+                                              lwcell.msg->msg.conn_start.arg);
+
+                    /* All further received data belong to connection */
+                    conn->type = LWCELL_CONN_TYPE_TCP_TRANSPARENT;
+                    lwcell.m.transp.conn = conn;
+                    lwcell.m.transp.data_mode = 1;
+                    lwcell.m.transp.escaping = 0;
+
+                    lwcell.msg->msg.conn_start.conn_res = LWCELL_CONN_CONNECT_OK;
+                    stat.is_ok = 1;
+                } else if (!strncmp(rcv->data, "CONNECT FAIL" CRLF, 12 + CRLF_LEN)) {
+                    lwcell.msg->msg.conn_start.conn_res = LWCELL_CONN_CONNECT_ERROR;
+                    stat.is_error = 1;
+                } else if (!strncmp(rcv->data, "ALREADY CONNECT" CRLF, 15 + CRLF_LEN)) {
+                    lwcell.msg->msg.conn_start.conn_res = LWCELL_CONN_CONNECT_ALREADY;
+                    stat.is_error = 1;
+                }
+#endif /* LWCELL_CFG_CONN_TRANSPARENT */
+            } else if (LWCELL_CHARISNUM(rcv->data[0]) && rcv->data[1] == ',' && rcv->data[2] == ' ') {
                 uint8_t num = LWCELL_CHARTONUM(rcv->data[0]);
                 if (num < LWCELL_CFG_MAX_CONNS) {
-                    uint8_t id;
-                    lwcell_conn_t* conn = &lwcell.m.conns[num]; /* Get connection handle */
-
                     if (!strncmp(&rcv->data[3], "CONNECT OK" CRLF, 10 + CRLF_LEN)) {
-                        id = conn->val_id;
-                        LWCELL_MEMSET(conn, 0x00, sizeof(*conn)); /* Reset connection parameters */
-                        conn->num = num;
-                        conn->status.f.active = 1;
-                        conn->val_id = ++id; /* Set new validation ID */
-
-                        /* Set connection parameters */
-                        conn->status.f.client = 1;
-                        conn->evt_func = lwcell.msg->msg.conn_start.evt_func;
-                        conn->arg = lwcell.msg->msg.conn_start.arg;
+                        lwcelli_conn_activate(num, 1, lwcell.msg->msg.conn_start.evt_func,
+                                              lwcell.msg->msg.conn_start.arg);
 
                         /* Set status */
                         lwcell.msg->msg.conn_start.conn_res = LWCELL_CONN_CONNECT_OK;
@@ -985,21 +1686,21 @@ lwcelli_parse_received(lwcell_recv_t* rcv) {
                     }
                 }
             }
-        } else if (CMD_IS_CUR(LWCELL_CMD_CIPSEND)) {
-            if (stat.is_ok) {
-                stat.is_ok = 0;
+        } else if (CMD_IS_CUR(LWCELL_CMD_CIPSERVER)) {
+            if (!strncmp(rcv->data, "SERVER OK" CRLF, 9 + CRLF_LEN)
+                || !strncmp(rcv->data, "SERVER CLOSE" CRLF, 12 + CRLF_LEN)) {
+                stat.is_ok = 1;
             }
+        } else if (CMD_IS_CUR(LWCELL_CMD_CIPSEND)) {
             lwcelli_process_cipsend_response(rcv, &stat);
+#if LWCELL_CFG_CONN_QSEND
+        } else if (CMD_IS_CUR(LWCELL_CMD_CIPACK)) {
+            lwcelli_process_cipack_response(rcv, &stat);
+#endif /* LWCELL_CFG_CONN_QSEND */
 #endif /* LWCELL_CFG_CONN */
 #if LWCELL_CFG_USSD
         } else if (CMD_IS_CUR(LWCELL_CMD_CUSD)) {
-            /* OK is returned before +CUSD */
-            /* Command is not finished yet, unless it was an ERROR */
-            if (stat.is_ok) {
-                stat.is_ok = 0;
-            }
-
-            /* Check for manual CUSTOM OK message */
+            /* Check for manual CUSTOM OK message, sent after +CUSD */
             if (!strcmp(rcv->data, "CUSTOM_OK\r\n")) {
                 stat.is_ok = 1;
             }
@@ -1012,29 +1713,65 @@ lwcelli_parse_received(lwcell_recv_t* rcv) {
      * and proceed with next command
      */
     if (stat.is_ok || stat.is_error) {
-        lwcellr_t res = lwcellOK;
-        if (lwcell.msg != NULL) {                /* Do we have active message? */
-            res = lwcelli_process_sub_cmd(lwcell.msg, &stat);
-            if (res != lwcellCONT) {             /* Shall we continue with next subcommand under this one? */
-                if (stat.is_ok) {                /* Check OK status */
-                    res = lwcell.msg->res = lwcellOK;
-                } else {                         /* Or error status */
-                    res = lwcell.msg->res = res; /* Set the error status */
-                }
-            } else {
-                ++lwcell.msg->i; /* Number of continue calls */
-            }
+        lwcelli_process_cmd_finished(&stat);
+    }
+}
 
-            /*
-             * When the command is finished,
-             * release synchronization semaphore
-             * from user thread and start with next command
-             */
-            if (res != lwcellCONT) {                      /* Do we have to continue to wait for command? */
-                lwcell_sys_sem_release(&lwcell.sem_sync); /* Release semaphore */
-            }
+/**
+ * \brief           Finish current command of active message and start next one or release waiting thread
+ * \param[in]       stat: Pointer to status variables with final result of command
+ */
+static void
+lwcelli_process_cmd_finished(lwcell_status_flags_t* stat) {
+    lwcellr_t res = lwcellOK;
+
+    if (lwcell.msg == NULL) { /* Do we have active message? */
+        return;
+    }
+    lwcell_timeout_cancel(lwcell.cmd_tmr); /* Command finished in time */
+    lwcell.cmd_tmr = 0;
+
+    res = lwcelli_process_sub_cmd(lwcell.msg, stat);
+    if (res != lwcellCONT) {             /* Shall we continue with next subcommand under this one? */
+        if (stat->is_ok) {               /* Check OK status */
+            res = lwcell.msg->res = lwcellOK;
+        } else {                         /* Or error status */
+            res = lwcell.msg->res = res; /* Set the error status */
         }
+    } else {
+        ++lwcell.msg->i; /* Number of continue calls */
+    }
+
+    /*
+     * When the command is finished,
+     * release synchronization semaphore
+     * from user thread and start with next command
+     */
+    if (res != lwcellCONT) {                      /* Do we have to continue to wait for command? */
+        lwcell_sys_sem_release(&lwcell.sem_sync); /* Release semaphore */
+    }
+}
+
+/**
+ * \brief           Timeout callback when command did not finish in time set by its descriptor
+ *
+ * Command is finished as if device returned `ERROR`
+ *
+ * \param[in]       arg: Custom argument, not used
+ */
+static void
+lwcelli_cmd_timeout_fn(void* arg) {
+    lwcell_status_flags_t stat = {0};
+
+    LWCELL_UNUSED(arg);
+    lwcell.cmd_tmr = 0; /* Entry has been released */
+    if (lwcell.msg == NULL) {
+        return;
     }
+    LWCELL_DEBUGF(LWCELL_CFG_DBG_THREAD | LWCELL_DBG_TYPE_TRACE | LWCELL_DBG_LVL_WARNING,
+                  "[LWCELL THREAD] Timeout waiting for final response of command %d\r\n", (int)CMD_GET_CUR());
+    stat.is_error = 1;
+    lwcelli_process_cmd_finished(&stat);
 }
 
 #if !LWCELL_CFG_INPUT_USE_PROCESS || __DOXYGEN__
@@ -1074,6 +1811,208 @@ lwcelli_process_buffer(void) {
 }
 #endif /* !LWCELL_CFG_INPUT_USE_PROCESS || __DOXYGEN__ */
 
+/**
+ * \brief           Get length of printable ASCII characters run, including `\r` but without `\n`
+ *
+ * Data are scanned word-at-a-time, only word with special character is checked byte by byte
+ *
+ * \param[in]       d: Pointer to data to scan
+ * \param[in]       len: Length of data in units of bytes
+ * \return          Number of printable characters from the beginning of data
+ */
+static size_t
+lwcelli_ascii_run_len(const uint8_t* d, size_t len) {
+    const size_t ones = ((size_t)-1) / 0xFF; /* 0x0101...01 */
+    size_t i = 0, w;
+
+    /* Skip full words where every byte is in range 0x20 - 0x7E */
+    for (; (i + sizeof(w)) <= len; i += sizeof(w)) {
+        LWCELL_MEMCPY(&w, &d[i], sizeof(w));
+        if (((w - ones * 0x20) | w | (w + ones)) & (ones * 0x80)) {
+            break;
+        }
+    }
+    for (; i < len && ((d[i] >= 32 && d[i] <= 126) || d[i] == '\r'); ++i) {}
+    return i;
+}
+
+#if LWCELL_CFG_CONN && LWCELL_CFG_CONN_TRANSPARENT
+
+/* Status markers device sends in data mode */
+static const char transp_ok[] = CRLF "OK" CRLF;
+static const char transp_closed[] = CRLF "CLOSED" CRLF;
+
+/**
+ * \brief           Return device to multi-connection mode after transparent connection was closed
+ * \return          \ref lwcellOK on success, member of \ref lwcellr_t enumeration otherwise
+ */
+static lwcellr_t
+lwcelli_transparent_restore(void) {
+    LWCELL_MSG_VAR_DEFINE(msg);
+
+    LWCELL_MSG_VAR_ALLOC(msg, 0);
+    LWCELL_MSG_VAR_REF(msg).cmd_def = LWCELL_CMD_CIPMODE_SET_0;
+
+    return lwcelli_send_msg_to_producer_mbox(&LWCELL_MSG_VAR_REF(msg), lwcelli_initiate_cmd, 1000);
+}
+
+/**
+ * \brief           Send received data to transparent connection
+ * \param[in]       data: Received data
+ * \param[in]       len: Length of received data
+ */
+static void
+lwcelli_transparent_recv(const void* data, size_t len) {
+    lwcell_conn_p conn = lwcell.m.transp.conn;
+    const uint8_t* d = data;
+    size_t off = 0;
+
+    /* Send data to connection in packet buffers of maximal size */
+    while (off < len) {
+        lwcell_pbuf_p pbuf;
+        size_t pbuf_len = LWCELL_MIN(len - off, LWCELL_CFG_CONN_MAX_DATA_LEN);
+
+        do {
+            pbuf = lwcell_pbuf_new(pbuf_len); /* Allocate new packet buffer */
+        } while (pbuf == NULL && (pbuf_len = (pbuf_len >> 1)) >= LWCELL_CFG_CONN_MIN_DATA_LEN);
+        if (pbuf == NULL) {
+            LWCELL_DEBUGF(LWCELL_CFG_DBG_IPD | LWCELL_DBG_TYPE_TRACE | LWCELL_DBG_LVL_WARNING,
+                          "[LWCELL IPD] Buffer allocation failed, skipping %d byte(s)\r\n", (int)(len - off));
+            break;
+        }
+        LWCELL_MEMCPY(pbuf->payload, &d[off], pbuf_len);
+        off += pbuf_len;
+        conn->total_recved += pbuf_len;
+
+        lwcell.evt.type = LWCELL_EVT_CONN_RECV;
+        lwcell.evt.evt.conn_data_recv.buff = pbuf;
+        lwcell.evt.evt.conn_data_recv.conn = conn;
+        lwcelli_send_conn_cb(conn, NULL);
+        lwcell_pbuf_free(pbuf); /* Free packet buffer at this point */
+    }
+}
+
+/**
+ * \brief           Match next received byte against status markers
+ *
+ * `OK` marker is only matched while escape sequence is in progress,
+ * as device cannot send it in data mode otherwise
+ *
+ * \param[in]       ch: Received byte
+ * \return          `1` if byte continues the marker, `0` otherwise
+ */
+static uint8_t
+lwcelli_transparent_match(uint8_t ch) {
+    lwcell_transp_t* t = &lwcell.m.transp;
+
+    if (t->match_len == 0) {
+        t->match = transp_closed; /* Both markers share the same CRLF start */
+    } else if (t->match_len == CRLF_LEN && t->escaping && ch == (uint8_t)transp_ok[CRLF_LEN]) {
+        t->match = transp_ok;
+    }
+    if (t->match[t->match_len] != '\0' && (uint8_t)t->match[t->match_len] == ch) {
+        ++t->match_len;
+        return 1;
+    }
+    return 0;
+}
+
+/**
+ * \brief           Resolve bytes held back after line was idle for \ref LWCELL_CFG_CONN_TRANSPARENT_MARKER_TIME
+ *
+ * Complete `CLOSED` marker closes connection, anything else is connection data
+ *
+ * \param[in]       arg: Unused argument
+ */
+static void
+lwcelli_transparent_marker_fn(void* arg) {
+    lwcell_transp_t* t = &lwcell.m.transp;
+
+    LWCELL_UNUSED(arg);
+    t->tmr = 0;
+    if (!t->data_mode || t->match_len == 0) {
+        return;
+    }
+    if (t->match == transp_closed && t->match_len == sizeof(transp_closed) - 1) {
+        lwcelli_conn_closed_process(t->conn->num, 0); /* Device is in command mode again */
+        lwcelli_transparent_restore();
+    } else {
+        lwcelli_transparent_recv(t->match, t->match_len);
+        t->match_len = 0;
+    }
+}
+
+/**
+ * \brief           Process input data in transparent data mode
+ *
+ * Data are sent to connection without going through the parser.
+ * Device leaves data mode with `OK` after escape sequence or with `CLOSED` when remote side closes connection.
+ * As there is no framing in data mode, markers are matched byte by byte across received blocks.
+ * Bytes which may be part of the marker are held back until marker is complete or mismatches.
+ * `OK` is accepted as soon as it is complete, while `CLOSED` must be followed by idle line.
+ *
+ * \param[in]       data: Received data
+ * \param[in]       data_len: Length of received data
+ * \return          Number of processed bytes, remaining bytes must go through the parser
+ */
+static size_t
+lwcelli_transparent_process(const uint8_t* data, size_t data_len) {
+    lwcell_transp_t* t = &lwcell.m.transp;
+
+    /* New data arrived, line was not idle after held back bytes */
+    if (t->tmr != 0) {
+        lwcell_timeout_cancel(t->tmr);
+        t->tmr = 0;
+    }
+    for (size_t i = 0; i < data_len; ++i) {
+        if (!lwcelli_transparent_match(data[i]) && t->match_len > 0) {
+            /* Not a marker, bytes are connection data after all */
+            if (t->match_len > i) {
+                lwcelli_transparent_recv(t->match, t->match_len - i); /* Bytes held back from previous block */
+            }
+            t->match_len = 0;
+            lwcelli_transparent_match(data[i]); /* Byte may start new marker */
+        }
+
+        /* Escape sequence accepted, parser processes OK response */
+        if (t->match == transp_ok && t->match_len == sizeof(transp_ok) - 1) {
+            if (i + 1 > t->match_len) {
+                lwcelli_transparent_recv(data, i + 1 - t->match_len);
+            }
+            t->match_len = 0;
+            t->data_mode = 0;
+            t->escaping = 0;
+            lwcelli_process_at(transp_ok, sizeof(transp_ok) - 1);
+            return i + 1;
+        }
+    }
+    lwcelli_transparent_recv(data, data_len - LWCELL_MIN(data_len, (size_t)t->match_len));
+
+    /* Decide about held back bytes once line stays idle */
+    if (t->match_len > 0
+        && lwcell_timeout_add_ex(LWCELL_CFG_CONN_TRANSPARENT_MARKER_TIME, lwcelli_transparent_marker_fn, NULL, &t->tmr)
+               != lwcellOK) {
+        lwcelli_transparent_marker_fn(NULL); /* No timeout available, decide at the end of block */
+    }
+    return data_len;
+}
+
+/**
+ * \brief           Leave data mode after escape sequence was not confirmed by device
+ *
+ * Guard time has elapsed, device is expected in command mode.
+ * Connection is closed locally and device is requested back to multi-connection mode
+ */
+static void
+lwcelli_transparent_escape_failed(void) {
+    if (lwcell.m.transp.conn != NULL) {
+        lwcelli_conn_closed_process(lwcell.m.transp.conn->num, 1);
+        lwcelli_transparent_restore();
+    }
+}
+
+#endif /* LWCELL_CFG_CONN && LWCELL_CFG_CONN_TRANSPARENT */
+
 /**
  * \brief           Process input data received from GSM device
  * \param[in]       data: Pointer to data to process
@@ -1082,18 +2021,61 @@ lwcelli_process_buffer(void) {
  */
 lwcellr_t
 lwcelli_process(const void* data, size_t data_len) {
+    /* Check status if device is available */
+    if (!lwcell.status.f.dev_present) {
+        return lwcellERRNODEVICE;
+    }
+
+#if LWCELL_CFG_CMUX
+    /* Multiplexer forwards AT channel to parser, the rest belongs to parser only if it gets closed meanwhile */
+    if (lwcell.cmux.active) {
+        size_t len = lwcelli_cmux_process(data, data_len);
+
+        data = (const uint8_t*)data + len;
+        data_len -= len;
+        if (data_len == 0) {
+            return lwcellOK;
+        }
+    }
+#endif /* LWCELL_CFG_CMUX */
+    return lwcelli_process_at(data, data_len);
+}
+
+/**
+ * \brief           Process AT data received from GSM device
+ * \param[in]       data: Pointer to data to process
+ * \param[in]       data_len: Length of data to process in units of bytes
+ * \return          \ref lwcellOK on success, member of \ref lwcellr_t enumeration otherwise
+ */
+lwcellr_t
+lwcelli_process_at(const void* data, size_t data_len) {
     uint8_t ch;
     const uint8_t* d = data;
     size_t d_len = data_len;
     static uint8_t ch_prev1, ch_prev2;
     static lwcell_unicode_t unicode;
 
-    /* Check status if device is available */
-    if (!lwcell.status.f.dev_present) {
-        return lwcellERRNODEVICE;
-    }
-
     while (d_len > 0) { /* Read entire set of characters from buffer */
+#if LWCELL_CFG_CONN && LWCELL_CFG_CONN_TRANSPARENT
+        /* In data mode, all data belong to connection */
+        if (lwcell.m.transp.data_mode) {
+            size_t len = lwcelli_transparent_process(d, d_len);
+
+            d += len;
+            d_len -= len;
+            continue;
+        }
+#endif                  /* LWCELL_CFG_CONN && LWCELL_CFG_CONN_TRANSPARENT */
+#if LWCELL_CFG_PPP
+        /* In PPP data mode, all data are HDLC frames */
+        if (lwcell.m.ppp.data_mode) {
+            size_t len = lwcelli_ppp_process(d, d_len);
+
+            d += len;
+            d_len -= len;
+            continue;
+        }
+#endif                  /* LWCELL_CFG_PPP */
         ch = *d;        /* Get next character */
         ++d;            /* Go to next character, must be here as it is used later on */
         --d_len;        /* Decrease remaining length, must be here as it is decreased later too */
@@ -1149,7 +2131,21 @@ lwcelli_process(const void* data, size_t data_len) {
                     lwcell.evt.type = LWCELL_EVT_CONN_RECV;
                     lwcell.evt.evt.conn_data_recv.buff = lwcell.m.ipd.buff;
                     lwcell.evt.evt.conn_data_recv.conn = lwcell.m.ipd.conn;
+#if LWCELL_CFG_CONN_MANUAL_RX
+                    /* Buffer counts to receive window until application confirms it with lwcell_conn_recved */
+                    lwcell.m.ipd.conn->rx_unconfirmed += lwcell.m.ipd.buff->tot_len;
+                    ++lwcell.m.ipd.conn->rx_pbufs;
+#endif /* LWCELL_CFG_CONN_MANUAL_RX */
                     res = lwcelli_send_conn_cb(lwcell.m.ipd.conn, NULL);
+#if LWCELL_CFG_CONN_MANUAL_RX
+                    if (res == lwcellOKIGNOREMORE) { /* Application did not keep the buffer */
+                        lwcell.m.ipd.conn->rx_unconfirmed -=
+                            LWCELL_MIN(lwcell.m.ipd.conn->rx_unconfirmed, lwcell.m.ipd.buff->tot_len);
+                        if (lwcell.m.ipd.conn->rx_pbufs > 0) {
+                            --lwcell.m.ipd.conn->rx_pbufs;
+                        }
+                    }
+#endif /* LWCELL_CFG_CONN_MANUAL_RX */
 
                     lwcell_pbuf_free(lwcell.m.ipd.buff); /* Free packet buffer at this point */
                     LWCELL_DEBUGF(LWCELL_CFG_DBG_IPD | LWCELL_DBG_TYPE_TRACE, "[LWCELL IPD] Free packet buffer\r\n");
@@ -1252,6 +2248,30 @@ lwcelli_process(const void* data, size_t data_len) {
                 lwcelli_parse_received(&recv_buff);
             }
 #endif /* LWCELL_CFG_USSD */
+            /*
+             * Fast path in command mode for the middle of the line.
+             *
+             * Special sequences ("> " prompt, "+COPS:" and "+CUSD:" prefixes) may only appear
+             * at the beginning of the line, remaining printable characters up to `\r` or `\n`
+             * are copied to receive buffer at once
+             */
+        } else if (RECV_LEN() >= 6 && ch != '\n' && LWCELL_ISVALIDASCII(ch)) {
+            size_t len, to_copy;
+
+            RECV_ADD(ch);
+            len = lwcelli_ascii_run_len(d, d_len);
+            to_copy = LWCELL_MIN(len, sizeof(recv_buff.data) - 1 - recv_buff.len); /* Overflow is dropped */
+            LWCELL_MEMCPY(&recv_buff.data[recv_buff.len], d, to_copy);
+            recv_buff.len += to_copy;
+            recv_buff.data[recv_buff.len] = 0;
+            unicode.t = 1; /* Manually set total to 1 */
+            unicode.r = 0; /* Reset remaining bytes */
+            if (len > 0) {
+                ch_prev1 = len > 1 ? d[len - 2] : ch; /* Keep last 2 characters for sequence detection */
+                ch = d[len - 1];
+                d += len;
+                d_len -= len;
+            }
             /*
              * We are in command mode where we have to process byte by byte
              * Simply check for ASCII and unicode format and process data accordingly
@@ -1294,14 +2314,18 @@ lwcelli_process(const void* data, size_t data_len) {
                          *  - Connection is not in closing mode
                          */
                         if (lwcell.m.ipd.conn->status.f.active && !lwcell.m.ipd.conn->status.f.in_closing) {
-                            do {
-                                lwcell.m.ipd.buff = lwcell_pbuf_new(len); /* Allocate new packet buffer */
-                            } while (lwcell.m.ipd.buff == NULL && (len = (len >> 1)) >= LWCELL_CFG_CONN_MIN_DATA_LEN);
+                            /* In manual receive mode, buffer is already allocated by read command */
+                            if (lwcell.m.ipd.buff == NULL) {
+                                do {
+                                    lwcell.m.ipd.buff = lwcell_pbuf_new(len); /* Allocate new packet buffer */
+                                } while (lwcell.m.ipd.buff == NULL
+                                         && (len = (len >> 1)) >= LWCELL_CFG_CONN_MIN_DATA_LEN);
+                            }
                             LWCELL_DEBUGW(LWCELL_CFG_DBG_IPD | LWCELL_DBG_TYPE_TRACE | LWCELL_DBG_LVL_WARNING,
                                           lwcell.m.ipd.buff == NULL,
                                           "[LWCELL IPD] Buffer allocation failed for %d byte(s)\r\n", (int)len);
                         } else {
-                            lwcell.m.ipd.buff = NULL; /* Ignore reading on closed connection */
+                            lwcell_pbuf_free_s(&lwcell.m.ipd.buff); /* Ignore reading on closed connection */
                             LWCELL_DEBUGF(LWCELL_CFG_DBG_IPD | LWCELL_DBG_TYPE_TRACE,
                                           "[LWCELL IPD] Connection %d closed or in closing, skipping %d byte(s)\r\n",
                                           (int)lwcell.m.ipd.conn->num, (int)len);
@@ -1323,8 +2347,7 @@ lwcelli_process(const void* data, size_t data_len) {
                             RECV_RESET(); /* Reset received object */
 
                             /* Now actually send the data prepared before */
-                            AT_PORT_SEND_WITH_FLUSH(&lwcell.msg->msg.conn_send.data[lwcell.msg->msg.conn_send.ptr],
-                                                    lwcell.msg->msg.conn_send.sent);
+                            lwcelli_tcpip_send_chunk(lwcell.msg);
                             lwcell.msg->msg.conn_send.wait_send_ok_err =
                                 1;                                /* Now we are waiting for "SEND OK" or "SEND ERROR" */
 #endif                                                            /* LWCELL_CFG_CONN */
@@ -1370,20 +2393,93 @@ lwcelli_process(const void* data, size_t data_len) {
     return lwcellOK;
 }
 
-/* Temporary macros, only available for inside lwcelli_process_sub_cmd function */
-/* Set new command, but first check for error on previous */
-#define SET_NEW_CMD_CHECK_ERROR(new_cmd)                                                                               \
-    do {                                                                                                               \
-        if (!stat->is_error) {                                                                                         \
-            n_cmd = (new_cmd);                                                                                         \
-        }                                                                                                              \
-    } while (0)
+/* Declare step arrays for every command sequence */
+#define LWCELL_CMD_SEQ_BEGIN(cmd_def) static const lwcell_cmd_step_t cmd_seq_##cmd_def[] = {
+#define LWCELL_CMD_SEQ_STEP(cmd, flags) {cmd, flags},
+#define LWCELL_CMD_SEQ_END(cmd_def)     };
+#include "lwcell/lwcell_cmd_seqs.h"
 
-/* Set new command, ignore result of previous */
-#define SET_NEW_CMD(new_cmd)                                                                                           \
-    do {                                                                                                               \
-        n_cmd = (new_cmd);                                                                                             \
-    } while (0)
+/**
+ * \brief           List of multi-step command sequences
+ */
+static const lwcell_cmd_seq_t cmd_seqs[] = {
+#define LWCELL_CMD_SEQ_BEGIN(cmd_def)   {cmd_def, cmd_seq_##cmd_def, LWCELL_ARRAYSIZE(cmd_seq_##cmd_def)},
+#define LWCELL_CMD_SEQ_STEP(cmd, flags)
+#define LWCELL_CMD_SEQ_END(cmd_def)
+#include "lwcell/lwcell_cmd_seqs.h"
+};
+
+/**
+ * \brief           Get next command from multi-step sequence of current message
+ *
+ * API function may start message with any step of the sequence,
+ * usually to skip steps not needed for given parameters.
+ * Position of current step is kept in message.
+ *
+ * \param[in]       msg: Pointer to current message
+ * \param[in]       stat: Pointer to status variables
+ * \return          Next command to execute or \ref LWCELL_CMD_IDLE if sequence has finished
+ */
+static lwcell_cmd_t
+lwcelli_cmd_seq_next(lwcell_msg_t* msg, lwcell_status_flags_t* stat) {
+    const lwcell_cmd_seq_t* seq = NULL;
+    const lwcell_cmd_step_t* step;
+
+    for (size_t i = 0; i < LWCELL_ARRAYSIZE(cmd_seqs); ++i) {
+        if (cmd_seqs[i].cmd_def == msg->cmd_def) {
+            seq = &cmd_seqs[i];
+            break;
+        }
+    }
+    if (seq == NULL) {
+        return LWCELL_CMD_IDLE;
+    }
+
+    /* Locate first command of the message in the sequence */
+    if (msg->i == 0) {
+        for (msg->seq_step = 0; msg->seq_step < seq->steps_len && seq->steps[msg->seq_step].cmd != msg->cmd;
+             ++msg->seq_step) {}
+        msg->seq_tries = 0;
+    }
+    if (msg->seq_step >= seq->steps_len) {
+        return LWCELL_CMD_IDLE;
+    }
+
+    /* Repeat failed step, if allowed */
+    step = &seq->steps[msg->seq_step];
+    if ((step->flags & LWCELL_CMD_STEP_F_RETRY) && stat->is_error && msg->seq_tries < LWCELL_CMD_STEP_RETRY_MAX) {
+        ++msg->seq_tries;
+        lwcell_delay(LWCELL_CMD_STEP_RETRY_DELAY);
+        return step->cmd;
+    }
+
+    /* Advance to next step */
+    if ((size_t)msg->seq_step + 1 >= seq->steps_len) {
+        return LWCELL_CMD_IDLE;
+    }
+    step = &seq->steps[msg->seq_step + 1];
+    if ((step->flags & LWCELL_CMD_STEP_F_CHECK_ERROR) && stat->is_error) {
+        return LWCELL_CMD_IDLE;
+    }
+    ++msg->seq_step;
+    msg->seq_tries = 0;
+    return step->cmd;
+}
+
+/* Temporary macros, only available for inside lwcelli_process_sub_cmd function */
+/* Set new command, but first check for error on previous */
+#define SET_NEW_CMD_CHECK_ERROR(new_cmd)                                                                               \
+    do {                                                                                                               \
+        if (!stat->is_error) {                                                                                         \
+            n_cmd = (new_cmd);                                                                                         \
+        }                                                                                                              \
+    } while (0)
+
+/* Set new command, ignore result of previous */
+#define SET_NEW_CMD(new_cmd)                                                                                           \
+    do {                                                                                                               \
+        n_cmd = (new_cmd);                                                                                             \
+    } while (0)
 
 /**
  * \brief           Process current command with known execution status and start another if necessary
@@ -1395,37 +2491,22 @@ lwcelli_process(const void* data, size_t data_len) {
  */
 static lwcellr_t
 lwcelli_process_sub_cmd(lwcell_msg_t* msg, lwcell_status_flags_t* stat) {
-    lwcell_cmd_t n_cmd = LWCELL_CMD_IDLE;
-    if (CMD_IS_DEF(LWCELL_CMD_RESET)) {
-        switch (CMD_GET_CUR()) {                                                     /* Check current command */
-            case LWCELL_CMD_RESET: {
-                lwcelli_reset_everything(1);                                         /* Reset everything */
-                SET_NEW_CMD(LWCELL_CFG_AT_ECHO ? LWCELL_CMD_ATE1 : LWCELL_CMD_ATE0); /* Set ECHO mode */
-                lwcell_delay(LWCELL_CFG_RESET_DELAY_AFTER); /* Delay for some time before we can continue after reset */
-                break;
-            }
-            case LWCELL_CMD_ATE0:
-            case LWCELL_CMD_ATE1: SET_NEW_CMD(LWCELL_CMD_CFUN_SET); break;     /* Set full functionality */
-            case LWCELL_CMD_CFUN_SET: SET_NEW_CMD(LWCELL_CMD_CMEE_SET); break; /* Set detailed error reporting */
-            case LWCELL_CMD_CMEE_SET: SET_NEW_CMD(LWCELL_CMD_CGMI_GET); break; /* Get manufacturer */
-            case LWCELL_CMD_CGMI_GET: SET_NEW_CMD(LWCELL_CMD_CGMM_GET); break; /* Get model */
-            case LWCELL_CMD_CGMM_GET: SET_NEW_CMD(LWCELL_CMD_CGSN_GET); break; /* Get product serial number */
-            case LWCELL_CMD_CGSN_GET: SET_NEW_CMD(LWCELL_CMD_CGMR_GET); break; /* Get product revision */
-            case LWCELL_CMD_CGMR_GET: {
-                /*
-                 * At this point we have modem info.
-                 * It is now time to send info to user
-                 * to select between device drivers
-                 */
-                lwcelli_send_cb(LWCELL_EVT_DEVICE_IDENTIFIED);
+    lwcell_cmd_t n_cmd = lwcelli_cmd_seq_next(msg, stat); /* Get next step of multi-step sequence, if any */
 
-                SET_NEW_CMD(LWCELL_CMD_CREG_SET); /* Enable unsolicited code for CREG */
-                break;
-            }
-            case LWCELL_CMD_CREG_SET: SET_NEW_CMD(LWCELL_CMD_CLCC_SET); break; /* Set call state */
-            case LWCELL_CMD_CLCC_SET: SET_NEW_CMD(LWCELL_CMD_CPIN_GET); break; /* Get SIM state */
-            case LWCELL_CMD_CPIN_GET: break;
-            default: break;
+    if (CMD_IS_DEF(LWCELL_CMD_RESET)) {
+        if (CMD_IS_CUR(LWCELL_CMD_RESET)) {
+#if LWCELL_CFG_CMUX
+            lwcelli_cmux_close(1);                      /* Device restarts in normal AT mode */
+#endif                                                  /* LWCELL_CFG_CMUX */
+            lwcelli_reset_everything(1);                /* Reset everything */
+            lwcell_delay(LWCELL_CFG_RESET_DELAY_AFTER); /* Delay for some time before we can continue after reset */
+        } else if (CMD_IS_CUR(LWCELL_CMD_CGMR_GET)) {
+            /*
+             * At this point we have modem info.
+             * It is now time to send info to user
+             * to select between device drivers
+             */
+            lwcelli_send_cb(LWCELL_EVT_DEVICE_IDENTIFIED);
         }
 
         /* Send event */
@@ -1441,18 +2522,6 @@ lwcelli_process_sub_cmd(lwcell_msg_t* msg, lwcell_status_flags_t* stat) {
         if (CMD_IS_CUR(LWCELL_CMD_COPS_GET_OPT)) {
             OPERATOR_SCAN_SEND_EVT(lwcell.msg, stat->is_ok ? lwcellOK : lwcellERR);
         }
-    } else if (CMD_IS_DEF(LWCELL_CMD_SIM_PROCESS_BASIC_CMDS)) {
-        if (CMD_IS_CUR(LWCELL_CMD_CNUM)) {
-            /* Get own phone number */
-            if (!stat->is_ok) {
-                /* Sometimes SIM is not ready just after PIN entered */
-                if (msg->msg.sim_info.cnum_tries < 5) {
-                    ++msg->msg.sim_info.cnum_tries;
-                    SET_NEW_CMD(LWCELL_CMD_CNUM);
-                    lwcell_delay(1000);
-                }
-            }
-        }
     } else if (CMD_IS_DEF(LWCELL_CMD_CPIN_SET)) { /* Set PIN code */
         switch (CMD_GET_CUR()) {
             case LWCELL_CMD_CPIN_GET: {           /* Get own phone number */
@@ -1490,34 +2559,19 @@ lwcelli_process_sub_cmd(lwcell_msg_t* msg, lwcell_status_flags_t* stat) {
         }
 #if LWCELL_CFG_SMS
     } else if (CMD_IS_DEF(LWCELL_CMD_SMS_ENABLE)) {
-        switch (CMD_GET_CUR()) {
-            case LWCELL_CMD_CPMS_GET_OPT: SET_NEW_CMD(LWCELL_CMD_CPMS_GET); break;
-            case LWCELL_CMD_CPMS_GET: break;
-            default: break;
-        }
-        if (!stat->is_ok || n_cmd == LWCELL_CMD_IDLE) {      /* Stop execution on any command */
-            SET_NEW_CMD(LWCELL_CMD_IDLE);
-            lwcell.m.sms.enabled = n_cmd == LWCELL_CMD_IDLE; /* Set enabled status */
+        /* Sequence stops on first error */
+        if (n_cmd == LWCELL_CMD_IDLE) {
+            lwcell.m.sms.enabled = stat->is_ok; /* Set enabled status */
             lwcell.evt.evt.sms_enable.status = lwcell.m.sms.enabled ? lwcellOK : lwcellERR;
-            lwcelli_send_cb(LWCELL_EVT_SMS_ENABLE);          /* Send to user */
-        }
-    } else if (CMD_IS_DEF(LWCELL_CMD_CMGS)) {                /* Send SMS default command */
-        if (CMD_IS_CUR(LWCELL_CMD_CMGF) && stat->is_ok) {    /* Set message format current command */
-            SET_NEW_CMD(LWCELL_CMD_CMGS);                    /* Now send actual message */
+            lwcelli_send_cb(LWCELL_EVT_SMS_ENABLE); /* Send to user */
         }
-
+    } else if (CMD_IS_DEF(LWCELL_CMD_CMGS)) { /* Send SMS default command */
         /* Send event on finish */
         if (n_cmd == LWCELL_CMD_IDLE) {
             SMS_SEND_SEND_EVT(lwcell.msg, stat->is_ok ? lwcellOK : lwcellERR);
         }
-    } else if (CMD_IS_DEF(LWCELL_CMD_CMGR)) {                    /* Read SMS message */
-        if (CMD_IS_CUR(LWCELL_CMD_CPMS_GET) && stat->is_ok) {
-            SET_NEW_CMD(LWCELL_CMD_CPMS_SET);                    /* Set memory */
-        } else if (CMD_IS_CUR(LWCELL_CMD_CPMS_SET) && stat->is_ok) {
-            SET_NEW_CMD(LWCELL_CMD_CMGF);                        /* Set text mode */
-        } else if (CMD_IS_CUR(LWCELL_CMD_CMGF) && stat->is_ok) { /* Set message format current command*/
-            SET_NEW_CMD(LWCELL_CMD_CMGR);                        /* Start message read */
-        } else if (CMD_IS_CUR(LWCELL_CMD_CMGR) && stat->is_ok) {
+    } else if (CMD_IS_DEF(LWCELL_CMD_CMGR)) { /* Read SMS message */
+        if (CMD_IS_CUR(LWCELL_CMD_CMGR) && stat->is_ok) {
             msg->msg.sms_read.mem = lwcell.m.sms.mem[0].current; /* Set current memory */
         }
 
@@ -1526,38 +2580,16 @@ lwcelli_process_sub_cmd(lwcell_msg_t* msg, lwcell_status_flags_t* stat) {
             SMS_SEND_READ_EVT(lwcell.msg, stat->is_ok ? lwcellOK : lwcellERR);
         }
     } else if (CMD_IS_DEF(LWCELL_CMD_CMGD)) { /* Delete SMS message*/
-        if (CMD_IS_CUR(LWCELL_CMD_CPMS_GET) && stat->is_ok) {
-            SET_NEW_CMD(LWCELL_CMD_CPMS_SET); /* Set memory */
-        } else if (CMD_IS_CUR(LWCELL_CMD_CPMS_SET) && stat->is_ok) {
-            SET_NEW_CMD(LWCELL_CMD_CMGD);     /* Delete message */
-        }
-
         /* Send event on finish */
         if (n_cmd == LWCELL_CMD_IDLE) {
             SMS_SEND_DELETE_EVT(msg, stat->is_ok ? lwcellOK : lwcellERR);
         }
-    } else if (CMD_IS_DEF(LWCELL_CMD_CMGDA)) {
-        if (CMD_IS_CUR(LWCELL_CMD_CMGF) && stat->is_ok) {
-            SET_NEW_CMD(LWCELL_CMD_CMGDA);    /* Mass storage */
-        }
     } else if (CMD_IS_DEF(LWCELL_CMD_CMGL)) { /* List SMS messages */
-        if (CMD_IS_CUR(LWCELL_CMD_CPMS_GET) && stat->is_ok) {
-            SET_NEW_CMD(LWCELL_CMD_CPMS_SET); /* Set memory */
-        } else if (CMD_IS_CUR(LWCELL_CMD_CPMS_SET) && stat->is_ok) {
-            SET_NEW_CMD(LWCELL_CMD_CMGF);     /* Set text format */
-        } else if (CMD_IS_CUR(LWCELL_CMD_CMGF) && stat->is_ok) {
-            SET_NEW_CMD(LWCELL_CMD_CMGL);     /* List messages */
-        }
-
         /* Send event on finish */
         if (n_cmd == LWCELL_CMD_IDLE) {
             SMS_SEND_LIST_EVT(msg, stat->is_ok ? lwcellOK : lwcellERR);
         }
-    } else if (CMD_IS_DEF(LWCELL_CMD_CPMS_SET)) { /* Set preferred memory */
-        if (CMD_IS_CUR(LWCELL_CMD_CPMS_GET) && stat->is_ok) {
-            SET_NEW_CMD(LWCELL_CMD_CPMS_SET);     /* Now set the command */
-        }
-#endif                                            /* LWCELL_CFG_SMS */
+#endif /* LWCELL_CFG_SMS */
 #if LWCELL_CFG_CALL
     } else if (CMD_IS_DEF(LWCELL_CMD_CALL_ENABLE)) {
         lwcell.m.call.enabled = stat->is_ok;     /* Set enabled status */
@@ -1569,18 +2601,8 @@ lwcelli_process_sub_cmd(lwcell_msg_t* msg, lwcell_status_flags_t* stat) {
         lwcell.m.pb.enabled = stat->is_ok;                    /* Set enabled status */
         lwcell.evt.evt.pb_enable.res = lwcell.m.pb.enabled ? lwcellOK : lwcellERR;
         lwcelli_send_cb(LWCELL_EVT_PB_ENABLE);                /* Send to user */
-    } else if (CMD_IS_DEF(LWCELL_CMD_CPBW_SET)) {             /* Write phonebook entry */
-        if (CMD_IS_CUR(LWCELL_CMD_CPBS_GET) && stat->is_ok) { /* Get current memory */
-            SET_NEW_CMD(LWCELL_CMD_CPBS_SET);                 /* Set current memory */
-        } else if (CMD_IS_CUR(LWCELL_CMD_CPBS_SET) && stat->is_ok) {
-            SET_NEW_CMD(LWCELL_CMD_CPBW_SET);                 /* Write entry to phonebook */
-        }
     } else if (CMD_IS_DEF(LWCELL_CMD_CPBR)) {
-        if (CMD_IS_CUR(LWCELL_CMD_CPBS_GET) && stat->is_ok) { /* Get current memory */
-            SET_NEW_CMD(LWCELL_CMD_CPBS_SET);                 /* Set current memory */
-        } else if (CMD_IS_CUR(LWCELL_CMD_CPBS_SET) && stat->is_ok) {
-            SET_NEW_CMD(LWCELL_CMD_CPBR);                     /* Read entries */
-        } else if (CMD_IS_CUR(LWCELL_CMD_CPBR)) {
+        if (CMD_IS_CUR(LWCELL_CMD_CPBR)) {
             lwcell.evt.evt.pb_list.mem = lwcell.m.pb.mem.current;
             lwcell.evt.evt.pb_list.entries = lwcell.msg->msg.pb_list.entries;
             lwcell.evt.evt.pb_list.size = lwcell.msg->msg.pb_list.ei;
@@ -1588,11 +2610,7 @@ lwcelli_process_sub_cmd(lwcell_msg_t* msg, lwcell_status_flags_t* stat) {
             lwcelli_send_cb(LWCELL_EVT_PB_LIST);
         }
     } else if (CMD_IS_DEF(LWCELL_CMD_CPBF)) {
-        if (CMD_IS_CUR(LWCELL_CMD_CPBS_GET) && stat->is_ok) { /* Get current memory */
-            SET_NEW_CMD(LWCELL_CMD_CPBS_SET);                 /* Set current memory */
-        } else if (CMD_IS_CUR(LWCELL_CMD_CPBS_SET) && stat->is_ok) {
-            SET_NEW_CMD(LWCELL_CMD_CPBF);                     /* Read entries */
-        } else if (CMD_IS_CUR(LWCELL_CMD_CPBF)) {
+        if (CMD_IS_CUR(LWCELL_CMD_CPBF)) {
             lwcell.evt.evt.pb_search.mem = lwcell.m.pb.mem.current;
             lwcell.evt.evt.pb_search.search = lwcell.msg->msg.pb_search.search;
             lwcell.evt.evt.pb_search.entries = lwcell.msg->msg.pb_search.entries;
@@ -1602,39 +2620,60 @@ lwcelli_process_sub_cmd(lwcell_msg_t* msg, lwcell_status_flags_t* stat) {
         }
 #endif /* LWCELL_CFG_PHONEBOOK */
 #if LWCELL_CFG_NETWORK
-    } else if (CMD_IS_DEF(LWCELL_CMD_NETWORK_ATTACH)) {
-        switch (msg->i) {
-            case 0: SET_NEW_CMD_CHECK_ERROR(LWCELL_CMD_CGACT_SET_0); break;
-            case 1: SET_NEW_CMD(LWCELL_CMD_CGACT_SET_1); break;
-#if LWCELL_CFG_NETWORK_IGNORE_CGACT_RESULT
-            case 2: SET_NEW_CMD(LWCELL_CMD_CGATT_SET_0); break;
-#else  /* LWCELL_CFG_NETWORK_IGNORE_CGACT_RESULT */
-            case 2: SET_NEW_CMD_CHECK_ERROR(LWCELL_CMD_CGATT_SET_0); break;
-#endif /* !LWCELL_CFG_NETWORK_IGNORE_CGACT_RESULT */
-            case 3: SET_NEW_CMD(LWCELL_CMD_CGATT_SET_1); break;
-            case 4: SET_NEW_CMD_CHECK_ERROR(LWCELL_CMD_CIPSHUT); break;
-            case 5: SET_NEW_CMD_CHECK_ERROR(LWCELL_CMD_CIPMUX_SET); break;
-            case 6: SET_NEW_CMD_CHECK_ERROR(LWCELL_CMD_CIPRXGET_SET); break;
-            case 7: SET_NEW_CMD_CHECK_ERROR(LWCELL_CMD_CSTT_SET); break;
-            case 8: SET_NEW_CMD_CHECK_ERROR(LWCELL_CMD_CIICR); break;
-            case 9: SET_NEW_CMD_CHECK_ERROR(LWCELL_CMD_CIFSR); break;
-            case 10: SET_NEW_CMD(LWCELL_CMD_CIPSTATUS); break;
-            default: break;
-        }
     } else if (CMD_IS_DEF(LWCELL_CMD_NETWORK_DETACH)) {
-        switch (msg->i) {
-            case 0: SET_NEW_CMD(LWCELL_CMD_CGATT_SET_0); break;
-            case 1: SET_NEW_CMD(LWCELL_CMD_CGACT_SET_0); break;
-#if LWCELL_CFG_CONN
-            case 2: SET_NEW_CMD(LWCELL_CMD_CIPSTATUS); break;
-#endif /* LWCELL_CFG_CONN */
-            default: break;
-        }
         if (!n_cmd) {
             stat->is_ok = 1;
         }
 #endif /* LWCELL_CFG_NETWORK */
 #if LWCELL_CFG_CONN
+#if LWCELL_CFG_CONN_TRANSPARENT
+    } else if (CMD_IS_DEF(LWCELL_CMD_CIPSTART)
+               && msg->msg.conn_start.type == LWCELL_CONN_TYPE_TCP_TRANSPARENT) {
+        if (CMD_IS_CUR(LWCELL_CMD_CIPMUX_SET_0)) {
+            SET_NEW_CMD_CHECK_ERROR(LWCELL_CMD_CIPMODE_SET_1);
+        } else if (CMD_IS_CUR(LWCELL_CMD_CIPMODE_SET_1)) {
+            /* Go back to multi-connection mode on failure */
+            SET_NEW_CMD(stat->is_ok ? LWCELL_CMD_CIPSTART : LWCELL_CMD_CIPMUX);
+        } else if (CMD_IS_CUR(LWCELL_CMD_CIPSTART)) {
+            if (msg->msg.conn_start.conn_res == LWCELL_CONN_CONNECT_OK) {
+                lwcell_conn_t* conn = &lwcell.m.conns[msg->msg.conn_start.num];
+
+                lwcell.evt.type = LWCELL_EVT_CONN_ACTIVE;
+                lwcell.evt.evt.conn_active_close.client = 1;
+                lwcell.evt.evt.conn_active_close.conn = conn;
+                lwcell.evt.evt.conn_active_close.forced = 1;
+                lwcelli_send_conn_cb(conn, NULL);
+                lwcelli_conn_start_timeout(conn);
+            } else {
+                SET_NEW_CMD(LWCELL_CMD_CIPMODE_SET_0);
+            }
+        } else if (CMD_IS_CUR(LWCELL_CMD_CIPMODE_SET_0)) {
+            SET_NEW_CMD(LWCELL_CMD_CIPMUX);
+        }
+
+        /* Report failure once device is back in multi-connection mode */
+        if (n_cmd == LWCELL_CMD_IDLE && msg->msg.conn_start.conn_res != LWCELL_CONN_CONNECT_OK) {
+            lwcelli_send_conn_error_cb(msg, lwcellERRCONNFAIL);
+            stat->is_error = 1;
+            stat->is_ok = 0;
+        }
+    } else if (CMD_IS_DEF(LWCELL_CMD_CIPCLOSE) && msg->msg.conn_close.conn != NULL
+               && msg->msg.conn_close.conn->type == LWCELL_CONN_TYPE_TCP_TRANSPARENT) {
+        if (CMD_IS_CUR(LWCELL_CMD_PPP)) {
+            if (stat->is_ok) {
+                SET_NEW_CMD(LWCELL_CMD_CIPCLOSE); /* Close connection in command mode */
+            } else {
+                lwcelli_transparent_escape_failed();
+            }
+        } else if (CMD_IS_CUR(LWCELL_CMD_CIPCLOSE)) {
+            if (stat->is_error && msg->msg.conn_close.conn->status.f.active) {
+                lwcelli_conn_closed_process(msg->msg.conn_close.conn->num, 1);
+            }
+            SET_NEW_CMD(LWCELL_CMD_CIPMODE_SET_0);
+        } else if (CMD_IS_CUR(LWCELL_CMD_CIPMODE_SET_0)) {
+            SET_NEW_CMD(LWCELL_CMD_CIPMUX);
+        }
+#endif /* LWCELL_CFG_CONN_TRANSPARENT */
     } else if (CMD_IS_DEF(LWCELL_CMD_CIPSTART)) {
         if (!msg->i && CMD_IS_CUR(LWCELL_CMD_CIPSTATUS)) { /* Was the current command status info? */
             if (stat->is_ok) {
@@ -1673,6 +2712,11 @@ lwcelli_process_sub_cmd(lwcell_msg_t* msg, lwcell_status_flags_t* stat) {
                 }
             }
         }
+    } else if (CMD_IS_DEF(LWCELL_CMD_CIPSERVER)) {
+        if (stat->is_ok) {
+            lwcell.m.server_port = msg->msg.tcpip_server.en ? msg->msg.tcpip_server.port : 0;
+            lwcell.m.server_evt_func = msg->msg.tcpip_server.en ? msg->msg.tcpip_server.evt_func : NULL;
+        }
     } else if (CMD_IS_DEF(LWCELL_CMD_CIPCLOSE)) {
         /*
          * It is unclear in which state connection is when ERROR is received on close command.
@@ -1692,16 +2736,26 @@ lwcelli_process_sub_cmd(lwcell_msg_t* msg, lwcell_status_flags_t* stat) {
                 msg->msg.conn_close.conn->status.f.active && msg->msg.conn_close.conn->status.f.client;
             lwcelli_send_conn_cb(msg->msg.conn_close.conn, NULL);
         }
+#if LWCELL_CFG_CONN_MANUAL_RX
+    } else if (CMD_IS_DEF(LWCELL_CMD_CIPRXGET)) {
+        lwcellr_t res = stat->is_ok ? lwcellOK : lwcellERR;
+
+        /* Read data after length query, when there is anything to read */
+        if (CMD_IS_CUR(LWCELL_CMD_CIPRXGET_LEN) && stat->is_ok
+            && (res = lwcelli_conn_manual_rx_alloc(msg)) == lwcellOK) {
+            SET_NEW_CMD(LWCELL_CMD_CIPRXGET);
+        }
+        if (n_cmd == LWCELL_CMD_IDLE) {
+            lwcelli_conn_manual_rx_done(msg, res);
+        }
+#endif /* LWCELL_CFG_CONN_MANUAL_RX */
 #endif /* LWCELL_CFG_CONN */
-#if LWCELL_CFG_USSD
-    } else if (CMD_IS_DEF(LWCELL_CMD_CUSD)) {
-        if (CMD_IS_CUR(LWCELL_CMD_CUSD_GET)) {
-            if (stat->is_ok) {
-                SET_NEW_CMD(LWCELL_CMD_CUSD); /* Run next command */
-            }
+#if LWCELL_CFG_CMUX
+    } else if (CMD_IS_DEF(LWCELL_CMD_CMUX)) {
+        if (!stat->is_ok) {
+            lwcelli_cmux_close(0); /* Device rejected multiplexer or AT channel does not respond */
         }
-        /* The rest is handled in one layer above */
-#endif /* LWCELL_CFG_USSD */
+#endif /* LWCELL_CFG_CMUX */
     }
 
     /* Check if new command was set for execution */
@@ -1722,542 +2776,765 @@ lwcelli_process_sub_cmd(lwcell_msg_t* msg, lwcell_status_flags_t* stat) {
 }
 
 /**
- * \brief           Function to initialize every AT command
- * \note            Never call this function directly. Set as initialization function for command and use `msg->fn(msg)`
+ * \brief           Hardware reset the device before AT reset command is sent
  * \param[in]       msg: Pointer to \ref lwcell_msg_t with data
  * \return          Member of \ref lwcellr_t enumeration
  */
-lwcellr_t
-lwcelli_initiate_cmd(lwcell_msg_t* msg) {
-    switch (CMD_GET_CUR()) {     /* Check current message we want to send over AT */
-        case LWCELL_CMD_RESET: { /* Reset modem with AT commands */
-            /* Try with hardware reset */
-            if (lwcell.ll.reset_fn != NULL && lwcell.ll.reset_fn(1)) {
-                lwcell_delay(2);
-                lwcell.ll.reset_fn(0);
-                lwcell_delay(500);
-            }
+static lwcellr_t
+lwcelli_cmd_prep_reset(lwcell_msg_t* msg) {
+    LWCELL_UNUSED(msg);
 
-            /* Send manual AT command */
-            AT_PORT_SEND_BEGIN_AT();
-            AT_PORT_SEND_CONST_STR("+CFUN=1,1");
-            AT_PORT_SEND_END_AT();
-            break;
-        }
-        case LWCELL_CMD_RESET_DEVICE_FIRST_CMD: { /* First command for device driver specific reset */
-            AT_PORT_SEND_BEGIN_AT();
-            AT_PORT_SEND_END_AT();
-            break;
-        }
-        case LWCELL_CMD_ATE0:
-        case LWCELL_CMD_ATE1: {
-            AT_PORT_SEND_BEGIN_AT();
-            if (CMD_IS_CUR(LWCELL_CMD_ATE0)) {
-                AT_PORT_SEND_CONST_STR("E0");
-            } else {
-                AT_PORT_SEND_CONST_STR("E1");
-            }
-            AT_PORT_SEND_END_AT();
-            break;
-        }
-        case LWCELL_CMD_CMEE_SET: { /* Enable detailed error messages */
-            AT_PORT_SEND_BEGIN_AT();
-            AT_PORT_SEND_CONST_STR("+CMEE=1");
-            AT_PORT_SEND_END_AT();
-            break;
-        }
-        case LWCELL_CMD_CLCC_SET: { /* Enable detailed call info */
-            AT_PORT_SEND_BEGIN_AT();
-            AT_PORT_SEND_CONST_STR("+CLCC=1");
-            AT_PORT_SEND_END_AT();
-            break;
-        }
-        case LWCELL_CMD_CGMI_GET: { /* Get manufacturer */
-            AT_PORT_SEND_BEGIN_AT();
-            AT_PORT_SEND_CONST_STR("+CGMI");
-            AT_PORT_SEND_END_AT();
-            break;
-        }
-        case LWCELL_CMD_CGMM_GET: { /* Get model */
-            AT_PORT_SEND_BEGIN_AT();
-            AT_PORT_SEND_CONST_STR("+CGMM");
-            AT_PORT_SEND_END_AT();
-            break;
-        }
-        case LWCELL_CMD_CGSN_GET: { /* Get serial number */
-            AT_PORT_SEND_BEGIN_AT();
-            AT_PORT_SEND_CONST_STR("+CGSN");
-            AT_PORT_SEND_END_AT();
-            break;
-        }
-        case LWCELL_CMD_CGMR_GET: { /* Get revision */
-            AT_PORT_SEND_BEGIN_AT();
-            AT_PORT_SEND_CONST_STR("+CGMR");
-            AT_PORT_SEND_END_AT();
-            break;
-        }
-        case LWCELL_CMD_CREG_SET: { /* Enable +CREG message */
-            AT_PORT_SEND_BEGIN_AT();
-            AT_PORT_SEND_CONST_STR("+CREG=1");
-            AT_PORT_SEND_END_AT();
-            break;
-        }
-        case LWCELL_CMD_CREG_GET: { /* Get network registration status */
-            AT_PORT_SEND_BEGIN_AT();
-            AT_PORT_SEND_CONST_STR("+CREG?");
-            AT_PORT_SEND_END_AT();
-            break;
-        }
-        case LWCELL_CMD_CFUN_SET: {
-            AT_PORT_SEND_BEGIN_AT();
-            AT_PORT_SEND_CONST_STR("+CFUN=");
-            /**
-             * \todo: If CFUN command forced, check value
-             */
-            if (CMD_IS_DEF(LWCELL_CMD_RESET) || (CMD_IS_DEF(LWCELL_CMD_CFUN_SET) && msg->msg.cfun.mode)) {
-                AT_PORT_SEND_CONST_STR("1");
-            } else {
-                AT_PORT_SEND_CONST_STR("0");
-            }
-            AT_PORT_SEND_END_AT();
-            break;
-        }
-        case LWCELL_CMD_CPIN_GET: { /* Read current SIM status */
-            AT_PORT_SEND_BEGIN_AT();
-            AT_PORT_SEND_CONST_STR("+CPIN?");
-            AT_PORT_SEND_END_AT();
-            break;
-        }
-        case LWCELL_CMD_CPIN_SET: { /* Set SIM pin code */
-            AT_PORT_SEND_BEGIN_AT();
-            AT_PORT_SEND_CONST_STR("+CPIN=");
-            lwcelli_send_string(msg->msg.cpin_enter.pin, 0, 1, 0);
-            AT_PORT_SEND_END_AT();
-            break;
-        }
-        case LWCELL_CMD_CPIN_ADD: { /* Add new pin code */
-            AT_PORT_SEND_BEGIN_AT();
-            AT_PORT_SEND_CONST_STR("+CLCK=\"SC\",1,");
-            lwcelli_send_string(msg->msg.cpin_add.pin, 0, 1, 0);
-            AT_PORT_SEND_END_AT();
-            break;
-        }
-        case LWCELL_CMD_CPIN_CHANGE: { /* Change already active SIM */
-            AT_PORT_SEND_BEGIN_AT();
-            AT_PORT_SEND_CONST_STR("+CPWD=\"SC\"");
-            lwcelli_send_string(msg->msg.cpin_change.current_pin, 0, 1, 1);
-            lwcelli_send_string(msg->msg.cpin_change.new_pin, 0, 1, 1);
-            AT_PORT_SEND_END_AT();
-            break;
-        }
-        case LWCELL_CMD_CPIN_REMOVE: { /* Remove current PIN */
-            AT_PORT_SEND_BEGIN_AT();
-            AT_PORT_SEND_CONST_STR("+CLCK=\"SC\",0,");
-            lwcelli_send_string(msg->msg.cpin_remove.pin, 0, 1, 0);
-            AT_PORT_SEND_END_AT();
-            break;
-        }
-        case LWCELL_CMD_CPUK_SET: { /* Enter PUK and set new PIN */
-            AT_PORT_SEND_BEGIN_AT();
-            AT_PORT_SEND_CONST_STR("+CPIN=");
-            lwcelli_send_string(msg->msg.cpuk_enter.puk, 0, 1, 0);
-            lwcelli_send_string(msg->msg.cpuk_enter.pin, 0, 1, 1);
-            AT_PORT_SEND_END_AT();
-            break;
-        }
-        case LWCELL_CMD_COPS_SET: { /* Set current operator */
-            AT_PORT_SEND_BEGIN_AT();
-            AT_PORT_SEND_CONST_STR("+COPS=");
-            lwcelli_send_number(LWCELL_U32(msg->msg.cops_set.mode), 0, 0);
-            if (msg->msg.cops_set.mode != LWCELL_OPERATOR_MODE_AUTO) {
-                lwcelli_send_number(LWCELL_U32(msg->msg.cops_set.format), 0, 1);
-                switch (msg->msg.cops_set.format) {
-                    case LWCELL_OPERATOR_FORMAT_LONG_NAME:
-                    case LWCELL_OPERATOR_FORMAT_SHORT_NAME: lwcelli_send_string(msg->msg.cops_set.name, 1, 1, 1); break;
-                    default: lwcelli_send_number(LWCELL_U32(msg->msg.cops_set.num), 0, 1);
-                }
-            }
-            AT_PORT_SEND_END_AT();
-            break;
-        }
-        case LWCELL_CMD_COPS_GET: { /* Get current operator */
-            AT_PORT_SEND_BEGIN_AT();
-            AT_PORT_SEND_CONST_STR("+COPS?");
-            AT_PORT_SEND_END_AT();
-            break;
-        }
-        case LWCELL_CMD_COPS_GET_OPT: { /* Get list of available operators */
-            AT_PORT_SEND_BEGIN_AT();
-            AT_PORT_SEND_CONST_STR("+COPS=?");
-            AT_PORT_SEND_END_AT();
-            break;
-        }
-        case LWCELL_CMD_CSQ_GET: { /* Get signal strength */
-            AT_PORT_SEND_BEGIN_AT();
-            AT_PORT_SEND_CONST_STR("+CSQ");
-            AT_PORT_SEND_END_AT();
-            break;
-        }
-        case LWCELL_CMD_CNUM: { /* Get SIM number */
-            AT_PORT_SEND_BEGIN_AT();
-            AT_PORT_SEND_CONST_STR("+CNUM");
-            AT_PORT_SEND_END_AT();
-            break;
-        }
-        case LWCELL_CMD_CIPSHUT: { /* Shut down network connection and put to reset state */
-            AT_PORT_SEND_BEGIN_AT();
-            AT_PORT_SEND_CONST_STR("+CIPSHUT");
-            AT_PORT_SEND_END_AT();
-            break;
-        }
-#if LWCELL_CFG_CONN
-        case LWCELL_CMD_CIPMUX: { /* Enable multiple connections */
-            AT_PORT_SEND_BEGIN_AT();
-            AT_PORT_SEND_CONST_STR("+CIPMUX=1");
-            AT_PORT_SEND_END_AT();
-            break;
-        }
-        case LWCELL_CMD_CIPHEAD: { /* Enable information on receive data about connection and length */
-            AT_PORT_SEND_BEGIN_AT();
-            AT_PORT_SEND_CONST_STR("+CIPHEAD=1");
-            AT_PORT_SEND_END_AT();
-            break;
-        }
-        case LWCELL_CMD_CIPSRIP: {
-            AT_PORT_SEND_BEGIN_AT();
-            AT_PORT_SEND_CONST_STR("+CIPSRIP=1");
-            AT_PORT_SEND_END_AT();
-            break;
-        }
-        case LWCELL_CMD_CIPSSL: { /* Set SSL configuration */
-            AT_PORT_SEND_BEGIN_AT();
-            AT_PORT_SEND_CONST_STR("+CIPSSL=");
-            lwcelli_send_number((msg->msg.conn_start.type == LWCELL_CONN_TYPE_SSL) ? 1 : 0, 0, 0);
-            AT_PORT_SEND_END_AT();
-            break;
-        }
-        case LWCELL_CMD_CIPSTART: { /* Start a new connection */
-            lwcell_conn_t* c = NULL;
+    /* Try with hardware reset */
+    if (lwcell.ll.reset_fn != NULL && lwcell.ll.reset_fn(1)) {
+        lwcell_delay(2);
+        lwcell.ll.reset_fn(0);
+        lwcell_delay(500);
+#if LWCELL_CFG_CMUX
+        lwcelli_cmux_close(1); /* Device starts in normal AT mode */
+#endif                         /* LWCELL_CFG_CMUX */
+    }
+    return lwcellOK;
+}
 
-            /* Do we have network connection? */
-            /* Check if we are connected to network */
+static void
+lwcelli_cmd_args_cfun_set(lwcell_msg_t* msg) {
+    /**
+     * \todo: If CFUN command forced, check value
+     */
+    if (CMD_IS_DEF(LWCELL_CMD_RESET) || (CMD_IS_DEF(LWCELL_CMD_CFUN_SET) && msg->msg.cfun.mode)) {
+        AT_PORT_SEND_CONST_STR("1");
+    } else {
+        AT_PORT_SEND_CONST_STR("0");
+    }
+}
 
-            msg->msg.conn_start.num = 0;                              /* Start with max value = invalidated */
-            for (int16_t i = LWCELL_CFG_MAX_CONNS - 1; i >= 0; --i) { /* Find available connection */
-                if (!lwcell.m.conns[i].status.f.active) {
-                    c = &lwcell.m.conns[i];
-                    c->num = LWCELL_U8(i);
-                    msg->msg.conn_start.num = LWCELL_U8(i); /* Set connection number for message structure */
-                    break;
-                }
-            }
-            if (c == NULL) {
-                lwcelli_send_conn_error_cb(msg, lwcellERRNOFREECONN);
-                return lwcellERRNOFREECONN; /* We don't have available connection */
-            }
+static void
+lwcelli_cmd_args_cpin_set(lwcell_msg_t* msg) {
+    lwcelli_send_string(msg->msg.cpin_enter.pin, 0, 1, 0);
+}
 
-            if (msg->msg.conn_start.conn != NULL) { /* Is user interested about connection info? */
-                *msg->msg.conn_start.conn = c;      /* Save connection for user */
-            }
+static void
+lwcelli_cmd_args_cpin_add(lwcell_msg_t* msg) {
+    lwcelli_send_string(msg->msg.cpin_add.pin, 0, 1, 0);
+}
 
-            AT_PORT_SEND_BEGIN_AT();
-            AT_PORT_SEND_CONST_STR("+CIPSTART=");
-            lwcelli_send_number(LWCELL_U32(c->num), 0, 0);
-            if (msg->msg.conn_start.type == LWCELL_CONN_TYPE_UDP) {
-                lwcelli_send_string("UDP", 0, 1, 1);
-            } else {
-                lwcelli_send_string("TCP", 0, 1, 1);
-            }
-            lwcelli_send_string(msg->msg.conn_start.host, 0, 1, 1);
-            lwcelli_send_port(msg->msg.conn_start.port, 0, 1);
-            AT_PORT_SEND_END_AT();
-            break;
-        }
-        case LWCELL_CMD_CIPCLOSE: { /* Close the connection */
-            lwcell_conn_p c = msg->msg.conn_close.conn;
-            if (c != NULL &&
-                /* Is connection already closed or command for this connection is not valid anymore? */
-                (!lwcell_conn_is_active(c) || c->val_id != msg->msg.conn_close.val_id)) {
-                return lwcellERR;
-            }
-            AT_PORT_SEND_BEGIN_AT();
-            AT_PORT_SEND_CONST_STR("+CIPCLOSE=");
-            lwcelli_send_number(
-                LWCELL_U32(msg->msg.conn_close.conn ? msg->msg.conn_close.conn->num : LWCELL_CFG_MAX_CONNS), 0, 0);
-            AT_PORT_SEND_END_AT();
-            break;
-        }
-        case LWCELL_CMD_CIPSEND: {                    /* Send data to connection */
-            return lwcelli_tcpip_process_send_data(); /* Process send data */
-        }
-        case LWCELL_CMD_CIPSTATUS: {                  /* Get status of device and all connections */
-            AT_PORT_SEND_BEGIN_AT();
-            AT_PORT_SEND_CONST_STR("+CIPSTATUS");
-            AT_PORT_SEND_END_AT();
-            break;
-        }
-#endif                          /* LWCELL_CFG_CONN */
-#if LWCELL_CFG_SMS
-        case LWCELL_CMD_CMGF: { /* Select SMS message format */
-            AT_PORT_SEND_BEGIN_AT();
-            AT_PORT_SEND_CONST_STR("+CMGF=");
-            if (CMD_IS_DEF(LWCELL_CMD_CMGS)) {
-                lwcelli_send_number(LWCELL_U32(!!msg->msg.sms_send.format), 0, 0);
-            } else if (CMD_IS_DEF(LWCELL_CMD_CMGR)) {
-                lwcelli_send_number(LWCELL_U32(!!msg->msg.sms_read.format), 0, 0);
-            } else if (CMD_IS_DEF(LWCELL_CMD_CMGL)) {
-                lwcelli_send_number(LWCELL_U32(!!msg->msg.sms_list.format), 0, 0);
-            } else {
-                /* Used for all other operations like delete all messages, etc */
-                AT_PORT_SEND_CONST_STR("1");
-            }
-            AT_PORT_SEND_END_AT();
-            break;
-        }
-        case LWCELL_CMD_CMGS: { /* Send SMS */
-            AT_PORT_SEND_BEGIN_AT();
-            AT_PORT_SEND_CONST_STR("+CMGS=");
-            lwcelli_send_string(msg->msg.sms_send.num, 0, 1, 0);
-            AT_PORT_SEND_END_AT();
-            break;
-        }
-        case LWCELL_CMD_CMGR: { /* Read message */
-            AT_PORT_SEND_BEGIN_AT();
-            AT_PORT_SEND_CONST_STR("+CMGR=");
-            lwcelli_send_number(LWCELL_U32(msg->msg.sms_read.pos), 0, 0);
-            lwcelli_send_number(LWCELL_U32(!msg->msg.sms_read.update), 0, 1);
-            AT_PORT_SEND_END_AT();
-            break;
-        }
-        case LWCELL_CMD_CMGD: { /* Delete SMS message */
-            AT_PORT_SEND_BEGIN_AT();
-            AT_PORT_SEND_CONST_STR("+CMGD=");
-            lwcelli_send_number(LWCELL_U32(msg->msg.sms_delete.pos), 0, 0);
-            AT_PORT_SEND_END_AT();
-            break;
-        }
-        case LWCELL_CMD_CMGDA: { /* Mass delete SMS messages */
-            AT_PORT_SEND_BEGIN_AT();
-            AT_PORT_SEND_CONST_STR("+CMGDA=");
-            switch (msg->msg.sms_delete_all.status) {
-                case LWCELL_SMS_STATUS_READ: lwcelli_send_string("DEL READ", 0, 1, 0); break;
-                case LWCELL_SMS_STATUS_UNREAD: lwcelli_send_string("DEL UNREAD", 0, 1, 0); break;
-                case LWCELL_SMS_STATUS_SENT: lwcelli_send_string("DEL SENT", 0, 1, 0); break;
-                case LWCELL_SMS_STATUS_UNSENT: lwcelli_send_string("DEL UNSENT", 0, 1, 0); break;
-                case LWCELL_SMS_STATUS_INBOX: lwcelli_send_string("DEL INBOX", 0, 1, 0); break;
-                case LWCELL_SMS_STATUS_ALL: lwcelli_send_string("DEL ALL", 0, 1, 0); break;
-                default: break;
-            }
-            AT_PORT_SEND_END_AT();
-            break;
+static void
+lwcelli_cmd_args_cpin_change(lwcell_msg_t* msg) {
+    lwcelli_send_string(msg->msg.cpin_change.current_pin, 0, 1, 1);
+    lwcelli_send_string(msg->msg.cpin_change.new_pin, 0, 1, 1);
+}
+
+static void
+lwcelli_cmd_args_cpin_remove(lwcell_msg_t* msg) {
+    lwcelli_send_string(msg->msg.cpin_remove.pin, 0, 1, 0);
+}
+
+static void
+lwcelli_cmd_args_cpuk_set(lwcell_msg_t* msg) {
+    lwcelli_send_string(msg->msg.cpuk_enter.puk, 0, 1, 0);
+    lwcelli_send_string(msg->msg.cpuk_enter.pin, 0, 1, 1);
+}
+
+static void
+lwcelli_cmd_args_cops_set(lwcell_msg_t* msg) {
+    lwcelli_send_number(LWCELL_U32(msg->msg.cops_set.mode), 0, 0);
+    if (msg->msg.cops_set.mode != LWCELL_OPERATOR_MODE_AUTO) {
+        lwcelli_send_number(LWCELL_U32(msg->msg.cops_set.format), 0, 1);
+        switch (msg->msg.cops_set.format) {
+            case LWCELL_OPERATOR_FORMAT_LONG_NAME:
+            case LWCELL_OPERATOR_FORMAT_SHORT_NAME: lwcelli_send_string(msg->msg.cops_set.name, 1, 1, 1); break;
+            default: lwcelli_send_number(LWCELL_U32(msg->msg.cops_set.num), 0, 1);
         }
+    }
+}
+
+#if LWCELL_CFG_CONN
+
+static void
+lwcelli_cmd_args_cipssl(lwcell_msg_t* msg) {
+    lwcelli_send_number((msg->msg.conn_start.type == LWCELL_CONN_TYPE_SSL) ? 1 : 0, 0, 0);
+}
 
-        case LWCELL_CMD_CMGL: { /* Delete SMS message */
-            AT_PORT_SEND_BEGIN_AT();
-            AT_PORT_SEND_CONST_STR("+CMGL=");
-            lwcelli_send_sms_stat(msg->msg.sms_list.status, 1, 0);
-            lwcelli_send_number(LWCELL_U32(!msg->msg.sms_list.update), 0, 1);
-            AT_PORT_SEND_END_AT();
+/**
+ * \brief           Find free connection for new connection start
+ * \param[in]       msg: Pointer to \ref lwcell_msg_t with data
+ * \return          Member of \ref lwcellr_t enumeration
+ */
+static lwcellr_t
+lwcelli_cmd_prep_cipstart(lwcell_msg_t* msg) {
+    lwcell_conn_t* c = NULL;
+
+#if LWCELL_CFG_CONN_TRANSPARENT
+    /* Connection has been reserved by CIPMUX=0 step */
+    if (msg->msg.conn_start.type == LWCELL_CONN_TYPE_TCP_TRANSPARENT) {
+        return lwcellOK;
+    }
+#endif /* LWCELL_CFG_CONN_TRANSPARENT */
+    msg->msg.conn_start.num = 0;                              /* Start with max value = invalidated */
+    for (int16_t i = LWCELL_CFG_MAX_CONNS - 1; i >= 0; --i) { /* Find available connection */
+        if (!lwcell.m.conns[i].status.f.active) {
+            c = &lwcell.m.conns[i];
+            c->num = LWCELL_U8(i);
+            msg->msg.conn_start.num = LWCELL_U8(i); /* Set connection number for message structure */
             break;
         }
-        case LWCELL_CMD_CPMS_GET_OPT: { /* Get available SMS storages */
-            AT_PORT_SEND_BEGIN_AT();
-            AT_PORT_SEND_CONST_STR("+CPMS=?");
-            AT_PORT_SEND_END_AT();
-            break;
+    }
+    if (c == NULL) {
+        lwcelli_send_conn_error_cb(msg, lwcellERRNOFREECONN);
+        return lwcellERRNOFREECONN; /* We don't have available connection */
+    }
+
+    if (msg->msg.conn_start.conn != NULL) { /* Is user interested about connection info? */
+        *msg->msg.conn_start.conn = c;      /* Save connection for user */
+    }
+    return lwcellOK;
+}
+
+static void
+lwcelli_cmd_args_cipstart(lwcell_msg_t* msg) {
+    if (0) {
+#if LWCELL_CFG_CONN_TRANSPARENT
+    } else if (msg->msg.conn_start.type == LWCELL_CONN_TYPE_TCP_TRANSPARENT) {
+        lwcelli_send_string("TCP", 0, 1, 0); /* Single connection mode does not use connection number */
+#endif /* LWCELL_CFG_CONN_TRANSPARENT */
+    } else {
+        lwcelli_send_number(LWCELL_U32(msg->msg.conn_start.num), 0, 0);
+        if (msg->msg.conn_start.type == LWCELL_CONN_TYPE_UDP) {
+            lwcelli_send_string("UDP", 0, 1, 1);
+        } else {
+            lwcelli_send_string("TCP", 0, 1, 1);
         }
-        case LWCELL_CMD_CPMS_GET: { /* Get current SMS storage info */
-            AT_PORT_SEND_BEGIN_AT();
-            AT_PORT_SEND_CONST_STR("+CPMS?");
-            AT_PORT_SEND_END_AT();
-            break;
+    }
+    lwcelli_send_string(msg->msg.conn_start.host, 0, 1, 1);
+    lwcelli_send_port(msg->msg.conn_start.port, 0, 1);
+}
+
+#if LWCELL_CFG_CONN_TRANSPARENT
+
+/**
+ * \brief           Reserve first connection before switching to single connection mode
+ * \note            Single connection mode is only possible when no other connection is active
+ * \param[in]       msg: Pointer to \ref lwcell_msg_t with data
+ * \return          Member of \ref lwcellr_t enumeration
+ */
+static lwcellr_t
+lwcelli_cmd_prep_cipmux_set_0(lwcell_msg_t* msg) {
+    for (size_t i = 0; i < LWCELL_CFG_MAX_CONNS; ++i) {
+        if (lwcell.m.conns[i].status.f.active) {
+            return lwcellERRNOFREECONN;
         }
-        case LWCELL_CMD_CPMS_SET: { /* Set active SMS storage(s) */
-            AT_PORT_SEND_BEGIN_AT();
-            AT_PORT_SEND_CONST_STR("+CPMS=");
-            if (CMD_IS_DEF(LWCELL_CMD_CMGR)) { /* Read SMS original command? */
-                lwcelli_send_dev_memory(msg->msg.sms_read.mem == LWCELL_MEM_CURRENT ? lwcell.m.sms.mem[0].current
-                                                                                    : msg->msg.sms_read.mem,
-                                        1, 0);
-            } else if (CMD_IS_DEF(LWCELL_CMD_CMGD)) { /* Delete SMS original command? */
-                lwcelli_send_dev_memory(msg->msg.sms_delete.mem == LWCELL_MEM_CURRENT ? lwcell.m.sms.mem[0].current
-                                                                                      : msg->msg.sms_delete.mem,
-                                        1, 0);
-            } else if (CMD_IS_DEF(LWCELL_CMD_CMGL)) { /* List SMS original command? */
-                lwcelli_send_dev_memory(msg->msg.sms_list.mem == LWCELL_MEM_CURRENT ? lwcell.m.sms.mem[0].current
-                                                                                    : msg->msg.sms_list.mem,
-                                        1, 0);
-            } else if (CMD_IS_DEF(
-                           LWCELL_CMD_CPMS_SET)) { /* Do we want to set memory for read/delete,sent/write,receive? */
-                for (size_t i = 0; i < 3; ++i) {   /* Write 3 memories */
-                    lwcelli_send_dev_memory(msg->msg.sms_memory.mem[i] == LWCELL_MEM_CURRENT
-                                                ? lwcell.m.sms.mem[i].current
-                                                : msg->msg.sms_memory.mem[i],
-                                            1, !!i);
-                }
-            }
-            AT_PORT_SEND_END_AT();
-            break;
-        }
-#endif                         /* LWCELL_CFG_SMS */
-#if LWCELL_CFG_CALL
-        case LWCELL_CMD_ATD: { /* Start new call */
-            AT_PORT_SEND_BEGIN_AT();
-            AT_PORT_SEND_CONST_STR("D");
-            lwcelli_send_string(msg->msg.call_start.number, 0, 0, 0);
-            AT_PORT_SEND_CONST_STR(";");
-            AT_PORT_SEND_END_AT();
-            break;
-        }
-        case LWCELL_CMD_ATA: { /* Answer phone call */
-            AT_PORT_SEND_BEGIN_AT();
-            AT_PORT_SEND_CONST_STR("A");
-            AT_PORT_SEND_END_AT();
-            break;
+    }
+
+    lwcell.m.conns[0].num = 0;
+    msg->msg.conn_start.num = 0;
+    if (msg->msg.conn_start.conn != NULL) {
+        *msg->msg.conn_start.conn = &lwcell.m.conns[0];
+    }
+    return lwcellOK;
+}
+
+/**
+ * \brief           Wait guard time before escape sequence is sent to the device
+ * \note            Core is unlocked during guard time to let connection data through
+ * \param[in]       msg: Pointer to \ref lwcell_msg_t with data
+ * \return          Member of \ref lwcellr_t enumeration
+ */
+static lwcellr_t
+lwcelli_cmd_prep_ppp(lwcell_msg_t* msg) {
+    LWCELL_UNUSED(msg);
+
+    if (!lwcell.m.transp.data_mode) {
+        return lwcellERR;
+    }
+
+    /* Block further writes and keep line silent for guard time */
+    lwcell.m.transp.escaping = 1;
+    lwcell_core_unlock();
+    lwcell_delay(LWCELL_CFG_CONN_TRANSPARENT_GUARD_TIME);
+    lwcell_core_lock();
+
+    /* Connection may be closed by remote side in the meantime */
+    if (!lwcell.m.transp.data_mode) {
+        lwcell.m.transp.escaping = 0;
+        return lwcellERR;
+    }
+    return lwcellOK;
+}
+
+#endif /* LWCELL_CFG_CONN_TRANSPARENT */
+
+/**
+ * \brief           Check if connection can still be closed
+ * \param[in]       msg: Pointer to \ref lwcell_msg_t with data
+ * \return          Member of \ref lwcellr_t enumeration
+ */
+static lwcellr_t
+lwcelli_cmd_prep_cipclose(lwcell_msg_t* msg) {
+    lwcell_conn_p c = msg->msg.conn_close.conn;
+    if (c != NULL &&
+        /* Is connection already closed or command for this connection is not valid anymore? */
+        (!lwcell_conn_is_active(c) || c->val_id != msg->msg.conn_close.val_id)) {
+        return lwcellERR;
+    }
+    return lwcellOK;
+}
+
+static void
+lwcelli_cmd_args_cipserver(lwcell_msg_t* msg) {
+    if (msg->msg.tcpip_server.en) {
+        AT_PORT_SEND_CONST_STR("1");
+        lwcelli_send_port(msg->msg.tcpip_server.port, 0, 1);
+    } else {
+        AT_PORT_SEND_CONST_STR("0");
+    }
+}
+
+static void
+lwcelli_cmd_args_cipclose(lwcell_msg_t* msg) {
+    lwcelli_send_number(LWCELL_U32(msg->msg.conn_close.conn ? msg->msg.conn_close.conn->num : LWCELL_CFG_MAX_CONNS),
+                        0, 0);
+}
+
+/**
+ * \brief           Check connection and calculate length of next data chunk to send
+ * \param[in]       msg: Pointer to \ref lwcell_msg_t with data
+ * \return          Member of \ref lwcellr_t enumeration
+ */
+static lwcellr_t
+lwcelli_cmd_prep_cipsend(lwcell_msg_t* msg) {
+    lwcell_conn_t* c = msg->msg.conn_send.conn;
+    if (!lwcell_conn_is_active(c) ||           /* Is the connection already closed? */
+        msg->msg.conn_send.val_id != c->val_id /* Did validation ID change after we set parameter? */
+    ) {
+        /* Send event to user about failed send event */
+        CONN_SEND_DATA_SEND_EVT(msg, lwcellCLOSED);
+        return lwcellERR;
+    }
+    msg->msg.conn_send.sent = LWCELL_MIN(msg->msg.conn_send.btw, LWCELL_CFG_CONN_MAX_DATA_LEN);
+#if LWCELL_CFG_CONN_QSEND
+    /* Query acknowledged bytes first, if chunk does not fit into in-flight window */
+    if (c->tx_unacked > 0 && (c->tx_unacked + msg->msg.conn_send.sent) > LWCELL_CFG_CONN_QSEND_WINDOW) {
+        msg->cmd = LWCELL_CMD_CIPACK;
+    }
+#endif /* LWCELL_CFG_CONN_QSEND */
+    return lwcellOK;
+}
+
+#if LWCELL_CFG_CONN_QSEND
+static void
+lwcelli_cmd_args_cipack(lwcell_msg_t* msg) {
+    lwcelli_send_number(LWCELL_U32(msg->msg.conn_send.conn->num), 0, 0);
+}
+#endif /* LWCELL_CFG_CONN_QSEND */
+
+#if LWCELL_CFG_CONN_MANUAL_RX
+/**
+ * \brief           Allocate buffer for next data read in manual receive mode
+ *
+ * Buffer length is limited by data available in device, maximal data length
+ * and free space in receive window. It is halved when memory is not available
+ *
+ * \param[in]       msg: Pointer to \ref lwcell_msg_t with read command
+ * \return          \ref lwcellOK on success, \ref lwcellINPROG when there is nothing to read,
+ *                      member of \ref lwcellr_t enumeration otherwise
+ */
+static lwcellr_t
+lwcelli_conn_manual_rx_alloc(lwcell_msg_t* msg) {
+    lwcell_conn_t* c = msg->msg.conn_recv.conn;
+    size_t len;
+
+    if (!lwcell_conn_is_active(c) || msg->msg.conn_recv.val_id != c->val_id) {
+        return lwcellERR;
+    }
+    if (c->rx_unconfirmed >= LWCELL_CFG_CONN_MANUAL_RX_WINDOW
+        || c->rx_pbufs >= LWCELL_CFG_CONN_MANUAL_RX_MAX_PBUFS) {
+        return lwcellINPROG; /* Wait for application to process received data */
+    }
+    len = LWCELL_MIN(c->rx_avail, LWCELL_CFG_CONN_MAX_DATA_LEN);
+    len = LWCELL_MIN(len, LWCELL_CFG_CONN_MANUAL_RX_WINDOW - c->rx_unconfirmed);
+    if (len == 0) {
+        return lwcellINPROG;
+    }
+    do {
+        msg->msg.conn_recv.pbuf = lwcell_pbuf_new(len); /* Allocate new packet buffer */
+    } while (msg->msg.conn_recv.pbuf == NULL && (len = (len >> 1)) >= LWCELL_CFG_CONN_MIN_DATA_LEN);
+    return msg->msg.conn_recv.pbuf != NULL ? lwcellOK : lwcellERRMEM;
+}
+
+/**
+ * \brief           Check connection and allocate buffer for data read
+ * \param[in]       msg: Pointer to \ref lwcell_msg_t with read command
+ * \return          Member of \ref lwcellr_t enumeration
+ */
+static lwcellr_t
+lwcelli_cmd_prep_ciprxget(lwcell_msg_t* msg) {
+    if (msg->msg.conn_recv.pbuf == NULL) {
+        return lwcelli_conn_manual_rx_alloc(msg);
+    }
+    return lwcellOK;
+}
+
+static void
+lwcelli_cmd_args_ciprxget(lwcell_msg_t* msg) {
+    lwcelli_send_number(LWCELL_U32(msg->msg.conn_recv.conn->num), 0, 0);
+    lwcelli_send_number(LWCELL_U32(msg->msg.conn_recv.pbuf->len), 0, 1);
+}
+
+static void
+lwcelli_cmd_args_ciprxget_len(lwcell_msg_t* msg) {
+    lwcelli_send_number(LWCELL_U32(msg->msg.conn_recv.conn->num), 0, 0);
+}
+#endif /* LWCELL_CFG_CONN_MANUAL_RX */
+
+static void
+lwcelli_cmd_args_cipsend(lwcell_msg_t* msg) {
+    lwcell_conn_t* c = msg->msg.conn_send.conn;
+
+    lwcelli_send_number(LWCELL_U32(c->num), 0, 0);                  /* Send connection number */
+    lwcelli_send_number(LWCELL_U32(msg->msg.conn_send.sent), 0, 1); /* Send length number */
+
+    /* On UDP connections, IP address and port may be selected */
+    if (c->type == LWCELL_CONN_TYPE_UDP) {
+        if (msg->msg.conn_send.remote_ip != NULL && msg->msg.conn_send.remote_port) {
+            lwcelli_send_ip_mac(msg->msg.conn_send.remote_ip, 1, 1, 1); /* Send IP address including quotes */
+            lwcelli_send_port(msg->msg.conn_send.remote_port, 0, 1);    /* Send length number */
         }
-        case LWCELL_CMD_ATH: { /* Disconnect existing connection (hang-up phone call) */
-            AT_PORT_SEND_BEGIN_AT();
-            AT_PORT_SEND_CONST_STR("H");
-            AT_PORT_SEND_END_AT();
-            break;
+    }
+}
+
+#endif /* LWCELL_CFG_CONN */
+
+#if LWCELL_CFG_SMS
+
+static void
+lwcelli_cmd_args_cmgf(lwcell_msg_t* msg) {
+    if (CMD_IS_DEF(LWCELL_CMD_CMGS)) {
+        lwcelli_send_number(LWCELL_U32(!!msg->msg.sms_send.format), 0, 0);
+    } else if (CMD_IS_DEF(LWCELL_CMD_CMGR)) {
+        lwcelli_send_number(LWCELL_U32(!!msg->msg.sms_read.format), 0, 0);
+    } else if (CMD_IS_DEF(LWCELL_CMD_CMGL)) {
+        lwcelli_send_number(LWCELL_U32(!!msg->msg.sms_list.format), 0, 0);
+    } else {
+        /* Used for all other operations like delete all messages, etc */
+        AT_PORT_SEND_CONST_STR("1");
+    }
+}
+
+static void
+lwcelli_cmd_args_cmgs(lwcell_msg_t* msg) {
+    lwcelli_send_string(msg->msg.sms_send.num, 0, 1, 0);
+}
+
+static void
+lwcelli_cmd_args_cmgr(lwcell_msg_t* msg) {
+    lwcelli_send_number(LWCELL_U32(msg->msg.sms_read.pos), 0, 0);
+    lwcelli_send_number(LWCELL_U32(!msg->msg.sms_read.update), 0, 1);
+}
+
+static void
+lwcelli_cmd_args_cmgd(lwcell_msg_t* msg) {
+    lwcelli_send_number(LWCELL_U32(msg->msg.sms_delete.pos), 0, 0);
+}
+
+static void
+lwcelli_cmd_args_cmgda(lwcell_msg_t* msg) {
+    switch (msg->msg.sms_delete_all.status) {
+        case LWCELL_SMS_STATUS_READ: lwcelli_send_string("DEL READ", 0, 1, 0); break;
+        case LWCELL_SMS_STATUS_UNREAD: lwcelli_send_string("DEL UNREAD", 0, 1, 0); break;
+        case LWCELL_SMS_STATUS_SENT: lwcelli_send_string("DEL SENT", 0, 1, 0); break;
+        case LWCELL_SMS_STATUS_UNSENT: lwcelli_send_string("DEL UNSENT", 0, 1, 0); break;
+        case LWCELL_SMS_STATUS_INBOX: lwcelli_send_string("DEL INBOX", 0, 1, 0); break;
+        case LWCELL_SMS_STATUS_ALL: lwcelli_send_string("DEL ALL", 0, 1, 0); break;
+        default: break;
+    }
+}
+
+static void
+lwcelli_cmd_args_cmgl(lwcell_msg_t* msg) {
+    lwcelli_send_sms_stat(msg->msg.sms_list.status, 1, 0);
+    lwcelli_send_number(LWCELL_U32(!msg->msg.sms_list.update), 0, 1);
+}
+
+static void
+lwcelli_cmd_args_cpms_set(lwcell_msg_t* msg) {
+    if (CMD_IS_DEF(LWCELL_CMD_CMGR)) { /* Read SMS original command? */
+        lwcelli_send_dev_memory(msg->msg.sms_read.mem == LWCELL_MEM_CURRENT ? lwcell.m.sms.mem[0].current
+                                                                            : msg->msg.sms_read.mem,
+                                1, 0);
+    } else if (CMD_IS_DEF(LWCELL_CMD_CMGD)) { /* Delete SMS original command? */
+        lwcelli_send_dev_memory(msg->msg.sms_delete.mem == LWCELL_MEM_CURRENT ? lwcell.m.sms.mem[0].current
+                                                                              : msg->msg.sms_delete.mem,
+                                1, 0);
+    } else if (CMD_IS_DEF(LWCELL_CMD_CMGL)) { /* List SMS original command? */
+        lwcelli_send_dev_memory(msg->msg.sms_list.mem == LWCELL_MEM_CURRENT ? lwcell.m.sms.mem[0].current
+                                                                            : msg->msg.sms_list.mem,
+                                1, 0);
+    } else if (CMD_IS_DEF(LWCELL_CMD_CPMS_SET)) { /* Do we want to set memory for read/delete,sent/write,receive? */
+        for (size_t i = 0; i < 3; ++i) {          /* Write 3 memories */
+            lwcelli_send_dev_memory(msg->msg.sms_memory.mem[i] == LWCELL_MEM_CURRENT ? lwcell.m.sms.mem[i].current
+                                                                                     : msg->msg.sms_memory.mem[i],
+                                    1, !!i);
         }
-#endif                                  /* LWCELL_CFG_CALL */
+    }
+}
+
+#endif /* LWCELL_CFG_SMS */
+
+#if LWCELL_CFG_CALL
+
+static void
+lwcelli_cmd_args_atd(lwcell_msg_t* msg) {
+    lwcelli_send_string(msg->msg.call_start.number, 0, 0, 0);
+    AT_PORT_SEND_CONST_STR(";");
+}
+
+#endif /* LWCELL_CFG_CALL */
+
 #if LWCELL_CFG_PHONEBOOK
-        case LWCELL_CMD_CPBS_GET_OPT: { /* Get available phonebook storages */
-            AT_PORT_SEND_BEGIN_AT();
-            AT_PORT_SEND_CONST_STR("+CPBS=?");
-            AT_PORT_SEND_END_AT();
-            break;
-        }
-        case LWCELL_CMD_CPBS_GET: { /* Get current memory info */
-            AT_PORT_SEND_BEGIN_AT();
-            AT_PORT_SEND_CONST_STR("+CPBS?");
-            AT_PORT_SEND_END_AT();
-            break;
-        }
-        case LWCELL_CMD_CPBS_SET: { /* Get current memory info */
-            lwcell_mem_t mem;
-            AT_PORT_SEND_BEGIN_AT();
-            AT_PORT_SEND_CONST_STR("+CPBS=");
-            switch (CMD_GET_DEF()) {
-                case LWCELL_CMD_CPBW_SET: mem = msg->msg.pb_write.mem; break;
-                case LWCELL_CMD_CPBR: mem = msg->msg.pb_list.mem; break;
-                case LWCELL_CMD_CPBF: mem = msg->msg.pb_search.mem; break;
-                default: break;
-            }
-            lwcelli_send_dev_memory(mem == LWCELL_MEM_CURRENT ? lwcell.m.pb.mem.current : mem, 1, 0);
-            AT_PORT_SEND_END_AT();
-            break;
-        }
-        case LWCELL_CMD_CPBW_SET: { /* Write/Delete new/old entry */
-            AT_PORT_SEND_BEGIN_AT();
-            AT_PORT_SEND_CONST_STR("+CPBW=");
-            if (msg->msg.pb_write.pos > 0) { /* Write number if more than 0 */
-                lwcelli_send_number(LWCELL_U32(msg->msg.pb_write.pos), 0, 0);
-            }
-            if (!msg->msg.pb_write.del) {
-                lwcelli_send_string(msg->msg.pb_write.num, 0, 1, 1);
-                lwcelli_send_number(LWCELL_U32(msg->msg.pb_write.type), 0, 1);
-                lwcelli_send_string(msg->msg.pb_write.name, 0, 1, 1);
-            }
-            AT_PORT_SEND_END_AT();
-            break;
-        }
-        case LWCELL_CMD_CPBR: { /* Read entires */
-            AT_PORT_SEND_BEGIN_AT();
-            AT_PORT_SEND_CONST_STR("+CPBR=");
-            lwcelli_send_number(LWCELL_U32(msg->msg.pb_list.start_index), 0, 0);
-            lwcelli_send_number(LWCELL_U32(msg->msg.pb_list.etr), 0, 1);
-            AT_PORT_SEND_END_AT();
-            break;
-        }
-        case LWCELL_CMD_CPBF: { /* Find entires */
-            AT_PORT_SEND_BEGIN_AT();
-            AT_PORT_SEND_CONST_STR("+CPBF=");
-            lwcelli_send_string(msg->msg.pb_search.search, 1, 1, 0);
-            AT_PORT_SEND_END_AT();
-            break;
-        }
+
+static void
+lwcelli_cmd_args_cpbs_set(lwcell_msg_t* msg) {
+    lwcell_mem_t mem = LWCELL_MEM_CURRENT;
+
+    switch (CMD_GET_DEF()) {
+        case LWCELL_CMD_CPBW_SET: mem = msg->msg.pb_write.mem; break;
+        case LWCELL_CMD_CPBR: mem = msg->msg.pb_list.mem; break;
+        case LWCELL_CMD_CPBF: mem = msg->msg.pb_search.mem; break;
+        default: break;
+    }
+    lwcelli_send_dev_memory(mem == LWCELL_MEM_CURRENT ? lwcell.m.pb.mem.current : mem, 1, 0);
+}
+
+static void
+lwcelli_cmd_args_cpbw_set(lwcell_msg_t* msg) {
+    if (msg->msg.pb_write.pos > 0) { /* Write number if more than 0 */
+        lwcelli_send_number(LWCELL_U32(msg->msg.pb_write.pos), 0, 0);
+    }
+    if (!msg->msg.pb_write.del) {
+        lwcelli_send_string(msg->msg.pb_write.num, 0, 1, 1);
+        lwcelli_send_number(LWCELL_U32(msg->msg.pb_write.type), 0, 1);
+        lwcelli_send_string(msg->msg.pb_write.name, 0, 1, 1);
+    }
+}
+
+static void
+lwcelli_cmd_args_cpbr(lwcell_msg_t* msg) {
+    lwcelli_send_number(LWCELL_U32(msg->msg.pb_list.start_index), 0, 0);
+    lwcelli_send_number(LWCELL_U32(msg->msg.pb_list.etr), 0, 1);
+}
+
+static void
+lwcelli_cmd_args_cpbf(lwcell_msg_t* msg) {
+    lwcelli_send_string(msg->msg.pb_search.search, 1, 1, 0);
+}
+
 #endif /* LWCELL_CFG_PHONEBOOK */
+
 #if LWCELL_CFG_NETWORK
-        case LWCELL_CMD_NETWORK_ATTACH:
-        case LWCELL_CMD_CGACT_SET_0: {
-            AT_PORT_SEND_BEGIN_AT();
-            AT_PORT_SEND_CONST_STR("+CGACT=0");
-            AT_PORT_SEND_END_AT();
-            break;
-        }
-        case LWCELL_CMD_CGACT_SET_1: {
-            AT_PORT_SEND_BEGIN_AT();
-            AT_PORT_SEND_CONST_STR("+CGACT=1");
-            AT_PORT_SEND_END_AT();
-            break;
-        }
-        case LWCELL_CMD_NETWORK_DETACH:
-        case LWCELL_CMD_CGATT_SET_0: {
-            AT_PORT_SEND_BEGIN_AT();
-            AT_PORT_SEND_CONST_STR("+CGATT=0");
-            AT_PORT_SEND_END_AT();
-            break;
-        }
-        case LWCELL_CMD_CGATT_SET_1: {
-            AT_PORT_SEND_BEGIN_AT();
-            AT_PORT_SEND_CONST_STR("+CGATT=1");
-            AT_PORT_SEND_END_AT();
-            break;
-        }
-        case LWCELL_CMD_CIPMUX_SET: {
-            AT_PORT_SEND_BEGIN_AT();
-            AT_PORT_SEND_CONST_STR("+CIPMUX=1");
-            AT_PORT_SEND_END_AT();
-            break;
-        }
-        case LWCELL_CMD_CIPRXGET_SET: {
-            AT_PORT_SEND_BEGIN_AT();
-            AT_PORT_SEND_CONST_STR("+CIPRXGET=0");
-            AT_PORT_SEND_END_AT();
-            break;
-        }
-        case LWCELL_CMD_CSTT_SET: {
-            AT_PORT_SEND_BEGIN_AT();
-            AT_PORT_SEND_CONST_STR("+CSTT=");
-            lwcelli_send_string(msg->msg.network_attach.apn, 1, 1, 0);
-            lwcelli_send_string(msg->msg.network_attach.user, 1, 1, 1);
-            lwcelli_send_string(msg->msg.network_attach.pass, 1, 1, 1);
-            AT_PORT_SEND_END_AT();
-            break;
-        }
-        case LWCELL_CMD_CIICR: {
-            AT_PORT_SEND_BEGIN_AT();
-            AT_PORT_SEND_CONST_STR("+CIICR");
-            AT_PORT_SEND_END_AT();
-            break;
-        }
-        case LWCELL_CMD_CIFSR: {
-            AT_PORT_SEND_BEGIN_AT();
-            AT_PORT_SEND_CONST_STR("+CIFSR");
-            AT_PORT_SEND_END_AT();
-            break;
-        }
+
+static void
+lwcelli_cmd_args_cstt_set(lwcell_msg_t* msg) {
+    lwcelli_send_string(msg->msg.network_attach.apn, 1, 1, 0);
+    lwcelli_send_string(msg->msg.network_attach.user, 1, 1, 1);
+    lwcelli_send_string(msg->msg.network_attach.pass, 1, 1, 1);
+}
+
 #endif /* LWCELL_CFG_NETWORK */
+
 #if LWCELL_CFG_USSD
-        case LWCELL_CMD_CUSD_GET: {
-            AT_PORT_SEND_BEGIN_AT();
-            AT_PORT_SEND_CONST_STR("+CUSD?");
-            AT_PORT_SEND_END_AT();
+
+static void
+lwcelli_cmd_args_cusd(lwcell_msg_t* msg) {
+    lwcelli_send_string(msg->msg.ussd.code, 1, 1, 0);
+}
+
+#endif /* LWCELL_CFG_USSD */
+
+#if LWCELL_CFG_PPP
+
+/**
+ * \brief           Keep PPP credentials and input function before device is dialled
+ * \param[in]       msg: Pointer to \ref lwcell_msg_t with data
+ * \return          Member of \ref lwcellr_t enumeration
+ */
+static lwcellr_t
+lwcelli_cmd_prep_ppp_start(lwcell_msg_t* msg) {
+    return lwcelli_ppp_prepare(msg);
+}
+
+static void
+lwcelli_cmd_args_ppp_start(lwcell_msg_t* msg) {
+    lwcelli_send_string(msg->msg.ppp_start.apn, 1, 1, 0);
+}
+
+/**
+ * \brief           Send LCP terminate request instead of AT command
+ * \param[in]       msg: Pointer to \ref lwcell_msg_t with data
+ * \return          Member of \ref lwcellr_t enumeration
+ */
+static lwcellr_t
+lwcelli_cmd_prep_ppp_stop(lwcell_msg_t* msg) {
+    LWCELL_UNUSED(msg);
+    return lwcelli_ppp_terminate();
+}
+
+#endif /* LWCELL_CFG_PPP */
+
+#if LWCELL_CFG_CMUX
+
+/**
+ * \brief           Allocate channel buffers before device is switched to multiplexer mode
+ * \param[in]       msg: Pointer to \ref lwcell_msg_t with data
+ * \return          Member of \ref lwcellr_t enumeration
+ */
+static lwcellr_t
+lwcelli_cmd_prep_cmux(lwcell_msg_t* msg) {
+    LWCELL_UNUSED(msg);
+    return lwcelli_cmux_prepare();
+}
+
+static void
+lwcelli_cmd_args_cmux(lwcell_msg_t* msg) {
+    static const uint32_t speeds[] = {9600, 19200, 38400, 57600, 115200, 230400};
+
+    LWCELL_UNUSED(msg);
+
+    /* Port speed is sent as index of known baudrate, left empty for others */
+    for (size_t i = 0; i < LWCELL_ARRAYSIZE(speeds); ++i) {
+        if (lwcell.ll.uart.baudrate == speeds[i]) {
+            lwcelli_send_number(LWCELL_U32(i + 1), 0, 0);
             break;
         }
-        case LWCELL_CMD_CUSD: {
-            AT_PORT_SEND_BEGIN_AT();
-            AT_PORT_SEND_CONST_STR("+CUSD=1,");
-            lwcelli_send_string(msg->msg.ussd.code, 1, 1, 0);
-            AT_PORT_SEND_END_AT();
+    }
+    lwcelli_send_number(LWCELL_U32(LWCELL_CFG_CMUX_N1), 0, 1);
+}
+
+/**
+ * \brief           Start framing and open channels once device accepted multiplexer command
+ * \param[in]       msg: Pointer to \ref lwcell_msg_t with data
+ * \return          Member of \ref lwcellr_t enumeration
+ */
+static lwcellr_t
+lwcelli_cmd_prep_cmux_at(lwcell_msg_t* msg) {
+    LWCELL_UNUSED(msg);
+    lwcelli_cmux_activate();
+    return lwcellOK;
+}
+
+/**
+ * \brief           Close down multiplexer before AT port is checked in normal mode
+ * \param[in]       msg: Pointer to \ref lwcell_msg_t with data
+ * \return          Member of \ref lwcellr_t enumeration
+ */
+static lwcellr_t
+lwcelli_cmd_prep_cmux_cld(lwcell_msg_t* msg) {
+    LWCELL_UNUSED(msg);
+
+    if (!lwcell.cmux.active) {
+        return lwcellERR;
+    }
+    lwcelli_cmux_close(0);
+    return lwcellOK;
+}
+
+#endif /* LWCELL_CFG_CMUX */
+
+/**
+ * \brief           Index of every command in descriptor table
+ */
+enum {
+#define LWCELL_CMD_ENTRY(cmd, str, final, timeout, prep_fn, args_fn) LWCELL_CMD_DESC_IDX_##cmd,
+#include "lwcell/lwcell_cmds.h"
+    LWCELL_CMD_DESC_COUNT
+};
+
+/**
+ * \brief           AT command descriptors, only for commands of enabled features
+ */
+static const lwcell_cmd_desc_t cmd_descs[] = {
+#define LWCELL_CMD_ENTRY(cmd, str, final, timeout, prep_fn, args_fn)                                                 \
+    {str, LWCELL_U8(sizeof(str) - 1), final, timeout, prep_fn, args_fn},
+#include "lwcell/lwcell_cmds.h"
+};
+
+/**
+ * \brief           Mapping from command to descriptor index, increased by `1`.
+ *                  Value `0` means command is not supported
+ */
+static const uint8_t cmd_desc_map[LWCELL_CMD_END] = {
+#define LWCELL_CMD_ENTRY(cmd, str, final, timeout, prep_fn, args_fn) [cmd] = LWCELL_CMD_DESC_IDX_##cmd + 1,
+#include "lwcell/lwcell_cmds.h"
+};
+
+/**
+ * \brief           Get expected final response of command
+ * \param[in]       cmd: Command to check
+ * \return          \ref LWCELL_CMD_FINAL_OK or \ref LWCELL_CMD_FINAL_DATA
+ */
+static uint8_t
+lwcelli_cmd_get_final(lwcell_cmd_t cmd) {
+    if (cmd >= LWCELL_CMD_END || cmd_desc_map[cmd] == 0) {
+        return LWCELL_CMD_FINAL_OK;
+    }
+    return cmd_descs[cmd_desc_map[cmd] - 1].final;
+}
+
+/**
+ * \brief           Function to initialize every AT command
+ * \note            Never call this function directly. Set as initialization function for command and use `msg->fn(msg)`
+ * \param[in]       msg: Pointer to \ref lwcell_msg_t with data
+ * \return          Member of \ref lwcellr_t enumeration
+ */
+lwcellr_t
+lwcelli_initiate_cmd(lwcell_msg_t* msg) {
+    const lwcell_cmd_desc_t* desc;
+    lwcellr_t res;
+
+    /* Find descriptor for current command */
+    if (CMD_GET_CUR() >= LWCELL_CMD_END || cmd_desc_map[CMD_GET_CUR()] == 0) {
+        return lwcellERR; /* Invalid command */
+    }
+    desc = &cmd_descs[cmd_desc_map[CMD_GET_CUR()] - 1];
+
+#if LWCELL_CFG_CONN && LWCELL_CFG_CONN_TRANSPARENT
+    /* Modem does not accept commands in data mode, except escape sequence */
+    if (lwcell.m.transp.data_mode && CMD_GET_CUR() != LWCELL_CMD_PPP) {
+        return lwcellERR;
+    }
+#endif /* LWCELL_CFG_CONN && LWCELL_CFG_CONN_TRANSPARENT */
+#if LWCELL_CFG_PPP
+    /* In PPP data mode, link can only be terminated with LCP */
+    if (lwcell.m.ppp.data_mode && CMD_GET_CUR() != LWCELL_CMD_PPP_STOP) {
+        return lwcellERR;
+    }
+#endif /* LWCELL_CFG_PPP */
+
+    /* Prepare command, it may reject execution or redirect message to another command */
+    if (desc->prep_fn != NULL) {
+        lwcell_cmd_t cmd = CMD_GET_CUR();
+
+        if ((res = desc->prep_fn(msg)) != lwcellOK) {
+            return res;
+        }
+        if (CMD_GET_CUR() != cmd) {
+            return lwcelli_initiate_cmd(msg);
+        }
+    }
+
+#if LWCELL_CFG_CONN && LWCELL_CFG_CONN_TRANSPARENT
+    /* Escape sequence is sent raw, without AT prefix and line ending */
+    if (CMD_IS_CUR(LWCELL_CMD_PPP)) {
+        AT_PORT_SEND(desc->str, desc->str_len);
+        AT_PORT_SEND_FLUSH();
+        return lwcellOK;
+    }
+#endif /* LWCELL_CFG_CONN && LWCELL_CFG_CONN_TRANSPARENT */
+#if LWCELL_CFG_PPP
+    /* Terminate request has been sent in prepare function, wait for NO CARRIER */
+    if (CMD_IS_CUR(LWCELL_CMD_PPP_STOP)) {
+        return lwcellOK;
+    }
+#endif /* LWCELL_CFG_PPP */
+
+    AT_PORT_SEND_BEGIN_AT();
+    if (desc->str_len > 0) {
+        AT_PORT_SEND(desc->str, desc->str_len);
+    }
+    if (desc->args_fn != NULL) {
+        desc->args_fn(msg);
+    }
+    AT_PORT_SEND_END_AT();
+
+    /* Limit waiting for final response, blocking time of API call still applies */
+    if (desc->timeout > 0
+        && lwcell_timeout_add_ex(desc->timeout, lwcelli_cmd_timeout_fn, NULL, &lwcell.cmd_tmr) != lwcellOK) {
+        LWCELL_DEBUGF(LWCELL_CFG_DBG_THREAD | LWCELL_DBG_TYPE_TRACE | LWCELL_DBG_LVL_WARNING,
+                      "[LWCELL THREAD] Cannot start timeout of command %d\r\n", (int)CMD_GET_CUR());
+    }
+    return lwcellOK; /* Valid command */
+}
+
+#if LWCELL_CFG_MSG_POOL_SIZE > 0
+static lwcell_msg_t msg_pool[LWCELL_CFG_MSG_POOL_SIZE]; /*!< Preallocated command messages */
+static uint8_t msg_pool_used[LWCELL_CFG_MSG_POOL_SIZE]; /*!< Set to `1` when message is in use */
+#endif                                                  /* LWCELL_CFG_MSG_POOL_SIZE > 0 */
+
+/**
+ * \brief           Allocate new command message
+ *
+ * Message is placed on caller stack if provided, taken from static pool if available
+ * or allocated from heap otherwise. Message is set to zero, except semaphore of pool message
+ *
+ * \param[in]       stack_msg: Pointer to message on caller stack. Set to `NULL` if not used
+ * \return          Pointer to message on success, `NULL` otherwise
+ */
+lwcell_msg_t*
+lwcelli_msg_alloc(lwcell_msg_t* stack_msg) {
+    lwcell_msg_t* msg = NULL;
+
+    if (stack_msg != NULL) {
+        LWCELL_MEMSET(stack_msg, 0x00, sizeof(*stack_msg));
+        stack_msg->mem_type = LWCELL_MSG_MEM_STACK;
+        return stack_msg;
+    }
+#if LWCELL_CFG_MSG_POOL_SIZE > 0
+    lwcell_core_lock();
+    for (size_t i = 0; i < LWCELL_ARRAYSIZE(msg_pool); ++i) {
+        if (!msg_pool_used[i]) {
+            msg_pool_used[i] = 1;
+            msg = &msg_pool[i];
             break;
         }
-#endif                             /* LWCELL_CFG_USSD */
-        default: return lwcellERR; /* Invalid command */
     }
-    return lwcellOK;               /* Valid command */
+    lwcell_core_unlock();
+    if (msg != NULL) {
+        lwcell_sys_sem_t sem = msg->sem; /* Keep semaphore for next blocking call */
+
+        LWCELL_MEMSET(msg, 0x00, sizeof(*msg));
+        msg->sem = sem;
+        msg->mem_type = LWCELL_MSG_MEM_POOL;
+        LWCELL_DEBUGF(LWCELL_CFG_DBG_VAR | LWCELL_DBG_TYPE_TRACE, "[LWCELL MSG] Pool message: %p\r\n", (void*)msg);
+        return msg;
+    }
+#endif /* LWCELL_CFG_MSG_POOL_SIZE > 0 */
+    msg = lwcell_mem_malloc_tag(sizeof(*msg), LWCELL_MEM_TAG_MSG);
+    LWCELL_DEBUGW(LWCELL_CFG_DBG_VAR | LWCELL_DBG_TYPE_TRACE, msg != NULL, "[LWCELL MSG] Allocated %d bytes at %p\r\n",
+                  (int)sizeof(*msg), (void*)msg);
+    LWCELL_DEBUGW(LWCELL_CFG_DBG_VAR | LWCELL_DBG_TYPE_TRACE, msg == NULL, "[LWCELL MSG] Error allocating %d bytes\r\n",
+                  (int)sizeof(*msg));
+    if (msg != NULL) {
+        LWCELL_MEMSET(msg, 0x00, sizeof(*msg));
+        msg->mem_type = LWCELL_MSG_MEM_HEAP;
+    }
+    return msg;
+}
+
+/**
+ * \brief           Free command message, allocated with \ref lwcelli_msg_alloc
+ * \param[in]       msg: Message to free
+ */
+void
+lwcelli_msg_free(lwcell_msg_t* msg) {
+    if (msg == NULL) {
+        return;
+    }
+#if LWCELL_CFG_MSG_POOL_SIZE > 0
+    if (msg->mem_type == LWCELL_MSG_MEM_POOL) {
+        LWCELL_DEBUGF(LWCELL_CFG_DBG_VAR | LWCELL_DBG_TYPE_TRACE, "[LWCELL MSG] Return to pool: %p\r\n", (void*)msg);
+        lwcell_core_lock();
+        msg_pool_used[msg - msg_pool] = 0; /* Semaphore stays valid for next use */
+        lwcell_core_unlock();
+        return;
+    }
+#endif /* LWCELL_CFG_MSG_POOL_SIZE > 0 */
+    if (lwcell_sys_sem_isvalid(&msg->sem)) {
+        lwcell_sys_sem_delete(&msg->sem);
+        lwcell_sys_sem_invalid(&msg->sem);
+    }
+    if (msg->mem_type == LWCELL_MSG_MEM_HEAP) {
+        LWCELL_DEBUGF(LWCELL_CFG_DBG_VAR | LWCELL_DBG_TYPE_TRACE, "[LWCELL MSG] Free memory: %p\r\n", (void*)msg);
+        lwcell_mem_free_s((void**)&msg);
+    }
 }
 
 /**
@@ -2287,9 +3564,9 @@ lwcelli_send_msg_to_producer_mbox(lwcell_msg_t* msg, lwcellr_t (*process_fn)(lwc
         return res;
     }
 
-    if (msg->is_blocking) {                         /* In case message is blocking */
-        if (!lwcell_sys_sem_create(&msg->sem, 0)) { /* Create semaphore and lock it immediately */
-            LWCELL_MSG_VAR_FREE(msg);               /* Release memory and return */
+    if (msg->is_blocking && !lwcell_sys_sem_isvalid(&msg->sem)) { /* Pool message may already have semaphore */
+        if (!lwcell_sys_sem_create(&msg->sem, 0)) {                /* Create semaphore and lock it immediately */
+            LWCELL_MSG_VAR_FREE(msg);                              /* Release memory and return */
             return lwcellERRMEM;
         }
     }
@@ -2298,6 +3575,9 @@ lwcelli_send_msg_to_producer_mbox(lwcell_msg_t* msg, lwcellr_t (*process_fn)(lwc
     }
     msg->block_time = max_block_time;                    /* Set blocking status if necessary */
     msg->fn = process_fn;                                /* Save processing function to be called as callback */
+#if LWCELL_CFG_STATS
+    msg->stats_time = lwcell_sys_now(); /* Queue time includes waiting for free space */
+#endif                                  /* LWCELL_CFG_STATS */
     if (msg->is_blocking) {
         lwcell_sys_mbox_put(&lwcell.mbox_producer, msg); /* Write message to producer queue and wait forever */
     } else {
@@ -2363,8 +3643,44 @@ lwcelli_process_events_for_timeout_or_error(lwcell_msg_t* msg, lwcellr_t err) {
             CONN_SEND_DATA_SEND_EVT(msg, err);
             break;
         }
+
+#if LWCELL_CFG_CONN_TRANSPARENT
+        case LWCELL_CMD_CIPCLOSE: {
+            /* Escape sequence was not confirmed, do not stay in data mode forever */
+            if (msg->cmd == LWCELL_CMD_PPP) {
+                lwcelli_transparent_escape_failed();
+            }
+            break;
+        }
+#endif /* LWCELL_CFG_CONN_TRANSPARENT */
+
+#if LWCELL_CFG_CONN_MANUAL_RX
+        case LWCELL_CMD_CIPRXGET: {
+            /* Release read buffer and schedule next read */
+            lwcelli_conn_manual_rx_done(msg, err);
+            break;
+        }
+#endif /* LWCELL_CFG_CONN_MANUAL_RX */
 #endif /* LWCELL_CFG_CONN */
 
+#if LWCELL_CFG_PPP
+        case LWCELL_CMD_PPP_STOP: {
+            /* Device did not confirm end of data mode, continue in command mode anyway */
+            lwcelli_ppp_reset();
+            break;
+        }
+#endif /* LWCELL_CFG_PPP */
+
+#if LWCELL_CFG_CMUX
+        case LWCELL_CMD_CMUX: {
+            /* Keep multiplexer if start was rejected because it is already running */
+            if (!lwcell.cmux.active || CMD_IS_CUR(LWCELL_CMD_CMUX_AT)) {
+                lwcelli_cmux_close(0);
+            }
+            break;
+        }
+#endif /* LWCELL_CFG_CMUX */
+
 #if LWCELL_CFG_SMS
         case LWCELL_CMD_CMGS: {
             /* Send error event */
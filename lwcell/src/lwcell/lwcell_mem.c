@@ -32,11 +32,355 @@
  * Version:         v0.1.1
  */
 #include <limits.h>
+#include <stddef.h>
 #include "lwcell/lwcell_mem.h"
 #include "lwcell/lwcell_private.h"
 
 #if !LWCELL_CFG_MEM_CUSTOM || __DOXYGEN__
 
+static size_t mem_total_bytes; /*!< Total size of all assigned regions */
+
+#if LWCELL_CFG_MEM_TLSF
+
+#if LWCELL_CFG_MEM_ALIGNMENT <= 8
+#define TLSF_ALIGN_LOG2 3
+#elif LWCELL_CFG_MEM_ALIGNMENT == 16
+#define TLSF_ALIGN_LOG2 4
+#else
+#error "LWCELL_CFG_MEM_ALIGNMENT must not exceed 16 when LWCELL_CFG_MEM_TLSF is enabled"
+#endif
+#if LWCELL_CFG_MEM_TLSF_FL_MAX < 7 || LWCELL_CFG_MEM_TLSF_FL_MAX > 31
+#error "LWCELL_CFG_MEM_TLSF_FL_MAX must be between 7 and 31"
+#endif
+
+#if !__DOXYGEN__
+typedef struct tlsf_block {
+    struct tlsf_block* prev_phys; /*!< Previous block in memory, `NULL` for first block in region */
+    size_t size;                  /*!< Size of block including header, free status in lowest bit */
+    struct tlsf_block* next_free; /*!< Next free block in the same list. Valid only when block is free */
+    struct tlsf_block* prev_free; /*!< Previous free block in the same list. Valid only when block is free */
+} tlsf_block_t;
+#endif                            /* !__DOXYGEN__ */
+
+/**
+ * \brief           Block granularity and two-level index layout.
+ *
+ * First level splits sizes by power of `2`, second level linearly splits each range to `TLSF_SL_COUNT` lists.
+ * All blocks below `TLSF_SMALL_SIZE` are kept in first level list `0`
+ */
+#define TLSF_ALIGN_NUM           (LWCELL_SZ(1) << TLSF_ALIGN_LOG2)
+#define TLSF_ALIGN(x)            ((LWCELL_SZ(x) + TLSF_ALIGN_NUM - 1) & ~(TLSF_ALIGN_NUM - 1))
+#define TLSF_SL_LOG2             3
+#define TLSF_SL_COUNT            (1U << TLSF_SL_LOG2)
+#define TLSF_FL_SHIFT            (TLSF_SL_LOG2 + TLSF_ALIGN_LOG2)
+#define TLSF_FL_COUNT            (LWCELL_CFG_MEM_TLSF_FL_MAX - TLSF_FL_SHIFT + 1)
+#define TLSF_SMALL_SIZE          (LWCELL_SZ(1) << TLSF_FL_SHIFT)
+#define TLSF_BLOCK_MAX           (LWCELL_SZ(1) << LWCELL_CFG_MEM_TLSF_FL_MAX)
+
+#define TLSF_FREE_BIT            LWCELL_SZ(0x01)
+#define TLSF_HDR_SIZE            TLSF_ALIGN(offsetof(tlsf_block_t, next_free))
+#define TLSF_BLOCK_MIN           TLSF_ALIGN(sizeof(tlsf_block_t))
+#define TLSF_BLOCK_SIZE(b)       ((b)->size & ~TLSF_FREE_BIT)
+#define TLSF_BLOCK_IS_FREE(b)    (((b)->size & TLSF_FREE_BIT) > 0)
+#define TLSF_BLOCK_NEXT(b)       ((tlsf_block_t*)((uint8_t*)(b) + TLSF_BLOCK_SIZE(b)))
+
+#define MEM_BLOCK_FROM_PTR(ptr)  ((tlsf_block_t*)(((uint8_t*)(ptr)) - TLSF_HDR_SIZE))
+#define MEM_BLOCK_USER_SIZE(ptr) (TLSF_BLOCK_SIZE(MEM_BLOCK_FROM_PTR(ptr)) - TLSF_HDR_SIZE)
+
+static tlsf_block_t* tlsf_heads[TLSF_FL_COUNT][TLSF_SL_COUNT]; /*!< Free list heads */
+static uint32_t tlsf_fl_bitmap;                                /*!< Non-empty first level lists */
+static uint8_t tlsf_sl_bitmap[TLSF_FL_COUNT];                  /*!< Non-empty second level lists */
+static size_t mem_available_bytes;                             /*!< Number of available bytes for allocations */
+static size_t mem_free_blocks;                                 /*!< Number of blocks in free lists */
+
+/**
+ * \brief           Get index of lowest set bit
+ * \param[in]       x: Input value, must not be `0`
+ * \return          Bit index
+ */
+static uint32_t
+tlsf_ffs(uint32_t x) {
+#if defined(__GNUC__)
+    return (uint32_t)__builtin_ctzl((unsigned long)x);
+#else  /* defined(__GNUC__) */
+    uint32_t bit = 0;
+    for (; (x & 0x01) == 0; x >>= 1, ++bit) {}
+    return bit;
+#endif /* !defined(__GNUC__) */
+}
+
+/**
+ * \brief           Get index of highest set bit
+ * \param[in]       x: Input value, must not be `0`
+ * \return          Bit index
+ */
+static uint32_t
+tlsf_fls(size_t x) {
+#if defined(__GNUC__)
+    return (uint32_t)(sizeof(unsigned long) * CHAR_BIT - 1 - __builtin_clzl((unsigned long)x));
+#else  /* defined(__GNUC__) */
+    uint32_t bit = 0;
+    for (; x > 1; x >>= 1, ++bit) {}
+    return bit;
+#endif /* !defined(__GNUC__) */
+}
+
+/**
+ * \brief           Get list indexes for block size
+ * \param[in]       size: Block size, must be less than `TLSF_BLOCK_MAX`
+ * \param[out]      fl: First level index
+ * \param[out]      sl: Second level index
+ */
+static void
+tlsf_mapping(size_t size, uint32_t* fl, uint32_t* sl) {
+    if (size < TLSF_SMALL_SIZE) {
+        *fl = 0;
+        *sl = (uint32_t)(size >> TLSF_ALIGN_LOG2);
+    } else {
+        uint32_t bit = tlsf_fls(size);
+
+        *sl = (uint32_t)(size >> (bit - TLSF_SL_LOG2)) ^ TLSF_SL_COUNT;
+        *fl = bit - (TLSF_FL_SHIFT - 1);
+    }
+}
+
+/**
+ * \brief           Insert block to its free list and mark it as free
+ * \param[in]       b: Block to insert
+ */
+static void
+tlsf_insert(tlsf_block_t* b) {
+    uint32_t fl, sl;
+
+    tlsf_mapping(TLSF_BLOCK_SIZE(b), &fl, &sl);
+    b->prev_free = NULL;
+    b->next_free = tlsf_heads[fl][sl];
+    if (b->next_free != NULL) {
+        b->next_free->prev_free = b;
+    }
+    tlsf_heads[fl][sl] = b;
+    tlsf_fl_bitmap |= LWCELL_U32(1) << fl;
+    tlsf_sl_bitmap[fl] |= LWCELL_U8(1U << sl);
+
+    mem_available_bytes += TLSF_BLOCK_SIZE(b);
+    ++mem_free_blocks;
+    b->size |= TLSF_FREE_BIT;
+}
+
+/**
+ * \brief           Remove block from its free list and mark it as used
+ * \param[in]       b: Block to remove
+ */
+static void
+tlsf_remove(tlsf_block_t* b) {
+    uint32_t fl, sl;
+
+    b->size &= ~TLSF_FREE_BIT;
+    tlsf_mapping(TLSF_BLOCK_SIZE(b), &fl, &sl);
+    if (b->prev_free != NULL) {
+        b->prev_free->next_free = b->next_free;
+    } else {
+        tlsf_heads[fl][sl] = b->next_free;
+    }
+    if (b->next_free != NULL) {
+        b->next_free->prev_free = b->prev_free;
+    }
+    if (tlsf_heads[fl][sl] == NULL) {
+        tlsf_sl_bitmap[fl] &= LWCELL_U8(~(1U << sl));
+        if (tlsf_sl_bitmap[fl] == 0) {
+            tlsf_fl_bitmap &= ~(LWCELL_U32(1) << fl);
+        }
+    }
+
+    mem_available_bytes -= TLSF_BLOCK_SIZE(b);
+    --mem_free_blocks;
+}
+
+/**
+ * \brief           Assign memory for HEAP allocations
+ * \param[in]       regions: Pointer to list of regions.
+ *                  Set regions in ascending order by address
+ * \param[in]       len: Number of regions to assign
+ */
+static uint8_t
+mem_assignmem(const lwcell_mem_region_t* regions, size_t len) {
+    uint8_t* mem_start_addr;
+    size_t mem_size;
+    tlsf_block_t *first_block, *sentinel;
+
+    if (mem_total_bytes > 0) { /* Regions already defined */
+        return 0;
+    }
+
+    /* Check if region address are linear and rising */
+    mem_start_addr = (uint8_t*)0;
+    for (size_t i = 0; i < len; ++i) {
+        if (mem_start_addr >= (uint8_t*)regions[i].start_addr) { /* Check if previous greater than current */
+            return 0;                                            /* Return as invalid and failed */
+        }
+        mem_start_addr = (uint8_t*)regions[i].start_addr;        /* Save as previous address */
+    }
+
+    for (; len > 0; --len, ++regions) {
+        /* Align start address and size of region */
+        mem_start_addr = (uint8_t*)TLSF_ALIGN(regions->start_addr);
+        if (regions->size <= LWCELL_SZ(mem_start_addr - (uint8_t*)regions->start_addr)) {
+            continue;
+        }
+        mem_size = (regions->size - (mem_start_addr - (uint8_t*)regions->start_addr)) & ~(TLSF_ALIGN_NUM - 1);
+
+        /* Region holds one free block and used sentinel block with header only */
+        if (mem_size < (TLSF_BLOCK_MIN + TLSF_HDR_SIZE)) {
+            continue;
+        }
+        mem_size -= TLSF_HDR_SIZE;
+        if (mem_size >= TLSF_BLOCK_MAX) {
+            mem_size = TLSF_BLOCK_MAX - TLSF_ALIGN_NUM;
+        }
+
+        first_block = (tlsf_block_t*)mem_start_addr;
+        first_block->prev_phys = NULL;
+        first_block->size = mem_size;
+
+        sentinel = TLSF_BLOCK_NEXT(first_block); /* Sentinel is never free, it stops merging at region end */
+        sentinel->prev_phys = first_block;
+        sentinel->size = 0;
+
+        tlsf_insert(first_block);
+        mem_total_bytes += mem_size;
+    }
+
+    return 1; /* Regions set as expected */
+}
+
+/**
+ * \brief           Allocate memory of specific size
+ * \param[in]       size: Number of bytes to allocate
+ * \return          Memory address on success, `NULL` otherwise
+ */
+static void*
+mem_alloc(size_t size) {
+    tlsf_block_t *block, *next, *rem;
+    uint32_t fl, sl, sl_map, fl_map;
+    size_t search_size;
+
+    if (mem_total_bytes == 0 || size == 0 || size >= TLSF_BLOCK_MAX) {
+        return NULL;
+    }
+
+    size = TLSF_ALIGN(size) + TLSF_HDR_SIZE; /* Increase size for metadata */
+    if (size < TLSF_BLOCK_MIN) {
+        size = TLSF_BLOCK_MIN;
+    }
+    if (size > mem_available_bytes) { /* Check if we have enough memory available */
+        return NULL;
+    }
+
+    /*
+     * Round size up to next list boundary,
+     * every block in found list is then guaranteed to be big enough
+     */
+    search_size = size;
+    if (search_size >= TLSF_SMALL_SIZE) {
+        search_size += (LWCELL_SZ(1) << (tlsf_fls(search_size) - TLSF_SL_LOG2)) - 1;
+    }
+    if (search_size >= TLSF_BLOCK_MAX) {
+        return NULL;
+    }
+    tlsf_mapping(search_size, &fl, &sl);
+
+    /* Find first non-empty list, starting in the same first level range */
+    sl_map = tlsf_sl_bitmap[fl] & (~0U << sl);
+    if (sl_map == 0) {
+        fl_map = (fl + 1) < 32 ? (tlsf_fl_bitmap & (~LWCELL_U32(0) << (fl + 1))) : 0;
+        if (fl_map == 0) {
+            return NULL; /* Allocation failed, no free blocks of required size */
+        }
+        fl = tlsf_ffs(fl_map);
+        sl_map = tlsf_sl_bitmap[fl];
+    }
+    sl = tlsf_ffs(sl_map);
+    block = tlsf_heads[fl][sl];
+    tlsf_remove(block);
+
+    /* Split block and return remaining part to free lists */
+    if ((TLSF_BLOCK_SIZE(block) - size) >= TLSF_BLOCK_MIN) {
+        rem = (tlsf_block_t*)((uint8_t*)block + size);
+        rem->prev_phys = block;
+        rem->size = TLSF_BLOCK_SIZE(block) - size;
+        next = TLSF_BLOCK_NEXT(rem);
+        next->prev_phys = rem;
+        block->size = size;
+        tlsf_insert(rem);
+    }
+    return (uint8_t*)block + TLSF_HDR_SIZE;
+}
+
+/**
+ * \brief           Check if memory block is currently allocated
+ * \param[in]       ptr: Pointer to memory returned by allocator
+ * \return          `1` if allocated, `0` if already free
+ */
+static uint8_t
+mem_is_allocated(void* ptr) {
+    return !TLSF_BLOCK_IS_FREE(MEM_BLOCK_FROM_PTR(ptr));
+}
+
+/**
+ * \brief           Free memory
+ * \param[in]       ptr: Pointer to memory previously returned using \ref lwcell_mem_malloc,
+ *                      \ref lwcell_mem_calloc or \ref lwcell_mem_realloc functions
+ */
+static void
+mem_free(void* ptr) {
+    tlsf_block_t *block, *next;
+
+    if (ptr == NULL) { /* To be in compliance with C free function */
+        return;
+    }
+
+    if (!mem_is_allocated(ptr)) { /* Block is already free */
+        return;
+    }
+    block = MEM_BLOCK_FROM_PTR(ptr);
+
+    /* Merge with previous and next physical block, if they are free */
+    if (block->prev_phys != NULL && TLSF_BLOCK_IS_FREE(block->prev_phys)) {
+        tlsf_remove(block->prev_phys);
+        block->prev_phys->size += block->size;
+        block = block->prev_phys;
+    }
+    next = TLSF_BLOCK_NEXT(block);
+    if (TLSF_BLOCK_IS_FREE(next)) {
+        tlsf_remove(next);
+        block->size += next->size;
+    }
+    TLSF_BLOCK_NEXT(block)->prev_phys = block;
+    tlsf_insert(block);
+}
+
+/**
+ * \brief           Get free block statistics
+ * \param[out]      largest: Size of largest free block
+ * \param[out]      count: Number of free blocks
+ */
+static void
+mem_get_free_blocks(size_t* largest, size_t* count) {
+    *largest = 0;
+    *count = mem_free_blocks;
+    if (tlsf_fl_bitmap != 0) {
+        uint32_t fl = tlsf_fls(tlsf_fl_bitmap);
+        uint32_t sl = tlsf_fls(tlsf_sl_bitmap[fl]);
+
+        /* Largest block is in the highest non-empty list */
+        for (tlsf_block_t* b = tlsf_heads[fl][sl]; b != NULL; b = b->next_free) {
+            *largest = LWCELL_MAX(*largest, TLSF_BLOCK_SIZE(b));
+        }
+    }
+}
+
+#else /* LWCELL_CFG_MEM_TLSF */
+
 #if !__DOXYGEN__
 typedef struct mem_block {
     struct mem_block* next; /*!< Pointer to next free block */
@@ -202,6 +546,7 @@ mem_assignmem(const lwcell_mem_region_t* regions, size_t len) {
 
         /* Set number of free bytes available to allocate in region */
         mem_available_bytes += first_block->size;
+        mem_total_bytes += first_block->size;
     }
 
     return 1; /* Regions set as expected */
@@ -270,16 +615,28 @@ mem_alloc(size_t size) {
              */
             mem_insertfreeblock(next); /* Insert free memory block to list of free memory blocks (linked list chain) */
         }
-        curr->size |= MEM_ALLOC_BIT;   /* Set allocated bit = memory is allocated */
-        curr->next = NULL;             /* Clear next free block pointer as there is no one */
-
-        mem_available_bytes -= size;   /* Decrease available memory */
+        mem_available_bytes -= curr->size; /* Decrease available memory, block may be bigger than requested */
+        curr->size |= MEM_ALLOC_BIT;       /* Set allocated bit = memory is allocated */
+        curr->next = NULL;                 /* Clear next free block pointer as there is no one */
     } else {
         /* Allocation failed, no free blocks of required size */
     }
     return retval;
 }
 
+/**
+ * \brief           Check if memory block is currently allocated
+ * \param[in]       ptr: Pointer to memory returned by allocator
+ * \return          `1` if allocated, `0` if already free
+ */
+static uint8_t
+mem_is_allocated(void* ptr) {
+    mem_block_t* block = MEM_BLOCK_FROM_PTR(ptr);
+
+    /* Allocated block has upper bit set on size and no next free block */
+    return (block->size & MEM_ALLOC_BIT) && block->next == NULL;
+}
+
 /**
  * \brief           Free memory
  * \param[in]       ptr: Pointer to memory previously returned using \ref lwcell_mem_malloc,
@@ -294,12 +651,7 @@ mem_free(void* ptr) {
     }
 
     block = MEM_BLOCK_FROM_PTR(ptr); /* Get block data pointer from input pointer */
-
-    /*
-     * Check if block is even allocated by upper bit on size
-     * and next free block must be set to NULL in order to work properly
-     */
-    if ((block->size & MEM_ALLOC_BIT) && block->next == NULL) {
+    if (mem_is_allocated(ptr)) {
         /*
          * Clear allocated bit before entering back to free list
          * List will automatically take care for fragmentation
@@ -311,22 +663,170 @@ mem_free(void* ptr) {
 }
 
 /**
- * \brief           Allocate memory of specific size
- * \param[in]       num: Number of elements to allocate
- * \param[in]       size: Size of element in units of bytes
+ * \brief           Get free block statistics
+ * \param[out]      largest: Size of largest free block
+ * \param[out]      count: Number of free blocks
+ */
+static void
+mem_get_free_blocks(size_t* largest, size_t* count) {
+    *largest = 0;
+    *count = 0;
+    for (mem_block_t* b = start_block.next; b != NULL; b = b->next) {
+        if (b->size > 0) { /* End blocks of regions have zero size */
+            *largest = LWCELL_MAX(*largest, b->size);
+            ++*count;
+        }
+    }
+}
+
+#endif /* !LWCELL_CFG_MEM_TLSF */
+
+#if LWCELL_CFG_MEM_LEAK_TRACK && !LWCELL_CFG_MEM_TAGS
+#error "LWCELL_CFG_MEM_LEAK_TRACK requires LWCELL_CFG_MEM_TAGS to be enabled"
+#endif
+
+#if LWCELL_CFG_MEM_TAGS
+
+#if !__DOXYGEN__
+typedef struct mem_tag_hdr {
+#if LWCELL_CFG_MEM_LEAK_TRACK
+    struct mem_tag_hdr* next; /*!< Next live allocation */
+    struct mem_tag_hdr* prev; /*!< Previous live allocation */
+    uint32_t seq;             /*!< Allocation sequence number */
+#endif                        /* LWCELL_CFG_MEM_LEAK_TRACK */
+    size_t size;              /*!< Requested size in units of bytes */
+    uint8_t tag;              /*!< Subsystem tag, member of \ref lwcell_mem_tag_t */
+} mem_tag_hdr_t;
+#endif                        /* !__DOXYGEN__ */
+
+#define MEM_TAG_HDR_SIZE          LWCELL_MEM_ALIGN(sizeof(mem_tag_hdr_t))
+#define MEM_TAG_HDR_FROM_PTR(ptr) ((mem_tag_hdr_t*)(((uint8_t*)(ptr)) - MEM_TAG_HDR_SIZE))
+#define MEM_USER_SIZE(ptr)        (MEM_TAG_HDR_FROM_PTR(ptr)->size)
+
+static lwcell_mem_tag_stats_t mem_tag_stats[LWCELL_MEM_TAG_END]; /*!< Statistics for each subsystem */
+#if LWCELL_CFG_MEM_LEAK_TRACK
+static mem_tag_hdr_t* mem_live; /*!< List of live allocations, newest first */
+static uint32_t mem_seq;        /*!< Sequence number of last allocation */
+#endif                          /* LWCELL_CFG_MEM_LEAK_TRACK */
+
+#else /* LWCELL_CFG_MEM_TAGS */
+
+#define MEM_TAG_HDR_SIZE   0
+#define MEM_USER_SIZE(ptr) MEM_BLOCK_USER_SIZE(ptr)
+
+#endif /* !LWCELL_CFG_MEM_TAGS */
+
+static size_t mem_available_bytes_min; /*!< Minimal number of available bytes */
+static size_t mem_alloc_cnt;           /*!< Number of successful allocations */
+static size_t mem_alloc_failed_cnt;    /*!< Number of failed allocations */
+static size_t mem_free_cnt;            /*!< Number of freed allocations */
+
+/**
+ * \brief           Allocate memory of specific size and update statistics
+ * \note            Core must be locked
+ * \param[in]       size: Number of bytes to allocate
+ * \param[in]       tag: Subsystem tag of allocation
+ * \param[in]       clear: Set to `1` to set memory to zero
  * \return          Memory address on success, `NULL` otherwise
  */
 static void*
-mem_calloc(size_t num, size_t size) {
-    void* ptr;
-    size_t tot_len = num * size;
+mem_alloc_tracked(size_t size, uint8_t tag, uint8_t clear) {
+    uint8_t* ptr = NULL;
+#if LWCELL_CFG_MEM_TAGS
+    mem_tag_hdr_t* hdr;
+    lwcell_mem_tag_stats_t* ts;
+    size_t bucket;
+#endif /* LWCELL_CFG_MEM_TAGS */
 
-    if ((ptr = mem_alloc(tot_len)) != NULL) { /* Try to allocate memory */
-        LWCELL_MEMSET(ptr, 0x00, tot_len);    /* Reset entire memory */
+    if (size + MEM_TAG_HDR_SIZE >= size) { /* Check overflow with header */
+        ptr = mem_alloc(size + MEM_TAG_HDR_SIZE);
+    }
+    if (ptr == NULL) {
+        ++mem_alloc_failed_cnt;
+        return NULL;
+    }
+    ++mem_alloc_cnt;
+    if (mem_available_bytes < mem_available_bytes_min) {
+        mem_available_bytes_min = mem_available_bytes;
+    }
+
+#if LWCELL_CFG_MEM_TAGS
+    hdr = (mem_tag_hdr_t*)ptr;
+    hdr->size = size;
+    hdr->tag = tag;
+
+    ts = &mem_tag_stats[tag];
+    ++ts->alloc_count;
+    ts->bytes_used += size;
+    if (ts->bytes_used > ts->bytes_used_max) {
+        ts->bytes_used_max = ts->bytes_used;
+    }
+    for (bucket = 0; bucket < (LWCELL_MEM_SIZE_HIST_LEN - 1) && size > (LWCELL_SZ(16) << bucket); ++bucket) {}
+    ++ts->size_hist[bucket];
+
+#if LWCELL_CFG_MEM_LEAK_TRACK
+    hdr->seq = ++mem_seq;
+    hdr->prev = NULL;
+    hdr->next = mem_live;
+    if (mem_live != NULL) {
+        mem_live->prev = hdr;
+    }
+    mem_live = hdr;
+#endif /* LWCELL_CFG_MEM_LEAK_TRACK */
+    ptr += MEM_TAG_HDR_SIZE;
+#else  /* LWCELL_CFG_MEM_TAGS */
+    LWCELL_UNUSED(tag);
+#endif /* !LWCELL_CFG_MEM_TAGS */
+
+    if (clear) {
+        LWCELL_MEMSET(ptr, 0x00, size); /* Reset entire memory */
     }
     return ptr;
 }
 
+/**
+ * \brief           Free memory and update statistics
+ * \note            Core must be locked
+ * \param[in]       ptr: Pointer to memory previously returned by \ref mem_alloc_tracked
+ */
+static void
+mem_free_tracked(void* ptr) {
+#if LWCELL_CFG_MEM_TAGS
+    mem_tag_hdr_t* hdr = MEM_TAG_HDR_FROM_PTR(ptr);
+    lwcell_mem_tag_stats_t* ts;
+#endif /* LWCELL_CFG_MEM_TAGS */
+    void* block = ptr;
+
+#if LWCELL_CFG_MEM_TAGS
+    block = hdr; /* Allocator returned pointer to header */
+#endif           /* LWCELL_CFG_MEM_TAGS */
+
+    /* Validate block first, double free must not touch statistics and leak list */
+    if (!mem_is_allocated(block)) {
+        LWCELL_DEBUGF(LWCELL_CFG_DBG_MEM | LWCELL_DBG_LVL_SEVERE | LWCELL_DBG_TYPE_TRACE,
+                      "[LWCELL MEM] Free of already free memory: %p\r\n", ptr);
+        return;
+    }
+
+#if LWCELL_CFG_MEM_TAGS
+    ts = &mem_tag_stats[hdr->tag];
+    ++ts->free_count;
+    ts->bytes_used -= hdr->size;
+#if LWCELL_CFG_MEM_LEAK_TRACK
+    if (hdr->prev != NULL) {
+        hdr->prev->next = hdr->next;
+    } else {
+        mem_live = hdr->next;
+    }
+    if (hdr->next != NULL) {
+        hdr->next->prev = hdr->prev;
+    }
+#endif /* LWCELL_CFG_MEM_LEAK_TRACK */
+#endif /* LWCELL_CFG_MEM_TAGS */
+    ++mem_free_cnt;
+    mem_free(block);
+}
+
 /**
  * \brief           Reallocate memory to specific size
  * \note            After new memory is allocated, content of old one is copied to new memory
@@ -339,31 +839,35 @@ static void*
 mem_realloc(void* ptr, size_t size) {
     void* new_ptr;
     size_t old_size;
+    uint8_t tag = LWCELL_MEM_TAG_OTHER;
 
-    if (ptr == NULL) {          /* If pointer is not valid */
-        return mem_alloc(size); /* Only allocate memory */
+    if (ptr == NULL) {                          /* If pointer is not valid */
+        return mem_alloc_tracked(size, tag, 0); /* Only allocate memory */
     }
 
-    old_size = MEM_BLOCK_USER_SIZE(ptr);                         /* Get size of old pointer */
-    new_ptr = mem_alloc(size);                                   /* Try to allocate new memory block */
+    old_size = MEM_USER_SIZE(ptr);                               /* Get size of old pointer */
+#if LWCELL_CFG_MEM_TAGS
+    tag = MEM_TAG_HDR_FROM_PTR(ptr)->tag;                        /* New memory belongs to the same subsystem */
+#endif                                                           /* LWCELL_CFG_MEM_TAGS */
+    new_ptr = mem_alloc_tracked(size, tag, 0);                   /* Try to allocate new memory block */
     if (new_ptr != NULL) {
         LWCELL_MEMCPY(new_ptr, ptr, LWCELL_MIN(size, old_size)); /* Copy old data to new array */
-        mem_free(ptr);                                           /* Free old pointer */
+        mem_free_tracked(ptr);                                   /* Free old pointer */
     }
     return new_ptr;
 }
 
 /**
- * \brief           Allocate memory of specific size
+ * \brief           Allocate memory of specific size and set memory to zero
  * \param[in]       size: Number of bytes to allocate
+ * \param[in]       tag: Subsystem tag of allocation
  * \return          Memory address on success, `NULL` otherwise
- * \note            Function is not available when \ref LWCELL_CFG_MEM_CUSTOM is `1` and must be implemented by user
  */
-void*
-lwcell_mem_malloc(size_t size) {
+static void*
+mem_malloc(size_t size, uint8_t tag) {
     void* ptr;
     lwcell_core_lock();
-    ptr = mem_calloc(1, size); /* Allocate memory and return pointer */
+    ptr = mem_alloc_tracked(size, tag, 1); /* Allocate memory and return pointer */
     lwcell_core_unlock();
     LWCELL_DEBUGW(LWCELL_CFG_DBG_MEM | LWCELL_DBG_TYPE_TRACE, ptr == NULL,
                   "[LWCELL MEM] Allocation failed: %d bytes\r\n", (int)size);
@@ -372,6 +876,55 @@ lwcell_mem_malloc(size_t size) {
     return ptr;
 }
 
+/**
+ * \brief           Allocate memory for array and set memory to zero
+ * \param[in]       num: Number of elements to allocate
+ * \param[in]       size: Size of each element
+ * \param[in]       tag: Subsystem tag of allocation
+ * \return          Memory address on success, `NULL` otherwise
+ */
+static void*
+mem_calloc(size_t num, size_t size, uint8_t tag) {
+    void* ptr;
+    lwcell_core_lock();
+    ptr = mem_alloc_tracked(num * size, tag, 1); /* Allocate memory and clear it to 0. Then return pointer */
+    lwcell_core_unlock();
+    LWCELL_DEBUGW(LWCELL_CFG_DBG_MEM | LWCELL_DBG_TYPE_TRACE, ptr == NULL,
+                  "[LWCELL MEM] Callocation failed: %d bytes\r\n", (int)size * (int)num);
+    LWCELL_DEBUGW(LWCELL_CFG_DBG_MEM | LWCELL_DBG_TYPE_TRACE, ptr != NULL,
+                  "[LWCELL MEM] Callocation OK: %d bytes, addr: %p\r\n", (int)size * (int)num, ptr);
+    return ptr;
+}
+
+/**
+ * \brief           Allocate memory of specific size
+ * \param[in]       size: Number of bytes to allocate
+ * \return          Memory address on success, `NULL` otherwise
+ * \note            Function is not available when \ref LWCELL_CFG_MEM_CUSTOM is `1` and must be implemented by user
+ */
+void*
+lwcell_mem_malloc(size_t size) {
+    return mem_malloc(size, LWCELL_MEM_TAG_OTHER);
+}
+
+#if LWCELL_CFG_MEM_TAGS || __DOXYGEN__
+
+/**
+ * \brief           Allocate memory of specific size for subsystem
+ *
+ * When \ref LWCELL_CFG_MEM_TAGS is disabled, macro calls \ref lwcell_mem_malloc instead
+ *
+ * \param[in]       size: Number of bytes to allocate
+ * \param[in]       tag: Subsystem tag of allocation
+ * \return          Memory address on success, `NULL` otherwise
+ */
+void*
+lwcell_mem_malloc_tag(size_t size, lwcell_mem_tag_t tag) {
+    return mem_malloc(size, tag < LWCELL_MEM_TAG_END ? (uint8_t)tag : (uint8_t)LWCELL_MEM_TAG_OTHER);
+}
+
+#endif /* LWCELL_CFG_MEM_TAGS || __DOXYGEN__ */
+
 /**
  * \brief           Reallocate memory to specific size
  * \note            After new memory is allocated, content of old one is copied to new memory
@@ -402,17 +955,28 @@ lwcell_mem_realloc(void* ptr, size_t size) {
  */
 void*
 lwcell_mem_calloc(size_t num, size_t size) {
-    void* ptr;
-    lwcell_core_lock();
-    ptr = mem_calloc(num, size); /* Allocate memory and clear it to 0. Then return pointer */
-    lwcell_core_unlock();
-    LWCELL_DEBUGW(LWCELL_CFG_DBG_MEM | LWCELL_DBG_TYPE_TRACE, ptr == NULL,
-                  "[LWCELL MEM] Callocation failed: %d bytes\r\n", (int)size * (int)num);
-    LWCELL_DEBUGW(LWCELL_CFG_DBG_MEM | LWCELL_DBG_TYPE_TRACE, ptr != NULL,
-                  "[LWCELL MEM] Callocation OK: %d bytes, addr: %p\r\n", (int)size * (int)num, ptr);
-    return ptr;
+    return mem_calloc(num, size, LWCELL_MEM_TAG_OTHER);
 }
 
+#if LWCELL_CFG_MEM_TAGS || __DOXYGEN__
+
+/**
+ * \brief           Allocate memory of specific size for subsystem and set memory to zero
+ *
+ * When \ref LWCELL_CFG_MEM_TAGS is disabled, macro calls \ref lwcell_mem_calloc instead
+ *
+ * \param[in]       num: Number of elements to allocate
+ * \param[in]       size: Size of each element
+ * \param[in]       tag: Subsystem tag of allocation
+ * \return          Memory address on success, `NULL` otherwise
+ */
+void*
+lwcell_mem_calloc_tag(size_t num, size_t size, lwcell_mem_tag_t tag) {
+    return mem_calloc(num, size, tag < LWCELL_MEM_TAG_END ? (uint8_t)tag : (uint8_t)LWCELL_MEM_TAG_OTHER);
+}
+
+#endif /* LWCELL_CFG_MEM_TAGS || __DOXYGEN__ */
+
 /**
  * \brief           Free memory
  * \param[in]       ptr: Pointer to memory previously returned using \ref lwcell_mem_malloc,
@@ -425,9 +989,9 @@ lwcell_mem_free(void* ptr) {
         return;
     }
     LWCELL_DEBUGF(LWCELL_CFG_DBG_MEM | LWCELL_DBG_TYPE_TRACE, "[LWCELL MEM] Free size: %d, address: %p\r\n",
-                  (int)MEM_BLOCK_USER_SIZE(ptr), ptr);
+                  (int)MEM_USER_SIZE(ptr), ptr);
     lwcell_core_lock();
-    mem_free(ptr);
+    mem_free_tracked(ptr);
     lwcell_core_unlock();
 }
 
@@ -443,9 +1007,104 @@ uint8_t
 lwcell_mem_assignmemory(const lwcell_mem_region_t* regions, size_t len) {
     uint8_t ret;
     ret = mem_assignmem(regions, len); /* Assign memory */
+    if (ret) {
+        mem_available_bytes_min = mem_available_bytes;
+    }
     return ret;
 }
 
+/**
+ * \brief           Get memory manager statistics
+ * \param[out]      stats: Pointer to structure to fill with statistics
+ * \return          \ref lwcellOK on success, member of \ref lwcellr_t enumeration otherwise
+ * \note            Function is not available when \ref LWCELL_CFG_MEM_CUSTOM is `1`
+ */
+lwcellr_t
+lwcell_mem_get_stats(lwcell_mem_stats_t* stats) {
+    LWCELL_ASSERT(stats != NULL);
+
+    LWCELL_MEMSET(stats, 0x00, sizeof(*stats));
+    lwcell_core_lock();
+    stats->mem_size_bytes = mem_total_bytes;
+    stats->mem_available_bytes = mem_available_bytes;
+    stats->mem_available_bytes_min = mem_available_bytes_min;
+    stats->alloc_count = mem_alloc_cnt;
+    stats->alloc_failed_count = mem_alloc_failed_cnt;
+    stats->free_count = mem_free_cnt;
+    mem_get_free_blocks(&stats->largest_free_block, &stats->free_blocks);
+    lwcell_core_unlock();
+    if (stats->mem_available_bytes > 0) {
+        stats->fragmentation = LWCELL_U8(100 - (stats->largest_free_block * 100) / stats->mem_available_bytes);
+    }
+    return lwcellOK;
+}
+
+#if LWCELL_CFG_MEM_TAGS || __DOXYGEN__
+
+/**
+ * \brief           Get allocation statistics of single subsystem
+ * \param[in]       tag: Subsystem tag
+ * \param[out]      stats: Pointer to structure to fill with statistics
+ * \return          \ref lwcellOK on success, member of \ref lwcellr_t enumeration otherwise
+ * \note            Function is available only when \ref LWCELL_CFG_MEM_TAGS is enabled
+ */
+lwcellr_t
+lwcell_mem_get_tag_stats(lwcell_mem_tag_t tag, lwcell_mem_tag_stats_t* stats) {
+    LWCELL_ASSERT(tag < LWCELL_MEM_TAG_END);
+    LWCELL_ASSERT(stats != NULL);
+
+    lwcell_core_lock();
+    *stats = mem_tag_stats[tag];
+    lwcell_core_unlock();
+    return lwcellOK;
+}
+
+#endif /* LWCELL_CFG_MEM_TAGS || __DOXYGEN__ */
+
+#if LWCELL_CFG_MEM_LEAK_TRACK || __DOXYGEN__
+
+/**
+ * \brief           Get sequence number for next allocation
+ *
+ * Use returned value with \ref lwcell_mem_leak_check to report only allocations made after this call
+ *
+ * \return          Sequence number mark
+ */
+uint32_t
+lwcell_mem_leak_mark(void) {
+    uint32_t mark;
+
+    lwcell_core_lock();
+    mark = mem_seq + 1;
+    lwcell_core_unlock();
+    return mark;
+}
+
+/**
+ * \brief           Report live allocations made since mark
+ * \note            Callback is called with core locked and must not allocate or free memory
+ * \param[in]       mark: Sequence mark returned by \ref lwcell_mem_leak_mark. Use `0` to report all allocations
+ * \param[in]       fn: Callback function called for each live allocation. Set to `NULL` to only count them
+ * \param[in]       arg: Custom user argument passed to callback function
+ * \return          Number of live allocations made since mark
+ */
+size_t
+lwcell_mem_leak_check(uint32_t mark, lwcell_mem_leak_fn fn, void* arg) {
+    size_t cnt = 0;
+
+    lwcell_core_lock();
+    for (mem_tag_hdr_t* hdr = mem_live; hdr != NULL && hdr->seq >= mark; hdr = hdr->next) {
+        if (fn != NULL) {
+            fn((uint8_t*)hdr + MEM_TAG_HDR_SIZE, hdr->size, (lwcell_mem_tag_t)hdr->tag, hdr->seq, arg);
+        }
+        ++cnt;
+    }
+    lwcell_core_unlock();
+    return cnt;
+}
+
+#endif /* LWCELL_CFG_MEM_LEAK_TRACK || __DOXYGEN__ */
+
 #endif /* !LWCELL_CFG_MEM_CUSTOM || __DOXYGEN__ */
 
 /**
@@ -982,4 +982,87 @@ lwcelli_parse_ipd(const char* str) {
     return 1;
 }
 
+#if LWCELL_CFG_CONN_QSEND || __DOXYGEN__
+
+/**
+ * \brief           Parse +CIPACK statement with connection transmit state
+ * \param[in]       str: Input string
+ * \param[in]       conn: Connection handle the query was sent for
+ * \return          `1` on success, `0` otherwise
+ */
+uint8_t
+lwcelli_parse_cipack(const char* str, lwcell_conn_p conn) {
+    if (*str == '+') {
+        str += 9; /* Advance for +CIPACK: */
+    }
+
+    lwcelli_parse_number(&str);                             /* Total number of sent bytes */
+    lwcelli_parse_number(&str);                             /* Number of acknowledged bytes */
+    conn->tx_unacked = (size_t)lwcelli_parse_number(&str); /* Number of not yet acknowledged bytes */
+    return 1;
+}
+
+#endif /* LWCELL_CFG_CONN_QSEND || __DOXYGEN__ */
+
+#if LWCELL_CFG_CONN_MANUAL_RX || __DOXYGEN__
+
+/**
+ * \brief           Parse +CIPRXGET statement in manual receive mode
+ *
+ * Mode `1` notifies new data, mode `2` starts data read of previously allocated buffer
+ * and mode `4` reports number of bytes waiting in device
+ *
+ * \param[in]       str: Input string
+ * \return          `1` on success, `0` otherwise
+ */
+uint8_t
+lwcelli_parse_ciprxget(const char* str) {
+    uint8_t mode, num;
+    size_t len;
+    lwcell_conn_p c;
+
+    if (*str == '+') {
+        str += 11; /* Advance for +CIPRXGET: */
+    }
+
+    mode = lwcelli_parse_number(&str);
+    num = lwcelli_parse_number(&str);
+    if (num >= LWCELL_CFG_MAX_CONNS) { /* Invalid connection number */
+        return 0;
+    }
+    c = &lwcell.m.conns[num];
+
+    if (mode == 1) {
+        /* New data arrived to device, length must be queried first */
+        c->status.f.rx_avail_unknown = 1;
+        lwcelli_conn_manual_rx_read(c);
+    } else if (mode == 2 && CMD_IS_CUR(LWCELL_CMD_CIPRXGET) && lwcell.msg->msg.conn_recv.conn == c) {
+        lwcell_pbuf_p pbuf = lwcell.msg->msg.conn_recv.pbuf;
+
+        len = lwcelli_parse_number(&str);                 /* Number of bytes that follow */
+        c->rx_avail = (size_t)lwcelli_parse_number(&str); /* Number of bytes still waiting in device */
+        c->status.f.rx_avail_unknown = 0;
+        if (len == 0) {
+            return 1;
+        }
+
+        /* Read data directly to buffer allocated when command started, if it fits */
+        if (pbuf != NULL && len <= pbuf->len) {
+            lwcell.msg->msg.conn_recv.pbuf = NULL;
+            pbuf->len = pbuf->tot_len = len;
+            lwcell.m.ipd.buff = pbuf;
+        }
+        lwcell.m.ipd.read = 1;
+        lwcell.m.ipd.tot_len = len;
+        lwcell.m.ipd.rem_len = len;
+        lwcell.m.ipd.conn = c;
+    } else if (mode == 4 && CMD_IS_CUR(LWCELL_CMD_CIPRXGET_LEN) && lwcell.msg->msg.conn_recv.conn == c) {
+        c->rx_avail = (size_t)lwcelli_parse_number(&str); /* Number of bytes waiting in device */
+        c->status.f.rx_avail_unknown = 0;
+    }
+    return 1;
+}
+
+#endif /* LWCELL_CFG_CONN_MANUAL_RX || __DOXYGEN__ */
+
 #endif /* LWCELL_CFG_CONN */
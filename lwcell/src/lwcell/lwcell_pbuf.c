@@ -43,6 +43,118 @@
         }                                                                                                              \
     } while (0)
 
+#if LWCELL_CFG_PBUF_POOL
+
+/**
+ * \brief           Packet buffer pool size class
+ */
+typedef struct {
+    lwcell_pbuf_p first_free;     /*!< List of free buffers, linked with `next` member */
+    uint8_t* start;               /*!< Start address of class memory */
+    uint8_t* end;                 /*!< End address of class memory */
+    lwcell_pbuf_pool_stat_t stat; /*!< Class statistics */
+} pbuf_pool_class_t;
+
+/* Memory for all classes, buffer payload length is aligned */
+#define LWCELL_PBUF_POOL_CLASS(size, cnt) +(cnt) * (SIZEOF_PBUF_STRUCT + LWCELL_MEM_ALIGN(size))
+static size_t pool_mem[((0 LWCELL_CFG_PBUF_POOL_CLASSES) + sizeof(size_t) - 1) / sizeof(size_t)];
+#undef LWCELL_PBUF_POOL_CLASS
+
+#define LWCELL_PBUF_POOL_CLASS(size, cnt) {NULL, NULL, NULL, {(size), (cnt), 0, 0, 0}},
+static pbuf_pool_class_t pool_classes[] = {LWCELL_CFG_PBUF_POOL_CLASSES};
+#undef LWCELL_PBUF_POOL_CLASS
+
+static uint8_t pool_init; /*!< Set to `1` when free lists are ready */
+
+/**
+ * \brief           Split pool memory to classes and build free lists
+ * \note            Core must be locked
+ */
+static void
+pbuf_pool_init(void) {
+    uint8_t* mem = (uint8_t*)pool_mem;
+
+    for (size_t i = 0; i < LWCELL_ARRAYSIZE(pool_classes); ++i) {
+        pbuf_pool_class_t* c = &pool_classes[i];
+        size_t entry_size = SIZEOF_PBUF_STRUCT + LWCELL_MEM_ALIGN(c->stat.size);
+
+        c->start = mem;
+        for (size_t k = 0; k < c->stat.count; ++k, mem += entry_size) {
+            ((lwcell_pbuf_p)mem)->next = c->first_free;
+            c->first_free = (lwcell_pbuf_p)mem;
+        }
+        c->end = mem;
+    }
+    pool_init = 1;
+}
+
+#endif /* LWCELL_CFG_PBUF_POOL */
+
+/**
+ * \brief           Get memory for packet buffer structure and payload
+ *
+ * Memory is taken from the smallest pool class with enough space,
+ * or from heap if pool is disabled or all suitable classes are empty
+ *
+ * \param[in]       len: Length of payload
+ * \return          Pointer to memory on success, `NULL` otherwise
+ */
+static lwcell_pbuf_p
+pbuf_mem_alloc(size_t len) {
+#if LWCELL_CFG_PBUF_POOL
+    lwcell_pbuf_p p = NULL;
+
+    lwcell_core_lock();
+    if (!pool_init) {
+        pbuf_pool_init();
+    }
+    for (size_t i = 0; i < LWCELL_ARRAYSIZE(pool_classes); ++i) {
+        pbuf_pool_class_t* c = &pool_classes[i];
+
+        if (c->stat.size < len) {
+            continue;
+        }
+        if ((p = c->first_free) != NULL) {
+            c->first_free = p->next;
+            if (++c->stat.used > c->stat.used_max) {
+                c->stat.used_max = c->stat.used;
+            }
+            break;
+        }
+        ++c->stat.empty;
+    }
+    lwcell_core_unlock();
+    if (p != NULL) {
+        return p;
+    }
+#endif /* LWCELL_CFG_PBUF_POOL */
+    return lwcell_mem_malloc_tag(SIZEOF_PBUF_STRUCT + len, LWCELL_MEM_TAG_PBUF);
+}
+
+/**
+ * \brief           Release memory of single packet buffer to pool or heap
+ * \param[in]       p: Packet buffer to release
+ */
+static void
+pbuf_mem_free(lwcell_pbuf_p p) {
+#if LWCELL_CFG_PBUF_POOL
+    lwcell_core_lock();
+    for (size_t i = 0; i < LWCELL_ARRAYSIZE(pool_classes); ++i) {
+        pbuf_pool_class_t* c = &pool_classes[i];
+
+        if ((uint8_t*)p >= c->start && (uint8_t*)p < c->end) {
+            p->next = c->first_free;
+            c->first_free = p;
+            --c->stat.used;
+            lwcell_core_unlock();
+            return;
+        }
+    }
+    lwcell_core_unlock();
+#endif /* LWCELL_CFG_PBUF_POOL */
+    lwcell_mem_free(p);
+}
+
 /**
  * \brief           Skip pbufs for desired offset
  * \param[in]       p: Source pbuf to skip
@@ -75,7 +187,7 @@ lwcell_pbuf_p
 lwcell_pbuf_new(size_t len) {
     lwcell_pbuf_p p;
 
-    p = lwcell_mem_malloc(SIZEOF_PBUF_STRUCT + sizeof(*p->payload) * len);
+    p = pbuf_mem_alloc(sizeof(*p->payload) * len);
     LWCELL_DEBUGW(LWCELL_CFG_DBG_PBUF | LWCELL_DBG_TYPE_TRACE, p == NULL,
                   "[LWCELL PBUF] Failed to allocate %u bytes\r\n", (unsigned)len);
     LWCELL_DEBUGW(LWCELL_CFG_DBG_PBUF | LWCELL_DBG_TYPE_TRACE, p != NULL, "[LWCELL PBUF] Allocated %u bytes on %p\r\n",
@@ -121,10 +233,10 @@ lwcell_pbuf_free(lwcell_pbuf_p pbuf) {
             LWCELL_DEBUGF(LWCELL_CFG_DBG_PBUF | LWCELL_DBG_TYPE_TRACE,
                           "[LWCELL PBUF] Deallocating %p with len/tot_len: %u/%u\r\n", (void*)p, (unsigned)p->len,
                           (unsigned)p->tot_len);
-            pn = p->next;                  /* Save next entry */
-            lwcell_mem_free_s((void**)&p); /* Free memory for pbuf */
-            p = pn;                        /* Restore with next entry */
-            ++cnt;                         /* Increase number of freed pbufs */
+            pn = p->next;     /* Save next entry */
+            pbuf_mem_free(p); /* Free memory for pbuf */
+            p = pn;           /* Restore with next entry */
+            ++cnt;            /* Increase number of freed pbufs */
         } else {
             break;
         }
@@ -613,3 +725,29 @@ lwcell_pbuf_dump(lwcell_pbuf_p p, uint8_t seq) {
         LWCELL_DEBUGF(LWCELL_CFG_DBG_PBUF | LWCELL_DBG_TYPE_TRACE, "[LWCELL PBUF] Dump end\r\n");
     }
 }
+
+/**
+ * \brief           Get statistics of packet buffer pool size classes
+ * \param[out]      stats: Array to write statistics of each class to
+ * \param[in]       btr: Number of entries in `stats` array
+ * \return          Number of entries written, `0` if \ref LWCELL_CFG_PBUF_POOL is disabled
+ */
+size_t
+lwcell_pbuf_pool_get_stats(lwcell_pbuf_pool_stat_t* stats, size_t btr) {
+#if LWCELL_CFG_PBUF_POOL
+    size_t cnt = LWCELL_MIN(btr, LWCELL_ARRAYSIZE(pool_classes));
+
+    LWCELL_ASSERT0(stats != NULL);
+
+    lwcell_core_lock();
+    for (size_t i = 0; i < cnt; ++i) {
+        stats[i] = pool_classes[i].stat;
+    }
+    lwcell_core_unlock();
+    return cnt;
+#else  /* LWCELL_CFG_PBUF_POOL */
+    LWCELL_UNUSED(stats);
+    LWCELL_UNUSED(btr);
+    return 0;
+#endif /* !LWCELL_CFG_PBUF_POOL */
+}
@@ -0,0 +1,1201 @@
+/**
+ * \file            lwcell_ppp.c
+ * \brief           PPP link with HDLC-like framing
+ */
+
+/*
+ * Copyright (c) 2023 Tilen MAJERLE
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without restriction,
+ * including without limitation the rights to use, copy, modify, merge,
+ * publish, distribute, sublicense, and/or sell copies of the Software,
+ * and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE
+ * AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * This file is part of LwCELL - Lightweight cellular modem AT library.
+ *
+ * Author:          Tilen MAJERLE <tilen@majerle.eu>
+ * Version:         v0.1.1
+ */
+#include "lwcell/lwcell_ppp.h"
+#include "lwcell/lwcell_private.h"
+
+#if LWCELL_CFG_PPP || __DOXYGEN__
+
+#define PPP_FLAG     0x7E   /*!< Frame opening and closing flag */
+#define PPP_ESC      0x7D   /*!< Control escape */
+#define PPP_TRANS    0x20   /*!< Value XOR-ed with escaped byte */
+#define PPP_ADDR     0xFF   /*!< All-stations address */
+#define PPP_CTRL     0x03   /*!< Unnumbered information control field */
+#define PPP_FCS_INIT 0xFFFF /*!< Initial frame check sequence value */
+#define PPP_FCS_GOOD 0xF0B8 /*!< Frame check sequence result of valid frame */
+#define PPP_MRU_DEF  1500   /*!< Default maximum receive unit, used until negotiated otherwise */
+
+/* Protocol field values */
+#define PPP_PROTO_IP   0x0021 /*!< Internet protocol version 4 */
+#define PPP_PROTO_LCP  0xC021 /*!< Link control protocol */
+#define PPP_PROTO_PAP  0xC023 /*!< Password authentication protocol */
+#define PPP_PROTO_IPCP 0x8021 /*!< Internet protocol control protocol */
+
+/* Control protocol codes, shared by LCP and IPCP */
+#define PPP_CONF_REQ  0x01 /*!< Configure request */
+#define PPP_CONF_ACK  0x02 /*!< Configure acknowledge */
+#define PPP_CONF_NAK  0x03 /*!< Configure not acknowledged, with suggested values */
+#define PPP_CONF_REJ  0x04 /*!< Configure reject */
+#define PPP_TERM_REQ  0x05 /*!< Terminate request */
+#define PPP_TERM_ACK  0x06 /*!< Terminate acknowledge */
+#define PPP_CODE_REJ  0x07 /*!< Code reject */
+#define PPP_PROTO_REJ 0x08 /*!< Protocol reject, LCP only */
+#define PPP_ECHO_REQ  0x09 /*!< Echo request, LCP only */
+#define PPP_ECHO_REP  0x0A /*!< Echo reply, LCP only */
+#define PPP_DISC_REQ  0x0B /*!< Discard request, LCP only */
+
+/* PAP codes */
+#define PPP_PAP_REQ 0x01 /*!< Authenticate request */
+#define PPP_PAP_ACK 0x02 /*!< Authenticate acknowledge */
+#define PPP_PAP_NAK 0x03 /*!< Authenticate not acknowledged */
+
+/* LCP options */
+#define PPP_LCP_OPT_MRU   0x01 /*!< Maximum receive unit */
+#define PPP_LCP_OPT_ACCM  0x02 /*!< Asynchronous control character map */
+#define PPP_LCP_OPT_AUTH  0x03 /*!< Authentication protocol */
+#define PPP_LCP_OPT_MAGIC 0x05 /*!< Magic number */
+#define PPP_LCP_OPT_PFC   0x07 /*!< Protocol field compression */
+#define PPP_LCP_OPT_ACFC  0x08 /*!< Address and control field compression */
+
+/* IPCP options */
+#define PPP_IPCP_OPT_IP   0x03 /*!< IP address */
+#define PPP_IPCP_OPT_DNS1 0x81 /*!< Primary DNS server address */
+#define PPP_IPCP_OPT_DNS2 0x83 /*!< Secondary DNS server address */
+
+/* Our options rejected by peer, bits of \ref lwcell_ppp_cp_t.rejected */
+#define PPP_LCP_REJ_MRU   0x01
+#define PPP_LCP_REJ_ACCM  0x02
+#define PPP_LCP_REJ_MAGIC 0x04
+#define PPP_IPCP_REJ_IP   0x01
+#define PPP_IPCP_REJ_DNS1 0x02
+#define PPP_IPCP_REJ_DNS2 0x04
+
+#define PPP_RESTART_TIME  3000 /*!< Time between request retransmissions in units of milliseconds */
+#define PPP_MAX_CONFIGURE 10   /*!< Maximal number of configure or authenticate requests without reply */
+#define PPP_MAX_TERMINATE 2    /*!< Maximal number of terminate requests without reply */
+
+#define PPP_FCS_UPDATE(fcs, b) LWCELL_U16(((fcs) >> 8) ^ ppp_fcs_table[((fcs) ^ (b)) & 0xFF])
+#define PPP_NEEDS_ESC(accm, b)                                                                                         \
+    ((b) == PPP_FLAG || (b) == PPP_ESC || ((b) < 0x20 && ((accm) & ((uint32_t)1 << (b)))))
+#define PPP_GET_U16(d) LWCELL_U16(((uint16_t)(d)[0] << 8) | (d)[1])
+
+/**
+ * \brief           Frame being sent, escaped data are collected to send them in larger blocks
+ * \note            Low-level may keep reference to sent data until flush, buffer is only appended until then
+ */
+typedef struct {
+    uint8_t buff[64]; /*!< Escaped data waiting to be sent */
+    size_t len;       /*!< Number of bytes in buffer */
+    size_t sent;      /*!< Number of bytes in buffer already passed to low-level */
+    uint16_t fcs;     /*!< Running frame check sequence */
+    uint32_t accm;    /*!< Control characters to escape in this frame */
+} ppp_tx_t;
+
+/**
+ * \brief           Reversed CRC-16 table with polynomial `x^16 + x^12 + x^5 + 1`, as defined in RFC 1662
+ */
+static const uint16_t ppp_fcs_table[256] = {
+    0x0000, 0x1189, 0x2312, 0x329B, 0x4624, 0x57AD, 0x6536, 0x74BF, 0x8C48, 0x9DC1, 0xAF5A, 0xBED3, 0xCA6C, 0xDBE5,
+    0xE97E, 0xF8F7, 0x1081, 0x0108, 0x3393, 0x221A, 0x56A5, 0x472C, 0x75B7, 0x643E, 0x9CC9, 0x8D40, 0xBFDB, 0xAE52,
+    0xDAED, 0xCB64, 0xF9FF, 0xE876, 0x2102, 0x308B, 0x0210, 0x1399, 0x6726, 0x76AF, 0x4434, 0x55BD, 0xAD4A, 0xBCC3,
+    0x8E58, 0x9FD1, 0xEB6E, 0xFAE7, 0xC87C, 0xD9F5, 0x3183, 0x200A, 0x1291, 0x0318, 0x77A7, 0x662E, 0x54B5, 0x453C,
+    0xBDCB, 0xAC42, 0x9ED9, 0x8F50, 0xFBEF, 0xEA66, 0xD8FD, 0xC974, 0x4204, 0x538D, 0x6116, 0x709F, 0x0420, 0x15A9,
+    0x2732, 0x36BB, 0xCE4C, 0xDFC5, 0xED5E, 0xFCD7, 0x8868, 0x99E1, 0xAB7A, 0xBAF3, 0x5285, 0x430C, 0x7197, 0x601E,
+    0x14A1, 0x0528, 0x37B3, 0x263A, 0xDECD, 0xCF44, 0xFDDF, 0xEC56, 0x98E9, 0x8960, 0xBBFB, 0xAA72, 0x6306, 0x728F,
+    0x4014, 0x519D, 0x2522, 0x34AB, 0x0630, 0x17B9, 0xEF4E, 0xFEC7, 0xCC5C, 0xDDD5, 0xA96A, 0xB8E3, 0x8A78, 0x9BF1,
+    0x7387, 0x620E, 0x5095, 0x411C, 0x35A3, 0x242A, 0x16B1, 0x0738, 0xFFCF, 0xEE46, 0xDCDD, 0xCD54, 0xB9EB, 0xA862,
+    0x9AF9, 0x8B70, 0x8408, 0x9581, 0xA71A, 0xB693, 0xC22C, 0xD3A5, 0xE13E, 0xF0B7, 0x0840, 0x19C9, 0x2B52, 0x3ADB,
+    0x4E64, 0x5FED, 0x6D76, 0x7CFF, 0x9489, 0x8500, 0xB79B, 0xA612, 0xD2AD, 0xC324, 0xF1BF, 0xE036, 0x18C1, 0x0948,
+    0x3BD3, 0x2A5A, 0x5EE5, 0x4F6C, 0x7DF7, 0x6C7E, 0xA50A, 0xB483, 0x8618, 0x9791, 0xE32E, 0xF2A7, 0xC03C, 0xD1B5,
+    0x2942, 0x38CB, 0x0A50, 0x1BD9, 0x6F66, 0x7EEF, 0x4C74, 0x5DFD, 0xB58B, 0xA402, 0x9699, 0x8710, 0xF3AF, 0xE226,
+    0xD0BD, 0xC134, 0x39C3, 0x284A, 0x1AD1, 0x0B58, 0x7FE7, 0x6E6E, 0x5CF5, 0x4D7C, 0xC60C, 0xD785, 0xE51E, 0xF497,
+    0x8028, 0x91A1, 0xA33A, 0xB2B3, 0x4A44, 0x5BCD, 0x6956, 0x78DF, 0x0C60, 0x1DE9, 0x2F72, 0x3EFB, 0xD68D, 0xC704,
+    0xF59F, 0xE416, 0x90A9, 0x8120, 0xB3BB, 0xA232, 0x5AC5, 0x4B4C, 0x79D7, 0x685E, 0x1CE1, 0x0D68, 0x3FF3, 0x2E7A,
+    0xE70E, 0xF687, 0xC41C, 0xD595, 0xA12A, 0xB0A3, 0x8238, 0x93B1, 0x6B46, 0x7ACF, 0x4854, 0x59DD, 0x2D62, 0x3CEB,
+    0x0E70, 0x1FF9, 0xF78F, 0xE606, 0xD49D, 0xC514, 0xB1AB, 0xA022, 0x92B9, 0x8330, 0x7BC7, 0x6A4E, 0x58D5, 0x495C,
+    0x3DE3, 0x2C6A, 0x1EF1, 0x0F78,
+};
+
+static void ppp_timeout_fn(void* arg);
+
+/**
+ * \brief           Get length of data run without flag and control escape bytes
+ *
+ * Full words are checked at once, with zero byte detection on word XOR-ed with flag and escape pattern
+ *
+ * \param[in]       d: Data to scan
+ * \param[in]       len: Length of data in units of bytes
+ * \return          Number of bytes before first flag or control escape byte
+ */
+static size_t
+ppp_plain_run_len(const uint8_t* d, size_t len) {
+    const size_t ones = ((size_t)-1) / 0xFF; /* 0x0101...01 */
+    size_t i = 0, w, f, e;
+
+    for (; (i + sizeof(w)) <= len; i += sizeof(w)) {
+        LWCELL_MEMCPY(&w, &d[i], sizeof(w));
+        f = w ^ (ones * PPP_FLAG);
+        e = w ^ (ones * PPP_ESC);
+        if ((((f - ones) & ~f) | ((e - ones) & ~e)) & (ones * 0x80)) {
+            break;
+        }
+    }
+    for (; i < len && d[i] != PPP_FLAG && d[i] != PPP_ESC; ++i) {}
+    return i;
+}
+
+/**
+ * \brief           Add already escaped data to frame being sent
+ * \param[in]       tx: Frame being sent
+ * \param[in]       d: Data to add
+ * \param[in]       len: Length of data in units of bytes
+ */
+static void
+ppp_tx_raw(ppp_tx_t* tx, const uint8_t* d, size_t len) {
+    if (len >= sizeof(tx->buff) || tx->len + len > sizeof(tx->buff)) {
+        if (tx->len > tx->sent) {
+            lwcell.ll.send_fn(&tx->buff[tx->sent], tx->len - tx->sent);
+            tx->sent = tx->len;
+        }
+        if (len >= sizeof(tx->buff)) {
+            lwcell.ll.send_fn(d, len); /* Long runs go to low-level without copy */
+            return;
+        }
+        lwcell.ll.send_fn(NULL, 0); /* Flush before buffer is reused */
+        tx->len = tx->sent = 0;
+    }
+    LWCELL_MEMCPY(&tx->buff[tx->len], d, len);
+    tx->len += len;
+}
+
+/**
+ * \brief           Escape data and add them to frame being sent
+ * \param[in]       tx: Frame being sent
+ * \param[in]       data: Data to add
+ * \param[in]       len: Length of data in units of bytes
+ */
+static void
+ppp_tx_data(ppp_tx_t* tx, const void* data, size_t len) {
+    const uint8_t* d = data;
+
+    while (len > 0) {
+        size_t run = 0;
+
+        /* With empty map, only flag and escape bytes break the run */
+        if (tx->accm == 0) {
+            run = ppp_plain_run_len(d, len);
+        } else {
+            for (; run < len && !PPP_NEEDS_ESC(tx->accm, d[run]); ++run) {}
+        }
+        for (size_t i = 0; i < run; ++i) {
+            tx->fcs = PPP_FCS_UPDATE(tx->fcs, d[i]);
+        }
+        if (run > 0) {
+            ppp_tx_raw(tx, d, run);
+        }
+        if (run < len) {
+            uint8_t esc[2] = {PPP_ESC, LWCELL_U8(d[run] ^ PPP_TRANS)};
+
+            tx->fcs = PPP_FCS_UPDATE(tx->fcs, d[run]);
+            ppp_tx_raw(tx, esc, sizeof(esc));
+            ++run;
+        }
+        d += run;
+        len -= run;
+    }
+}
+
+/**
+ * \brief           Start new frame with address, control and protocol field
+ * \param[in]       tx: Frame to start
+ * \param[in]       proto: Protocol field value
+ */
+static void
+ppp_tx_begin(ppp_tx_t* tx, uint16_t proto) {
+    uint8_t hdr[4] = {PPP_ADDR, PPP_CTRL, LWCELL_U8(proto >> 8), LWCELL_U8(proto)};
+
+    tx->buff[0] = PPP_FLAG;
+    tx->len = 1;
+    tx->sent = 0;
+    tx->fcs = PPP_FCS_INIT;
+    /* LCP frames always escape all control characters, as map is not known before negotiation */
+    tx->accm = proto == PPP_PROTO_LCP ? 0xFFFFFFFF : lwcell.m.ppp.tx_accm;
+    ppp_tx_data(tx, hdr, sizeof(hdr));
+}
+
+/**
+ * \brief           Finish frame with frame check sequence and closing flag and send it
+ * \param[in]       tx: Frame to finish
+ */
+static void
+ppp_tx_end(ppp_tx_t* tx) {
+    uint16_t fcs = LWCELL_U16(~tx->fcs);
+    uint8_t fcs_le[2] = {LWCELL_U8(fcs), LWCELL_U8(fcs >> 8)}, flag = PPP_FLAG;
+
+    ppp_tx_data(tx, fcs_le, sizeof(fcs_le));
+    ppp_tx_raw(tx, &flag, 1);
+    lwcell.ll.send_fn(&tx->buff[tx->sent], tx->len - tx->sent);
+    lwcell.ll.send_fn(NULL, 0);
+}
+
+/**
+ * \brief           Send control protocol packet
+ * \param[in]       proto: Protocol field value
+ * \param[in]       code: Packet code
+ * \param[in]       id: Packet identifier
+ * \param[in]       data: Packet data after header. Set to `NULL` if not used
+ * \param[in]       len: Length of packet data in units of bytes
+ */
+static void
+ppp_send_cp(uint16_t proto, uint8_t code, uint8_t id, const void* data, size_t len) {
+    ppp_tx_t tx;
+    uint8_t hdr[4] = {code, id, LWCELL_U8((len + 4) >> 8), LWCELL_U8(len + 4)};
+
+    ppp_tx_begin(&tx, proto);
+    ppp_tx_data(&tx, hdr, sizeof(hdr));
+    if (len > 0) {
+        ppp_tx_data(&tx, data, len);
+    }
+    ppp_tx_end(&tx);
+}
+
+/**
+ * \brief           Write configuration option with 32-bit or IP address value
+ * \param[out]      opt: Memory to write option to, `6` bytes long
+ * \param[in]       type: Option type
+ * \param[in]       val: Value in network byte order
+ * \return          Length of option in units of bytes
+ */
+static size_t
+ppp_put_opt4(uint8_t* opt, uint8_t type, const uint8_t* val) {
+    opt[0] = type;
+    opt[1] = 6;
+    LWCELL_MEMCPY(&opt[2], val, 4);
+    return 6;
+}
+
+/**
+ * \brief           Check that options of configure packet are well formed
+ * \param[in]       d: Options
+ * \param[in]       len: Length of options in units of bytes
+ * \return          `1` if valid, `0` otherwise
+ */
+static uint8_t
+ppp_opts_valid(const uint8_t* d, size_t len) {
+    for (size_t i = 0; i < len; i += d[i + 1]) {
+        if ((len - i) < 2 || d[i + 1] < 2 || d[i + 1] > (len - i)) {
+            return 0;
+        }
+    }
+    return 1;
+}
+
+/**
+ * \brief           Reply to configure request of peer
+ *
+ * Reply code is the strongest of all option results, reject before not acknowledged before acknowledged.
+ * Only options with matching result are kept in reply, written in place over the request
+ *
+ * \param[in]       proto: Protocol field value
+ * \param[in]       id: Request identifier
+ * \param[in,out]   d: Request options, overwritten by reply options
+ * \param[in]       len: Length of options in units of bytes
+ * \param[in]       check_fn: Function returning result code for option, filling suggested option on nak
+ * \return          Reply code sent to peer
+ */
+static uint8_t
+ppp_conf_reply(uint16_t proto, uint8_t id, uint8_t* d, size_t len, uint8_t (*check_fn)(const uint8_t*, uint8_t*)) {
+    uint8_t code = PPP_CONF_ACK, nak[6];
+    size_t out = 0;
+
+    for (size_t i = 0; i < len; i += d[i + 1]) {
+        code = LWCELL_MAX(code, check_fn(&d[i], nak));
+    }
+    for (size_t i = 0, opt_len; i < len; i += opt_len) {
+        opt_len = d[i + 1];
+        if (check_fn(&d[i], nak) == code) {
+            if (code == PPP_CONF_NAK) {
+                memmove(&d[out], nak, nak[1]); /* Suggested option is never longer than original */
+                out += nak[1];
+            } else {
+                memmove(&d[out], &d[i], opt_len);
+                out += opt_len;
+            }
+        }
+    }
+    ppp_send_cp(proto, code, id, d, out);
+    return code;
+}
+
+/**
+ * \brief           Mark link as down and notify application
+ */
+static void
+ppp_link_down(void) {
+    lwcell_timeout_remove(ppp_timeout_fn);
+    if (lwcell.m.ppp.phase != LWCELL_PPP_PHASE_DEAD) {
+        lwcell.m.ppp.phase = LWCELL_PPP_PHASE_DEAD;
+        lwcelli_send_cb(LWCELL_EVT_PPP_DOWN);
+    }
+}
+
+/**
+ * \brief           Start restart timer of current phase
+ *
+ * Negotiation cannot recover from lost packets without timer,
+ * link is taken down when timer cannot be started
+ *
+ * \return          \ref lwcellOK on success, member of \ref lwcellr_t enumeration otherwise
+ */
+static lwcellr_t
+ppp_timer_start(void) {
+    lwcellr_t res;
+
+    lwcell_timeout_remove(ppp_timeout_fn);
+    if ((res = lwcell_timeout_add(PPP_RESTART_TIME, ppp_timeout_fn, NULL)) != lwcellOK) {
+        ppp_link_down();
+    }
+    return res;
+}
+
+/**
+ * \brief           Start link termination with LCP terminate request
+ */
+static void
+ppp_terminate(void) {
+    lwcell.m.ppp.phase = LWCELL_PPP_PHASE_TERMINATE;
+    lwcell.m.ppp.retries = 0;
+    ppp_send_cp(PPP_PROTO_LCP, PPP_TERM_REQ, ++lwcell.m.ppp.id, NULL, 0);
+    ppp_timer_start();
+}
+
+/**
+ * \brief           Send LCP configure request with our options
+ */
+static void
+ppp_lcp_send_req(void) {
+    lwcell_ppp_t* ppp = &lwcell.m.ppp;
+    uint8_t opts[4 + 6 + 6];
+    size_t len = 0;
+
+    if (!(ppp->lcp.rejected & PPP_LCP_REJ_MRU)) {
+        opts[len++] = PPP_LCP_OPT_MRU;
+        opts[len++] = 4;
+        opts[len++] = LWCELL_U8(LWCELL_CFG_PPP_MRU >> 8);
+        opts[len++] = LWCELL_U8(LWCELL_CFG_PPP_MRU);
+    }
+    if (!(ppp->lcp.rejected & PPP_LCP_REJ_ACCM)) {
+        static const uint8_t accm[4] = {0}; /* Nothing needs to be escaped towards host */
+        len += ppp_put_opt4(&opts[len], PPP_LCP_OPT_ACCM, accm);
+    }
+    if (!(ppp->lcp.rejected & PPP_LCP_REJ_MAGIC)) {
+        uint8_t magic[4] = {LWCELL_U8(ppp->magic >> 24), LWCELL_U8(ppp->magic >> 16), LWCELL_U8(ppp->magic >> 8),
+                            LWCELL_U8(ppp->magic)};
+        len += ppp_put_opt4(&opts[len], PPP_LCP_OPT_MAGIC, magic);
+    }
+    ppp->lcp.req_acked = 0;
+    ppp_send_cp(PPP_PROTO_LCP, PPP_CONF_REQ, ++ppp->lcp.id, opts, len);
+}
+
+/**
+ * \brief           Send IPCP configure request with our options
+ */
+static void
+ppp_ipcp_send_req(void) {
+    lwcell_ppp_t* ppp = &lwcell.m.ppp;
+    uint8_t opts[3 * 6];
+    size_t len = 0;
+
+    if (!(ppp->ipcp.rejected & PPP_IPCP_REJ_IP)) {
+        len += ppp_put_opt4(&opts[len], PPP_IPCP_OPT_IP, ppp->ip.ip);
+    }
+    if (!(ppp->ipcp.rejected & PPP_IPCP_REJ_DNS1)) {
+        len += ppp_put_opt4(&opts[len], PPP_IPCP_OPT_DNS1, ppp->dns[0].ip);
+    }
+    if (!(ppp->ipcp.rejected & PPP_IPCP_REJ_DNS2)) {
+        len += ppp_put_opt4(&opts[len], PPP_IPCP_OPT_DNS2, ppp->dns[1].ip);
+    }
+    ppp->ipcp.req_acked = 0;
+    ppp_send_cp(PPP_PROTO_IPCP, PPP_CONF_REQ, ++ppp->ipcp.id, opts, len);
+}
+
+/**
+ * \brief           Send PAP authenticate request
+ */
+static void
+ppp_pap_send_req(void) {
+    lwcell_ppp_t* ppp = &lwcell.m.ppp;
+    uint8_t buff[2 + sizeof(ppp->user) + sizeof(ppp->pass)];
+    size_t user_len = strlen(ppp->user), pass_len = strlen(ppp->pass), len = 0;
+
+    buff[len++] = LWCELL_U8(user_len);
+    LWCELL_MEMCPY(&buff[len], ppp->user, user_len);
+    len += user_len;
+    buff[len++] = LWCELL_U8(pass_len);
+    LWCELL_MEMCPY(&buff[len], ppp->pass, pass_len);
+    len += pass_len;
+    ppp_send_cp(PPP_PROTO_PAP, PPP_PAP_REQ, ++ppp->id, buff, len);
+}
+
+/**
+ * \brief           Enter network phase and start IPCP negotiation
+ */
+static void
+ppp_network_start(void) {
+    lwcell.m.ppp.phase = LWCELL_PPP_PHASE_NETWORK;
+    lwcell.m.ppp.retries = 0;
+    lwcell.m.ppp.ipcp.ack_sent = 0;
+    ppp_ipcp_send_req();
+    ppp_timer_start();
+}
+
+/**
+ * \brief           Restart timer callback, retransmits request of current phase
+ * \param[in]       arg: Custom argument, not used
+ */
+static void
+ppp_timeout_fn(void* arg) {
+    lwcell_ppp_t* ppp = &lwcell.m.ppp;
+
+    LWCELL_UNUSED(arg);
+    ++ppp->retries;
+    if (ppp->phase == LWCELL_PPP_PHASE_TERMINATE) {
+        if (ppp->retries < PPP_MAX_TERMINATE) {
+            ppp_send_cp(PPP_PROTO_LCP, PPP_TERM_REQ, ++ppp->id, NULL, 0);
+            ppp_timer_start();
+        } else {
+            ppp_link_down();
+        }
+        return;
+    } else if (ppp->retries >= PPP_MAX_CONFIGURE) {
+        ppp_terminate(); /* Peer does not respond */
+        return;
+    }
+    switch (ppp->phase) {
+        case LWCELL_PPP_PHASE_ESTABLISH: ppp_lcp_send_req(); break;
+        case LWCELL_PPP_PHASE_AUTHENTICATE: ppp_pap_send_req(); break;
+        case LWCELL_PPP_PHASE_NETWORK: ppp_ipcp_send_req(); break;
+        default: return;
+    }
+    ppp_timer_start();
+}
+
+/**
+ * \brief           Check LCP option from peer configure request
+ * \param[in]       opt: Option to check
+ * \param[out]      nak: Suggested option when result is not acknowledged
+ * \return          \ref PPP_CONF_ACK, \ref PPP_CONF_NAK or \ref PPP_CONF_REJ
+ */
+static uint8_t
+ppp_lcp_opt_check(const uint8_t* opt, uint8_t* nak) {
+    switch (opt[0]) {
+        case PPP_LCP_OPT_MRU: return opt[1] == 4 ? PPP_CONF_ACK : PPP_CONF_REJ;
+        case PPP_LCP_OPT_ACCM:
+        case PPP_LCP_OPT_MAGIC: return opt[1] == 6 ? PPP_CONF_ACK : PPP_CONF_REJ;
+        case PPP_LCP_OPT_PFC:
+        case PPP_LCP_OPT_ACFC: return opt[1] == 2 ? PPP_CONF_ACK : PPP_CONF_REJ;
+        case PPP_LCP_OPT_AUTH: {
+            if (opt[1] < 4) {
+                return PPP_CONF_REJ;
+            } else if (opt[1] == 4 && PPP_GET_U16(&opt[2]) == PPP_PROTO_PAP) {
+                return PPP_CONF_ACK;
+            }
+            /* Only PAP is supported, suggest it instead */
+            nak[0] = PPP_LCP_OPT_AUTH;
+            nak[1] = 4;
+            nak[2] = LWCELL_U8(PPP_PROTO_PAP >> 8);
+            nak[3] = LWCELL_U8(PPP_PROTO_PAP);
+            return PPP_CONF_NAK;
+        }
+        default: return PPP_CONF_REJ;
+    }
+}
+
+/**
+ * \brief           Check if LCP is opened in both directions and go to next phase
+ */
+static void
+ppp_lcp_check_opened(void) {
+    lwcell_ppp_t* ppp = &lwcell.m.ppp;
+
+    if (ppp->phase != LWCELL_PPP_PHASE_ESTABLISH || !ppp->lcp.req_acked || !ppp->lcp.ack_sent) {
+        return;
+    }
+    if (ppp->auth) {
+        ppp->phase = LWCELL_PPP_PHASE_AUTHENTICATE;
+        ppp->retries = 0;
+        ppp_pap_send_req();
+        ppp_timer_start();
+    } else {
+        ppp_network_start();
+    }
+}
+
+/**
+ * \brief           Process received LCP packet
+ * \param[in]       pkt: Packet, starting with code
+ * \param[in]       len: Packet length in units of bytes
+ */
+static void
+ppp_lcp_input(uint8_t* pkt, size_t len) {
+    lwcell_ppp_t* ppp = &lwcell.m.ppp;
+    uint8_t code = pkt[0], id = pkt[1], *d = &pkt[4];
+
+    len -= 4;
+    switch (code) {
+        case PPP_CONF_REQ: {
+            uint32_t accm = 0xFFFFFFFF;
+            uint16_t mru = PPP_MRU_DEF;
+            uint8_t auth = 0;
+
+            if (ppp->phase == LWCELL_PPP_PHASE_DEAD || ppp->phase == LWCELL_PPP_PHASE_TERMINATE
+                || !ppp_opts_valid(d, len)) {
+                break;
+            }
+            if (ppp->phase != LWCELL_PPP_PHASE_ESTABLISH) { /* Peer restarts negotiation */
+                if (ppp->phase == LWCELL_PPP_PHASE_RUNNING) {
+                    lwcelli_send_cb(LWCELL_EVT_PPP_DOWN);
+                }
+                ppp->phase = LWCELL_PPP_PHASE_ESTABLISH;
+                ppp->retries = 0;
+                ppp->tx_accm = 0xFFFFFFFF;
+                ppp->lcp.ack_sent = 0;
+                ppp_lcp_send_req();
+                if (ppp_timer_start() != lwcellOK) {
+                    break;
+                }
+            }
+
+            /* Options are overwritten by reply, read values first */
+            for (size_t i = 0; i < len; i += d[i + 1]) {
+                if (d[i] == PPP_LCP_OPT_MRU && d[i + 1] == 4) {
+                    mru = PPP_GET_U16(&d[i + 2]);
+                } else if (d[i] == PPP_LCP_OPT_ACCM && d[i + 1] == 6) {
+                    accm = ((uint32_t)d[i + 2] << 24) | ((uint32_t)d[i + 3] << 16) | ((uint32_t)d[i + 4] << 8) | d[i + 5];
+                } else if (d[i] == PPP_LCP_OPT_AUTH) {
+                    auth = 1;
+                }
+            }
+            if (ppp_conf_reply(PPP_PROTO_LCP, id, d, len, ppp_lcp_opt_check) == PPP_CONF_ACK) {
+                ppp->peer_mru = mru;
+                ppp->tx_accm = accm;
+                ppp->auth = auth;
+                ppp->lcp.ack_sent = 1;
+                ppp_lcp_check_opened();
+            } else {
+                ppp->lcp.ack_sent = 0;
+            }
+            break;
+        }
+        case PPP_CONF_ACK: {
+            if (id == ppp->lcp.id && ppp->phase == LWCELL_PPP_PHASE_ESTABLISH) {
+                ppp->lcp.req_acked = 1;
+                ppp_lcp_check_opened();
+            }
+            break;
+        }
+        case PPP_CONF_NAK:
+        case PPP_CONF_REJ: {
+            if (id != ppp->lcp.id || ppp->phase != LWCELL_PPP_PHASE_ESTABLISH || !ppp_opts_valid(d, len)) {
+                break;
+            }
+            for (size_t i = 0; i < len; i += d[i + 1]) {
+                if (code == PPP_CONF_NAK && d[i] == PPP_LCP_OPT_MAGIC) {
+                    ppp->magic = ppp->magic * 1103515245UL + lwcell_sys_now(); /* Peer detected loopback */
+                } else if (d[i] == PPP_LCP_OPT_MRU) {
+                    ppp->lcp.rejected |= PPP_LCP_REJ_MRU; /* Use default value instead of negotiating another */
+                } else if (d[i] == PPP_LCP_OPT_ACCM) {
+                    ppp->lcp.rejected |= PPP_LCP_REJ_ACCM;
+                } else if (d[i] == PPP_LCP_OPT_MAGIC) {
+                    ppp->lcp.rejected |= PPP_LCP_REJ_MAGIC;
+                }
+            }
+            ppp_lcp_send_req();
+            break;
+        }
+        case PPP_TERM_REQ: {
+            ppp_send_cp(PPP_PROTO_LCP, PPP_TERM_ACK, id, NULL, 0);
+            ppp_link_down(); /* Device reports NO CARRIER when it leaves data mode */
+            break;
+        }
+        case PPP_TERM_ACK: {
+            if (ppp->phase == LWCELL_PPP_PHASE_TERMINATE) {
+                ppp_link_down();
+            }
+            break;
+        }
+        case PPP_ECHO_REQ: {
+            if (len >= 4 && ppp->phase != LWCELL_PPP_PHASE_ESTABLISH && ppp->phase != LWCELL_PPP_PHASE_DEAD) {
+                d[0] = LWCELL_U8(ppp->magic >> 24);
+                d[1] = LWCELL_U8(ppp->magic >> 16);
+                d[2] = LWCELL_U8(ppp->magic >> 8);
+                d[3] = LWCELL_U8(ppp->magic);
+                ppp_send_cp(PPP_PROTO_LCP, PPP_ECHO_REP, id, d, len);
+            }
+            break;
+        }
+        case PPP_CODE_REJ:
+        case PPP_PROTO_REJ:
+        case PPP_ECHO_REP:
+        case PPP_DISC_REQ: break;
+        default: {
+            ppp_send_cp(PPP_PROTO_LCP, PPP_CODE_REJ, ++ppp->id, pkt, LWCELL_MIN(len + 4, ppp->peer_mru - 4U));
+            break;
+        }
+    }
+}
+
+/**
+ * \brief           Process received PAP packet
+ * \param[in]       pkt: Packet, starting with code
+ * \param[in]       len: Packet length in units of bytes
+ */
+static void
+ppp_pap_input(uint8_t* pkt, size_t len) {
+    lwcell_ppp_t* ppp = &lwcell.m.ppp;
+
+    LWCELL_UNUSED(len);
+    if (ppp->phase != LWCELL_PPP_PHASE_AUTHENTICATE || pkt[1] != ppp->id) {
+        return;
+    }
+    if (pkt[0] == PPP_PAP_ACK) {
+        ppp_network_start();
+    } else if (pkt[0] == PPP_PAP_NAK) {
+        ppp_terminate(); /* Wrong credentials */
+    }
+}
+
+/**
+ * \brief           Check IPCP option from peer configure request
+ * \param[in]       opt: Option to check
+ * \param[out]      nak: Suggested option when result is not acknowledged, not used
+ * \return          \ref PPP_CONF_ACK or \ref PPP_CONF_REJ
+ */
+static uint8_t
+ppp_ipcp_opt_check(const uint8_t* opt, uint8_t* nak) {
+    LWCELL_UNUSED(nak);
+    return opt[0] == PPP_IPCP_OPT_IP && opt[1] == 6 ? PPP_CONF_ACK : PPP_CONF_REJ;
+}
+
+/**
+ * \brief           Check if IPCP is opened in both directions and notify application
+ */
+static void
+ppp_ipcp_check_opened(void) {
+    lwcell_ppp_t* ppp = &lwcell.m.ppp;
+
+    if (ppp->phase == LWCELL_PPP_PHASE_NETWORK && ppp->ipcp.req_acked && ppp->ipcp.ack_sent) {
+        ppp->phase = LWCELL_PPP_PHASE_RUNNING;
+        lwcell_timeout_remove(ppp_timeout_fn);
+        lwcelli_send_cb(LWCELL_EVT_PPP_UP);
+    }
+}
+
+/**
+ * \brief           Process received IPCP packet
+ * \param[in]       pkt: Packet, starting with code
+ * \param[in]       len: Packet length in units of bytes
+ */
+static void
+ppp_ipcp_input(uint8_t* pkt, size_t len) {
+    lwcell_ppp_t* ppp = &lwcell.m.ppp;
+    uint8_t code = pkt[0], id = pkt[1], *d = &pkt[4];
+
+    /* Network control packets are silently discarded before network phase */
+    if (ppp->phase != LWCELL_PPP_PHASE_NETWORK && ppp->phase != LWCELL_PPP_PHASE_RUNNING) {
+        return;
+    }
+    len -= 4;
+    switch (code) {
+        case PPP_CONF_REQ: {
+            if (ppp_opts_valid(d, len)) {
+                ppp->ipcp.ack_sent = ppp_conf_reply(PPP_PROTO_IPCP, id, d, len, ppp_ipcp_opt_check) == PPP_CONF_ACK;
+                ppp_ipcp_check_opened();
+            }
+            break;
+        }
+        case PPP_CONF_ACK: {
+            if (id == ppp->ipcp.id) {
+                ppp->ipcp.req_acked = 1;
+                ppp_ipcp_check_opened();
+            }
+            break;
+        }
+        case PPP_CONF_NAK:
+        case PPP_CONF_REJ: {
+            if (id != ppp->ipcp.id || ppp->phase != LWCELL_PPP_PHASE_NETWORK || !ppp_opts_valid(d, len)) {
+                break;
+            }
+            for (size_t i = 0; i < len; i += d[i + 1]) {
+                lwcell_ip_t* ip = NULL;
+                uint8_t rej = 0;
+
+                if (d[i] == PPP_IPCP_OPT_IP) {
+                    ip = &ppp->ip;
+                    rej = PPP_IPCP_REJ_IP;
+                } else if (d[i] == PPP_IPCP_OPT_DNS1) {
+                    ip = &ppp->dns[0];
+                    rej = PPP_IPCP_REJ_DNS1;
+                } else if (d[i] == PPP_IPCP_OPT_DNS2) {
+                    ip = &ppp->dns[1];
+                    rej = PPP_IPCP_REJ_DNS2;
+                }
+                if (code == PPP_CONF_REJ) {
+                    ppp->ipcp.rejected |= rej;
+                } else if (ip != NULL && d[i + 1] == 6) {
+                    LWCELL_MEMCPY(ip->ip, &d[i + 2], 4); /* Use address assigned by peer */
+                }
+            }
+            ppp_ipcp_send_req();
+            break;
+        }
+        case PPP_TERM_REQ: {
+            ppp_send_cp(PPP_PROTO_IPCP, PPP_TERM_ACK, id, NULL, 0);
+            break;
+        }
+        default: break;
+    }
+}
+
+/**
+ * \brief           Pass received IP packet to application
+ * \param[in]       d: IP packet
+ * \param[in]       len: Length of packet in units of bytes
+ */
+static void
+ppp_ip_input(const uint8_t* d, size_t len) {
+    lwcell_ppp_t* ppp = &lwcell.m.ppp;
+    lwcell_pbuf_p pbuf;
+
+    if (ppp->phase != LWCELL_PPP_PHASE_RUNNING || ppp->input_fn == NULL || len == 0) {
+        return;
+    }
+    if ((pbuf = lwcell_pbuf_new(len)) == NULL) {
+        return; /* Packet is dropped, IP stack recovers from it */
+    }
+    LWCELL_MEMCPY(pbuf->payload, d, len);
+    ppp->input_fn(pbuf, ppp->input_arg);
+}
+
+/**
+ * \brief           Process received frame with valid frame check sequence
+ */
+static void
+ppp_frame_process(void) {
+    lwcell_ppp_t* ppp = &lwcell.m.ppp;
+    uint8_t* d = ppp->rx;
+    size_t len = ppp->rx_len - 2; /* Frame check sequence */
+    uint16_t proto;
+
+    /* Address and control field may be omitted and protocol field compressed to single odd byte */
+    if (len >= 2 && d[0] == PPP_ADDR && d[1] == PPP_CTRL) {
+        d += 2;
+        len -= 2;
+    }
+    if (len >= 1 && (d[0] & 0x01)) {
+        proto = d[0];
+        d += 1;
+        len -= 1;
+    } else if (len >= 2) {
+        proto = PPP_GET_U16(d);
+        d += 2;
+        len -= 2;
+    } else {
+        return;
+    }
+
+    if (proto == PPP_PROTO_IP) {
+        ppp_ip_input(d, len);
+    } else if (proto == PPP_PROTO_LCP || proto == PPP_PROTO_PAP || proto == PPP_PROTO_IPCP) {
+        size_t pkt_len = len >= 4 ? PPP_GET_U16(&d[2]) : 0;
+
+        if (pkt_len < 4 || pkt_len > len) {
+            return; /* Malformed packet, padding after packet is allowed */
+        }
+        if (proto == PPP_PROTO_LCP) {
+            ppp_lcp_input(d, pkt_len);
+        } else if (proto == PPP_PROTO_PAP) {
+            ppp_pap_input(d, pkt_len);
+        } else {
+            ppp_ipcp_input(d, pkt_len);
+        }
+    } else if (ppp->phase == LWCELL_PPP_PHASE_AUTHENTICATE || ppp->phase == LWCELL_PPP_PHASE_NETWORK
+               || ppp->phase == LWCELL_PPP_PHASE_RUNNING) {
+        ppp_tx_t tx;
+        uint8_t hdr[6];
+
+        /* Reject unknown protocol with as much of the packet as fits to peer MRU */
+        len = LWCELL_MIN(len, ppp->peer_mru - sizeof(hdr));
+        hdr[0] = PPP_PROTO_REJ;
+        hdr[1] = ++ppp->id;
+        hdr[2] = LWCELL_U8((len + sizeof(hdr)) >> 8);
+        hdr[3] = LWCELL_U8(len + sizeof(hdr));
+        hdr[4] = LWCELL_U8(proto >> 8);
+        hdr[5] = LWCELL_U8(proto);
+        ppp_tx_begin(&tx, PPP_PROTO_LCP);
+        ppp_tx_data(&tx, hdr, sizeof(hdr));
+        ppp_tx_data(&tx, d, len);
+        ppp_tx_end(&tx);
+    }
+}
+
+/**
+ * \brief           Add unescaped run of received bytes to current frame
+ * \param[in]       d: Received bytes
+ * \param[in]       len: Number of bytes
+ */
+static void
+ppp_rx_data(const uint8_t* d, size_t len) {
+    lwcell_ppp_t* ppp = &lwcell.m.ppp;
+    uint8_t* dst;
+
+    if (ppp->rx_drop || len > (sizeof(ppp->rx) - ppp->rx_len)) {
+        ppp->rx_drop = 1; /* Frame does not fit to buffer, discard it until next flag */
+        ppp->rx_esc = 0;
+        return;
+    }
+    dst = &ppp->rx[ppp->rx_len];
+    LWCELL_MEMCPY(dst, d, len);
+    if (ppp->rx_esc) { /* First byte follows control escape */
+        dst[0] ^= PPP_TRANS;
+        ppp->rx_esc = 0;
+    }
+    for (size_t i = 0; i < len; ++i) {
+        ppp->rx_fcs = PPP_FCS_UPDATE(ppp->rx_fcs, dst[i]);
+    }
+    ppp->rx_len += len;
+}
+
+/**
+ * \brief           Process flag byte, closing current frame and opening next one
+ */
+static void
+ppp_rx_flag(void) {
+    lwcell_ppp_t* ppp = &lwcell.m.ppp;
+
+    /* Control escape followed by flag aborts the frame */
+    if (!ppp->rx_drop && !ppp->rx_esc && ppp->rx_len >= 4 && ppp->rx_fcs == PPP_FCS_GOOD) {
+        ppp_frame_process();
+    }
+    ppp->rx_len = 0;
+    ppp->rx_fcs = PPP_FCS_INIT;
+    ppp->rx_esc = 0;
+    ppp->rx_drop = 0;
+}
+
+/**
+ * \brief           Process received bytes as HDLC frames
+ * \param[in]       data: Received data
+ * \param[in]       len: Length of received data
+ */
+static void
+ppp_rx_bytes(const uint8_t* data, size_t len) {
+    size_t i = 0;
+
+    while (i < len) {
+        size_t run = ppp_plain_run_len(&data[i], len - i);
+
+        if (run > 0) {
+            ppp_rx_data(&data[i], run);
+            i += run;
+        } else {
+            if (data[i] == PPP_FLAG) {
+                ppp_rx_flag();
+            } else {
+                lwcell.m.ppp.rx_esc = 1;
+            }
+            ++i;
+        }
+    }
+}
+
+/**
+ * \brief           Process input data in PPP data mode
+ *
+ * Device leaves data mode with `NO CARRIER`. As there is no framing around it,
+ * it is only recognized at the end of received data.
+ * Beginning of it at the end of data block is kept, to continue with next block,
+ * as device may send it in several parts.
+ *
+ * \param[in]       data: Received data
+ * \param[in]       data_len: Length of received data
+ * \return          Number of processed bytes, remaining bytes must go through the parser
+ */
+size_t
+lwcelli_ppp_process(const uint8_t* data, size_t data_len) {
+    static const char no_carrier[] = CRLF "NO CARRIER" CRLF;
+    const size_t nc_len = sizeof(no_carrier) - 1;
+    lwcell_ppp_t* ppp = &lwcell.m.ppp;
+    size_t len = data_len;
+
+    /* Continue match from the end of previous block */
+    if (ppp->rx_nc > 0) {
+        size_t n = LWCELL_MIN(nc_len - ppp->rx_nc, data_len);
+
+        if (!memcmp(data, &no_carrier[ppp->rx_nc], n)) {
+            if (ppp->rx_nc + n == nc_len) {
+                len = n; /* Preceding bytes went to frame, which is dropped with the link */
+                goto out;
+            }
+            ppp->rx_nc += n;
+            ppp_rx_bytes(data, data_len); /* May still be frame data */
+            return data_len;
+        }
+        ppp->rx_nc = 0;
+    }
+
+    if (data_len >= nc_len && !memcmp(&data[data_len - nc_len], no_carrier, nc_len)) {
+        ppp_rx_bytes(data, data_len - nc_len);
+        goto out;
+    }
+    ppp_rx_bytes(data, data_len);
+
+    /* Keep longest end of block, which is beginning of the marker */
+    for (size_t k = LWCELL_MIN(nc_len - 1, data_len); k > 0; --k) {
+        if (!memcmp(&data[data_len - k], no_carrier, k)) {
+            ppp->rx_nc = LWCELL_U8(k);
+            break;
+        }
+    }
+    return data_len;
+
+out:
+    /* Device is in command mode again */
+    ppp->rx_nc = 0;
+    ppp->data_mode = 0;
+    ppp_link_down();
+    return len;
+}
+
+/**
+ * \brief           Keep credentials and input function before device is dialled
+ * \param[in]       msg: Message with PPP start settings
+ * \return          \ref lwcellOK on success, member of \ref lwcellr_t enumeration otherwise
+ */
+lwcellr_t
+lwcelli_ppp_prepare(const lwcell_msg_t* msg) {
+    lwcell_ppp_t* ppp = &lwcell.m.ppp;
+    const char* user = msg->msg.ppp_start.user != NULL ? msg->msg.ppp_start.user : "";
+    const char* pass = msg->msg.ppp_start.pass != NULL ? msg->msg.ppp_start.pass : "";
+
+    if (ppp->data_mode) {
+        return lwcellERR; /* Link is already active */
+    }
+    if (strlen(user) >= sizeof(ppp->user) || strlen(pass) >= sizeof(ppp->pass)) {
+        return lwcellERRPAR;
+    }
+    strcpy(ppp->user, user);
+    strcpy(ppp->pass, pass);
+    ppp->input_fn = msg->msg.ppp_start.input_fn;
+    ppp->input_arg = msg->msg.ppp_start.input_arg;
+    return lwcellOK;
+}
+
+/**
+ * \brief           Device replied with `CONNECT` to dial command, start link negotiation
+ */
+void
+lwcelli_ppp_connected(void) {
+    lwcell_ppp_t* ppp = &lwcell.m.ppp;
+
+    ppp->data_mode = 1;
+    ppp->phase = LWCELL_PPP_PHASE_ESTABLISH;
+    ppp->retries = 0;
+    ppp->auth = 0;
+    ppp->magic = ppp->magic * 1103515245UL + lwcell_sys_now();
+    ppp->tx_accm = 0xFFFFFFFF;
+    ppp->peer_mru = PPP_MRU_DEF;
+    LWCELL_MEMSET(&ppp->lcp, 0x00, sizeof(ppp->lcp));
+    LWCELL_MEMSET(&ppp->ipcp, 0x00, sizeof(ppp->ipcp));
+    LWCELL_MEMSET(&ppp->ip, 0x00, sizeof(ppp->ip));
+    LWCELL_MEMSET(ppp->dns, 0x00, sizeof(ppp->dns));
+    ppp->rx_len = 0;
+    ppp->rx_fcs = PPP_FCS_INIT;
+    ppp->rx_esc = 0;
+    ppp->rx_drop = 0;
+    ppp->rx_nc = 0;
+
+    ppp_lcp_send_req();
+    ppp_timer_start();
+}
+
+/**
+ * \brief           Terminate link on application request
+ * \return          \ref lwcellOK when terminate request has been sent, member of \ref lwcellr_t enumeration otherwise
+ */
+lwcellr_t
+lwcelli_ppp_terminate(void) {
+    if (!lwcell.m.ppp.data_mode) {
+        return lwcellERR;
+    }
+    if (lwcell.m.ppp.phase == LWCELL_PPP_PHASE_DEAD) {
+        /* Link is already down, only device has to leave data mode */
+        ppp_send_cp(PPP_PROTO_LCP, PPP_TERM_REQ, ++lwcell.m.ppp.id, NULL, 0);
+    } else if (lwcell.m.ppp.phase != LWCELL_PPP_PHASE_TERMINATE) {
+        ppp_terminate();
+    }
+    return lwcellOK;
+}
+
+/**
+ * \brief           Drop link state after device reset or when device did not leave data mode
+ */
+void
+lwcelli_ppp_reset(void) {
+    if (lwcell.m.ppp.data_mode) {
+        /* Best effort, device in data mode would not accept following AT commands */
+        ppp_send_cp(PPP_PROTO_LCP, PPP_TERM_REQ, ++lwcell.m.ppp.id, NULL, 0);
+        lwcell.m.ppp.data_mode = 0;
+    }
+    ppp_link_down();
+}
+
+/**
+ * \brief           Dial packet data service and start PPP link
+ *
+ * Command finishes when device enters data mode,
+ * \ref LWCELL_EVT_PPP_UP is sent when link negotiation succeeds and IP packets may be sent
+ *
+ * \param[in]       apn: APN name for PDP context
+ * \param[in]       user: PAP username, used when peer requires authentication. Set to `NULL` if not used
+ * \param[in]       pass: PAP password. Set to `NULL` if not used
+ * \param[in]       input_fn: Function called for every received IP packet
+ * \param[in]       input_arg: Custom argument for input function
+ * \param[in]       evt_fn: Callback function called when command has finished. Set to `NULL` when not used
+ * \param[in]       evt_arg: Custom argument for event callback function
+ * \param[in]       blocking: Status whether command should be blocking or not
+ * \return          \ref lwcellOK on success, member of \ref lwcellr_t enumeration otherwise
+ */
+lwcellr_t
+lwcell_ppp_start(const char* apn, const char* user, const char* pass, lwcell_ppp_input_fn input_fn, void* input_arg,
+                 const lwcell_api_cmd_evt_fn evt_fn, void* const evt_arg, const uint32_t blocking) {
+    LWCELL_MSG_VAR_DEFINE(msg);
+
+    LWCELL_ASSERT(apn != NULL);
+    LWCELL_ASSERT(input_fn != NULL);
+
+    LWCELL_MSG_VAR_ALLOC(msg, blocking);
+    LWCELL_MSG_VAR_SET_EVT(msg, evt_fn, evt_arg);
+    LWCELL_MSG_VAR_REF(msg).cmd_def = LWCELL_CMD_PPP_START;
+    LWCELL_MSG_VAR_REF(msg).cmd = LWCELL_CMD_PPP_START;
+    LWCELL_MSG_VAR_REF(msg).msg.ppp_start.apn = apn;
+    LWCELL_MSG_VAR_REF(msg).msg.ppp_start.user = user;
+    LWCELL_MSG_VAR_REF(msg).msg.ppp_start.pass = pass;
+    LWCELL_MSG_VAR_REF(msg).msg.ppp_start.input_fn = input_fn;
+    LWCELL_MSG_VAR_REF(msg).msg.ppp_start.input_arg = input_arg;
+
+    return lwcelli_send_msg_to_producer_mbox(&LWCELL_MSG_VAR_REF(msg), lwcelli_initiate_cmd, 200000);
+}
+
+/**
+ * \brief           Terminate PPP link and wait for device to return to command mode
+ * \param[in]       evt_fn: Callback function called when command has finished. Set to `NULL` when not used
+ * \param[in]       evt_arg: Custom argument for event callback function
+ * \param[in]       blocking: Status whether command should be blocking or not
+ * \return          \ref lwcellOK on success, member of \ref lwcellr_t enumeration otherwise
+ */
+lwcellr_t
+lwcell_ppp_stop(const lwcell_api_cmd_evt_fn evt_fn, void* const evt_arg, const uint32_t blocking) {
+    LWCELL_MSG_VAR_DEFINE(msg);
+
+    LWCELL_MSG_VAR_ALLOC(msg, blocking);
+    LWCELL_MSG_VAR_SET_EVT(msg, evt_fn, evt_arg);
+    LWCELL_MSG_VAR_REF(msg).cmd_def = LWCELL_CMD_PPP_STOP;
+    LWCELL_MSG_VAR_REF(msg).cmd = LWCELL_CMD_PPP_STOP;
+
+    return lwcelli_send_msg_to_producer_mbox(&LWCELL_MSG_VAR_REF(msg), lwcelli_initiate_cmd, 20000);
+}
+
+/**
+ * \brief           Send IP packet over PPP link
+ * \note            Packet buffer stays in ownership of caller
+ * \param[in]       pbuf: Packet buffer or chain with single IP packet
+ * \return          \ref lwcellOK on success, member of \ref lwcellr_t enumeration otherwise
+ */
+lwcellr_t
+lwcell_ppp_output(const lwcell_pbuf_p pbuf) {
+    lwcellr_t res = lwcellOK;
+
+    LWCELL_ASSERT(pbuf != NULL);
+
+    lwcell_core_lock();
+    if (lwcell.m.ppp.phase != LWCELL_PPP_PHASE_RUNNING) {
+        res = lwcellERRNOIP;
+    } else if (pbuf->tot_len > lwcell.m.ppp.peer_mru) {
+        res = lwcellERRPAR;
+    } else {
+        ppp_tx_t tx;
+
+        ppp_tx_begin(&tx, PPP_PROTO_IP);
+        for (lwcell_pbuf_p p = pbuf; p != NULL; p = p->next) {
+            ppp_tx_data(&tx, p->payload, p->len);
+        }
+        ppp_tx_end(&tx);
+    }
+    lwcell_core_unlock();
+    return res;
+}
+
+/**
+ * \brief           Check if PPP link is up and IP packets may be sent
+ * \return          `1` if link is up, `0` otherwise
+ */
+uint8_t
+lwcell_ppp_is_up(void) {
+    uint8_t res;
+
+    lwcell_core_lock();
+    res = lwcell.m.ppp.phase == LWCELL_PPP_PHASE_RUNNING;
+    lwcell_core_unlock();
+    return res;
+}
+
+/**
+ * \brief           Get addresses negotiated with IPCP
+ * \param[out]      ip: Local IP address. Set to `NULL` if not used
+ * \param[out]      dns1: Primary DNS server. Set to `NULL` if not used
+ * \param[out]      dns2: Secondary DNS server. Set to `NULL` if not used
+ * \return          \ref lwcellOK on success, member of \ref lwcellr_t enumeration otherwise
+ */
+lwcellr_t
+lwcell_ppp_get_ip(lwcell_ip_t* ip, lwcell_ip_t* dns1, lwcell_ip_t* dns2) {
+    lwcellr_t res = lwcellERRNOIP;
+
+    lwcell_core_lock();
+    if (lwcell.m.ppp.phase == LWCELL_PPP_PHASE_RUNNING) {
+        if (ip != NULL) {
+            LWCELL_MEMCPY(ip, &lwcell.m.ppp.ip, sizeof(*ip));
+        }
+        if (dns1 != NULL) {
+            LWCELL_MEMCPY(dns1, &lwcell.m.ppp.dns[0], sizeof(*dns1));
+        }
+        if (dns2 != NULL) {
+            LWCELL_MEMCPY(dns2, &lwcell.m.ppp.dns[1], sizeof(*dns2));
+        }
+        res = lwcellOK;
+    }
+    lwcell_core_unlock();
+    return res;
+}
+
+#endif /* LWCELL_CFG_PPP || __DOXYGEN__ */
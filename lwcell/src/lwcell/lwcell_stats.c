@@ -0,0 +1,135 @@
+/**
+ * \file            lwcell_stats.c
+ * \brief           Command latency statistics
+ */
+
+/*
+ * Copyright (c) 2023 Tilen MAJERLE
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without restriction,
+ * including without limitation the rights to use, copy, modify, merge,
+ * publish, distribute, sublicense, and/or sell copies of the Software,
+ * and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE
+ * AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * This file is part of LwCELL - Lightweight cellular modem AT library.
+ *
+ * Author:          Tilen MAJERLE <tilen@majerle.eu>
+ * Version:         v0.1.1
+ */
+#include "lwcell/lwcell_stats.h"
+#include "lwcell/lwcell_private.h"
+
+#if LWCELL_CFG_STATS || __DOXYGEN__
+
+static lwcell_stats_cmd_t stats_cmds[LWCELL_CMD_END]; /*!< Statistics of each command type */
+
+/**
+ * \brief           Add duration to histogram
+ * \param[in,out]   hist: Histogram with \ref LWCELL_CFG_STATS_HIST_LEN buckets
+ * \param[in,out]   max: Maximal duration to update
+ * \param[in]       time: Duration in units of milliseconds
+ */
+static void
+stats_hist_add(uint32_t* hist, uint32_t* max, uint32_t time) {
+    size_t bucket = 0;
+
+    /* Bucket is number of significant bits */
+    for (uint32_t t = time; t > 0 && bucket < LWCELL_CFG_STATS_HIST_LEN - 1; t >>= 1) {
+        ++bucket;
+    }
+    ++hist[bucket];
+    if (time > *max) {
+        *max = time;
+    }
+}
+
+/**
+ * \brief           Record statistics of finished command
+ * \note            Function must be called with core lock held
+ * \param[in]       cmd: Command type
+ * \param[in]       res: Final command result
+ * \param[in]       queue: Time spent in producer queue
+ * \param[in]       exec: Execution time, or \ref LWCELL_STATS_NO_EXEC if command did not start
+ * \param[in]       cb: Duration of command callback function
+ */
+void
+lwcelli_stats_cmd(lwcell_cmd_t cmd, lwcellr_t res, uint32_t queue, uint32_t exec, uint32_t cb) {
+    lwcell_stats_cmd_t* s;
+
+    if ((size_t)cmd >= LWCELL_ARRAYSIZE(stats_cmds)) {
+        return;
+    }
+    s = &stats_cmds[cmd];
+    ++s->count;
+    if (res == lwcellTIMEOUT) {
+        ++s->timeouts;
+    } else if (res != lwcellOK) {
+        ++s->errors;
+    }
+    stats_hist_add(s->queue_hist, &s->queue_max, queue);
+    if (exec != LWCELL_STATS_NO_EXEC) {
+        stats_hist_add(s->exec_hist, &s->exec_max, exec);
+    }
+    if (cb > s->cb_max) {
+        s->cb_max = cb;
+    }
+}
+
+/**
+ * \brief           Get statistics of all command types
+ *
+ * Entry at index `i` holds statistics of command number `i`.
+ * Entries of commands never executed have `count` set to `0`
+ *
+ * \param[out]      stats: Array to write statistics to
+ * \param[in]       btr: Number of entries in `stats` array
+ * \return          Number of entries written
+ * \sa              lwcell_stats_get_cmd_count
+ */
+size_t
+lwcell_stats_get(lwcell_stats_cmd_t* stats, size_t btr) {
+    size_t cnt = LWCELL_MIN(btr, LWCELL_ARRAYSIZE(stats_cmds));
+
+    LWCELL_ASSERT0(stats != NULL);
+
+    lwcell_core_lock();
+    LWCELL_MEMCPY(stats, stats_cmds, cnt * sizeof(*stats));
+    lwcell_core_unlock();
+    return cnt;
+}
+
+/**
+ * \brief           Get number of command types, used as array length for \ref lwcell_stats_get
+ * \return          Number of command types
+ */
+size_t
+lwcell_stats_get_cmd_count(void) {
+    return LWCELL_ARRAYSIZE(stats_cmds);
+}
+
+/**
+ * \brief           Clear statistics of all command types
+ */
+void
+lwcell_stats_reset(void) {
+    lwcell_core_lock();
+    LWCELL_MEMSET(stats_cmds, 0x00, sizeof(stats_cmds));
+    lwcell_core_unlock();
+}
+
+#endif /* LWCELL_CFG_STATS || __DOXYGEN__ */
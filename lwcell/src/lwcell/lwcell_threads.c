@@ -49,6 +49,9 @@ lwcell_thread_produce(void* const arg) {
     lwcell_msg_t* msg;
     lwcellr_t res;
     uint32_t time;
+#if LWCELL_CFG_STATS
+    uint32_t stats_time, stats_queue, stats_exec, stats_cb = 0;
+#endif /* LWCELL_CFG_STATS */
 
     /* Thread is running, unlock semaphore */
     if (lwcell_sys_sem_isvalid(sem)) {
@@ -66,6 +69,11 @@ lwcell_thread_produce(void* const arg) {
 
         res = lwcellOK; /* Start with OK */
         e->msg = msg;   /* Set message handle */
+#if LWCELL_CFG_STATS
+        stats_time = lwcell_sys_now();
+        stats_queue = stats_time - msg->stats_time;
+        stats_exec = LWCELL_STATS_NO_EXEC;
+#endif /* LWCELL_CFG_STATS */
 
         /*
          * This check is performed when adding command to queue
@@ -98,6 +106,9 @@ lwcell_thread_produce(void* const arg) {
             lwcell_core_unlock();
             lwcell_sys_sem_wait(&e->sem_sync, 0); /* First call */
             lwcell_core_lock();
+#if LWCELL_CFG_STATS
+            stats_time = lwcell_sys_now();
+#endif                                            /* LWCELL_CFG_STATS */
             res = msg->fn(msg);                   /* Process this message, check if command started at least */
             time = ~LWCELL_SYS_TIMEOUT;           /* Reset time */
             if (res == lwcellOK) {                /* We have valid data and data were sent */
@@ -110,6 +121,11 @@ lwcell_thread_produce(void* const arg) {
                     res = lwcellTIMEOUT;          /* Timeout on command */
                 }
             }
+            lwcell_timeout_cancel(e->cmd_tmr); /* Stop timeout of last command, if still active */
+            e->cmd_tmr = 0;
+#if LWCELL_CFG_STATS
+            stats_exec = lwcell_sys_now() - stats_time;
+#endif /* LWCELL_CFG_STATS */
 
             /* Notify application on command timeout */
             if (res == lwcellTIMEOUT) {
@@ -155,9 +171,19 @@ lwcell_thread_produce(void* const arg) {
 #if LWCELL_CFG_USE_API_FUNC_EVT
         /* Send event function to user */
         if (msg->evt_fn != NULL) {
+#if LWCELL_CFG_STATS
+            stats_time = lwcell_sys_now();
+#endif                                           /* LWCELL_CFG_STATS */
             msg->evt_fn(msg->res, msg->evt_arg); /* Send event with user argument */
+#if LWCELL_CFG_STATS
+            stats_cb = lwcell_sys_now() - stats_time;
+#endif /* LWCELL_CFG_STATS */
         }
-#endif                                           /* LWCELL_CFG_USE_API_FUNC_EVT */
+#endif /* LWCELL_CFG_USE_API_FUNC_EVT */
+#if LWCELL_CFG_STATS
+        lwcelli_stats_cmd(msg->cmd_def, msg->res, stats_queue, stats_exec, stats_cb);
+        stats_cb = 0;
+#endif /* LWCELL_CFG_STATS */
 
         /*
          * In case message is blocking,
@@ -220,3 +246,25 @@ lwcell_thread_process(void* const arg) {
 #endif                            /* !LWCELL_CFG_INPUT_USE_PROCESS */
     }
 }
+
+#if LWCELL_CFG_EVT_DEFER && LWCELL_CFG_EVT_DEFER_THREAD
+
+/**
+ * \brief           Thread to dispatch deferred events to application
+ * \param[in]       arg: User argument. Semaphore to release when thread starts
+ */
+void
+lwcell_thread_evt(void* const arg) {
+    lwcell_sys_sem_t* sem = arg;
+
+    /* Thread is running, unlock semaphore */
+    if (lwcell_sys_sem_isvalid(sem)) {
+        lwcell_sys_sem_release(sem); /* Release semaphore */
+    }
+
+    while (1) {
+        lwcell_evt_dispatch(0); /* Wait for and dispatch events */
+    }
+}
+
+#endif /* LWCELL_CFG_EVT_DEFER && LWCELL_CFG_EVT_DEFER_THREAD */
@@ -34,8 +34,131 @@
 #include "lwcell/lwcell_timeout.h"
 #include "lwcell/lwcell_private.h"
 
-static lwcell_timeout_t* first_timeout;
-static uint32_t last_timeout_time;
+
+#if (LWCELL_CFG_TIMEOUT_WHEEL_SIZE & (LWCELL_CFG_TIMEOUT_WHEEL_SIZE - 1)) != 0
+#error "LWCELL_CFG_TIMEOUT_WHEEL_SIZE must be power of 2"
+#endif /* (LWCELL_CFG_TIMEOUT_WHEEL_SIZE & (LWCELL_CFG_TIMEOUT_WHEEL_SIZE - 1)) != 0 */
+
+#define WHEEL_MASK        (LWCELL_CFG_TIMEOUT_WHEEL_SIZE - 1)
+#define WHEEL_SLOT(tick)  (&wheel[(tick) & WHEEL_MASK])
+#define TICK_IS_DUE(e, t) ((int32_t)((e)->expire - (t)) <= 0)
+
+/**
+ * \brief           Single slot of timing wheel
+ */
+typedef struct {
+    lwcell_timeout_t* first; /*!< First entry in slot */
+    lwcell_timeout_t* last;  /*!< Last entry in slot */
+} wheel_slot_t;
+
+static lwcell_timeout_t pool[LWCELL_CFG_TIMEOUT_POOL_SIZE]; /*!< Preallocated timeout entries */
+static lwcell_timeout_t* pool_free;                         /*!< List of free entries */
+static uint8_t pool_init;                                   /*!< Set to `1` when free list is ready */
+static wheel_slot_t wheel[LWCELL_CFG_TIMEOUT_WHEEL_SIZE];   /*!< Timing wheel */
+static size_t active_cnt;                                   /*!< Number of active timeouts */
+static uint32_t wheel_tick;                                 /*!< Current tick of timing wheel */
+static uint32_t wheel_time;                                 /*!< System time of current tick */
+
+/**
+ * \brief           Get entry from pool
+ * \return          Pointer to entry or `NULL` if pool is empty
+ */
+static lwcell_timeout_t*
+entry_alloc(void) {
+    lwcell_timeout_t* to;
+
+    if (!pool_init) {
+        for (size_t i = 0; i < LWCELL_ARRAYSIZE(pool); ++i) {
+            pool[i].next = i + 1 < LWCELL_ARRAYSIZE(pool) ? &pool[i + 1] : NULL;
+        }
+        pool_free = &pool[0];
+        pool_init = 1;
+    }
+    if ((to = pool_free) != NULL) {
+        pool_free = to->next;
+    }
+    return to;
+}
+
+/**
+ * \brief           Return entry to pool and invalidate its handles
+ * \param[in]       to: Entry to release
+ */
+static void
+entry_free(lwcell_timeout_t* to) {
+    ++to->gen;
+    to->fn = NULL;
+    to->arg = NULL;
+    to->prev = NULL;
+    to->next = pool_free;
+    pool_free = to;
+}
+
+/**
+ * \brief           Get handle for pool entry
+ * \param[in]       to: Pool entry
+ * \return          Handle value, never `0`
+ */
+static lwcell_timeout_handle_t
+entry_to_handle(lwcell_timeout_t* to) {
+    return ((uint32_t)to->gen << 16) | (uint32_t)((to - pool) + 1);
+}
+
+/**
+ * \brief           Get active pool entry from handle
+ * \param[in]       handle: Timeout handle
+ * \return          Pointer to entry or `NULL` if handle is not valid anymore
+ */
+static lwcell_timeout_t*
+handle_to_entry(lwcell_timeout_handle_t handle) {
+    size_t idx = (size_t)(handle & 0xFFFF);
+
+    if (idx == 0 || idx > LWCELL_ARRAYSIZE(pool) || pool[idx - 1].gen != (uint16_t)(handle >> 16)
+        || pool[idx - 1].fn == NULL) {
+        return NULL;
+    }
+    return &pool[idx - 1];
+}
+
+/**
+ * \brief           Add entry to the end of wheel slot
+ * \param[in]       to: Entry to link
+ */
+static void
+wheel_link(lwcell_timeout_t* to) {
+    wheel_slot_t* slot = WHEEL_SLOT(to->expire);
+
+    to->next = NULL;
+    to->prev = slot->last;
+    if (slot->last != NULL) {
+        slot->last->next = to;
+    } else {
+        slot->first = to;
+    }
+    slot->last = to;
+    ++active_cnt;
+}
+
+/**
+ * \brief           Remove entry from its wheel slot
+ * \param[in]       to: Entry to unlink
+ */
+static void
+wheel_unlink(lwcell_timeout_t* to) {
+    wheel_slot_t* slot = WHEEL_SLOT(to->expire);
+
+    if (to->prev != NULL) {
+        to->prev->next = to->next;
+    } else {
+        slot->first = to->next;
+    }
+    if (to->next != NULL) {
+        to->next->prev = to->prev;
+    } else {
+        slot->last = to->prev;
+    }
+    --active_cnt;
+}
 
 /**
  * \brief           Get time we have to wait before we can process next timeout
@@ -44,43 +167,68 @@ static uint32_t last_timeout_time;
 static uint32_t
 get_next_timeout_diff(void) {
     uint32_t diff;
-    if (first_timeout == NULL) {
+
+    if (active_cnt == 0) {
         return 0xFFFFFFFF;
     }
-    diff = lwcell_sys_now() - last_timeout_time; /* Get difference between current time and last process time */
-    if (diff >= first_timeout->time) {           /* Are we over already? */
-        return 0;                                /* We have to immediately process this timeout */
+    diff = lwcell_sys_now() - wheel_time; /* Time elapsed since current tick */
+
+    /*
+     * Find first tick with expired entry in one wheel round.
+     * Entries for later rounds are checked again after full round
+     */
+    for (uint32_t i = 0; i < LWCELL_CFG_TIMEOUT_WHEEL_SIZE; ++i) {
+        for (lwcell_timeout_t* to = WHEEL_SLOT(wheel_tick + i)->first; to != NULL; to = to->next) {
+            if (TICK_IS_DUE(to, wheel_tick + i)) {
+                uint32_t t = i * LWCELL_CFG_TIMEOUT_TICK;
+                return t > diff ? (t - diff) : 0;
+            }
+        }
     }
-    return first_timeout->time - diff;           /* Return remaining time for sleep */
+    return LWCELL_CFG_TIMEOUT_WHEEL_SIZE * LWCELL_CFG_TIMEOUT_TICK > diff
+               ? (LWCELL_CFG_TIMEOUT_WHEEL_SIZE * LWCELL_CFG_TIMEOUT_TICK - diff)
+               : 0;
 }
 
 /**
- * \brief           Process next timeout in a linked list
+ * \brief           Call expired timeouts from slot of current tick
  */
 static void
-process_next_timeout(void) {
-    uint32_t time;
-
-    time = lwcell_sys_now();
+process_slot(void) {
+    lwcell_timeout_t* to;
 
     /*
-     * Before calling timeout callback, update variable
-     * to make sure we have correct timing in case
-     * callback creates timeout value again
+     * Search is restarted from the beginning after each callback,
+     * as callback may add or cancel other timeouts in the same slot
      */
-    last_timeout_time = time; /* Reset variable when we were last processed */
-
-    if (first_timeout != NULL) {
-        lwcell_timeout_t* to = first_timeout;
-
-        /*
-         * Before calling callback remove current timeout from list
-         * to make sure we are safe in case callback function
-         * adds a new timeout entry to list
-         */
-        first_timeout = first_timeout->next; /* Set next timeout on a list as first timeout */
-        to->fn(to->arg);                     /* Call user callback function */
-        lwcell_mem_free_s((void**)&to);
+    do {
+        for (to = WHEEL_SLOT(wheel_tick)->first; to != NULL && !TICK_IS_DUE(to, wheel_tick); to = to->next) {}
+        if (to != NULL) {
+            lwcell_timeout_fn fn = to->fn;
+            void* arg = to->arg;
+
+            /*
+             * Before calling callback remove timeout from wheel
+             * to make sure we are safe in case callback function
+             * adds a new timeout entry
+             */
+            wheel_unlink(to);
+            entry_free(to);
+            fn(arg); /* Call user callback function */
+        }
+    } while (to != NULL);
+}
+
+/**
+ * \brief           Advance timing wheel to current time and process expired timeouts
+ */
+static void
+process_timeouts(void) {
+    process_slot();
+    while (active_cnt > 0 && (lwcell_sys_now() - wheel_time) >= LWCELL_CFG_TIMEOUT_TICK) {
+        wheel_time += LWCELL_CFG_TIMEOUT_TICK;
+        ++wheel_tick;
+        process_slot();
     }
 }
 
@@ -95,13 +243,14 @@ uint32_t
 lwcelli_get_from_mbox_with_timeout_checks(lwcell_sys_mbox_t* b, void** m, uint32_t timeout) {
     uint32_t wait_time;
     do {
-        if (first_timeout == NULL) {                   /* We have no timeouts ready? */
+        if (active_cnt == 0) {                         /* We have no timeouts ready? */
             return lwcell_sys_mbox_get(b, m, timeout); /* Get entry from message queue */
         }
         wait_time = get_next_timeout_diff();           /* Get time to wait for next timeout execution */
-        if (wait_time == 0 || lwcell_sys_mbox_get(b, m, wait_time) == LWCELL_SYS_TIMEOUT) {
+        if (wait_time == 0 || lwcell_sys_mbox_get(b, m, timeout > 0 ? LWCELL_MIN(wait_time, timeout) : wait_time)
+                                  == LWCELL_SYS_TIMEOUT) {
             lwcell_core_lock();
-            process_next_timeout(); /* Process with next timeout */
+            process_timeouts(); /* Process expired timeouts */
             lwcell_core_unlock();
         }
         break;
@@ -110,120 +259,100 @@ lwcelli_get_from_mbox_with_timeout_checks(lwcell_sys_mbox_t* b, void** m, uint32
 }
 
 /**
- * \brief           Add new timeout to processing list
+ * \brief           Add new timeout to processing list and get its handle
  * \param[in]       time: Time in units of milliseconds for timeout execution
  * \param[in]       fn: Callback function to call when timeout expires
  * \param[in]       arg: Pointer to user specific argument to call when timeout callback function is executed
+ * \param[out]      handle: Pointer to output handle, used with \ref lwcell_timeout_cancel.
+ *                      Set to `NULL` if not used
  * \return          \ref lwcellOK on success, member of \ref lwcellr_t enumeration otherwise
  */
 lwcellr_t
-lwcell_timeout_add(uint32_t time, lwcell_timeout_fn fn, void* arg) {
+lwcell_timeout_add_ex(uint32_t time, lwcell_timeout_fn fn, void* arg, lwcell_timeout_handle_t* handle) {
     lwcell_timeout_t* to;
     uint32_t now;
 
     LWCELL_ASSERT(fn != NULL);
 
-    /* Allocate memory for timeout structure */
-    if ((to = lwcell_mem_calloc(1, sizeof(*to))) == NULL) {
+    lwcell_core_lock();
+    if ((to = entry_alloc()) == NULL) {
+        lwcell_core_unlock();
         return lwcellERRMEM;
     }
-
-    lwcell_core_lock();
     now = lwcell_sys_now(); /* Get current time */
-    if (first_timeout != NULL) {
-        /*
-         * Since we want timeout value to start from NOW,
-         * we have to add time when we last processed our timeouts
-         */
-        time += now - last_timeout_time; /* Add difference between now and last processed time */
+    if (active_cnt == 0) {
+        wheel_time = now; /* Start wheel from current time */
     }
-    to->time = time;
-    to->arg = arg;
-    to->fn = fn;
 
     /*
-     * Add new timeout to proper place on linked list
-     * and align times to have correct values between timeouts
+     * Since we want timeout value to start from NOW,
+     * add time elapsed since current wheel tick and round up to next tick
      */
-    if (first_timeout == NULL) {
-        first_timeout = to;      /* Set as first element */
-        last_timeout_time = now; /* Reset last timeout time to current time */
-    } else {                     /* Find where to place a new timeout */
-        /*
-         * First check if we have to put new timeout
-         * to beginning of linked list.
-         * In this case just align new value for current first element
-         */
-        if (first_timeout->time > to->time) {
-            first_timeout->time -= time; /* Decrease first timeout value to match difference */
-            to->next = first_timeout;    /* Set first timeout as next of new one */
-            first_timeout = to;          /* Set new timeout as first */
-        } else {                         /* Go somewhere in between current list */
-            for (lwcell_timeout_t* t = first_timeout; t != NULL; t = t->next) {
-                to->time -= t->time;     /* Decrease new timeout time by time in a linked list */
-                /*
-                 * Enter between 2 entries on a list in case:
-                 *
-                 * - We reached end of linked list
-                 * - Our time is less than diff between 2 entries in list
-                 */
-                if (t->next == NULL || t->next->time > to->time) {
-                    if (t->next != NULL) {         /* Check if there is next element */
-                        t->next->time -= to->time; /* Decrease difference time to next one */
-                    } else if (to->time > time) {  /* Overflow of time check */
-                        to->time = time + first_timeout->time;
-                    }
-                    to->next = t->next; /* Change order of elements */
-                    t->next = to;       /* Add new element to linked list */
-                    break;
-                }
-            }
-        }
+    to->expire = wheel_tick + (time + (now - wheel_time) + LWCELL_CFG_TIMEOUT_TICK - 1) / LWCELL_CFG_TIMEOUT_TICK;
+    to->fn = fn;
+    to->arg = arg;
+    wheel_link(to);
+    if (handle != NULL) {
+        *handle = entry_to_handle(to);
     }
     lwcell_core_unlock();
     lwcell_sys_mbox_putnow(&lwcell.mbox_process, NULL); /* Insert dummy value to wakeup process thread */
     return lwcellOK;
 }
 
+/**
+ * \brief           Add new timeout to processing list
+ * \param[in]       time: Time in units of milliseconds for timeout execution
+ * \param[in]       fn: Callback function to call when timeout expires
+ * \param[in]       arg: Pointer to user specific argument to call when timeout callback function is executed
+ * \return          \ref lwcellOK on success, member of \ref lwcellr_t enumeration otherwise
+ */
+lwcellr_t
+lwcell_timeout_add(uint32_t time, lwcell_timeout_fn fn, void* arg) {
+    return lwcell_timeout_add_ex(time, fn, arg, NULL);
+}
+
+/**
+ * \brief           Cancel timeout by its handle
+ * \param[in]       handle: Timeout handle from \ref lwcell_timeout_add_ex
+ * \return          \ref lwcellOK on success, \ref lwcellERR if timeout already expired or was cancelled
+ */
+lwcellr_t
+lwcell_timeout_cancel(lwcell_timeout_handle_t handle) {
+    lwcell_timeout_t* to;
+
+    lwcell_core_lock();
+    if ((to = handle_to_entry(handle)) != NULL) {
+        wheel_unlink(to);
+        entry_free(to);
+    }
+    lwcell_core_unlock();
+    return to != NULL ? lwcellOK : lwcellERR;
+}
+
 /**
  * \brief           Remove callback from timeout list
+ * \note            When several timeouts use the same callback, the one expiring first is removed.
+ *                  Use \ref lwcell_timeout_cancel to remove specific timeout
  * \param[in]       fn: Callback function to identify timeout to remove
  * \return          \ref lwcellOK on success, member of \ref lwcellr_t enumeration otherwise
  */
 lwcellr_t
 lwcell_timeout_remove(lwcell_timeout_fn fn) {
-    uint8_t success = 0;
-
-    lwcell_core_lock();
-    for (lwcell_timeout_t *t = first_timeout, *t_prev = NULL; t != NULL;
-         t_prev = t, t = t->next) { /* Check all entries */
-        if (t->fn == fn) {          /* Do we have a match from callback point of view? */
+    lwcell_timeout_t* found = NULL;
 
-            /*
-             * We have to first increase
-             * difference time between current and next one
-             * to be aligned for correct wait time
-             */
-            if (t->next != NULL) {        /* Do we have next element? */
-                t->next->time += t->time; /* Increase timeout time for next element */
-            }
+    LWCELL_ASSERT(fn != NULL);
 
-            /*
-             * In case we have previous element on a list,
-             * set next element of previous to next of current one
-             * otherwise we were first element so simply set
-             * next of current as first one
-             */
-            if (t_prev != NULL) {
-                t_prev->next = t->next;
-            } else {
-                first_timeout = t->next;
-            }
-            lwcell_mem_free_s((void**)&t);
-            success = 1;
-            break;
+    lwcell_core_lock();
+    for (size_t i = 0; i < LWCELL_ARRAYSIZE(pool); ++i) {
+        if (pool[i].fn == fn && (found == NULL || (int32_t)(pool[i].expire - found->expire) < 0)) {
+            found = &pool[i];
         }
     }
+    if (found != NULL) {
+        wheel_unlink(found);
+        entry_free(found);
+    }
     lwcell_core_unlock();
-    return success ? lwcellOK : lwcellERR;
+    return found != NULL ? lwcellOK : lwcellERR;
 }
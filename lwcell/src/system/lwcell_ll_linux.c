@@ -0,0 +1,429 @@
+/**
+ * \file            lwcell_ll_linux.c
+ * \brief           Low-level communication with GSM device for Linux (termios)
+ */
+
+/*
+ * Copyright (c) 2023 Tilen MAJERLE
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without restriction,
+ * including without limitation the rights to use, copy, modify, merge,
+ * publish, distribute, sublicense, and/or sell copies of the Software,
+ * and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE
+ * AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * This file is part of LwCELL - Lightweight cellular modem AT library.
+ *
+ * Author:          Tilen MAJERLE <tilen@majerle.eu>
+ * Version:         v0.1.1
+ */
+#include <errno.h>
+#include <fcntl.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <sys/uio.h>
+#include <termios.h>
+#include <unistd.h>
+#include "lwcell/lwcell.h"
+#include "lwcell/lwcell_input.h"
+#include "lwcell/lwcell_mem.h"
+#include "lwcell/lwcell_types.h"
+#include "lwcell/lwcell_utils.h"
+#include "system/lwcell_ll.h"
+#include "system/lwcell_sys.h"
+
+#if !__DOXYGEN__
+
+/* Default device path, may be overwritten with `LWCELL_LL_DEV` environment variable */
+#ifndef LWCELL_LL_LINUX_DEV
+#define LWCELL_LL_LINUX_DEV "/dev/ttyUSB0"
+#endif
+
+/* Fragments shorter than this are copied as they may live on caller's stack */
+#define LL_TX_COPY_THRESHOLD 64
+#define LL_TX_IOV_MAX        32
+
+static uint8_t initialized = 0;
+static lwcell_sys_thread_t thread_handle;
+static int tty_fd = -1;             /*!< TTY file descriptor */
+static int epoll_fd = -1;           /*!< Epoll instance used by reader thread */
+static int stop_fd = -1;            /*!< Event descriptor to stop reader thread */
+static lwcell_sys_sem_t stop_sem;   /*!< Released by reader thread when it stops */
+static uint8_t data_buffer[0x1000]; /*!< Received data array */
+
+static struct iovec tx_iov[LL_TX_IOV_MAX]; /*!< Pending fragments for next flush */
+static size_t tx_iov_cnt;                  /*!< Number of pending fragments */
+static uint8_t tx_buff[0x400];             /*!< Storage for short copied fragments */
+static size_t tx_buff_len;                 /*!< Used bytes in short fragment storage */
+
+static void uart_thread(void* param);
+
+/**
+ * \brief           Write all pending fragments to device with single system call
+ * \return          Number of bytes written
+ */
+static size_t
+tx_flush(void) {
+    struct iovec* iov = tx_iov;
+    size_t cnt = tx_iov_cnt, total = 0;
+
+    while (cnt > 0) {
+        ssize_t w = writev(tty_fd, iov, (int)cnt);
+        if (w < 0) {
+            if (errno == EINTR) {
+                continue;
+            } else if (errno == EAGAIN) {
+                tcdrain(tty_fd); /* Output queue full, wait for it to drain */
+                continue;
+            }
+            break;
+        }
+        total += (size_t)w;
+
+        /* Handle partial write */
+        while (cnt > 0 && (size_t)w >= iov->iov_len) {
+            w -= (ssize_t)iov->iov_len;
+            ++iov;
+            --cnt;
+        }
+        if (cnt > 0) {
+            iov->iov_base = (uint8_t*)iov->iov_base + w;
+            iov->iov_len -= (size_t)w;
+        }
+    }
+    tx_iov_cnt = 0;
+    tx_buff_len = 0;
+    return total;
+}
+
+/**
+ * \brief           Send data to GSM device, function called from GSM stack when we have data to send
+ *
+ * Fragments are gathered until stack requests flush with `data = NULL` and `len = 0`,
+ * when all of them are written to device with single `writev` call.
+ *
+ * \param[in]       data: Pointer to data to send
+ * \param[in]       len: Number of bytes to send
+ * \return          Number of bytes sent
+ */
+static size_t
+send_data(const void* data, size_t len) {
+    if (tty_fd < 0) {
+        return 0;
+    }
+    if (data == NULL || len == 0) {
+        tx_flush();
+        return 0;
+    }
+
+    /* Flush early when there is no more space for new fragment */
+    if (tx_iov_cnt == LL_TX_IOV_MAX || (len < LL_TX_COPY_THRESHOLD && tx_buff_len + len > sizeof(tx_buff))) {
+        tx_flush();
+    }
+    if (len < LL_TX_COPY_THRESHOLD) {
+        struct iovec* last = tx_iov_cnt > 0 ? &tx_iov[tx_iov_cnt - 1] : NULL;
+
+        LWCELL_MEMCPY(&tx_buff[tx_buff_len], data, len);
+        if (last != NULL && (uint8_t*)last->iov_base + last->iov_len == &tx_buff[tx_buff_len]) {
+            last->iov_len += len; /* Extend previous copied fragment */
+        } else {
+            tx_iov[tx_iov_cnt].iov_base = &tx_buff[tx_buff_len];
+            tx_iov[tx_iov_cnt].iov_len = len;
+            ++tx_iov_cnt;
+        }
+        tx_buff_len += len;
+    } else {
+        /* Long fragments are referenced directly and stay valid until flush */
+        tx_iov[tx_iov_cnt].iov_base = (void*)data;
+        tx_iov[tx_iov_cnt].iov_len = len;
+        ++tx_iov_cnt;
+    }
+    return len;
+}
+
+/**
+ * \brief           Get termios speed constant for baudrate
+ * \param[in]       baudrate: Baudrate in units of bits per second
+ * \return          Speed constant or `B0` if not supported
+ */
+static speed_t
+baudrate_to_speed(uint32_t baudrate) {
+    switch (baudrate) {
+        case 9600: return B9600;
+        case 19200: return B19200;
+        case 38400: return B38400;
+        case 57600: return B57600;
+        case 115200: return B115200;
+        case 230400: return B230400;
+        case 460800: return B460800;
+        case 921600: return B921600;
+        default: return B0;
+    }
+}
+
+/**
+ * \brief           Close TTY and reader descriptors opened so far
+ */
+static void
+close_fds(void) {
+    if (tty_fd >= 0) {
+        close(tty_fd);
+    }
+    if (epoll_fd >= 0) {
+        close(epoll_fd);
+    }
+    if (stop_fd >= 0) {
+        close(stop_fd);
+    }
+    tty_fd = epoll_fd = stop_fd = -1;
+}
+
+/**
+ * \brief           Configure UART (TTY device)
+ *
+ * \note            On failure during first call, all descriptors opened so far are closed again
+ */
+static uint8_t
+configure_uart(uint32_t baudrate) {
+    struct termios tio;
+    speed_t speed;
+
+    /* On first call, open device and create reader resources */
+    if (!initialized) {
+        struct epoll_event ev = {0};
+        const char* dev = getenv("LWCELL_LL_DEV");
+
+        if (dev == NULL) {
+            dev = LWCELL_LL_LINUX_DEV;
+        }
+        tty_fd = open(dev, O_RDWR | O_NOCTTY | O_NONBLOCK | O_CLOEXEC);
+        if (tty_fd < 0) {
+            printf("Cannot open TTY %s: %s\r\n", dev, strerror(errno));
+            return 0;
+        }
+        printf("TTY %s opened!\r\n", dev);
+
+        epoll_fd = epoll_create1(EPOLL_CLOEXEC);
+        stop_fd = eventfd(0, EFD_CLOEXEC | EFD_NONBLOCK);
+        if (epoll_fd < 0 || stop_fd < 0) {
+            printf("Cannot create epoll instance\r\n");
+            goto fail;
+        }
+        ev.events = EPOLLIN;
+        ev.data.fd = tty_fd;
+        if (epoll_ctl(epoll_fd, EPOLL_CTL_ADD, tty_fd, &ev) != 0) {
+            printf("Cannot add TTY to epoll: %s\r\n", strerror(errno));
+            goto fail;
+        }
+        ev.data.fd = stop_fd;
+        if (epoll_ctl(epoll_fd, EPOLL_CTL_ADD, stop_fd, &ev) != 0) {
+            printf("Cannot add stop event to epoll: %s\r\n", strerror(errno));
+            goto fail;
+        }
+    }
+
+    /* Configure TTY parameters: raw mode, 8N1, no flow control */
+    speed = baudrate_to_speed(baudrate);
+    if (speed == B0) {
+        printf("Unsupported baudrate %u\r\n", (unsigned)baudrate);
+        goto fail;
+    }
+    if (tcgetattr(tty_fd, &tio) == 0) {
+        cfmakeraw(&tio);
+        tio.c_cflag |= CLOCAL | CREAD;
+        tio.c_cflag &= ~(CSTOPB | CRTSCTS);
+        tio.c_cc[VMIN] = 1;
+        tio.c_cc[VTIME] = 0;
+        cfsetispeed(&tio, speed);
+        cfsetospeed(&tio, speed);
+        if (tcsetattr(tty_fd, TCSANOW, &tio) != 0) {
+            printf("Cannot set TTY attributes\r\n");
+            goto fail;
+        }
+    } else {
+        printf("Cannot get TTY attributes\r\n");
+        goto fail;
+    }
+
+    /* On first function call, create a thread to read data from TTY */
+    if (!initialized) {
+        if (!lwcell_sys_sem_create(&stop_sem, 0)) {
+            printf("Cannot create TTY reader stop semaphore\r\n");
+            goto fail;
+        }
+        if (!lwcell_sys_thread_create(&thread_handle, "lwcell_ll_thread", uart_thread, NULL, 0, 0)) {
+            printf("Cannot create TTY reader thread\r\n");
+            goto fail;
+        }
+    }
+    return 1;
+
+fail:
+    /* Reader thread uses descriptors once running, keep them on later calls */
+    if (!initialized) {
+        if (lwcell_sys_sem_isvalid(&stop_sem)) {
+            lwcell_sys_sem_delete(&stop_sem);
+            lwcell_sys_sem_invalid(&stop_sem);
+        }
+        close_fds();
+    }
+    return 0;
+}
+
+/**
+ * \brief           Read all available data from TTY and send it to upper layer
+ * \return          `1` when TTY is still usable, `0` when it is gone (hang-up or read error)
+ */
+static uint8_t
+uart_read(void) {
+    while (1) {
+        ssize_t bytes_read = read(tty_fd, data_buffer, sizeof(data_buffer));
+        if (bytes_read > 0) {
+#if LWCELL_CFG_INPUT_USE_PROCESS
+            lwcell_input_process(data_buffer, (size_t)bytes_read);
+#else  /* LWCELL_CFG_INPUT_USE_PROCESS */
+            lwcell_input(data_buffer, (size_t)bytes_read);
+#endif /* !LWCELL_CFG_INPUT_USE_PROCESS */
+        } else if (bytes_read < 0 && errno == EINTR) {
+            continue;
+        } else {
+            /* End of file means device has gone, so does any error other than no data */
+            return bytes_read < 0 && (errno == EAGAIN || errno == EWOULDBLOCK);
+        }
+    }
+}
+
+/**
+ * \brief           UART thread
+ *
+ * When TTY goes away, it is removed from epoll set and stack is notified that device is not present.
+ * Thread runs until de-init requests stop or waiting for events fails,
+ * descriptors are closed by \ref lwcell_ll_deinit afterwards.
+ */
+static void
+uart_thread(void* param) {
+    struct epoll_event evs[2];
+    uint8_t run = 1;
+    int n;
+
+    LWCELL_UNUSED(param);
+
+    while (run) {
+        n = epoll_wait(epoll_fd, evs, LWCELL_ARRAYSIZE(evs), -1);
+        if (n < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            printf("TTY epoll wait failed: %s\r\n", strerror(errno));
+            lwcell_device_set_present(0, NULL, NULL, 0);
+            break;
+        }
+        for (int i = 0; i < n; ++i) {
+            if (evs[i].data.fd == stop_fd) { /* Stop requested by de-init */
+                run = 0;
+                break;
+            }
+
+            /* Read remaining data first, hang-up may come together with it */
+            if (!uart_read() || (evs[i].events & (EPOLLHUP | EPOLLERR))) {
+                printf("TTY disconnected\r\n");
+                epoll_ctl(epoll_fd, EPOLL_CTL_DEL, tty_fd, NULL);
+                lwcell_device_set_present(0, NULL, NULL, 0);
+            }
+        }
+    }
+    lwcell_sys_sem_release(&stop_sem);
+    lwcell_sys_thread_terminate(NULL);
+}
+
+/**
+ * \brief           Callback function called from initialization process
+ *
+ * \note            This function may be called multiple times if AT baudrate is changed from application.
+ *                  It is important that every configuration except AT baudrate is configured only once!
+ *
+ * \note            This function may be called from different threads in GSM stack when using OS.
+ *                  When \ref LWCELL_CFG_INPUT_USE_PROCESS is set to 1, this function may be called from user UART thread.
+ *
+ * \param[in,out]   ll: Pointer to \ref lwcell_ll_t structure to fill data for communication functions
+ * \return          \ref lwcellOK on success, member of \ref lwcellr_t enumeration otherwise
+ */
+lwcellr_t
+lwcell_ll_init(lwcell_ll_t* ll) {
+#if !LWCELL_CFG_MEM_CUSTOM
+    /* Step 1: Configure memory for dynamic allocations */
+    static uint8_t memory[0x10000]; /* Create memory for dynamic allocations with specific size */
+
+    /*
+     * Create memory region(s) of memory.
+     * If device has internal/external memory available,
+     * multiple memories may be used
+     */
+    lwcell_mem_region_t mem_regions[] = {{memory, sizeof(memory)}};
+    if (!initialized) {
+        lwcell_mem_assignmemory(mem_regions,
+                                LWCELL_ARRAYSIZE(mem_regions)); /* Assign memory for allocations to GSM library */
+    }
+#endif /* !LWCELL_CFG_MEM_CUSTOM */
+
+    /* Step 2: Set AT port send function to use when we have data to transmit */
+    if (!initialized) {
+        ll->send_fn = send_data; /* Set callback function to send data */
+    }
+
+    /* Step 3: Configure AT port to be able to send/receive data to/from GSM device */
+    if (!configure_uart(ll->uart.baudrate)) { /* Initialize UART for communication */
+        return lwcellERR;
+    }
+    initialized = 1;
+    return lwcellOK;
+}
+
+/**
+ * \brief           Callback function to de-init low-level communication part
+ *
+ * Function returns after reader thread has stopped and all descriptors are closed,
+ * so that \ref lwcell_ll_init may be called again right away.
+ *
+ * \param[in,out]   ll: Pointer to \ref lwcell_ll_t structure to fill data for communication functions
+ * \return          \ref lwcellOK on success, member of \ref lwcellr_t enumeration otherwise
+ */
+lwcellr_t
+lwcell_ll_deinit(lwcell_ll_t* ll) {
+    uint64_t val = 1;
+
+    LWCELL_UNUSED(ll);
+    if (!initialized) {
+        return lwcellOK;
+    }
+    if (write(stop_fd, &val, sizeof(val)) < 0) { /* Wake-up reader thread to stop */
+        return lwcellERR;
+    }
+
+    /* Wait reader thread to stop before descriptors are closed and may be opened again */
+    lwcell_sys_sem_wait(&stop_sem, 0);
+    lwcell_sys_sem_delete(&stop_sem);
+    lwcell_sys_sem_invalid(&stop_sem);
+    close_fds();
+    initialized = 0;
+    return lwcellOK;
+}
+
+#endif /* !__DOXYGEN__ */
@@ -0,0 +1,473 @@
+/**
+ * \file            lwcell_sys_posix.c
+ * \brief           System dependant functions for POSIX (pthreads)
+ */
+
+/*
+ * Copyright (c) 2023 Tilen MAJERLE
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without restriction,
+ * including without limitation the rights to use, copy, modify, merge,
+ * publish, distribute, sublicense, and/or sell copies of the Software,
+ * and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE
+ * AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * This file is part of LwCELL - Lightweight cellular modem AT library.
+ *
+ * Author:          Tilen MAJERLE <tilen@majerle.eu>
+ * Version:         v0.1.1
+ */
+#include <errno.h>
+#include <pthread.h>
+#include <sched.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "lwcell/lwcell_private.h"
+#include "system/lwcell_sys.h"
+
+#if !__DOXYGEN__
+
+/**
+ * \brief           Binary semaphore built on mutex and condition variable
+ */
+struct lwcell_posix_sem {
+    pthread_mutex_t mutex; /*!< Mutex protecting semaphore state */
+    pthread_cond_t cond;   /*!< Condition variable signalled on release */
+    uint8_t cnt;           /*!< Semaphore state, `0` or `1` */
+};
+
+/**
+ * \brief           Bounded ring message queue with condition variables
+ */
+struct lwcell_posix_mbox {
+    pthread_mutex_t mutex;     /*!< Mutex protecting queue state */
+    pthread_cond_t not_empty;  /*!< Condition signalled when entry is written */
+    pthread_cond_t not_full;   /*!< Condition signalled when entry is read */
+    size_t in, out, cnt, size; /*!< Ring indexes, current number of entries and capacity */
+    void* entries[];           /*!< Ring entries */
+};
+
+/**
+ * \brief           Thread start parameters
+ */
+typedef struct {
+    lwcell_sys_thread_fn fn; /*!< User thread function */
+    void* arg;               /*!< User thread argument */
+} posix_thread_start_t;
+
+static struct timespec sys_start_time;
+static pthread_mutex_t sys_mutex; /* Mutex for main protection */
+
+/**
+ * \brief           Initialize condition variable to use monotonic clock for timed waits
+ * \param[in]       cond: Condition variable to initialize
+ * \return          `1` on success, `0` otherwise
+ */
+static uint8_t
+cond_init(pthread_cond_t* cond) {
+    pthread_condattr_t attr;
+    uint8_t res;
+
+    if (pthread_condattr_init(&attr) != 0) {
+        return 0;
+    }
+    pthread_condattr_setclock(&attr, CLOCK_MONOTONIC);
+    res = pthread_cond_init(cond, &attr) == 0;
+    pthread_condattr_destroy(&attr);
+    return res;
+}
+
+/**
+ * \brief           Get absolute monotonic time after `timeout` milliseconds
+ * \param[out]      ts: Output absolute time
+ * \param[in]       timeout: Relative timeout in units of milliseconds
+ */
+static void
+abs_time_get(struct timespec* ts, uint32_t timeout) {
+    clock_gettime(CLOCK_MONOTONIC, ts);
+    ts->tv_sec += timeout / 1000;
+    ts->tv_nsec += (long)(timeout % 1000) * 1000000L;
+    if (ts->tv_nsec >= 1000000000L) {
+        ++ts->tv_sec;
+        ts->tv_nsec -= 1000000000L;
+    }
+}
+
+/**
+ * \brief           Wait for condition variable, forever or until absolute time
+ * \param[in]       cond: Condition variable
+ * \param[in]       mutex: Locked mutex associated with condition
+ * \param[in]       abs: Absolute timeout or `NULL` to wait forever
+ * \return          `1` when woken up, `0` on timeout
+ */
+static uint8_t
+cond_wait(pthread_cond_t* cond, pthread_mutex_t* mutex, const struct timespec* abs) {
+    if (abs == NULL) {
+        pthread_cond_wait(cond, mutex);
+        return 1;
+    }
+    return pthread_cond_timedwait(cond, mutex, abs) != ETIMEDOUT;
+}
+
+/**
+ * \brief           Thread trampoline to match pthread function signature
+ * \param[in]       arg: Allocated \ref posix_thread_start_t structure
+ * \return          Always `NULL`
+ */
+static void*
+thread_start(void* arg) {
+    posix_thread_start_t st = *(posix_thread_start_t*)arg;
+
+    free(arg);
+    st.fn(st.arg);
+    return NULL;
+}
+
+uint8_t
+lwcell_sys_init(void) {
+    pthread_mutexattr_t attr;
+
+    clock_gettime(CLOCK_MONOTONIC, &sys_start_time);
+
+    pthread_mutexattr_init(&attr);
+    pthread_mutexattr_settype(&attr, PTHREAD_MUTEX_RECURSIVE);
+    pthread_mutex_init(&sys_mutex, &attr);
+    pthread_mutexattr_destroy(&attr);
+    return 1;
+}
+
+uint32_t
+lwcell_sys_now(void) {
+    struct timespec now;
+
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (uint32_t)((now.tv_sec - sys_start_time.tv_sec) * 1000
+                      + (now.tv_nsec - sys_start_time.tv_nsec) / 1000000L);
+}
+
+uint8_t
+lwcell_sys_protect(void) {
+    return pthread_mutex_lock(&sys_mutex) == 0;
+}
+
+uint8_t
+lwcell_sys_unprotect(void) {
+    return pthread_mutex_unlock(&sys_mutex) == 0;
+}
+
+uint8_t
+lwcell_sys_mutex_create(lwcell_sys_mutex_t* p) {
+    pthread_mutexattr_t attr;
+
+    *p = malloc(sizeof(**p));
+    if (*p == NULL) {
+        return 0;
+    }
+    pthread_mutexattr_init(&attr);
+    pthread_mutexattr_settype(&attr, PTHREAD_MUTEX_RECURSIVE);
+    if (pthread_mutex_init(*p, &attr) != 0) {
+        free(*p);
+        *p = LWCELL_SYS_MUTEX_NULL;
+    }
+    pthread_mutexattr_destroy(&attr);
+    return *p != NULL;
+}
+
+uint8_t
+lwcell_sys_mutex_delete(lwcell_sys_mutex_t* p) {
+    pthread_mutex_destroy(*p);
+    free(*p);
+    return 1;
+}
+
+uint8_t
+lwcell_sys_mutex_lock(lwcell_sys_mutex_t* p) {
+    return pthread_mutex_lock(*p) == 0;
+}
+
+uint8_t
+lwcell_sys_mutex_unlock(lwcell_sys_mutex_t* p) {
+    return pthread_mutex_unlock(*p) == 0;
+}
+
+uint8_t
+lwcell_sys_mutex_isvalid(lwcell_sys_mutex_t* p) {
+    return p != NULL && *p != NULL;
+}
+
+uint8_t
+lwcell_sys_mutex_invalid(lwcell_sys_mutex_t* p) {
+    *p = LWCELL_SYS_MUTEX_NULL;
+    return 1;
+}
+
+uint8_t
+lwcell_sys_sem_create(lwcell_sys_sem_t* p, uint8_t cnt) {
+    struct lwcell_posix_sem* sem;
+
+    *p = LWCELL_SYS_SEM_NULL;
+    sem = malloc(sizeof(*sem));
+    if (sem != NULL) {
+        if (pthread_mutex_init(&sem->mutex, NULL) != 0) {
+            free(sem);
+            return 0;
+        }
+        if (!cond_init(&sem->cond)) {
+            pthread_mutex_destroy(&sem->mutex);
+            free(sem);
+            return 0;
+        }
+        sem->cnt = !!cnt;
+        *p = sem;
+    }
+    return *p != NULL;
+}
+
+uint8_t
+lwcell_sys_sem_delete(lwcell_sys_sem_t* p) {
+    struct lwcell_posix_sem* sem = *p;
+
+    pthread_cond_destroy(&sem->cond);
+    pthread_mutex_destroy(&sem->mutex);
+    free(sem);
+    return 1;
+}
+
+uint32_t
+lwcell_sys_sem_wait(lwcell_sys_sem_t* p, uint32_t timeout) {
+    struct lwcell_posix_sem* sem = *p;
+    struct timespec abs;
+    uint32_t time = lwcell_sys_now();
+
+    if (timeout > 0) {
+        abs_time_get(&abs, timeout);
+    }
+    pthread_mutex_lock(&sem->mutex);
+    while (sem->cnt == 0) {
+        if (!cond_wait(&sem->cond, &sem->mutex, timeout > 0 ? &abs : NULL)) {
+            pthread_mutex_unlock(&sem->mutex);
+            return LWCELL_SYS_TIMEOUT;
+        }
+    }
+    sem->cnt = 0;
+    pthread_mutex_unlock(&sem->mutex);
+    return lwcell_sys_now() - time;
+}
+
+uint8_t
+lwcell_sys_sem_release(lwcell_sys_sem_t* p) {
+    struct lwcell_posix_sem* sem = *p;
+
+    pthread_mutex_lock(&sem->mutex);
+    sem->cnt = 1;
+    pthread_cond_signal(&sem->cond);
+    pthread_mutex_unlock(&sem->mutex);
+    return 1;
+}
+
+uint8_t
+lwcell_sys_sem_isvalid(lwcell_sys_sem_t* p) {
+    return p != NULL && *p != NULL;
+}
+
+uint8_t
+lwcell_sys_sem_invalid(lwcell_sys_sem_t* p) {
+    *p = LWCELL_SYS_SEM_NULL;
+    return 1;
+}
+
+uint8_t
+lwcell_sys_mbox_create(lwcell_sys_mbox_t* b, size_t size) {
+    struct lwcell_posix_mbox* mbox;
+
+    *b = LWCELL_SYS_MBOX_NULL;
+    mbox = malloc(sizeof(*mbox) + size * sizeof(void*));
+    if (mbox != NULL) {
+        memset(mbox, 0x00, sizeof(*mbox));
+        mbox->size = size;
+        if (pthread_mutex_init(&mbox->mutex, NULL) != 0) {
+            free(mbox);
+            return 0;
+        }
+        if (!cond_init(&mbox->not_empty) || !cond_init(&mbox->not_full)) {
+            pthread_mutex_destroy(&mbox->mutex);
+            free(mbox);
+            return 0;
+        }
+        *b = mbox;
+    }
+    return *b != NULL;
+}
+
+uint8_t
+lwcell_sys_mbox_delete(lwcell_sys_mbox_t* b) {
+    struct lwcell_posix_mbox* mbox = *b;
+
+    pthread_cond_destroy(&mbox->not_empty);
+    pthread_cond_destroy(&mbox->not_full);
+    pthread_mutex_destroy(&mbox->mutex);
+    free(mbox);
+    return 1;
+}
+
+uint32_t
+lwcell_sys_mbox_put(lwcell_sys_mbox_t* b, void* m) {
+    struct lwcell_posix_mbox* mbox = *b;
+    uint32_t time = lwcell_sys_now();
+
+    pthread_mutex_lock(&mbox->mutex);
+    while (mbox->cnt == mbox->size) {
+        pthread_cond_wait(&mbox->not_full, &mbox->mutex);
+    }
+    mbox->entries[mbox->in] = m;
+    if (++mbox->in >= mbox->size) {
+        mbox->in = 0;
+    }
+    ++mbox->cnt;
+    pthread_cond_signal(&mbox->not_empty);
+    pthread_mutex_unlock(&mbox->mutex);
+    return lwcell_sys_now() - time;
+}
+
+uint32_t
+lwcell_sys_mbox_get(lwcell_sys_mbox_t* b, void** m, uint32_t timeout) {
+    struct lwcell_posix_mbox* mbox = *b;
+    struct timespec abs;
+    uint32_t time = lwcell_sys_now();
+
+    if (timeout > 0) {
+        abs_time_get(&abs, timeout);
+    }
+    pthread_mutex_lock(&mbox->mutex);
+    while (mbox->cnt == 0) {
+        if (!cond_wait(&mbox->not_empty, &mbox->mutex, timeout > 0 ? &abs : NULL)) {
+            pthread_mutex_unlock(&mbox->mutex);
+            return LWCELL_SYS_TIMEOUT;
+        }
+    }
+    *m = mbox->entries[mbox->out];
+    if (++mbox->out >= mbox->size) {
+        mbox->out = 0;
+    }
+    --mbox->cnt;
+    pthread_cond_signal(&mbox->not_full);
+    pthread_mutex_unlock(&mbox->mutex);
+    return lwcell_sys_now() - time;
+}
+
+uint8_t
+lwcell_sys_mbox_putnow(lwcell_sys_mbox_t* b, void* m) {
+    struct lwcell_posix_mbox* mbox = *b;
+
+    pthread_mutex_lock(&mbox->mutex);
+    if (mbox->cnt == mbox->size) {
+        pthread_mutex_unlock(&mbox->mutex);
+        return 0;
+    }
+    mbox->entries[mbox->in] = m;
+    if (++mbox->in >= mbox->size) {
+        mbox->in = 0;
+    }
+    ++mbox->cnt;
+    pthread_cond_signal(&mbox->not_empty);
+    pthread_mutex_unlock(&mbox->mutex);
+    return 1;
+}
+
+uint8_t
+lwcell_sys_mbox_getnow(lwcell_sys_mbox_t* b, void** m) {
+    struct lwcell_posix_mbox* mbox = *b;
+
+    pthread_mutex_lock(&mbox->mutex);
+    if (mbox->cnt == 0) {
+        pthread_mutex_unlock(&mbox->mutex);
+        return 0;
+    }
+    *m = mbox->entries[mbox->out];
+    if (++mbox->out >= mbox->size) {
+        mbox->out = 0;
+    }
+    --mbox->cnt;
+    pthread_cond_signal(&mbox->not_full);
+    pthread_mutex_unlock(&mbox->mutex);
+    return 1;
+}
+
+uint8_t
+lwcell_sys_mbox_isvalid(lwcell_sys_mbox_t* b) {
+    return b != NULL && *b != NULL; /* Return status if message box is valid */
+}
+
+uint8_t
+lwcell_sys_mbox_invalid(lwcell_sys_mbox_t* b) {
+    *b = LWCELL_SYS_MBOX_NULL; /* Invalidate message box */
+    return 1;
+}
+
+uint8_t
+lwcell_sys_thread_create(lwcell_sys_thread_t* t, const char* name, lwcell_sys_thread_fn thread_func, void* const arg,
+                         size_t stack_size, lwcell_sys_thread_prio_t prio) {
+    posix_thread_start_t* st;
+    pthread_attr_t attr;
+    pthread_t thread;
+    int res;
+
+    LWCELL_UNUSED(name);
+    LWCELL_UNUSED(prio);
+
+    st = malloc(sizeof(*st));
+    if (st == NULL) {
+        return 0;
+    }
+    st->fn = thread_func;
+    st->arg = arg;
+
+    pthread_attr_init(&attr);
+    pthread_attr_setdetachstate(&attr, PTHREAD_CREATE_DETACHED);
+    if (stack_size > 0) {
+        pthread_attr_setstacksize(&attr, stack_size);
+    }
+    res = pthread_create(&thread, &attr, thread_start, st);
+    pthread_attr_destroy(&attr);
+    if (res != 0) {
+        free(st);
+        return 0;
+    }
+    if (t != NULL) {
+        *t = thread;
+    }
+    return 1;
+}
+
+uint8_t
+lwcell_sys_thread_terminate(lwcell_sys_thread_t* t) {
+    if (t == NULL) { /* Shall we terminate ourself? */
+        pthread_exit(NULL);
+    } else {
+        pthread_cancel(*t);
+    }
+    return 1;
+}
+
+uint8_t
+lwcell_sys_thread_yield(void) {
+    sched_yield();
+    return 1;
+}
+
+#endif /* !__DOXYGEN__ */
@@ -0,0 +1,1589 @@
+/**
+ * \file            lwcell_modem_sim.c
+ * \brief           Host-side SIM800/SIM900 AT modem simulator over pseudo-terminal
+ */
+
+/*
+ * Copyright (c) 2023 Tilen MAJERLE
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without restriction,
+ * including without limitation the rights to use, copy, modify, merge,
+ * publish, distribute, sublicense, and/or sell copies of the Software,
+ * and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE
+ * AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * This file is part of LwCELL - Lightweight cellular modem AT library.
+ *
+ * Author:          Tilen MAJERLE <tilen@majerle.eu>
+ * Version:         v0.1.1
+ */
+#define _GNU_SOURCE
+#include <errno.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <signal.h>
+#include <stdarg.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <termios.h>
+#include <time.h>
+#include <unistd.h>
+
+#define SIM_MAX_CONNS 6
+#define SIM_LINE_MAX  600
+#define SIM_DATA_MAX  1460
+#define SIM_SMS_MAX   20
+#define SIM_OUT_CHUNK 2048
+#define SIM_ACK_MAX   32
+#define SIM_RX_MAX    16384
+#define SIM_CMUX_N1   1024
+#define SIM_PPP_MRU   1500
+
+#define CMUX_FLAG 0xF9 /*!< Frame flag */
+#define CMUX_SABM 0x2F /*!< Open channel */
+#define CMUX_UA   0x63 /*!< Acknowledge */
+#define CMUX_DISC 0x43 /*!< Close channel */
+#define CMUX_UIH  0xEF /*!< Data frame */
+#define CMUX_PF   0x10 /*!< Poll/final bit */
+
+#define PPP_FLAG       0x7E   /*!< Frame flag */
+#define PPP_ESC        0x7D   /*!< Control escape */
+#define PPP_PROTO_IP   0x0021 /*!< IPv4 packet */
+#define PPP_PROTO_LCP  0xC021 /*!< Link control protocol */
+#define PPP_PROTO_PAP  0xC023 /*!< Password authentication protocol */
+#define PPP_PROTO_IPCP 0x8021 /*!< IP control protocol */
+
+/**
+ * \brief           Input parser mode
+ */
+typedef enum {
+    MODE_CMD,    /*!< Waiting for AT command line */
+    MODE_DATA,   /*!< Receiving CIPSEND payload */
+    MODE_SMS,    /*!< Receiving CMGS text until CTRL+Z */
+    MODE_TRANSP, /*!< Transparent data mode, all data belong to connection `0` */
+    MODE_PPP,    /*!< PPP data mode after ATD*99# */
+} sim_mode_t;
+
+/**
+ * \brief           Pending output chunk, released to host at `due` time
+ */
+typedef struct sim_out {
+    struct sim_out* next; /*!< Next chunk in queue */
+    uint64_t due;         /*!< Release time in microseconds */
+    size_t len, ptr;      /*!< Chunk length and already written bytes */
+    uint8_t data[];       /*!< Chunk data */
+} sim_out_t;
+
+/**
+ * \brief           Simulated connection
+ */
+typedef struct {
+    uint8_t active;                    /*!< Connection is connected */
+    char type[4];                      /*!< Connection type, `TCP` or `UDP` */
+    char host[64];                     /*!< Remote host */
+    unsigned port;                     /*!< Remote port */
+    unsigned long tx;                  /*!< Total number of sent bytes */
+    unsigned long ack;                 /*!< Number of sent bytes acknowledged by remote side */
+    unsigned long ack_tx[SIM_ACK_MAX]; /*!< Pending acknowledges, value of `tx` to acknowledge */
+    uint64_t ack_due[SIM_ACK_MAX];     /*!< Pending acknowledges, time of acknowledge */
+    size_t ack_cnt;                    /*!< Number of pending acknowledges */
+    uint8_t rx[SIM_RX_MAX];            /*!< Received data waiting for CIPRXGET in manual receive mode */
+    size_t rx_len;                     /*!< Number of bytes in `rx` buffer */
+} sim_conn_t;
+
+/**
+ * \brief           Stored SMS message
+ */
+typedef struct {
+    uint8_t used;   /*!< Entry holds message */
+    uint8_t read;   /*!< Message has been read */
+    char num[24];   /*!< Sender or receiver number */
+    char text[161]; /*!< Message text */
+} sim_sms_t;
+
+/**
+ * \brief           Simulator configuration
+ */
+typedef struct {
+    uint32_t latency_ms; /*!< Delay before any response is released */
+    uint32_t ack_ms;     /*!< Delay before remote side acknowledges sent data */
+    uint32_t bandwidth;  /*!< Output bandwidth in bytes per second, `0` for unlimited */
+    uint32_t urc_ms;     /*!< Interval of +CREG flap URCs, `0` to disable */
+    uint32_t recv_ms;    /*!< Interval of +RECEIVE injection per active connection, `0` to disable */
+    uint32_t recv_size;  /*!< Payload size of injected +RECEIVE */
+    uint32_t accept_ms;  /*!< Interval of incoming connections while server is enabled, `0` to disable */
+    uint32_t guard_ms;   /*!< Guard time around `+++` escape sequence in transparent mode */
+    uint8_t echo_data;   /*!< Echo every sent payload back as +RECEIVE */
+    uint8_t verbose;     /*!< Print traffic to stderr */
+    const char* link;    /*!< Optional symlink path to slave device */
+} sim_cfg_t;
+
+/**
+ * \brief           Simulator statistics
+ */
+typedef struct {
+    uint64_t cmds;       /*!< Number of processed AT commands */
+    uint64_t bytes_in;   /*!< Bytes received from host */
+    uint64_t bytes_out;  /*!< Bytes written to host */
+    uint64_t send_ok;    /*!< Number of successful CIPSEND commands */
+    uint64_t send_bytes; /*!< Number of payload bytes received with CIPSEND */
+    uint64_t recv_urcs;  /*!< Number of injected +RECEIVE URCs */
+    uint64_t recv_bytes; /*!< Number of payload bytes injected with +RECEIVE */
+    uint64_t recv_drop;  /*!< Number of bytes dropped on full manual receive buffer */
+    uint64_t accepts;    /*!< Number of incoming connections to server */
+    uint64_t sms_sent;   /*!< Number of sent SMS messages */
+    uint64_t cmux_in;    /*!< Number of valid multiplexer frames from host */
+    uint64_t cmux_bad;   /*!< Number of multiplexer frames with invalid length or checksum */
+    uint64_t ppp_in;     /*!< Number of valid PPP frames from host */
+    uint64_t ppp_bad;    /*!< Number of PPP frames with invalid checksum */
+    uint64_t ppp_ip;     /*!< Number of IP packets looped back on PPP link */
+} sim_stats_t;
+
+static sim_cfg_t cfg = {.recv_size = 512, .guard_ms = 1000};
+static sim_stats_t stats;
+static volatile sig_atomic_t running = 1;
+static int master_fd = -1;
+static uint64_t start_time;
+
+static sim_mode_t mode = MODE_CMD;
+static char line[SIM_LINE_MAX];
+static size_t line_len;
+static uint8_t lf_skip;
+static uint8_t data_buff[SIM_DATA_MAX];
+static size_t data_len, data_exp;
+static uint8_t data_conn;
+static char sms_text[161];
+static size_t sms_len;
+
+static uint8_t echo = 1;
+static uint8_t attached, ip_ready, cipmux, cipqsend, ciprxget, cipmode;
+static uint64_t transp_last_in;
+static uint8_t transp_plus;
+static uint8_t creg_urc, creg_stat = 1;
+static sim_conn_t conns[SIM_MAX_CONNS];
+static sim_sms_t sms[SIM_SMS_MAX] = {
+    {1, 1, "+38640111111", "Hello from simulator"},
+    {1, 0, "+38640222222", "Second message"},
+    {1, 0, "+38640333333", "Third message, unread"},
+};
+static const struct {
+    const char* num;
+    const char* name;
+} pb[] = {
+    {"+38640111111", "Alice"},
+    {"+38640222222", "Bob"},
+    {"+38640333333", "Carol"},
+};
+
+static sim_out_t *out_first, *out_last;
+static uint64_t out_last_due;
+static double tokens;
+static uint64_t tokens_time;
+static uint64_t next_urc, next_recv, next_accept;
+static unsigned server_port;
+static uint8_t cmux;
+static size_t cmux_n1;
+static uint8_t cmux_rx[SIM_CMUX_N1 + 8];
+static size_t cmux_rx_len;
+static uint8_t cmux_rx_open;
+static uint8_t ppp_rx[SIM_PPP_MRU + 8];
+static size_t ppp_rx_len;
+static uint8_t ppp_rx_esc, ppp_id;
+
+/**
+ * \brief           Get monotonic time in microseconds
+ */
+static uint64_t
+now_us(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000ULL + (uint64_t)ts.tv_nsec / 1000ULL;
+}
+
+/**
+ * \brief           Queue raw data to host, released after configured latency and additional delay
+ * \param[in]       data: Data to send
+ * \param[in]       len: Length of data in units of bytes
+ * \param[in]       delay_us: Additional delay in microseconds
+ */
+static void
+out_raw(const void* data, size_t len, uint64_t delay_us) {
+    sim_out_t* o;
+    uint64_t due;
+
+    if (len == 0) {
+        return;
+    }
+    o = malloc(sizeof(*o) + len);
+    if (o == NULL) {
+        return;
+    }
+    memcpy(o->data, data, len);
+    o->len = len;
+    o->ptr = 0;
+    o->next = NULL;
+
+    /* Keep output ordered, later chunks may not overtake earlier ones */
+    due = now_us() + (uint64_t)cfg.latency_ms * 1000ULL + delay_us;
+    if (due < out_last_due) {
+        due = out_last_due;
+    }
+    o->due = out_last_due = due;
+    if (out_last != NULL) {
+        out_last->next = o;
+    } else {
+        out_first = o;
+    }
+    out_last = o;
+}
+
+/**
+ * \brief           Calculate 3GPP 27.010 frame check sequence
+ * \param[in]       d: Data covered by checksum
+ * \param[in]       len: Length of data
+ * \return          Checksum, before final inversion
+ */
+static uint8_t
+cmux_fcs(const uint8_t* d, size_t len) {
+    uint8_t fcs = 0xFF;
+
+    while (len-- > 0) {
+        fcs ^= *d++;
+        for (int i = 0; i < 8; ++i) {
+            fcs = (fcs & 0x01) ? (uint8_t)((fcs >> 1) ^ 0xE0) : (uint8_t)(fcs >> 1);
+        }
+    }
+    return fcs;
+}
+
+/**
+ * \brief           Queue single multiplexer frame to host
+ * \param[in]       dlci: Channel number
+ * \param[in]       ctrl: Control field
+ * \param[in]       data: Information field
+ * \param[in]       len: Length of information field
+ * \param[in]       delay_us: Additional delay in microseconds
+ */
+static void
+cmux_out_frame(uint8_t dlci, uint8_t ctrl, const void* data, size_t len, uint64_t delay_us) {
+    uint8_t f[SIM_CMUX_N1 + 8];
+    size_t hl;
+
+    f[0] = CMUX_FLAG;
+    f[1] = (uint8_t)((dlci << 2) | 0x03);
+    f[2] = ctrl;
+    if (len < 0x80) {
+        f[3] = (uint8_t)((len << 1) | 0x01);
+        hl = 4;
+    } else {
+        f[3] = (uint8_t)(len << 1);
+        f[4] = (uint8_t)(len >> 7);
+        hl = 5;
+    }
+    memcpy(&f[hl], data, len);
+    f[hl + len] = (uint8_t)(0xFF - cmux_fcs(&f[1], hl - 1));
+    f[hl + len + 1] = CMUX_FLAG;
+    out_raw(f, hl + len + 2, delay_us);
+}
+
+/**
+ * \brief           Queue data to host, released after configured latency and additional delay
+ *
+ * While multiplexer is active, data are sent on AT channel
+ *
+ * \param[in]       data: Data to send
+ * \param[in]       len: Length of data in units of bytes
+ * \param[in]       delay_us: Additional delay in microseconds
+ */
+static void
+out_data_delayed(const void* data, size_t len, uint64_t delay_us) {
+    const uint8_t* d = data;
+
+    if (!cmux) {
+        out_raw(data, len, delay_us);
+        return;
+    }
+    while (len > 0) {
+        size_t chunk = len > cmux_n1 ? cmux_n1 : len;
+
+        cmux_out_frame(1, CMUX_UIH, d, chunk, delay_us);
+        d += chunk;
+        len -= chunk;
+    }
+}
+
+/**
+ * \brief           Queue data to host, released after configured latency
+ * \param[in]       data: Data to send
+ * \param[in]       len: Length of data in units of bytes
+ */
+static void
+out_data(const void* data, size_t len) {
+    out_data_delayed(data, len, 0);
+}
+
+/**
+ * \brief           Queue formatted string to host
+ * \param[in]       fmt: Format string
+ */
+static void
+out_printf(const char* fmt, ...) {
+    char buff[SIM_OUT_CHUNK];
+    va_list ap;
+    int len;
+
+    va_start(ap, fmt);
+    len = vsnprintf(buff, sizeof(buff), fmt, ap);
+    va_end(ap);
+    if (len > 0) {
+        out_data(buff, (size_t)len > sizeof(buff) - 1 ? sizeof(buff) - 1 : (size_t)len);
+    }
+}
+
+#define OUT_LINE(fmt, ...) out_printf("\r\n" fmt "\r\n", ##__VA_ARGS__)
+#define OUT_OK()           OUT_LINE("OK")
+#define OUT_ERROR()        OUT_LINE("ERROR")
+
+/**
+ * \brief           Write due output to host, respecting bandwidth limit
+ * \return          Time in microseconds until next output is due, `-1` when queue is empty
+ */
+static int64_t
+out_process(void) {
+    uint64_t now = now_us();
+
+    /* Refill token bucket */
+    if (cfg.bandwidth > 0) {
+        tokens += (double)(now - tokens_time) * cfg.bandwidth / 1000000.0;
+        if (tokens > cfg.bandwidth / 10.0 + SIM_OUT_CHUNK) { /* Allow burst of 100ms at most */
+            tokens = cfg.bandwidth / 10.0 + SIM_OUT_CHUNK;
+        }
+    }
+    tokens_time = now;
+
+    while (out_first != NULL) {
+        sim_out_t* o = out_first;
+        size_t len = o->len - o->ptr;
+        ssize_t w;
+
+        if (o->due > now) {
+            return (int64_t)(o->due - now);
+        }
+        if (cfg.bandwidth > 0) {
+            if (tokens < 1.0) {
+                return (int64_t)(1000000.0 / cfg.bandwidth) + 1;
+            }
+            if ((double)len > tokens) {
+                len = (size_t)tokens;
+            }
+        }
+        w = write(master_fd, &o->data[o->ptr], len);
+        if (w <= 0) {
+            return 1000; /* Host not reading, retry later */
+        }
+        if (cfg.verbose) {
+            fprintf(stderr, "\x1b[32m%.*s\x1b[0m", (int)w, (const char*)&o->data[o->ptr]);
+        }
+        stats.bytes_out += (uint64_t)w;
+        if (cfg.bandwidth > 0) {
+            tokens -= (double)w;
+        }
+        o->ptr += (size_t)w;
+        if (o->ptr == o->len) {
+            out_first = o->next;
+            if (out_first == NULL) {
+                out_last = NULL;
+            }
+            free(o);
+        }
+    }
+    return -1;
+}
+
+/**
+ * \brief           Parse unsigned number and advance pointer
+ * \param[in,out]   s: Pointer to string pointer
+ * \return          Parsed number
+ */
+static unsigned long
+parse_num(const char** s) {
+    unsigned long n = 0;
+
+    while (**s == ' ' || **s == ',' || **s == '"') {
+        ++*s;
+    }
+    while (**s >= '0' && **s <= '9') {
+        n = 10 * n + (unsigned long)(**s - '0');
+        ++*s;
+    }
+    return n;
+}
+
+/**
+ * \brief           Parse quoted string and advance pointer
+ * \param[in,out]   s: Pointer to string pointer
+ * \param[out]      dst: Output buffer
+ * \param[in]       dst_len: Output buffer length
+ */
+static void
+parse_str(const char** s, char* dst, size_t dst_len) {
+    size_t i = 0;
+
+    while (**s == ' ' || **s == ',') {
+        ++*s;
+    }
+    if (**s == '"') {
+        ++*s;
+    }
+    while (**s && **s != '"' && **s != ',') {
+        if (i < dst_len - 1) {
+            dst[i++] = **s;
+        }
+        ++*s;
+    }
+    if (**s == '"') {
+        ++*s;
+    }
+    dst[i] = 0;
+}
+
+/**
+ * \brief           Queue +RECEIVE URC with payload on connection
+ *
+ * In manual receive mode, payload is stored to connection buffer instead
+ * and `+CIPRXGET: 1` is reported when buffer was empty before
+ *
+ * \param[in]       num: Connection number
+ * \param[in]       data: Payload or `NULL` for generated pattern
+ * \param[in]       len: Payload length
+ */
+static void
+out_receive(uint8_t num, const uint8_t* data, size_t len) {
+    uint8_t buff[SIM_DATA_MAX];
+
+    if (len > sizeof(buff)) {
+        len = sizeof(buff);
+    }
+    if (data == NULL) {
+        for (size_t i = 0; i < len; ++i) {
+            buff[i] = (uint8_t)('A' + (i % 26));
+        }
+        data = buff;
+    }
+    if (cipmode && !cipmux) {
+        if (mode != MODE_TRANSP) { /* Data received in command mode are not kept */
+            stats.recv_drop += len;
+            return;
+        }
+        out_data(data, len);
+    } else if (ciprxget) {
+        sim_conn_t* c = &conns[num];
+
+        if (len > SIM_RX_MAX - c->rx_len) { /* Buffer full, drop whole packet */
+            stats.recv_drop += len;
+            return;
+        }
+        if (c->rx_len == 0 && len > 0) {
+            OUT_LINE("+CIPRXGET: 1,%u", (unsigned)num);
+        }
+        memcpy(&c->rx[c->rx_len], data, len);
+        c->rx_len += len;
+    } else {
+        out_printf("\r\n+RECEIVE,%u,%u:\r\n", (unsigned)num, (unsigned)len);
+        out_data(data, len);
+    }
+    ++stats.recv_urcs;
+    stats.recv_bytes += len;
+}
+
+/**
+ * \brief           Account sent payload, acknowledged by remote side after configured delay
+ * \param[in]       c: Connection handle
+ * \param[in]       len: Payload length
+ */
+static void
+conn_sent(sim_conn_t* c, size_t len) {
+    c->tx += len;
+    if (c->ack_cnt == SIM_ACK_MAX) { /* Queue full, treat oldest as acknowledged */
+        c->ack = c->ack_tx[0];
+        memmove(&c->ack_tx[0], &c->ack_tx[1], (SIM_ACK_MAX - 1) * sizeof(c->ack_tx[0]));
+        memmove(&c->ack_due[0], &c->ack_due[1], (SIM_ACK_MAX - 1) * sizeof(c->ack_due[0]));
+        --c->ack_cnt;
+    }
+    c->ack_tx[c->ack_cnt] = c->tx;
+    c->ack_due[c->ack_cnt] = now_us() + (uint64_t)cfg.ack_ms * 1000ULL;
+    ++c->ack_cnt;
+}
+
+/**
+ * \brief           Move due acknowledges of connection to acknowledged bytes
+ * \param[in]       c: Connection handle
+ */
+static void
+conn_ack_update(sim_conn_t* c) {
+    uint64_t now = now_us();
+    size_t i;
+
+    for (i = 0; i < c->ack_cnt && c->ack_due[i] <= now; ++i) {
+        c->ack = c->ack_tx[i];
+    }
+    if (i > 0) {
+        memmove(&c->ack_tx[0], &c->ack_tx[i], (c->ack_cnt - i) * sizeof(c->ack_tx[0]));
+        memmove(&c->ack_due[0], &c->ack_due[i], (c->ack_cnt - i) * sizeof(c->ack_due[0]));
+        c->ack_cnt -= i;
+    }
+}
+
+/**
+ * \brief           Send +CIPSTATUS response with state and connection lines
+ */
+static void
+cmd_cipstatus(void) {
+    OUT_OK();
+    if (!ip_ready) {
+        OUT_LINE("STATE: IP INITIAL");
+        return;
+    }
+    OUT_LINE("STATE: IP PROCESSING");
+    for (unsigned i = 0; i < SIM_MAX_CONNS; ++i) {
+        if (conns[i].active) {
+            out_printf("C: %u,0,\"%s\",\"%s\",\"%u\",\"CONNECTED\"\r\n", i, conns[i].type, "93.184.216.34",
+                       conns[i].port);
+        } else {
+            out_printf("C: %u,,\"\",\"\",\"\",\"INITIAL\"\r\n", i);
+        }
+    }
+}
+
+/**
+ * \brief           Print SMS entry header and text
+ * \param[in]       idx: Entry index
+ * \param[in]       list: Set to `1` for +CMGL format, `0` for +CMGR
+ */
+static void
+out_sms(size_t idx, uint8_t list) {
+    const char* stat = sms[idx].read ? "REC READ" : "REC UNREAD";
+
+    if (list) {
+        out_printf("\r\n+CMGL: %u,\"%s\",\"%s\",\"\",\"23/01/01,12:00:00+04\"\r\n%s\r\n", (unsigned)(idx + 1), stat,
+                   sms[idx].num, sms[idx].text);
+    } else {
+        out_printf("\r\n+CMGR: \"%s\",\"%s\",\"\",\"23/01/01,12:00:00+04\"\r\n%s\r\n", stat, sms[idx].num,
+                   sms[idx].text);
+    }
+}
+
+/**
+ * \brief           Get number of stored SMS messages
+ */
+static unsigned
+sms_count(void) {
+    unsigned cnt = 0;
+    for (size_t i = 0; i < SIM_SMS_MAX; ++i) {
+        cnt += sms[i].used;
+    }
+    return cnt;
+}
+
+/**
+ * \brief           Check if command starts with prefix and skip it
+ * \param[in,out]   p: Pointer to command pointer, advanced on match
+ * \param[in]       cmd: Command prefix to check
+ * \return          `1` on match, `0` otherwise
+ */
+static uint8_t
+is_cmd(const char** p, const char* cmd) {
+    size_t len = strlen(cmd);
+    if (!strncmp(*p, cmd, len)) {
+        *p += len;
+        return 1;
+    }
+    return 0;
+}
+
+/**
+ * \brief           Calculate RFC 1662 frame check sequence
+ * \param[in]       d: Data covered by checksum
+ * \param[in]       len: Length of data
+ * \return          Checksum, before final inversion
+ */
+static uint16_t
+ppp_fcs(const uint8_t* d, size_t len) {
+    uint16_t fcs = 0xFFFF;
+
+    while (len-- > 0) {
+        fcs ^= *d++;
+        for (int i = 0; i < 8; ++i) {
+            fcs = (fcs & 0x01) ? (uint16_t)((fcs >> 1) ^ 0x8408) : (uint16_t)(fcs >> 1);
+        }
+    }
+    return fcs;
+}
+
+/**
+ * \brief           Queue single PPP frame to host
+ *
+ * LCP frames escape all control characters, others only flag and escape bytes,
+ * as host requests empty control character map
+ *
+ * \param[in]       proto: Protocol field
+ * \param[in]       data: Information field
+ * \param[in]       len: Length of information field
+ */
+static void
+ppp_out_frame(uint16_t proto, const uint8_t* data, size_t len) {
+    uint8_t f[SIM_PPP_MRU + 8], out[2 * (SIM_PPP_MRU + 8) + 2];
+    size_t fl = 0, ol = 0;
+    uint16_t fcs;
+
+    f[fl++] = 0xFF;
+    f[fl++] = 0x03;
+    f[fl++] = (uint8_t)(proto >> 8);
+    f[fl++] = (uint8_t)proto;
+    memcpy(&f[fl], data, len);
+    fl += len;
+    fcs = (uint16_t)~ppp_fcs(f, fl);
+    f[fl++] = (uint8_t)fcs;
+    f[fl++] = (uint8_t)(fcs >> 8);
+
+    out[ol++] = PPP_FLAG;
+    for (size_t i = 0; i < fl; ++i) {
+        if (f[i] == PPP_FLAG || f[i] == PPP_ESC || (proto == PPP_PROTO_LCP && f[i] < 0x20)) {
+            out[ol++] = PPP_ESC;
+            out[ol++] = f[i] ^ 0x20;
+        } else {
+            out[ol++] = f[i];
+        }
+    }
+    out[ol++] = PPP_FLAG;
+    out_data(out, ol);
+}
+
+/**
+ * \brief           Queue control protocol packet to host
+ * \param[in]       proto: Protocol field
+ * \param[in]       code: Packet code
+ * \param[in]       id: Packet identifier
+ * \param[in]       data: Packet data after header
+ * \param[in]       len: Length of packet data
+ */
+static void
+ppp_out_cp(uint16_t proto, uint8_t code, uint8_t id, const uint8_t* data, size_t len) {
+    uint8_t pkt[SIM_PPP_MRU];
+
+    pkt[0] = code;
+    pkt[1] = id;
+    pkt[2] = (uint8_t)((len + 4) >> 8);
+    pkt[3] = (uint8_t)(len + 4);
+    memcpy(&pkt[4], data, len);
+    ppp_out_frame(proto, pkt, len + 4);
+}
+
+/**
+ * \brief           Enter PPP data mode and start LCP negotiation, requiring PAP authentication
+ */
+static void
+ppp_start(void) {
+    static const uint8_t opts[] = {0x02, 0x06, 0x00, 0x00, 0x00, 0x00, 0x03, 0x04,
+                                   0xC0, 0x23, 0x05, 0x06, 0x12, 0x34, 0x56, 0x78};
+
+    mode = MODE_PPP;
+    ppp_rx_len = ppp_rx_esc = 0;
+    ppp_out_cp(PPP_PROTO_LCP, 0x01, ++ppp_id, opts, sizeof(opts));
+}
+
+/**
+ * \brief           Process complete PPP frame from host
+ *
+ * Every configure request of host is acknowledged, except IPCP addresses of `0.0.0.0`
+ * which get address `10.0.0.2` and DNS servers `8.8.8.8` and `8.8.4.4` suggested.
+ * IP packets are sent back with swapped source and destination address
+ *
+ * \param[in]       f: Frame without flags, with checksum
+ * \param[in]       len: Frame length
+ */
+static void
+ppp_frame(uint8_t* f, size_t len) {
+    uint16_t proto;
+    uint8_t* pkt;
+    size_t pl;
+
+    if (len < 6 || ppp_fcs(f, len) != 0xF0B8 || f[0] != 0xFF || f[1] != 0x03) {
+        ++stats.ppp_bad;
+        return;
+    }
+    ++stats.ppp_in;
+    proto = (uint16_t)((f[2] << 8) | f[3]);
+    pkt = &f[4];
+    pl = len - 6;
+    if (proto == PPP_PROTO_IP) {
+        if (pl >= 20) {
+            uint8_t tmp[4];
+            memcpy(tmp, &pkt[12], 4);
+            memcpy(&pkt[12], &pkt[16], 4);
+            memcpy(&pkt[16], tmp, 4);
+            ++stats.ppp_ip;
+            ppp_out_frame(PPP_PROTO_IP, pkt, pl);
+        }
+        return;
+    }
+    if (pl < 4 || ((pkt[2] << 8) | pkt[3]) > (int)pl) {
+        return;
+    }
+    pl = (size_t)((pkt[2] << 8) | pkt[3]) - 4;
+    if (proto == PPP_PROTO_LCP) {
+        if (pkt[0] == 0x01) { /* Configure request */
+            ppp_out_cp(PPP_PROTO_LCP, 0x02, pkt[1], &pkt[4], pl);
+        } else if (pkt[0] == 0x05) { /* Terminate request, acknowledge and leave data mode */
+            ppp_out_cp(PPP_PROTO_LCP, 0x06, pkt[1], NULL, 0);
+            out_data("\r\nNO CARRIER\r\n", 14);
+            mode = MODE_CMD;
+        } else if (pkt[0] == 0x09) { /* Echo request */
+            ppp_out_cp(PPP_PROTO_LCP, 0x0A, pkt[1], &pkt[4], pl);
+        }
+    } else if (proto == PPP_PROTO_PAP) {
+        if (pkt[0] == 0x01) { /* Any credentials are accepted */
+            static const uint8_t msg[] = {0x00};
+            ppp_out_cp(PPP_PROTO_PAP, 0x02, pkt[1], msg, sizeof(msg));
+        }
+    } else if (proto == PPP_PROTO_IPCP) {
+        if (pkt[0] == 0x01) {
+            static const uint8_t ip_opt[] = {0x03, 0x06, 10, 0, 0, 1};
+            uint8_t nak[18];
+            size_t nl = 0;
+
+            for (size_t i = 0; i + 6 <= pl && pkt[4 + i + 1] == 6; i += 6) {
+                const uint8_t* o = &pkt[4 + i];
+                if (!o[2] && !o[3] && !o[4] && !o[5] && (o[0] == 0x03 || o[0] == 0x81 || o[0] == 0x83)) {
+                    nak[nl++] = o[0];
+                    nak[nl++] = 6;
+                    nak[nl++] = o[0] == 0x03 ? 10 : 8;
+                    nak[nl++] = o[0] == 0x03 ? 0 : 8;
+                    nak[nl++] = o[0] == 0x03 ? 0 : (o[0] == 0x81 ? 8 : 4);
+                    nak[nl++] = o[0] == 0x03 ? 2 : (o[0] == 0x81 ? 8 : 4);
+                }
+            }
+            if (nl > 0) {
+                ppp_out_cp(PPP_PROTO_IPCP, 0x03, pkt[1], nak, nl);
+                ppp_out_cp(PPP_PROTO_IPCP, 0x01, ++ppp_id, ip_opt, sizeof(ip_opt));
+            } else {
+                ppp_out_cp(PPP_PROTO_IPCP, 0x02, pkt[1], &pkt[4], pl);
+            }
+        }
+    }
+}
+
+/**
+ * \brief           Decode PPP frames received from host
+ * \param[in]       d: Received data
+ * \param[in]       len: Number of received bytes
+ * \return          Number of processed bytes, less than `len` when link terminated and command mode follows
+ */
+static size_t
+ppp_input(const uint8_t* d, size_t len) {
+    size_t i = 0;
+
+    for (; i < len && mode == MODE_PPP; ++i) {
+        if (d[i] == PPP_FLAG) {
+            if (ppp_rx_len > 0) {
+                ppp_frame(ppp_rx, ppp_rx_len);
+            }
+            ppp_rx_len = ppp_rx_esc = 0;
+        } else if (d[i] == PPP_ESC) {
+            ppp_rx_esc = 1;
+        } else if (ppp_rx_len < sizeof(ppp_rx)) {
+            ppp_rx[ppp_rx_len++] = ppp_rx_esc ? d[i] ^ 0x20 : d[i];
+            ppp_rx_esc = 0;
+        }
+    }
+    return i;
+}
+
+/**
+ * \brief           Process single AT command line
+ * \param[in]       l: Command line without line ending
+ */
+static void
+process_cmd(const char* l) {
+    const char* p;
+
+    ++stats.cmds;
+    if (strncasecmp(l, "AT", 2)) {
+        return; /* Not a command, ignore */
+    }
+    p = l + 2;
+
+#define IS(cmd) is_cmd(&p, cmd)
+
+    if (*p == 0) {
+        OUT_OK();
+    } else if (IS("E0")) {
+        echo = 0;
+        OUT_OK();
+    } else if (IS("E1")) {
+        echo = 1;
+        OUT_OK();
+    } else if (IS("+CFUN=1,1")) {
+        memset(conns, 0x00, sizeof(conns));
+        attached = ip_ready = cipmux = cipqsend = 0;
+        OUT_OK();
+        cmux = 0; /* Device restarts in normal mode */
+        OUT_LINE("RDY");
+        OUT_LINE("+CPIN: READY");
+        OUT_LINE("Call Ready");
+        OUT_LINE("SMS Ready");
+    } else if (IS("+CMUX=")) {
+        const char* n1 = p;
+
+        /* N1 is 4th parameter, port speed before it may be empty */
+        for (int i = 0; i < 3 && n1 != NULL; ++i) {
+            n1 = strchr(n1, ',');
+            n1 = n1 != NULL ? n1 + 1 : NULL;
+        }
+        cmux_n1 = n1 != NULL && *n1 >= '0' && *n1 <= '9' ? strtoul(n1, NULL, 10) : 31;
+        if (parse_num(&p) != 0 || cmux_n1 == 0 || cmux_n1 > SIM_CMUX_N1) { /* Only basic mode */
+            OUT_ERROR();
+        } else {
+            OUT_OK();
+            cmux = 1;
+            cmux_rx_len = cmux_rx_open = 0;
+        }
+    } else if (IS("+CGMI")) {
+        OUT_LINE("SIMCOM_Ltd");
+        OUT_OK();
+    } else if (IS("+CGMM")) {
+        OUT_LINE("SIMCOM_SIM800");
+        OUT_OK();
+    } else if (IS("+CGSN")) {
+        OUT_LINE("866104021234567");
+        OUT_OK();
+    } else if (IS("+CGMR")) {
+        OUT_LINE("Revision:1418B04SIM800C24");
+        OUT_OK();
+    } else if (IS("+CREG?")) {
+        OUT_LINE("+CREG: %u,%u", (unsigned)creg_urc, (unsigned)creg_stat);
+        OUT_OK();
+    } else if (IS("+CREG=")) {
+        creg_urc = (uint8_t)parse_num(&p);
+        OUT_OK();
+    } else if (IS("+CPIN?")) {
+        OUT_LINE("+CPIN: READY");
+        OUT_OK();
+    } else if (IS("+CSQ")) {
+        OUT_LINE("+CSQ: %u,0", (unsigned)(10 + rand() % 20));
+        OUT_OK();
+    } else if (IS("+CNUM")) {
+        OUT_LINE("+CNUM: \"\",\"+38640123456\",145,7,4");
+        OUT_OK();
+    } else if (IS("+COPS=?")) {
+        OUT_LINE("+COPS: (2,\"Operator A\",\"OPA\",\"29340\"),(1,\"Operator B\",\"OPB\",\"29341\"),"
+                 "(3,\"Operator C\",\"OPC\",\"29370\"),,(0-4),(0-2)");
+        OUT_OK();
+    } else if (IS("+COPS?")) {
+        OUT_LINE("+COPS: 0,0,\"Operator A\"");
+        OUT_OK();
+    } else if (IS("+CGATT=")) {
+        attached = (uint8_t)parse_num(&p);
+        if (!attached) {
+            ip_ready = 0;
+        }
+        OUT_OK();
+    } else if (IS("+CIPSHUT")) {
+        memset(conns, 0x00, sizeof(conns));
+        ip_ready = 0;
+        server_port = 0;
+        OUT_LINE("SHUT OK");
+    } else if (IS("+CIPSERVER=")) {
+        unsigned m = (unsigned)parse_num(&p);
+        if (m && ip_ready && cipmux) {
+            server_port = (unsigned)parse_num(&p);
+            next_accept = now_us() + (uint64_t)cfg.accept_ms * 1000ULL;
+            OUT_OK();
+            OUT_LINE("SERVER OK");
+        } else if (!m && server_port > 0) {
+            server_port = 0;
+            OUT_OK();
+            OUT_LINE("SERVER CLOSE");
+        } else {
+            OUT_ERROR();
+        }
+    } else if (IS("+CIPMUX=")) {
+        unsigned m = (unsigned)parse_num(&p);
+        if (m && cipmode) { /* Transparent mode works only with single connection */
+            OUT_ERROR();
+        } else {
+            cipmux = (uint8_t)m;
+            OUT_OK();
+        }
+    } else if (IS("+CIPMODE=")) {
+        unsigned m = (unsigned)parse_num(&p);
+        if (m && cipmux) {
+            OUT_ERROR();
+        } else {
+            cipmode = (uint8_t)m;
+            OUT_OK();
+        }
+    } else if (IS("+CIPQSEND=")) {
+        cipqsend = (uint8_t)parse_num(&p);
+        OUT_OK();
+    } else if (IS("+CIPRXGET=")) {
+        unsigned m = (unsigned)parse_num(&p), num = (unsigned)parse_num(&p);
+        if (m <= 1) {
+            ciprxget = (uint8_t)m;
+            OUT_OK();
+        } else if (!ciprxget || num >= SIM_MAX_CONNS || !conns[num].active) {
+            OUT_ERROR();
+        } else if (m == 2) {
+            sim_conn_t* c = &conns[num];
+            size_t cnt = (size_t)parse_num(&p);
+
+            if (cnt > c->rx_len) {
+                cnt = c->rx_len;
+            }
+            out_printf("\r\n+CIPRXGET: 2,%u,%u,%u\r\n", num, (unsigned)cnt, (unsigned)(c->rx_len - cnt));
+            out_data(c->rx, cnt);
+            memmove(&c->rx[0], &c->rx[cnt], c->rx_len - cnt);
+            c->rx_len -= cnt;
+            OUT_OK();
+        } else if (m == 4) {
+            OUT_LINE("+CIPRXGET: 4,%u,%u", num, (unsigned)conns[num].rx_len);
+            OUT_OK();
+        } else {
+            OUT_ERROR();
+        }
+    } else if (IS("+CIPACK=")) {
+        unsigned num = (unsigned)parse_num(&p);
+        if (num >= SIM_MAX_CONNS || !conns[num].active) {
+            OUT_ERROR();
+        } else {
+            conn_ack_update(&conns[num]);
+            OUT_LINE("+CIPACK: %lu,%lu,%lu", conns[num].tx, conns[num].ack, conns[num].tx - conns[num].ack);
+            OUT_OK();
+        }
+    } else if (IS("+CIICR")) {
+        if (attached) {
+            OUT_OK();
+        } else {
+            OUT_ERROR();
+        }
+    } else if (IS("+CIFSR")) {
+        if (attached) {
+            ip_ready = 1;
+            OUT_LINE("10.64.12.34");
+        } else {
+            OUT_ERROR();
+        }
+    } else if (IS("+CIPSTATUS")) {
+        cmd_cipstatus();
+    } else if (IS("+CIPSTART=")) {
+        unsigned num = cipmux ? (unsigned)parse_num(&p) : 0; /* Single connection mode has no number */
+        if (num >= SIM_MAX_CONNS || !ip_ready) {
+            OUT_ERROR();
+        } else if (conns[num].active) {
+            OUT_OK();
+            if (cipmux) {
+                OUT_LINE("%u, ALREADY CONNECT", num);
+            } else {
+                OUT_LINE("ALREADY CONNECT");
+            }
+        } else if (!cipmux) {
+            memset(&conns[num], 0x00, sizeof(conns[num]));
+            parse_str(&p, conns[num].type, sizeof(conns[num].type));
+            parse_str(&p, conns[num].host, sizeof(conns[num].host));
+            conns[num].port = (unsigned)parse_num(&p);
+            OUT_OK();
+            if (!strcmp(conns[num].host, "fail")) {
+                OUT_LINE("CONNECT FAIL");
+            } else if (cipmode) {
+                conns[num].active = 1;
+                OUT_LINE("CONNECT");
+                transp_last_in = now_us();
+                transp_plus = 0;
+                mode = MODE_TRANSP;
+            } else {
+                conns[num].active = 1;
+                OUT_LINE("CONNECT OK");
+            }
+        } else {
+            memset(&conns[num], 0x00, sizeof(conns[num]));
+            parse_str(&p, conns[num].type, sizeof(conns[num].type));
+            parse_str(&p, conns[num].host, sizeof(conns[num].host));
+            conns[num].port = (unsigned)parse_num(&p);
+            OUT_OK();
+            if (!strcmp(conns[num].host, "fail")) {
+                OUT_LINE("%u, CONNECT FAIL", num);
+            } else {
+                conns[num].active = 1;
+                OUT_LINE("%u, CONNECT OK", num);
+            }
+        }
+    } else if (IS("+CIPSEND=")) {
+        unsigned num = (unsigned)parse_num(&p);
+        unsigned len = (unsigned)parse_num(&p);
+        if (num >= SIM_MAX_CONNS || !conns[num].active || len == 0 || len > SIM_DATA_MAX) {
+            OUT_ERROR();
+        } else {
+            data_conn = (uint8_t)num;
+            data_exp = len;
+            data_len = 0;
+            mode = MODE_DATA;
+            out_printf("\r\n> ");
+        }
+    } else if (IS("+CIPCLOSE=")) {
+        unsigned num = cipmux ? (unsigned)parse_num(&p) : 0;
+        if (num >= SIM_MAX_CONNS || !conns[num].active) {
+            OUT_ERROR();
+        } else {
+            conns[num].active = 0;
+            if (cipmux) {
+                OUT_LINE("%u, CLOSE OK", num);
+            } else {
+                OUT_LINE("CLOSE OK");
+            }
+        }
+    } else if (IS("O")) {
+        if (cipmode && !cipmux && conns[0].active) { /* Return to data mode */
+            OUT_LINE("CONNECT");
+            transp_last_in = now_us();
+            transp_plus = 0;
+            mode = MODE_TRANSP;
+        } else {
+            OUT_ERROR();
+        }
+    } else if (IS("+CMGS=")) {
+        sms_len = 0;
+        mode = MODE_SMS;
+        out_printf("\r\n> ");
+    } else if (IS("+CMGL=")) {
+        char stat[16];
+        parse_str(&p, stat, sizeof(stat));
+        for (size_t i = 0; i < SIM_SMS_MAX; ++i) {
+            if (sms[i].used
+                && (!strcmp(stat, "ALL") || (!strcmp(stat, "REC READ") && sms[i].read)
+                    || (!strcmp(stat, "REC UNREAD") && !sms[i].read))) {
+                out_sms(i, 1);
+                if (parse_num(&p) == 0) {
+                    sms[i].read = 1;
+                }
+            }
+        }
+        OUT_OK();
+    } else if (IS("+CMGR=")) {
+        unsigned pos = (unsigned)parse_num(&p);
+        if (pos > 0 && pos <= SIM_SMS_MAX && sms[pos - 1].used) {
+            out_sms(pos - 1, 0);
+            sms[pos - 1].read = 1;
+        }
+        OUT_OK();
+    } else if (IS("+CMGD=")) {
+        unsigned pos = (unsigned)parse_num(&p);
+        if (pos > 0 && pos <= SIM_SMS_MAX) {
+            sms[pos - 1].used = 0;
+        }
+        OUT_OK();
+    } else if (IS("+CPMS=?")) {
+        OUT_LINE("+CPMS: (\"SM\",\"ME\",\"SM_P\",\"ME_P\",\"MT\"),(\"SM\",\"ME\",\"SM_P\",\"ME_P\",\"MT\"),"
+                 "(\"SM\",\"ME\",\"SM_P\",\"ME_P\",\"MT\")");
+        OUT_OK();
+    } else if (IS("+CPMS?")) {
+        unsigned c = sms_count();
+        OUT_LINE("+CPMS: \"SM\",%u,%u,\"SM\",%u,%u,\"SM\",%u,%u", c, SIM_SMS_MAX, c, SIM_SMS_MAX, c, SIM_SMS_MAX);
+        OUT_OK();
+    } else if (IS("+CPMS=")) {
+        unsigned c = sms_count();
+        OUT_LINE("+CPMS: %u,%u,%u,%u,%u,%u", c, SIM_SMS_MAX, c, SIM_SMS_MAX, c, SIM_SMS_MAX);
+        OUT_OK();
+    } else if (IS("+CPBS=?")) {
+        OUT_LINE("+CPBS: (\"MC\",\"RC\",\"DC\",\"LA\",\"ME\",\"SM\",\"FD\",\"ON\",\"BN\",\"SD\",\"VM\")");
+        OUT_OK();
+    } else if (IS("+CPBS?")) {
+        OUT_LINE("+CPBS: \"SM\",%u,250", (unsigned)(sizeof(pb) / sizeof(pb[0])));
+        OUT_OK();
+    } else if (IS("+CPBR=")) {
+        unsigned start = (unsigned)parse_num(&p);
+        unsigned cnt = (unsigned)parse_num(&p);
+        for (unsigned i = start; i < start + cnt && i > 0 && i <= sizeof(pb) / sizeof(pb[0]); ++i) {
+            OUT_LINE("+CPBR: %u,\"%s\",145,\"%s\"", i, pb[i - 1].num, pb[i - 1].name);
+        }
+        OUT_OK();
+    } else if (IS("+CPBF=")) {
+        char search[32];
+        parse_str(&p, search, sizeof(search));
+        for (unsigned i = 0; i < sizeof(pb) / sizeof(pb[0]); ++i) {
+            if (strcasestr(pb[i].name, search) != NULL) {
+                OUT_LINE("+CPBF: %u,\"%s\",145,\"%s\"", i + 1, pb[i].num, pb[i].name);
+            }
+        }
+        OUT_OK();
+    } else if (IS("+CUSD=")) {
+        OUT_OK();
+        OUT_LINE("+CUSD: 0,\"Balance: 10.00 EUR\",15");
+    } else if (IS("D*99")) {
+        OUT_LINE("CONNECT");
+        ppp_start();
+    } else if (IS("D")) {
+        OUT_OK();
+    } else if (IS("A") || IS("H")) {
+        OUT_OK();
+    } else if (IS("+CFUN=") || IS("+CMEE=") || IS("+CLCC=") || IS("+CGACT=") || IS("+CSTT=") || IS("+CIPSSL=")
+               || IS("+CIPHEAD=") || IS("+CIPSRIP=") || IS("+CMGF=") || IS("+CMGDA=") || IS("+CPBS=") || IS("+CPBW=")
+               || IS("+CPIN=") || IS("+CUSD?") || IS("+COPS=") || IS("+CGDCONT=")) {
+        OUT_OK();
+    } else {
+        OUT_ERROR();
+    }
+#undef IS
+}
+
+/**
+ * \brief           Send data to remote side of connection `0` in transparent mode
+ * \param[in]       d: Data to send
+ * \param[in]       len: Number of bytes
+ */
+static void
+transp_data(const uint8_t* d, size_t len) {
+    stats.send_bytes += len;
+    conns[0].tx += len;
+    while (cfg.echo_data && len > 0) {
+        size_t cnt = len > SIM_DATA_MAX ? SIM_DATA_MAX : len;
+
+        out_receive(0, d, cnt);
+        d += cnt;
+        len -= cnt;
+    }
+}
+
+/**
+ * \brief           Leave transparent mode once escape sequence is followed by guard time of silence
+ * \return          Time in microseconds until escape sequence completes, `-1` if there is none
+ */
+static int64_t
+transp_process(void) {
+    uint64_t now = now_us(), due = transp_last_in + (uint64_t)cfg.guard_ms * 1000ULL;
+
+    if (mode != MODE_TRANSP || transp_plus < 3) {
+        return -1;
+    }
+    if (now < due) {
+        return (int64_t)(due - now);
+    }
+    transp_plus = 0;
+    mode = MODE_CMD;
+    OUT_OK();
+    return -1;
+}
+
+/**
+ * \brief           Process AT channel bytes received from host
+ * \param[in]       d: Received data
+ * \param[in]       len: Number of received bytes
+ */
+static void
+process_at(const uint8_t* d, size_t len) {
+    for (size_t i = 0; i < len; ++i) {
+        uint8_t ch = d[i];
+
+        /* Line feed after command belongs to command, even if data mode started */
+        if (lf_skip) {
+            lf_skip = 0;
+            if (ch == '\n') {
+                continue;
+            }
+        }
+        switch (mode) {
+            case MODE_TRANSP: {
+                uint64_t now = now_us();
+
+                /* Escape sequence must follow guard time of silence */
+                if (ch == '+' && transp_plus < 3
+                    && (transp_plus > 0 || now - transp_last_in >= (uint64_t)cfg.guard_ms * 1000ULL)) {
+                    ++transp_plus;
+                } else {
+                    if (transp_plus > 0) { /* Not an escape sequence, pluses are data */
+                        transp_data((const uint8_t*)"+++", transp_plus);
+                        transp_plus = 0;
+                    }
+
+                    /* Rest of the block has no guard time before it */
+                    transp_data(&d[i], len - i);
+                    i = len - 1;
+                }
+                transp_last_in = now;
+                break;
+            }
+            case MODE_PPP: {
+                i += ppp_input(&d[i], len - i) - 1;
+                break;
+            }
+            case MODE_DATA: {
+                size_t cnt = len - i;
+                if (cnt > data_exp - data_len) {
+                    cnt = data_exp - data_len;
+                }
+                memcpy(&data_buff[data_len], &d[i], cnt);
+                data_len += cnt;
+                i += cnt - 1;
+                if (data_len == data_exp) {
+                    mode = MODE_CMD;
+                    ++stats.send_ok;
+                    stats.send_bytes += data_len;
+                    conn_sent(&conns[data_conn], data_len);
+                    if (cipqsend) {
+                        /* Quick send, reply once data are in buffer */
+                        OUT_LINE("DATA ACCEPT:%u,%u", (unsigned)data_conn, (unsigned)data_len);
+                    } else {
+                        /* Normal send, reply once remote side acknowledged data */
+                        char buff[32];
+                        int l = snprintf(buff, sizeof(buff), "\r\n%u, SEND OK\r\n", (unsigned)data_conn);
+                        out_data_delayed(buff, (size_t)l, (uint64_t)cfg.ack_ms * 1000ULL);
+                    }
+                    if (cfg.echo_data) {
+                        out_receive(data_conn, data_buff, data_len);
+                    }
+                }
+                break;
+            }
+            case MODE_SMS: {
+                if (ch == 0x1A) {
+                    mode = MODE_CMD;
+                    sms_text[sms_len] = 0;
+                    ++stats.sms_sent;
+                    OUT_LINE("+CMGS: %u", (unsigned)(stats.sms_sent % 256));
+                    OUT_OK();
+                } else if (ch == 0x1B) {
+                    mode = MODE_CMD;
+                    OUT_OK();
+                } else if (sms_len < sizeof(sms_text) - 1) {
+                    sms_text[sms_len++] = (char)ch;
+                }
+                break;
+            }
+            default: {
+                if (ch == '\r') {
+                    line[line_len] = 0;
+                    if (echo) {
+                        out_printf("%s\r", line);
+                    }
+                    if (line_len > 0) {
+                        process_cmd(line);
+                    }
+                    line_len = 0;
+                    lf_skip = 1;
+                } else if (ch != '\n' && line_len < sizeof(line) - 1) {
+                    line[line_len++] = (char)ch;
+                }
+                break;
+            }
+        }
+    }
+}
+
+/**
+ * \brief           Process complete multiplexer frame from host
+ * \param[in]       f: Frame without flags
+ * \param[in]       len: Frame length
+ */
+static void
+cmux_frame(const uint8_t* f, size_t len) {
+    uint8_t dlci = f[0] >> 2, ctrl = f[1] & ~CMUX_PF;
+    size_t hl = (f[2] & 0x01) ? 3 : 4;
+    size_t il = len - hl - 1;
+    const uint8_t* info = &f[hl];
+
+    if (il > cmux_n1 || (uint8_t)(cmux_fcs(f, hl) + f[len - 1]) != 0xFF) {
+        ++stats.cmux_bad;
+        return;
+    }
+    ++stats.cmux_in;
+    if (ctrl == CMUX_SABM || ctrl == CMUX_DISC) {
+        cmux_out_frame(dlci, CMUX_UA | CMUX_PF, NULL, 0, 0);
+        if (ctrl == CMUX_DISC && dlci == 0) {
+            cmux = 0;
+        }
+    } else if (ctrl == CMUX_UIH) {
+        if (dlci == 0) {
+            if (il > 0 && info[0] == 0xC3) { /* Close down, confirm and return to normal mode */
+                uint8_t rsp[] = {0xC1, 0x01};
+                cmux_out_frame(0, CMUX_UIH, rsp, sizeof(rsp), 0);
+                cmux = 0;
+            } else if (il > 0 && (info[0] & 0x02)) { /* Confirm other commands with the same value */
+                uint8_t rsp[SIM_CMUX_N1];
+                memcpy(rsp, info, il);
+                rsp[0] &= ~0x02;
+                cmux_out_frame(0, CMUX_UIH, rsp, il, 0);
+            }
+        } else if (dlci == 1) {
+            process_at(info, il);
+        } else {
+            cmux_out_frame(dlci, CMUX_UIH, info, il, 0); /* Loop back data channels */
+        }
+    }
+}
+
+/**
+ * \brief           Process bytes received from host
+ * \param[in]       d: Received data
+ * \param[in]       len: Number of received bytes
+ */
+static void
+process_input(const uint8_t* d, size_t len) {
+    stats.bytes_in += len;
+    if (cfg.verbose) {
+        fprintf(stderr, "\x1b[31m%.*s\x1b[0m", (int)len, (const char*)d);
+    }
+    for (size_t i = 0; i < len && cmux; ++i) {
+        uint8_t ch = d[i];
+        size_t flen = 0;
+
+        /* Frame length is known from header, information field may contain flag value */
+        if (cmux_rx_len >= 3 && (cmux_rx[2] & 0x01)) {
+            flen = 3 + (size_t)(cmux_rx[2] >> 1) + 1;
+        } else if (cmux_rx_len >= 4) {
+            flen = 4 + (size_t)((cmux_rx[2] >> 1) | (cmux_rx[3] << 7)) + 1;
+        }
+        if (!cmux_rx_open) {
+            cmux_rx_open = ch == CMUX_FLAG;
+            cmux_rx_len = 0;
+        } else if (cmux_rx_len == 0 && ch == CMUX_FLAG) {
+            /* Repeated flag between frames */
+        } else if (flen > 0 && cmux_rx_len == flen) {
+            if (ch == CMUX_FLAG) {
+                cmux_frame(cmux_rx, cmux_rx_len);
+            } else {
+                ++stats.cmux_bad;
+                cmux_rx_open = 0;
+            }
+            cmux_rx_len = 0; /* Closing flag may be opening flag of next frame */
+        } else if (cmux_rx_len < sizeof(cmux_rx)) {
+            cmux_rx[cmux_rx_len++] = ch;
+        } else {
+            ++stats.cmux_bad;
+            cmux_rx_open = 0;
+        }
+        if (!cmux) { /* Rest of the data is in normal mode */
+            d += i + 1;
+            len -= i + 1;
+            break;
+        }
+    }
+    if (!cmux) {
+        process_at(d, len);
+    }
+}
+
+/**
+ * \brief           Inject periodic URCs
+ * \return          Time in microseconds until next injection, `-1` if disabled
+ */
+static int64_t
+urc_process(void) {
+    uint64_t now = now_us();
+    int64_t next = -1;
+
+    if (cfg.urc_ms > 0) {
+        if (now >= next_urc) {
+            creg_stat = creg_stat == 1 ? 5 : 1; /* Flap between home and roaming registration */
+            if (creg_urc) {
+                OUT_LINE("+CREG: %u", (unsigned)creg_stat);
+            }
+            next_urc = now + (uint64_t)cfg.urc_ms * 1000ULL;
+        }
+        next = (int64_t)(next_urc - now);
+    }
+    if (cfg.recv_ms > 0) {
+        if (now >= next_recv) {
+            for (uint8_t i = 0; i < SIM_MAX_CONNS; ++i) {
+                if (conns[i].active) {
+                    out_receive(i, NULL, cfg.recv_size);
+                }
+            }
+            next_recv = now + (uint64_t)cfg.recv_ms * 1000ULL;
+        }
+        if (next < 0 || (int64_t)(next_recv - now) < next) {
+            next = (int64_t)(next_recv - now);
+        }
+    }
+    if (cfg.accept_ms > 0 && server_port > 0) {
+        if (now >= next_accept) {
+            /* Remote client connects to first free connection */
+            for (uint8_t i = 0; i < SIM_MAX_CONNS; ++i) {
+                if (!conns[i].active) {
+                    memset(&conns[i], 0x00, sizeof(conns[i]));
+                    strcpy(conns[i].type, "TCP");
+                    strcpy(conns[i].host, "10.0.0.100");
+                    conns[i].port = 40000U + i;
+                    conns[i].active = 1;
+                    ++stats.accepts;
+                    OUT_LINE("%u, REMOTE IP: %s", (unsigned)i, conns[i].host);
+                    break;
+                }
+            }
+            next_accept = now + (uint64_t)cfg.accept_ms * 1000ULL;
+        }
+        if (next < 0 || (int64_t)(next_accept - now) < next) {
+            next = (int64_t)(next_accept - now);
+        }
+    }
+    return next;
+}
+
+/**
+ * \brief           Print statistics to stderr
+ */
+static void
+print_stats(void) {
+    double sec = (double)(now_us() - start_time) / 1000000.0;
+
+    fprintf(stderr,
+            "\r\n--- lwcell modem simulator statistics (%.2f s) ---\r\n"
+            "AT commands:    %llu\r\n"
+            "Bytes in/out:   %llu / %llu\r\n"
+            "CIPSEND:        %llu OK, %llu bytes (%.1f kB/s)\r\n"
+            "+RECEIVE:       %llu URCs, %llu bytes (%.1f kB/s), %llu dropped\r\n"
+            "SMS sent:       %llu\r\n"
+            "Server:         %llu connections accepted\r\n"
+            "CMUX frames:    %llu, %llu bad\r\n"
+            "PPP frames:     %llu, %llu bad, %llu IP packets\r\n",
+            sec, (unsigned long long)stats.cmds, (unsigned long long)stats.bytes_in,
+            (unsigned long long)stats.bytes_out, (unsigned long long)stats.send_ok,
+            (unsigned long long)stats.send_bytes, sec > 0 ? stats.send_bytes / sec / 1024.0 : 0.0,
+            (unsigned long long)stats.recv_urcs, (unsigned long long)stats.recv_bytes,
+            sec > 0 ? stats.recv_bytes / sec / 1024.0 : 0.0, (unsigned long long)stats.recv_drop,
+            (unsigned long long)stats.sms_sent, (unsigned long long)stats.accepts, (unsigned long long)stats.cmux_in,
+            (unsigned long long)stats.cmux_bad, (unsigned long long)stats.ppp_in,
+            (unsigned long long)stats.ppp_bad, (unsigned long long)stats.ppp_ip);
+}
+
+static void
+signal_handler(int sig) {
+    (void)sig;
+    running = 0;
+}
+
+static void
+usage(const char* name) {
+    fprintf(stderr,
+            "Usage: %s [options]\n"
+            "  -l <ms>     Response latency (default 0)\n"
+            "  -a <ms>     Remote acknowledge delay of sent data (default 0)\n"
+            "  -b <B/s>    Output bandwidth limit in bytes per second (default unlimited)\n"
+            "  -u <ms>     +CREG flap URC interval (default off)\n"
+            "  -r <ms>     +RECEIVE injection interval per active connection (default off)\n"
+            "  -s <bytes>  +RECEIVE injection payload size (default 512)\n"
+            "  -c <ms>     Incoming connection interval while server is enabled (default off)\n"
+            "  -g <ms>     Guard time of +++ escape sequence in transparent mode (default 1000)\n"
+            "  -x          Echo sent payload back to host\n"
+            "  -L <path>   Create symlink to slave pseudo-terminal\n"
+            "  -v          Print traffic to stderr\n",
+            name);
+}
+
+int
+main(int argc, char** argv) {
+    struct pollfd pfd;
+    uint8_t buff[4096];
+    const char* slave;
+    int opt, slave_fd;
+
+    while ((opt = getopt(argc, argv, "l:a:b:u:r:s:c:g:xL:vh")) != -1) {
+        switch (opt) {
+            case 'l': cfg.latency_ms = (uint32_t)strtoul(optarg, NULL, 0); break;
+            case 'a': cfg.ack_ms = (uint32_t)strtoul(optarg, NULL, 0); break;
+            case 'b': cfg.bandwidth = (uint32_t)strtoul(optarg, NULL, 0); break;
+            case 'u': cfg.urc_ms = (uint32_t)strtoul(optarg, NULL, 0); break;
+            case 'r': cfg.recv_ms = (uint32_t)strtoul(optarg, NULL, 0); break;
+            case 's': cfg.recv_size = (uint32_t)strtoul(optarg, NULL, 0); break;
+            case 'c': cfg.accept_ms = (uint32_t)strtoul(optarg, NULL, 0); break;
+            case 'g': cfg.guard_ms = (uint32_t)strtoul(optarg, NULL, 0); break;
+            case 'x': cfg.echo_data = 1; break;
+            case 'L': cfg.link = optarg; break;
+            case 'v': cfg.verbose = 1; break;
+            default: usage(argv[0]); return opt == 'h' ? 0 : 1;
+        }
+    }
+
+    /* Create pseudo-terminal pair */
+    master_fd = posix_openpt(O_RDWR | O_NOCTTY);
+    if (master_fd < 0 || grantpt(master_fd) != 0 || unlockpt(master_fd) != 0
+        || (slave = ptsname(master_fd)) == NULL) {
+        perror("posix_openpt");
+        return 1;
+    }
+
+    /*
+     * Keep slave open so master does not see hang-up
+     * while host application reopens the device
+     */
+    slave_fd = open(slave, O_RDWR | O_NOCTTY);
+    if (slave_fd >= 0) {
+        struct termios tio;
+        if (tcgetattr(slave_fd, &tio) == 0) {
+            cfmakeraw(&tio);
+            tcsetattr(slave_fd, TCSANOW, &tio);
+        }
+    }
+    fcntl(master_fd, F_SETFL, fcntl(master_fd, F_GETFL) | O_NONBLOCK);
+    if (cfg.link != NULL) {
+        unlink(cfg.link);
+        if (symlink(slave, cfg.link) != 0) {
+            perror("symlink");
+        }
+    }
+    printf("%s\n", slave);
+    fflush(stdout);
+
+    signal(SIGINT, signal_handler);
+    signal(SIGTERM, signal_handler);
+    start_time = tokens_time = now_us();
+
+    while (running) {
+        int64_t t_out, t_urc, t_transp, t;
+        ssize_t r;
+
+        t_transp = transp_process();
+        t_out = out_process();
+        t_urc = urc_process();
+        t = t_out < 0 ? t_urc : (t_urc < 0 ? t_out : (t_out < t_urc ? t_out : t_urc));
+        t = t < 0 ? t_transp : (t_transp < 0 ? t : (t < t_transp ? t : t_transp));
+
+        pfd.fd = master_fd;
+        pfd.events = POLLIN;
+        if (poll(&pfd, 1, t < 0 ? -1 : (int)((t + 999) / 1000)) < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            break;
+        }
+        if (pfd.revents & POLLIN) {
+            while ((r = read(master_fd, buff, sizeof(buff))) > 0) {
+                process_input(buff, (size_t)r);
+            }
+        }
+    }
+
+    print_stats();
+    if (cfg.link != NULL) {
+        unlink(cfg.link);
+    }
+    if (slave_fd >= 0) {
+        close(slave_fd);
+    }
+    close(master_fd);
+    return 0;
+}